@@ -65,6 +65,11 @@
 #define XNV_STAT_WIP  0x01
 #endif
 
+// Bytes read from the image at a time for the CRC calculation
+#if !defined HAL_OTA_CRC_BUF_LEN
+#define HAL_OTA_CRC_BUF_LEN  16
+#endif
+
 /******************************************************************************
  * TYPEDEFS
  */
@@ -79,6 +84,13 @@ typedef struct
  */
 OTA_CrcControl_t OTA_crcControl;
 
+// Polynomial 0x1021 applied for each value of the 4 bits shifted out of the CRC
+static const CODE uint16 crcNibbleTbl[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
 #if HAL_OTA_BOOT_CODE
 halDMADesc_t dmaCh0;
 #endif
@@ -87,6 +99,7 @@ halDMADesc_t dmaCh0;
  * LOCAL FUNCTIONS
  */
 static uint16 runPoly(uint16 crc, uint8 val);
+static uint16 crcImage(uint32 base, uint32 len, image_t type);
 
 #if HAL_OTA_XNV_IS_SPI
 static void HalSPIRead(uint32 addr, uint8 *pBuf, uint16 len);
@@ -189,21 +202,8 @@ static void dl2rc(void)
  */
 static uint16 crcCalc()
 {
-  uint32 oset;
-  uint16 crc = 0;
-
   // Run the CRC calculation over the active body of code.
-  for (oset = 0; oset < OTA_crcControl.programSize; oset++)
-  {
-    if ((oset < HAL_OTA_CRC_OSET) || (oset >= HAL_OTA_CRC_OSET + 4))
-    {
-      uint8 buf;
-      HalOTARead(oset, &buf, 1, HAL_OTA_RC);
-      crc = runPoly(crc, buf);
-    }
-  }
-
-  return crc;
+  return crcImage(0, OTA_crcControl.programSize, HAL_OTA_RC);
 }
 #endif //HAL_OTA_BOOT_CODE
 
@@ -219,16 +219,53 @@ static uint16 crcCalc()
  */
 static uint16 runPoly(uint16 crc, uint8 val)
 {
-  const uint16 poly = 0x1021;
-  uint8 cnt;
+  crc = ((crc << 4) | (val >> 4)) ^ crcNibbleTbl[crc >> 12];
+  crc = ((crc << 4) | (val & 0x0F)) ^ crcNibbleTbl[crc >> 12];
+
+  return crc;
+}
+
+/******************************************************************************
+ * @fn      crcImage
+ *
+ * @brief   Run the CRC16 Polynomial calculation over an image, skipping the
+ *          CRC control bytes at HAL_OTA_CRC_OSET.
+ *
+ * @param   base - Offset of the program in the image.
+ * @param   len - Length of the program.
+ * @param   type - Which image to read.
+ *
+ * @return  The CRC16 calculated.
+ */
+static uint16 crcImage(uint32 base, uint32 len, image_t type)
+{
+  uint8 buf[HAL_OTA_CRC_BUF_LEN];
+  uint32 oset = 0;
+  uint16 crc = 0;
+  uint8 cnt, idx;
 
-  for (cnt = 0; cnt < 8; cnt++, val <<= 1)
+  while (oset < len)
   {
-    uint8 msb = (crc & 0x8000) ? 1 : 0;
+    if (oset == HAL_OTA_CRC_OSET)
+    {
+      oset += 4;
+      continue;
+    }
+
+    // Read up to a buffer, stopping short of the CRC control bytes.
+    cnt = (len - oset < HAL_OTA_CRC_BUF_LEN) ? (uint8)(len - oset) : HAL_OTA_CRC_BUF_LEN;
+    if ((oset < HAL_OTA_CRC_OSET) && (oset + cnt > HAL_OTA_CRC_OSET))
+    {
+      cnt = (uint8)(HAL_OTA_CRC_OSET - oset);
+    }
 
-    crc <<= 1;
-    if (val & 0x80)  crc |= 0x0001;
-    if (msb)         crc ^= poly;
+    HalOTARead(oset + base, buf, cnt, type);
+    for (idx = 0; idx < cnt; idx++)
+    {
+      crc = runPoly(crc, buf[idx]);
+    }
+
+    oset += cnt;
   }
 
   return crc;
@@ -247,8 +284,7 @@ uint8 HalOTAChkDL(uint8 dlImagePreambleOffset)
 {
  (void)dlImagePreambleOffset;  // Intentionally unreferenced parameter
 
-  uint32 oset;
-  uint16 crc = 0;
+  uint16 crc;
   OTA_CrcControl_t crcControl;
   OTA_ImageHeader_t header;
   uint32 programStart;
@@ -272,15 +308,7 @@ uint8 HalOTAChkDL(uint8 dlImagePreambleOffset)
   }
 
   // Run the CRC calculation over the downloaded image.
-  for (oset = 0; oset < crcControl.programSize; oset++)
-  {
-    if ((oset < HAL_OTA_CRC_OSET) || (oset >= HAL_OTA_CRC_OSET+4))
-    {
-      uint8 buf;
-      HalOTARead(oset + programStart, &buf, 1, HAL_OTA_DL);
-      crc = runPoly(crc, buf);
-    }
-  }
+  crc = crcImage(programStart, crcControl.programSize, HAL_OTA_DL);
 
   return (crcControl.crc[0] == crc) ? SUCCESS : FAILURE;
 }
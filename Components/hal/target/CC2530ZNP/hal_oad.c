@@ -52,6 +52,16 @@
 #include "hal_oad.h"
 #include "hal_types.h"
 
+/* ------------------------------------------------------------------------------------------------
+ *                                          Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// Bytes read from the image at a time for the CRC calculation
+#if !defined HAL_OAD_CRC_BUF_LEN
+#define HAL_OAD_CRC_BUF_LEN  16
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                       Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -61,12 +71,20 @@
 halDMADesc_t dmaCh0;
 #endif
 
+// Polynomial 0x1021 applied for each value of the 4 bits shifted out of the CRC
+static const CODE uint16 crcNibbleTbl[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
 /* ------------------------------------------------------------------------------------------------
  *                                       Local Functions
  * ------------------------------------------------------------------------------------------------
  */
 
 static uint16 runPoly(uint16 crc, uint8 val);
+static uint16 crcImage(uint32 len, image_t type);
 #if HAL_OAD_XNV_IS_SPI
 static void HalSPIRead(uint32 addr, uint8 *pBuf, uint16 len);
 static void HalSPIWrite(uint32 addr, uint8 *pBuf, uint16 len);
@@ -199,8 +217,7 @@ static void dl2rc(void)
 static uint16 crcCalc(void)
 {
   preamble_t preamble;
-  uint32 oset;
-  uint16 crc = 0;
+  uint16 crc;
 
   HalOADRead(PREAMBLE_OFFSET, (uint8 *)&preamble, sizeof(preamble_t), HAL_OAD_RC);
   if (preamble.len > HAL_OAD_DL_SIZE)
@@ -209,19 +226,7 @@ static uint16 crcCalc(void)
   }
 
   // Run the CRC calculation over the active body of code.
-  for (oset = 0; oset < preamble.len; oset++)
-  {
-    if (oset == HAL_OAD_CRC_OSET)
-    {
-      oset += 3;
-    }
-    else
-    {
-      uint8 buf;
-      HalOADRead(oset, &buf, 1, HAL_OAD_RC);
-      crc = runPoly(crc, buf);
-    }
-  }
+  crc = crcImage(preamble.len, HAL_OAD_RC);
 
   // IAR note explains that poly must be run with value zero for each byte of crc.
   crc = runPoly(crc, 0);
@@ -243,16 +248,52 @@ static uint16 crcCalc(void)
  */
 static uint16 runPoly(uint16 crc, uint8 val)
 {
-  const uint16 poly = 0x1021;
-  uint8 cnt;
+  crc = ((crc << 4) | (val >> 4)) ^ crcNibbleTbl[crc >> 12];
+  crc = ((crc << 4) | (val & 0x0F)) ^ crcNibbleTbl[crc >> 12];
+
+  return crc;
+}
 
-  for (cnt = 0; cnt < 8; cnt++, val <<= 1)
+/*********************************************************************
+ * @fn      crcImage
+ *
+ * @brief   Run the CRC16 Polynomial calculation over an image, skipping the CRC bytes at
+ *          HAL_OAD_CRC_OSET.
+ *
+ * @param   len - Length of the image.
+ * @param   type - Which image to read.
+ *
+ * @return  The CRC16 calculated, before the zero bytes are run for the CRC itself.
+ */
+static uint16 crcImage(uint32 len, image_t type)
+{
+  uint8 buf[HAL_OAD_CRC_BUF_LEN];
+  uint32 oset = 0;
+  uint16 crc = 0;
+  uint8 cnt, idx;
+
+  while (oset < len)
   {
-    uint8 msb = (crc & 0x8000) ? 1 : 0;
+    if (oset == HAL_OAD_CRC_OSET)
+    {
+      oset += 4;
+      continue;
+    }
 
-    crc <<= 1;
-    if (val & 0x80)  crc |= 0x0001;
-    if (msb)         crc ^= poly;
+    // Read up to a buffer, stopping short of the CRC bytes.
+    cnt = (len - oset < HAL_OAD_CRC_BUF_LEN) ? (uint8)(len - oset) : HAL_OAD_CRC_BUF_LEN;
+    if ((oset < HAL_OAD_CRC_OSET) && (oset + cnt > HAL_OAD_CRC_OSET))
+    {
+      cnt = (uint8)(HAL_OAD_CRC_OSET - oset);
+    }
+
+    HalOADRead(oset, buf, cnt, type);
+    for (idx = 0; idx < cnt; idx++)
+    {
+      crc = runPoly(crc, buf[idx]);
+    }
+
+    oset += cnt;
   }
 
   return crc;
@@ -270,21 +311,12 @@ static uint16 runPoly(uint16 crc, uint8 val)
 uint8 HalOADChkDL(uint8 dlImagePreambleOffset)
 {
   preamble_t preamble;
-  uint32 oset;
-  uint16 crc = 0, crc2;
+  uint16 crc, crc2;
 
   HalOADRead(dlImagePreambleOffset, (uint8 *)&preamble, sizeof(preamble_t), HAL_OAD_DL);
 
   // Run the CRC calculation over the downloaded image.
-  for (oset = 0; oset < preamble.len; oset++)
-  {
-    if ((oset < HAL_OAD_CRC_OSET) || (oset >= HAL_OAD_CRC_OSET+4))
-    {
-      uint8 buf;
-      HalOADRead(oset, &buf, 1, HAL_OAD_DL);
-      crc = runPoly(crc, buf);
-    }
-  }
+  crc = crcImage(preamble.len, HAL_OAD_DL);
 
   // IAR note explains that poly must be run with value zero for each byte of crc.
   crc = runPoly(crc, 0);
@@ -247,6 +247,17 @@ mtProcessMsg_t mtProcessIncoming[] =
 byte debugThreshold;
 byte debugCompId;
 
+/**************************************************************************************************
+ * LOCAL VARIABLES
+ **************************************************************************************************/
+
+#if defined MT_AREQ_BATCH
+static uint8 *mtBatchBuf = NULL;  // Inner frames waiting for the container, NULL if batching is off
+static uint8 mtBatchMax;          // Maximum container data length
+static uint8 mtBatchLen;          // Bytes of inner frames held in mtBatchBuf
+static uint16 mtBatchDelay;       // Longest time in ms that a frame is held before the batch is sent
+#endif
+
 /**************************************************************************************************
  * LOCAL FUNCTIONS
  **************************************************************************************************/
@@ -256,6 +267,14 @@ void MT_ResetMsgQueue( void );
 byte MT_QueueMsg( byte *msg , byte len );
 void MT_ProcessQueue( void );
 
+#if !defined(NPI)
+static void MT_SendZToolFrame(uint8 cmdType, uint8 cmdId, uint8 dataLen, uint8 *pData);
+#if defined MT_AREQ_BATCH
+static uint8 *MT_AreqBatchReserve(uint8 cmdType, uint8 cmdId, uint8 dataLen);
+static void MT_AreqBatchCommit(uint8 *pData);
+#endif
+#endif /* NPI */
+
 #if defined ( MT_USER_TEST_FUNC )
 void MT_ProcessAppUserCmd( byte *pData );
 #endif
@@ -309,6 +328,33 @@ void MT_Init(uint8 taskID)
  ***************************************************************************************************/
 #if !defined(NPI)
 void MT_BuildAndSendZToolResponse(uint8 cmdType, uint8 cmdId, uint8 dataLen, uint8 *pData)
+{
+#if defined MT_AREQ_BATCH
+  uint8 *pBatch;
+
+  if ((pBatch = MT_AreqBatchReserve(cmdType, cmdId, dataLen)) != NULL)
+  {
+    (void)osal_memcpy(pBatch, pData, dataLen);
+    MT_AreqBatchCommit(pBatch);
+    return;
+  }
+#endif
+
+  MT_SendZToolFrame(cmdType, cmdId, dataLen, pData);
+}
+
+/***************************************************************************************************
+ * @fn      MT_SendZToolFrame
+ *
+ * @brief   Build and send a ZTOOL msg in its own transport frame
+ * @param   uint8 cmdType - include type and subsystem
+ *          uint8 cmdId - command ID
+ *          byte dataLen
+ *          byte *pData
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_SendZToolFrame(uint8 cmdType, uint8 cmdId, uint8 dataLen, uint8 *pData)
 {
   uint8 *msg_ptr;
 
@@ -331,6 +377,217 @@ void MT_BuildAndSendZToolResponse(uint8 cmdType, uint8 cmdId, uint8 dataLen, uin
   }
 #endif /* FEATURE_DUAL_MAC */
 }
+
+/***************************************************************************************************
+ * @fn      MT_ZToolRspAlloc
+ *
+ * @brief   Allocate a ZTOOL msg and fill in its header so that the caller can serialize the
+ *          payload straight into the outgoing buffer instead of into a temporary one that
+ *          MT_BuildAndSendZToolResponse() would then copy.
+ * @param   uint8 cmdType - include type and subsystem
+ *          uint8 cmdId - command ID
+ *          byte dataLen
+ *
+ * @return  Pointer to the dataLen bytes of payload to be filled in and passed to
+ *          MT_ZToolRspSend(), or NULL if no buffer could be allocated.
+ ***************************************************************************************************/
+uint8 *MT_ZToolRspAlloc(uint8 cmdType, uint8 cmdId, uint8 dataLen)
+{
+  uint8 *msg_ptr;
+
+#if defined MT_AREQ_BATCH
+  if ((msg_ptr = MT_AreqBatchReserve(cmdType, cmdId, dataLen)) != NULL)
+  {
+    return msg_ptr;
+  }
+#endif
+
+#ifdef FEATURE_DUAL_MAC
+  /* DMMGR builds its own frame, so stage the header and payload in a heap buffer */
+  msg_ptr = osal_mem_alloc(MT_RPC_FRAME_HDR_SZ + dataLen);
+#else
+  msg_ptr = MT_TransportAlloc((mtRpcCmdType_t)(cmdType & 0xE0), dataLen);
+#endif /* FEATURE_DUAL_MAC */
+
+  if (msg_ptr == NULL)
+  {
+    return NULL;
+  }
+
+  msg_ptr[MT_RPC_POS_LEN] = dataLen;
+  msg_ptr[MT_RPC_POS_CMD0] = cmdType;
+  msg_ptr[MT_RPC_POS_CMD1] = cmdId;
+
+  return (msg_ptr + MT_RPC_POS_DAT0);
+}
+
+/***************************************************************************************************
+ * @fn      MT_ZToolRspSend
+ *
+ * @brief   Send a ZTOOL msg that was allocated by MT_ZToolRspAlloc().
+ * @param   uint8 *pData - payload pointer returned by MT_ZToolRspAlloc()
+ *
+ * @return  void
+ ***************************************************************************************************/
+void MT_ZToolRspSend(uint8 *pData)
+{
+  uint8 *msg_ptr = pData - MT_RPC_POS_DAT0;
+
+#if defined MT_AREQ_BATCH
+  if ((mtBatchBuf != NULL) && (msg_ptr >= mtBatchBuf) && (msg_ptr < (mtBatchBuf + mtBatchMax)))
+  {
+    MT_AreqBatchCommit(pData);
+    return;
+  }
+#endif
+
+#ifdef FEATURE_DUAL_MAC
+  MT_SendZToolFrame(msg_ptr[MT_RPC_POS_CMD0], msg_ptr[MT_RPC_POS_CMD1],
+                    msg_ptr[MT_RPC_POS_LEN], pData);
+  osal_mem_free(msg_ptr);
+#else
+  MT_TransportSend(msg_ptr);
+#endif /* FEATURE_DUAL_MAC */
+}
+
+#if defined MT_AREQ_BATCH
+/***************************************************************************************************
+ * @fn      MT_AreqBatchCfg
+ *
+ * @brief   Configure batching of AREQ messages into MT_SYS_AREQ_BATCH_IND containers.
+ * @param   uint8 maxLen - maximum container data length, 0 to turn batching off
+ *          uint16 delay - longest time in ms that a message is held before its batch is sent,
+ *                         0 to send each batch on the next pass of the MT task
+ *
+ * @return  ZSuccess, ZInvalidParameter or ZMemError
+ ***************************************************************************************************/
+uint8 MT_AreqBatchCfg(uint8 maxLen, uint16 delay)
+{
+  uint8 status = ZSuccess;
+
+  MT_AreqBatchFlush();
+
+  if (mtBatchBuf != NULL)
+  {
+    osal_mem_free(mtBatchBuf);
+    mtBatchBuf = NULL;
+  }
+
+  if (maxLen > MT_RPC_DATA_MAX)
+  {
+    maxLen = MT_RPC_DATA_MAX;
+  }
+
+  if (maxLen > MT_RPC_FRAME_HDR_SZ)
+  {
+    if ((mtBatchBuf = osal_mem_alloc(maxLen)) != NULL)
+    {
+      mtBatchMax = maxLen;
+      mtBatchDelay = delay;
+    }
+    else
+    {
+      status = ZMemError;
+    }
+  }
+  else if (maxLen != 0)
+  {
+    status = ZInvalidParameter;
+  }
+
+  return status;
+}
+
+/***************************************************************************************************
+ * @fn      MT_AreqBatchFlush
+ *
+ * @brief   Send the AREQ messages waiting in the batch, if any, in one container.
+ *
+ * @return  void
+ ***************************************************************************************************/
+void MT_AreqBatchFlush(void)
+{
+  if (mtBatchLen != 0)
+  {
+    uint8 len = mtBatchLen;
+
+    mtBatchLen = 0;
+    (void)osal_stop_timerEx(MT_TaskID, MT_AREQ_BATCH_EVT);
+
+    MT_SendZToolFrame(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_SYS), MT_SYS_AREQ_BATCH_IND,
+                      len, mtBatchBuf);
+  }
+}
+
+/***************************************************************************************************
+ * @fn      MT_AreqBatchReserve
+ *
+ * @brief   Reserve room for a message in the batch. Anything that cannot be batched first sends
+ *          the messages already waiting so that the host sees them in order.
+ * @param   uint8 cmdType - include type and subsystem
+ *          uint8 cmdId - command ID
+ *          byte dataLen
+ *
+ * @return  Pointer to the dataLen bytes of payload to be filled in and passed to
+ *          MT_AreqBatchCommit(), or NULL if the message is to be sent in its own frame.
+ ***************************************************************************************************/
+static uint8 *MT_AreqBatchReserve(uint8 cmdType, uint8 cmdId, uint8 dataLen)
+{
+  uint8 *pBuf = NULL;
+
+  if (mtBatchBuf != NULL)
+  {
+    if (((cmdType & MT_RPC_CMD_TYPE_MASK) != MT_RPC_CMD_AREQ) ||
+        (((uint16)MT_RPC_FRAME_HDR_SZ + dataLen) > mtBatchMax))
+    {
+      MT_AreqBatchFlush();
+    }
+    else
+    {
+      if (((uint16)mtBatchLen + MT_RPC_FRAME_HDR_SZ + dataLen) > mtBatchMax)
+      {
+        MT_AreqBatchFlush();
+      }
+
+      pBuf = mtBatchBuf + mtBatchLen;
+      pBuf[MT_RPC_POS_LEN] = dataLen;
+      pBuf[MT_RPC_POS_CMD0] = cmdType;
+      pBuf[MT_RPC_POS_CMD1] = cmdId;
+      pBuf += MT_RPC_POS_DAT0;
+    }
+  }
+
+  return pBuf;
+}
+
+/***************************************************************************************************
+ * @fn      MT_AreqBatchCommit
+ *
+ * @brief   Add a message reserved by MT_AreqBatchReserve() to the batch.
+ * @param   uint8 *pData - payload pointer returned by MT_AreqBatchReserve()
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_AreqBatchCommit(uint8 *pData)
+{
+  if (mtBatchLen == 0)
+  {
+    if ((mtBatchDelay == 0) ||
+        (ZSuccess != osal_start_timerEx(MT_TaskID, MT_AREQ_BATCH_EVT, mtBatchDelay)))
+    {
+      (void)osal_set_event(MT_TaskID, MT_AREQ_BATCH_EVT);
+    }
+  }
+
+  mtBatchLen += MT_RPC_FRAME_HDR_SZ + pData[MT_RPC_POS_LEN - MT_RPC_POS_DAT0];
+
+  /* Send now if not even an empty message would fit */
+  if ((mtBatchLen + MT_RPC_FRAME_HDR_SZ) > mtBatchMax)
+  {
+    MT_AreqBatchFlush();
+  }
+}
+#endif /* MT_AREQ_BATCH */
 #endif /* NPI */
 /***************************************************************************************************
  * @fn      MT_ProcessIncoming
@@ -103,6 +103,8 @@ extern "C"
 #define MT_SYS_ZDIAGS_SAVE_STATS_TO_NV       0x1B
 #define MT_SYS_OSAL_NV_READ_EXT              0x1C
 #define MT_SYS_OSAL_NV_WRITE_EXT             0x1D
+#define MT_SYS_ZDIAGS_GET_ALL_STATS          0x1E
+#define MT_SYS_SET_AREQ_BATCH                0x1F
 
 /* Extended Non-Vloatile Memory */
 #define MT_SYS_NV_CREATE                     0x30
@@ -118,6 +120,15 @@ extern "C"
 #define MT_SYS_OSAL_TIMER_EXPIRED            0x81
 #define MT_SYS_JAMMER_IND                    0x82
 
+/* AREQ batch container (MT_AREQ_BATCH), sent as an ordinary AREQ frame:
+ *   SOF | LEN | MT_RPC_CMD_AREQ|MT_RPC_SYS_SYS | MT_SYS_AREQ_BATCH_IND | Frames | FCS
+ * Frames is one or more inner frames back to back, each in the general frame format
+ * without SOF and FCS:  LEN | CMD0 | CMD1 | Data[LEN]
+ * Inner frames are in the order that they were generated, and a batch is always sent
+ * before any frame that is not batched, so the host sees the same order as without batching.
+ */
+#define MT_SYS_AREQ_BATCH_IND                0x83
+
 
 #define MT_SYS_RESET_HARD     0
 #define MT_SYS_RESET_SOFT     1
@@ -457,6 +468,7 @@ extern "C"
 /* SREQ/SRSP: */
 #define MT_DEBUG_SET_THRESHOLD               0x00
 #define MT_DEBUG_MAC_DATA_DUMP               0x10
+#define MT_DEBUG_HEAP_TRACE                  0x11
  
 //TP2 commands  
 #define MT_DEBUG_TP2_ENABLEAPSSECURITY       0x01
@@ -577,6 +589,7 @@ extern "C"
 #define MT_PERIODIC_MSG_EVENT           0x0020
 #define MT_MSG_SEQUENCE_EVT             0x0040
 #define MT_KEYPRESS_POLL_EVT            0x0080
+#define MT_AREQ_BATCH_EVT               MT_MSG_SEQUENCE_EVT
 
 /* SYS_OSAL_EVENT ID's */
 #define MT_SYS_OSAL_EVENT_0             0x0800
@@ -884,6 +897,30 @@ extern MT_msg_queue_t *_pCurQueueElem;
  */
 extern void MT_BuildAndSendZToolResponse(uint8 cmdType, uint8 cmdId, uint8 dataLen, uint8 *dataPtr);
 
+/*
+ * Allocate a ZTool response message and return its payload area to serialize into
+ */
+extern uint8 *MT_ZToolRspAlloc(uint8 cmdType, uint8 cmdId, uint8 dataLen);
+
+/*
+ * Send a ZTool response message allocated by MT_ZToolRspAlloc()
+ */
+extern void MT_ZToolRspSend(uint8 *pData);
+
+#if defined MT_AREQ_BATCH
+/*
+ * Configure batching of AREQ messages to the host
+ */
+extern uint8 MT_AreqBatchCfg(uint8 maxLen, uint16 delay);
+
+/*
+ * Send any AREQ messages waiting in the batch
+ */
+extern void MT_AreqBatchFlush(void);
+#else
+#define MT_AreqBatchFlush()
+#endif
+
 /*
  * Temp test function
  */
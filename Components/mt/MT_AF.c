@@ -696,8 +696,9 @@ void MT_AfIncomingMsg(afIncomingMSGPacket_t *pMsg)
     respLen -= dataLen;  // Zero data bytes are sent with an over-sized incoming indication.
   }
 
-  // Attempt to allocate memory for the response packet.
-  if ((pRsp = osal_mem_alloc(respLen)) == NULL)
+  // Attempt to allocate the response packet and serialize straight into it.
+  if ((pRsp = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ|(uint8)MT_RPC_SYS_AF), cmd,
+                               (uint8)respLen)) == NULL)
   {
     if (pItem != NULL)
     {
@@ -812,10 +813,8 @@ void MT_AfIncomingMsg(afIncomingMSGPacket_t *pMsg)
   // messages result radius
   *pTmp = pMsg->radius;
 
-  /* Build and send back the response */
-  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ|(uint8)MT_RPC_SYS_AF), cmd, respLen, pRsp);
-
-  (void)osal_mem_free(pRsp);
+  /* Send back the response */
+  MT_ZToolRspSend(pRsp);
 }
 
 /**************************************************************************************************
@@ -83,7 +83,18 @@ static void MT_DebugSetThreshold(uint8 *pBuf);
 
 
 static void MT_DebugMacDataDump(void);
+#if ( OSALMEM_TRACE )
+static void MT_DebugHeapTrace(void);
 #endif
+#endif
+
+/* Max number of heap trace records returned by one MT_DEBUG_HEAP_TRACE response */
+#if !defined MT_DEBUG_HEAP_TRACE_MAX
+#define MT_DEBUG_HEAP_TRACE_MAX  6
+#endif
+
+/* Size of one heap trace record in the MT_DEBUG_HEAP_TRACE response */
+#define MT_DEBUG_HEAP_TRACE_LEN  10
 
 
 #if defined (MT_DEBUG_FUNC)
@@ -122,6 +133,12 @@ uint8 MT_DebugCommandProcessing(uint8 *pBuf)
       MT_DebugMacDataDump();
       break;
 
+#if ( OSALMEM_TRACE )
+    case MT_DEBUG_HEAP_TRACE:
+      MT_DebugHeapTrace();
+      break;
+#endif
+
     default:
       status = MT_RPC_ERR_COMMAND_ID;
       break;
@@ -258,6 +275,59 @@ static void MT_DebugMacDataDump(void)
   MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
                                        MT_DEBUG_MAC_DATA_DUMP, sizeof(buf), buf);
 }
+
+#if ( OSALMEM_TRACE )
+/***************************************************************************************************
+ * @fn      MT_DebugHeapTrace
+ *
+ * @brief   Process the debug Heap Trace request. The response carries the number of records
+ *          dropped since boot, the number of records and the oldest records of the OSAL
+ *          allocation trace, each as time, size, file, line and id in little endian. The
+ *          trace is held while the response is built and sent, so the response buffer is not
+ *          recorded.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void MT_DebugHeapTrace(void)
+{
+  osalMemTrace_t rec[MT_DEBUG_HEAP_TRACE_MAX];
+  uint8 buf[3 + (MT_DEBUG_HEAP_TRACE_MAX * MT_DEBUG_HEAP_TRACE_LEN)];
+  uint8 *pBuf = buf;
+  uint16 lost;
+  uint8 cnt;
+  uint8 idx;
+
+  osal_mem_trace_hold(TRUE);
+
+  lost = osal_mem_trace_lost();
+  cnt = osal_mem_trace_read(rec, MT_DEBUG_HEAP_TRACE_MAX);
+
+  *pBuf++ = LO_UINT16(lost);
+  *pBuf++ = HI_UINT16(lost);
+  *pBuf++ = cnt;
+
+  for (idx = 0; idx < cnt; idx++)
+  {
+    *pBuf++ = LO_UINT16(rec[idx].time);
+    *pBuf++ = HI_UINT16(rec[idx].time);
+    *pBuf++ = LO_UINT16(rec[idx].size);
+    *pBuf++ = HI_UINT16(rec[idx].size);
+    *pBuf++ = LO_UINT16(rec[idx].file);
+    *pBuf++ = HI_UINT16(rec[idx].file);
+    *pBuf++ = LO_UINT16(rec[idx].line);
+    *pBuf++ = HI_UINT16(rec[idx].line);
+    *pBuf++ = LO_UINT16(rec[idx].id);
+    *pBuf++ = HI_UINT16(rec[idx].id);
+  }
+
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG),
+                               MT_DEBUG_HEAP_TRACE, (uint8)(pBuf - buf), buf);
+
+  osal_mem_trace_hold(FALSE);
+}
+#endif
 #endif
 
 /***************************************************************************************************
@@ -175,6 +175,7 @@ uint8 MT_OtaFileReadReq(afAddrType_t *pAddr, zclOTA_FileID_t *pFileId, uint8 len
     *p = len;
     
     // Send command to server
+    MT_AreqBatchFlush();
     MT_TransportSend(pBuf);
     
     return ZSuccess;
@@ -232,6 +233,7 @@ uint8 MT_OtaGetImage(afAddrType_t *pAddr, zclOTA_FileID_t *pFileId, uint16 hwVer
       osal_memcpy(p, ieee, Z_EXTADDR_LEN);
   
     // Send command to server
+    MT_AreqBatchFlush();
     MT_TransportSend(pBuf);
     
     return ZSuccess;
@@ -281,6 +283,7 @@ uint8 MT_OtaSendStatus(uint16 shortAddr, uint8 type, uint8 status, uint8 optiona
     *p = optional;
   
     // Send command to server
+    MT_AreqBatchFlush();
     MT_TransportSend(pBuf);
     
     return ZSuccess;
@@ -67,6 +67,12 @@
 #if defined( FEATURE_SYSTEM_STATS )
 #include "ZDiags.h"
 #endif
+#if MT_SYS_KEY_MANAGEMENT
+  #include "ZDSecMgr.h"
+#endif
+#if (defined OTA_SERVER) && (OTA_SERVER == TRUE)
+  #include "zcl_ota.h"
+#endif
 #if defined( MT_SYS_JAMMER_FEATURE )
   #include "mac_rx.h"
   #include "mac_radio_defs.h"
@@ -218,6 +224,9 @@ static void MT_SysStackTune(uint8 *pBuf);
 static void MT_SysSetUtcTime(uint8 *pBuf);
 static void MT_SysGetUtcTime(void);
 static void MT_SysSetTxPower(uint8 *pBuf);
+#if defined( MT_AREQ_BATCH )
+static void MT_SysSetAreqBatch(uint8 *pBuf);
+#endif /* MT_AREQ_BATCH */
 #if !defined( CC26XX )
 static void MT_SysAdcRead(uint8 *pBuf);
 #endif /* !CC26xx */
@@ -249,6 +258,7 @@ static void MT_SysSnifferParameters( uint8 *pBuf );
 static void MT_SysZDiagsInitStats(void);
 static void MT_SysZDiagsClearStats(uint8 *pBuf);
 static void MT_SysZDiagsGetStatsAttr(uint8 *pBuf);
+static void MT_SysZDiagsGetAllStats(void);
 static void MT_SysZDiagsRestoreStatsFromNV(void);
 static void MT_SysZDiagsSaveStatsToNV(void);
 #endif /* FEATURE_SYSTEM_STATS */
@@ -334,6 +344,12 @@ uint8 MT_SysCommandProcessing(uint8 *pBuf)
       MT_SysSetTxPower(pBuf);
       break;
 
+#if defined( MT_AREQ_BATCH )
+    case MT_SYS_SET_AREQ_BATCH:
+      MT_SysSetAreqBatch(pBuf);
+      break;
+#endif /* MT_AREQ_BATCH */
+
 // CC253X MAC Network Processor does not have NV support
 #if !defined( CC253X_MACNP )
     case MT_SYS_OSAL_NV_DELETE:
@@ -413,6 +429,10 @@ uint8 MT_SysCommandProcessing(uint8 *pBuf)
       MT_SysZDiagsGetStatsAttr(pBuf);
        break;
 
+    case MT_SYS_ZDIAGS_GET_ALL_STATS:
+      MT_SysZDiagsGetAllStats();
+      break;
+
     case MT_SYS_ZDIAGS_RESTORE_STATS_NV:
       MT_SysZDiagsRestoreStatsFromNV();
       break;
@@ -836,6 +856,20 @@ static void MT_SysOsalNVWrite(uint8 *pBuf)
       {
         rtrn = ZMacSetReq(ZMacExtAddr, pBuf);
       }
+#if (defined OTA_SERVER) && (OTA_SERVER == TRUE)
+      else if (nvId == ZCD_NV_OTA_BLOCK_REQ_DELAY)
+      {
+        /* The OTA server keeps the block request delay in RAM */
+        (void)osal_nv_read(nvId, 0, sizeof(zclOTA_MinBlockReqDelay), &zclOTA_MinBlockReqDelay);
+      }
+#endif
+#if MT_SYS_KEY_MANAGEMENT
+      else
+      {
+        /* The Security Manager keeps the state of APS link keys */
+        ZDSecMgrLinkKeyStateClear( nvId );
+      }
+#endif
     }
     else
     {
@@ -949,6 +983,13 @@ static void MT_SysOsalNVDelete(uint8 *pBuf)
   {
     /* Attempt to delete the NV item */
     ret = osal_nv_delete( nvId, nvLen );
+#if MT_SYS_KEY_MANAGEMENT
+    if ( ret == SUCCESS )
+    {
+      /* The Security Manager keeps the state of APS link keys */
+      ZDSecMgrLinkKeyStateClear( nvId );
+    }
+#endif
   }
 
   /* Build and send back the response */
@@ -1758,6 +1799,30 @@ static void MT_SysSetTxPower(uint8 *pBuf)
                                 &signed_dBm_of_TxPower_range_corrected);
 }
 
+#if defined( MT_AREQ_BATCH )
+/******************************************************************************
+ * @fn      MT_SysSetAreqBatch
+ *
+ * @brief   Turn batching of AREQ messages into MT_SYS_AREQ_BATCH_IND containers
+ *          on or off. A host that does not send this never sees a container.
+ *
+ * @param   pBuf - MT message containing the maximum container data length
+ *                 (0 turns batching off) and the 2-byte maximum delay in ms.
+ *
+ * @return  None
+ *****************************************************************************/
+static void MT_SysSetAreqBatch(uint8 *pBuf)
+{
+  uint8 retValue;
+
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+
+  retValue = MT_AreqBatchCfg(pBuf[0], osal_build_uint16(&pBuf[1]));
+
+  MT_BuildAndSendZToolResponse(MT_SRSP_SYS, MT_SYS_SET_AREQ_BATCH, 1, &retValue);
+}
+#endif /* MT_AREQ_BATCH */
+
 #if defined ( FEATURE_SYSTEM_STATS )
 /******************************************************************************
  * @fn      MT_SysZDiagsInitStats
@@ -1837,6 +1902,28 @@ static void MT_SysZDiagsGetStatsAttr(uint8 *pBuf)
                                 sizeof(retBuf), retBuf);
 }
 
+/******************************************************************************
+ * @fn      MT_SysZDiagsGetAllStats
+ *
+ * @brief   Reads all the statistics and metrics in one response, in
+ *          attribute ID order.
+ *
+ * @param   None
+ *
+ * @return  None
+ *****************************************************************************/
+static void MT_SysZDiagsGetAllStats(void)
+{
+  uint8 retBuf[ZDIAGS_SNAPSHOT_LEN];
+  uint8 len;
+
+  len = ZDiagsGetStatsSnapshot( retBuf );
+
+  /* Build and send back the response */
+  MT_BuildAndSendZToolResponse( MT_SRSP_SYS, MT_SYS_ZDIAGS_GET_ALL_STATS,
+                                len, retBuf);
+}
+
 /******************************************************************************
  * @fn      MT_SysZDiagsRestoreStatsFromNV
  *
@@ -147,6 +147,14 @@ UINT16 MT_ProcessEvent(uint8 task_id, uint16 events)
   }
 #endif  /* NONWK */
 
+#if defined MT_AREQ_BATCH
+  if ( events & MT_AREQ_BATCH_EVT )
+  {
+    MT_AreqBatchFlush();
+    return (events ^ MT_AREQ_BATCH_EVT);
+  }
+#endif
+
   /* Handle MT_SYS_OSAL_START_TIMER callbacks */
 #if defined MT_SYS_FUNC
   if ( events & (MT_SYS_OSAL_EVENT_MASK))
@@ -63,6 +63,11 @@
 #define DATA_STATE     0x04
 #define FCS_STATE      0x05
 
+/* Number of bytes taken from the UART Rx buffer at a time */
+#if !defined ( MT_UART_RX_CHUNK )
+  #define MT_UART_RX_CHUNK  32
+#endif
+
 /***************************************************************************************************
  *                                         GLOBAL VARIABLES
  ***************************************************************************************************/
@@ -76,6 +81,9 @@ uint8  LEN_Token;
 uint8  FSC_Token;
 mtOSALSerialData_t  *pMsg;
 uint8  tempDataLen;
+uint8  FCS_Calc;      /* FCS of the frame so far, updated as bytes arrive */
+
+static uint8 mtUartRxBuf[MT_UART_RX_CHUNK];
 
 #if defined (ZAPP_P1) || defined (ZAPP_P2)
 uint16  MT_UartMaxZAppBufLen;
@@ -86,6 +94,7 @@ bool    MT_UartZAppRxStatus;
 /***************************************************************************************************
  *                                          LOCAL FUNCTIONS
  ***************************************************************************************************/
+static void MT_UartParseZTool( uint8 *pBuf, uint16 len );
 
 /***************************************************************************************************
  * @fn      MT_UartInit
@@ -194,14 +203,68 @@ byte MT_UartCalcFCS( uint8 *msg_ptr, uint8 len )
  ***************************************************************************************************/
 void MT_UartProcessZToolData ( uint8 port, uint8 event )
 {
-  uint8  ch;
-  uint8  bytesInRxBuffer;
-  
+  uint16 len;
+
   (void)event;  // Intentionally unreferenced parameter
 
-  while (Hal_UART_RxBufLen(port))
+  while ((len = Hal_UART_RxBufLen(port)) != 0)
+  {
+    if (state == DATA_STATE)
+    {
+      /* Read the rest of the data straight into the message */
+      uint8 *pData = &pMsg->msg[MT_RPC_FRAME_HDR_SZ + tempDataLen];
+
+      if (len > (uint16)(LEN_Token - tempDataLen))
+      {
+        len = LEN_Token - tempDataLen;
+      }
+      len = HalUARTRead (port, pData, len);
+      tempDataLen += (uint8)len;
+
+      while (len--)
+      {
+        FCS_Calc ^= *pData++;
+      }
+
+      if (tempDataLen == LEN_Token)
+      {
+        state = FCS_STATE;
+      }
+    }
+    else
+    {
+      if (len > MT_UART_RX_CHUNK)
+      {
+        len = MT_UART_RX_CHUNK;
+      }
+      len = HalUARTRead (port, mtUartRxBuf, len);
+      MT_UartParseZTool (mtUartRxBuf, len);
+    }
+  }
+}
+
+/***************************************************************************************************
+ * @fn      MT_UartParseZTool
+ *
+ * @brief   Run the ZTool frame state machine over a span of received bytes. The FCS is
+ *          computed as the frame is received. A frame with a bad FCS may have started on a
+ *          stray SOF and swallowed the start of the next frame, so its bytes are parsed
+ *          again from the next SOF found inside it.
+ *
+ * @param   pBuf - received bytes
+ *          len  - number of bytes
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void MT_UartParseZTool( uint8 *pBuf, uint16 len )
+{
+  uint8 *pReplay = NULL;
+  uint8 ch;
+
+  while (len != 0)
   {
-    HalUARTRead (port, &ch, 1);
+    ch = *pBuf++;
+    len--;
 
     switch (state)
     {
@@ -212,6 +275,7 @@ void MT_UartProcessZToolData ( uint8 port, uint8 event )
 
       case LEN_STATE:
         LEN_Token = ch;
+        FCS_Calc = ch;
 
         tempDataLen = 0;
 
@@ -230,17 +294,18 @@ void MT_UartProcessZToolData ( uint8 port, uint8 event )
         else
         {
           state = SOP_STATE;
-          return;
         }
         break;
 
       case CMD_STATE1:
         pMsg->msg[MT_RPC_POS_CMD0] = ch;
+        FCS_Calc ^= ch;
         state = CMD_STATE2;
         break;
 
       case CMD_STATE2:
         pMsg->msg[MT_RPC_POS_CMD1] = ch;
+        FCS_Calc ^= ch;
         /* If there is no data, skip to FCS state */
         if (LEN_Token)
         {
@@ -253,55 +318,99 @@ void MT_UartProcessZToolData ( uint8 port, uint8 event )
         break;
 
       case DATA_STATE:
-
-        /* Fill in the buffer the first byte of the data */
-        pMsg->msg[MT_RPC_FRAME_HDR_SZ + tempDataLen++] = ch;
-
-        /* Check number of bytes left in the Rx buffer */
-        bytesInRxBuffer = Hal_UART_RxBufLen(port);
-
-        /* If the remain of the data is there, read them all, otherwise, just read enough */
-        if (bytesInRxBuffer <= LEN_Token - tempDataLen)
-        {
-          HalUARTRead (port, &pMsg->msg[MT_RPC_FRAME_HDR_SZ + tempDataLen], bytesInRxBuffer);
-          tempDataLen += bytesInRxBuffer;
-        }
-        else
         {
-          HalUARTRead (port, &pMsg->msg[MT_RPC_FRAME_HDR_SZ + tempDataLen], LEN_Token - tempDataLen);
-          tempDataLen += (LEN_Token - tempDataLen);
-        }
-
-        /* If number of bytes read is equal to data length, time to move on to FCS */
-        if ( tempDataLen == LEN_Token )
+          /* Take as much of the data as this span holds */
+          uint8 *pData = &pMsg->msg[MT_RPC_FRAME_HDR_SZ + tempDataLen];
+          uint16 cnt = LEN_Token - tempDataLen - 1;
+
+          if (cnt > len)
+          {
+            cnt = len;
+          }
+          len -= cnt;
+          tempDataLen += (uint8)(cnt + 1);
+
+          *pData++ = ch;
+          FCS_Calc ^= ch;
+          while (cnt--)
+          {
+            ch = *pBuf++;
+            *pData++ = ch;
+            FCS_Calc ^= ch;
+          }
+
+          /* If number of bytes read is equal to data length, time to move on to FCS */
+          if ( tempDataLen == LEN_Token )
             state = FCS_STATE;
-
+        }
         break;
 
       case FCS_STATE:
 
         FSC_Token = ch;
 
+        /* Reset the state, send or discard the buffers at this point */
+        state = SOP_STATE;
+
         /* Make sure it's correct */
-        if ((MT_UartCalcFCS ((uint8*)&pMsg->msg[0], MT_RPC_FRAME_HDR_SZ + LEN_Token) == FSC_Token))
+        if (FCS_Calc == FSC_Token)
         {
           osal_msg_send( App_TaskID, (byte *)pMsg );
         }
         else
         {
+          uint16 frameLen = MT_RPC_FRAME_HDR_SZ + LEN_Token;
+          uint16 k;
+
+          for (k = 0; k < frameLen; k++)
+          {
+            if (pMsg->msg[k] == MT_UART_SOF)
+            {
+              break;
+            }
+          }
+
+          if (k < frameLen)
+          {
+            /* Parse the bytes after the SOF again, ahead of the rest of this span */
+            uint16 tail = frameLen - k - 1;
+            uint8 *pNew = osal_mem_alloc( tail + 1 + len );
+
+            if (pNew)
+            {
+              osal_memcpy( pNew, &pMsg->msg[k+1], tail );
+              pNew[tail] = ch;
+              osal_memcpy( &pNew[tail+1], pBuf, len );
+
+              if (pReplay)
+              {
+                osal_mem_free( pReplay );
+              }
+              pReplay = pNew;
+              pBuf = pNew;
+              len += tail + 1;
+              state = LEN_STATE;
+            }
+          }
+          else if (ch == MT_UART_SOF)
+          {
+            state = LEN_STATE;
+          }
+
           /* deallocate the msg */
           osal_msg_deallocate ( (uint8 *)pMsg );
         }
-
-        /* Reset the state, send or discard the buffers at this point */
-        state = SOP_STATE;
-
         break;
 
       default:
        break;
     }
   }
+
+  if (pReplay)
+  {
+    osal_mem_free( pReplay );
+  }
 }
 
 #if defined (ZAPP_P1) || defined (ZAPP_P2)
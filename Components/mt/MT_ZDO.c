@@ -2190,8 +2190,14 @@ static void MT_ZdoSetRejoinParameters(uint8 *pBuf)
  */
 void MT_ZdoStateChangeCB(osal_event_hdr_t *pMsg)
 {
-  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
-                                       MT_ZDO_STATE_CHANGE_IND, 1, &pMsg->status);
+  uint8 *pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                 MT_ZDO_STATE_CHANGE_IND, 1);
+
+  if (pBuf != NULL)
+  {
+    pBuf[0] = pMsg->status;
+    MT_ZToolRspSend(pBuf);
+  }
 }
 
 /***************************************************************************************************
@@ -2223,18 +2229,16 @@ void MT_ZdoDirectCB( afIncomingMSGPacket_t *pData, zdoIncomingMsg_t *inMsg )
    */
   len = pData->cmd.DataLength - 1 + sizeof(uint16);
 
-  if (NULL != (pBuf = (uint8 *)osal_mem_alloc(len)))
+  if (NULL != (pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                       MT_ZDO_CID_TO_AREQ_ID(pData->clusterId), len)))
   {
-    uint8 id = MT_ZDO_CID_TO_AREQ_ID(pData->clusterId);
-
     pBuf[0] = LO_UINT16(pData->srcAddr.addr.shortAddr);
     pBuf[1] = HI_UINT16(pData->srcAddr.addr.shortAddr);
 
     /* copy ZDO data, skipping one-byte sequence number */
     osal_memcpy(pBuf+2, (pData->cmd.Data + 1), pData->cmd.DataLength-1);
 
-    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO), id, len, pBuf);
-    osal_mem_free(pBuf);
+    MT_ZToolRspSend(pBuf);
   }
 }
 
@@ -2321,9 +2325,9 @@ void MT_ZdoAddrRspCB( ZDO_NwkIEEEAddrResp_t *pMsg, uint16 clusterID )
   len = MT_ZDO_ADDR_RSP_LEN + (listLen * sizeof(uint16));
 
   /* get buffer */
-  if (NULL != (pBuf = (uint8 *)osal_mem_alloc(len)))
+  if (NULL != (pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                       MT_ZDO_CID_TO_AREQ_ID(clusterID), len)))
   {
-    uint8 id = MT_ZDO_CID_TO_AREQ_ID(clusterID);
     uint8 *pTmp = pBuf;
 
     *pTmp++ = pMsg->status;
@@ -2339,8 +2343,7 @@ void MT_ZdoAddrRspCB( ZDO_NwkIEEEAddrResp_t *pMsg, uint16 clusterID )
 
     MT_Word2Buf(pTmp, pMsg->devList, listLen);
 
-    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO), id, len, pBuf);
-    osal_mem_free(pBuf);
+    MT_ZToolRspSend(pBuf);
   }
 }
 
@@ -2357,7 +2360,9 @@ void MT_ZdoEndDevAnnceCB( ZDO_DeviceAnnce_t *pMsg, uint16 srcAddr )
 {
   uint8 *pBuf;
 
-  if (NULL != (pBuf = (uint8 *)osal_mem_alloc(MT_ZDO_END_DEVICE_ANNCE_IND_LEN)))
+  if (NULL != (pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                       MT_ZDO_END_DEVICE_ANNCE_IND,
+                                       MT_ZDO_END_DEVICE_ANNCE_IND_LEN)))
   {
     uint8 *pTmp = pBuf;
 
@@ -2372,10 +2377,7 @@ void MT_ZdoEndDevAnnceCB( ZDO_DeviceAnnce_t *pMsg, uint16 srcAddr )
 
     *pTmp = pMsg->capabilities;
 
-    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
-                                         MT_ZDO_END_DEVICE_ANNCE_IND,
-                                         MT_ZDO_END_DEVICE_ANNCE_IND_LEN, pBuf);
-    osal_mem_free(pBuf);
+    MT_ZToolRspSend(pBuf);
   }
 }
 
@@ -2396,7 +2398,8 @@ void* MT_ZdoSrcRtgCB( void *pStr )
   // srcAddr (2) + relayCnt (1) + relayList( relaycnt * 2 )
   len = 2 + 1 + pSrcRtg->relayCnt * sizeof(uint16);
 
-  if (NULL != (pBuf = (uint8 *)osal_mem_alloc(len)))
+  if (NULL != (pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                       MT_ZDO_SRC_RTG_IND, len)))
   {
     uint8 idx, *pTmp = pBuf;
     uint16 *pRelay;
@@ -2416,9 +2419,7 @@ void* MT_ZdoSrcRtgCB( void *pStr )
         pRelay++;
       }
     }
-    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
-                                         MT_ZDO_SRC_RTG_IND, len, pBuf);
-    osal_mem_free(pBuf);
+    MT_ZToolRspSend(pBuf);
   }
 
   return NULL;
@@ -2539,7 +2540,8 @@ void *MT_ZdoPermitJoinInd( void *duration )
 void MT_ZdoSendMsgCB(zdoIncomingMsg_t *pMsg)
 {
   uint8 len = pMsg->asduLen + 9;
-  uint8 *pBuf = (uint8 *)osal_mem_alloc(len);
+  uint8 *pBuf = MT_ZToolRspAlloc(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
+                                 MT_ZDO_MSG_CB_INCOMING, len);
 
   if (pBuf != NULL)
   {
@@ -2558,10 +2560,7 @@ void MT_ZdoSendMsgCB(zdoIncomingMsg_t *pMsg)
     *pTmp++ = HI_UINT16(pMsg->macDestAddr);
     (void)osal_memcpy(pTmp, pMsg->asdu, pMsg->asduLen);
 
-    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_ZDO),
-                                         MT_ZDO_MSG_CB_INCOMING, len, pBuf);
-
-    osal_mem_free(pBuf);
+    MT_ZToolRspSend(pBuf);
   }
 }
 
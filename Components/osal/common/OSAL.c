@@ -47,6 +47,7 @@
 
 #include "comdef.h"
 #include "hal_board.h"
+#include "hal_assert.h"
 #include "OSAL.h"
 #include "OSAL_Tasks.h"
 #include "OSAL_Memory.h"
@@ -83,13 +84,18 @@
  * TYPEDEFS
  */
 
+// Message queue of one task
+typedef struct
+{
+  void *head;    // Next message to be received
+  void *tail;    // Last message, where normal priority messages are appended
+  void *hiTail;  // Last high priority or front message, or NULL if none is queued
+} osalTaskQ_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
 
-// Message Pool Definitions
-osal_msg_q_t osal_qHead;
-
 #ifdef USE_ICALL
 // OSAL event loop hook function pointer 
 void (*osal_eventloop_hook)(void) = NULL;
@@ -110,6 +116,9 @@ void (*osal_eventloop_hook)(void) = NULL;
 // Index of active task
 static uint8 activeTaskID = TASK_NO_TASK;
 
+// Message queues, one per task
+static osalTaskQ_t *osalTaskQ;
+
 #ifdef USE_ICALL
 // Maximum number of proxy tasks
 #ifndef OSAL_MAX_NUM_PROXY_TASKS
@@ -154,7 +163,7 @@ static uint8 osal_notask_entity;
  * LOCAL FUNCTION PROTOTYPES
  */
 
-static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 urgent );
+static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 pos );
 
 #ifdef USE_ICALL
 static uint8 osal_alien2proxy(ICall_EntityID entity);
@@ -685,7 +694,41 @@ osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
  */
 uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
 {
-  return ( osal_msg_enqueue_push( destination_task, msg_ptr, TRUE ) );
+  return ( osal_msg_enqueue_push( destination_task, msg_ptr, OSAL_MSG_PRI_FRONT ) );
+}
+
+/*********************************************************************
+ * @fn      osal_msg_send_pri
+ *
+ * @brief
+ *
+ *    This function is called by a task to send a command message to
+ *    another task with a priority. A high priority message is queued
+ *    behind the high priority and pushed to front messages already
+ *    waiting for the task, but ahead of all its normal priority messages. This function will
+ *    also set a message ready event in the destination task's event list.
+ *
+ * @param   uint8 destination_task - Send msg to Task ID
+ * @param   uint8 *msg_ptr - pointer to new message buffer
+ * @param   uint8 pri - OSAL_MSG_PRI_NORMAL or OSAL_MSG_PRI_HIGH
+ *
+ * @return  SUCCESS, INVALID_TASK, INVALID_MSG_POINTER
+ */
+uint8 osal_msg_send_pri( uint8 destination_task, uint8 *msg_ptr, uint8 pri )
+{
+#ifdef USE_ICALL
+  if (destination_task & OSAL_PROXY_ID_FLAG)
+  {
+    pri = OSAL_MSG_PRI_NORMAL;
+  }
+#endif /* USE_ICALL */
+
+  if ( pri != OSAL_MSG_PRI_HIGH )
+  {
+    return ( osal_msg_send( destination_task, msg_ptr ) );
+  }
+
+  return ( osal_msg_enqueue_push( destination_task, msg_ptr, OSAL_MSG_PRI_HIGH ) );
 }
 
 /*********************************************************************
@@ -694,20 +737,24 @@ uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr )
  * @brief
  *
  *    This function is called by a task to either enqueue (append to
- *    queue) or push (prepend to queue) a command message to the OSAL
- *    queue. The destination_task field must refer to a valid task,
- *    since the task ID will be used to send the message to. This 
- *    function will also set a message ready event in the destination
- *    task's event list.
+ *    queue), enqueue behind the high priority messages, or push
+ *    (prepend to queue) a command message to the message queue of the
+ *    destination task. The destination_task field must refer to a
+ *    valid task, since the task ID will be used to send the message
+ *    to. This function will also set a message ready event in the
+ *    destination task's event list.
  *
  * @param   uint8 destination_task - Send msg to Task ID
  * @param   uint8 *msg_ptr - pointer to message buffer
- * @param   uint8 push - TRUE to push, otherwise enqueue
+ * @param   uint8 pos - OSAL_MSG_PRI_NORMAL, OSAL_MSG_PRI_HIGH or OSAL_MSG_PRI_FRONT
  *
  * @return  SUCCESS, INVALID_TASK, INVALID_MSG_POINTER
  */
-static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 push )
+static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint8 pos )
 {
+  osalTaskQ_t *pQ;
+  halIntState_t intState;
+
   if ( msg_ptr == NULL )
   {
     return ( INVALID_MSG_POINTER );
@@ -735,21 +782,60 @@ static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint
   }
 
   OSAL_MSG_ID( msg_ptr ) = destination_task;
+  pQ = osalTaskQ + destination_task;
 
-  if ( push == TRUE )
+  // Hold off interrupts
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  if ( pos == OSAL_MSG_PRI_FRONT )
   {
-    // prepend the message
-    osal_msg_push( &osal_qHead, msg_ptr );
+    // prepend the message, later high priority messages queue behind it
+    OSAL_MSG_NEXT( msg_ptr ) = pQ->head;
+    pQ->head = msg_ptr;
+    if ( pQ->hiTail == NULL )
+    {
+      pQ->hiTail = msg_ptr;
+    }
+  }
+  else if ( pos == OSAL_MSG_PRI_HIGH )
+  {
+    // insert the message behind the last high priority message
+    if ( pQ->hiTail == NULL )
+    {
+      OSAL_MSG_NEXT( msg_ptr ) = pQ->head;
+      pQ->head = msg_ptr;
+    }
+    else
+    {
+      OSAL_MSG_NEXT( msg_ptr ) = OSAL_MSG_NEXT( pQ->hiTail );
+      OSAL_MSG_NEXT( pQ->hiTail ) = msg_ptr;
+    }
+    pQ->hiTail = msg_ptr;
   }
   else
   {
     // append the message
-    osal_msg_enqueue( &osal_qHead, msg_ptr );
+    if ( pQ->tail == NULL )
+    {
+      pQ->head = msg_ptr;
+    }
+    else
+    {
+      OSAL_MSG_NEXT( pQ->tail ) = msg_ptr;
+    }
+  }
+
+  if ( OSAL_MSG_NEXT( msg_ptr ) == NULL )
+  {
+    pQ->tail = msg_ptr;
   }
 
   // Signal the task that a message is waiting
   osal_set_event( destination_task, SYS_EVENT_MSG );
 
+  // Re-enable interrupts
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
   return ( SUCCESS );
 }
 
@@ -768,42 +854,38 @@ static uint8 osal_msg_enqueue_push( uint8 destination_task, uint8 *msg_ptr, uint
  */
 uint8 *osal_msg_receive( uint8 task_id )
 {
-  osal_msg_hdr_t *listHdr;
-  osal_msg_hdr_t *prevHdr = NULL;
-  osal_msg_hdr_t *foundHdr = NULL;
+  osalTaskQ_t    *pQ;
+  osal_msg_hdr_t *foundHdr;
   halIntState_t   intState;
 
+  if ( task_id >= tasksCnt )
+  {
+    return ( NULL );
+  }
+  pQ = osalTaskQ + task_id;
+
   // Hold off interrupts
   HAL_ENTER_CRITICAL_SECTION(intState);
 
-  // Point to the top of the queue
-  listHdr = osal_qHead;
-
-  // Look through the queue for a message that belongs to the asking task
-  while ( listHdr != NULL )
+  // Take the first message out of the task's queue
+  foundHdr = pQ->head;
+  if ( foundHdr != NULL )
   {
-    if ( (listHdr - 1)->dest_id == task_id )
+    pQ->head = OSAL_MSG_NEXT( foundHdr );
+    if ( pQ->hiTail == foundHdr )
     {
-      if ( foundHdr == NULL )
-      {
-        // Save the first one
-        foundHdr = listHdr;
-      }
-      else
-      {
-        // Second msg found, stop looking
-        break;
-      }
+      pQ->hiTail = NULL;
     }
-    if ( foundHdr == NULL )
+    if ( pQ->tail == foundHdr )
     {
-      prevHdr = listHdr;
+      pQ->tail = NULL;
     }
-    listHdr = OSAL_MSG_NEXT( listHdr );
+    OSAL_MSG_NEXT( foundHdr ) = NULL;
+    OSAL_MSG_ID( foundHdr ) = TASK_NO_TASK;
   }
 
   // Is there more than one?
-  if ( listHdr != NULL )
+  if ( pQ->head != NULL )
   {
     // Yes, Signal the task that a message is waiting
     osal_set_event( task_id, SYS_EVENT_MSG );
@@ -814,13 +896,6 @@ uint8 *osal_msg_receive( uint8 task_id )
     osal_clear_event( task_id, SYS_EVENT_MSG );
   }
 
-  // Did we find a message?
-  if ( foundHdr != NULL )
-  {
-    // Take out of the link list
-    osal_msg_extract( &osal_qHead, foundHdr, prevHdr );
-  }
-
   // Release interrupts
   HAL_EXIT_CRITICAL_SECTION(intState);
 
@@ -850,14 +925,19 @@ osal_event_hdr_t *osal_msg_find(uint8 task_id, uint8 event)
   osal_msg_hdr_t *pHdr;
   halIntState_t intState;
 
+  if (task_id >= tasksCnt)
+  {
+    return NULL;
+  }
+
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
-  pHdr = osal_qHead;  // Point to the top of the queue.
+  pHdr = osalTaskQ[task_id].head;  // Point to the top of the task's queue.
 
-  // Look through the queue for a message that matches the task_id and event parameters.
+  // Look through the queue for a message that matches the event parameter.
   while (pHdr != NULL)
   {
-    if (((pHdr-1)->dest_id == task_id) && (((osal_event_hdr_t *)pHdr)->event == event))
+    if (((osal_event_hdr_t *)pHdr)->event == event)
     {
       break;
     }
@@ -895,15 +975,19 @@ uint8 osal_msg_count( uint8 task_id, uint8 event )
   osal_msg_hdr_t *pHdr;
   halIntState_t intState;
 
+  if (task_id >= tasksCnt)
+  {
+    return ( 0 );
+  }
+
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
 
-  pHdr = osal_qHead;  // Point to the top of the queue.
+  pHdr = osalTaskQ[task_id].head;  // Point to the top of the task's queue.
 
-  // Look through the queue for a message that matches the task_id and event parameters.
+  // Look through the queue for a message that matches the event parameter.
   while (pHdr != NULL)
   {
-    if ( ((pHdr-1)->dest_id == task_id) 
-        && ((event == 0xFF) || (((osal_event_hdr_t *)pHdr)->event == event)) )
+    if ( (event == 0xFF) || (((osal_event_hdr_t *)pHdr)->event == event) )
     {
       count++;
     }
@@ -1320,7 +1404,7 @@ uint8 osal_int_disable( uint8 interrupt_id )
  *
  * @param   void
  *
- * @return  SUCCESS
+ * @return  SUCCESS, or FAILURE if the task message queues could not be allocated
  */
 uint8 osal_init_system( void )
 {
@@ -1329,8 +1413,15 @@ uint8 osal_init_system( void )
   osal_mem_init();
 #endif /* !defined USE_ICALL && !defined OSAL_PORT2TIRTOS */
 
-  // Initialize the message queue
-  osal_qHead = NULL;
+  // Initialize the message queues
+  osalTaskQ = (osalTaskQ_t *) osal_mem_alloc( sizeof( osalTaskQ_t ) * tasksCnt );
+  if ( osalTaskQ == NULL )
+  {
+    // The heap is too small to run any task.
+    HAL_ASSERT_FORCED();
+    return ( FAILURE );
+  }
+  osal_memset( osalTaskQ, 0, sizeof( osalTaskQ_t ) * tasksCnt );
 
   // Initialize the timers
   osalTimerInit();
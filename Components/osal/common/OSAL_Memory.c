@@ -115,6 +115,70 @@
 #define OSALMEM_SMALL_BLKCNT       8
 #endif
 
+/* Segregated-fit size classes: when enabled, the end of the heap is carved into pools of fixed
+ * size blocks which are allocated and freed in constant time from a free list per size class.
+ * Short-lived allocations up to the largest class size are taken from the smallest class that
+ * fits, and fall back to the first-fit heap when that pool is empty. The blocks carry no header.
+ * Size the block counts by profiling with osal_heap_slab_max() and osal_heap_slab_miss().
+ */
+#if !defined OSALMEM_SLABS
+#define OSALMEM_SLABS              FALSE  // Enable/disable the segregated-fit size classes.
+#endif
+
+#if OSALMEM_SLABS
+#define OSALMEM_SLAB_CLASSES       5
+#define OSALMEM_SLAB_SZ0           16
+#define OSALMEM_SLAB_SZ1           32
+#define OSALMEM_SLAB_SZ2           64
+#define OSALMEM_SLAB_SZ3           128
+#define OSALMEM_SLAB_SZ4           256
+#if !defined OSALMEM_SLAB_CNT0
+#define OSALMEM_SLAB_CNT0          8
+#endif
+#if !defined OSALMEM_SLAB_CNT1
+#define OSALMEM_SLAB_CNT1          6
+#endif
+#if !defined OSALMEM_SLAB_CNT2
+#define OSALMEM_SLAB_CNT2          4
+#endif
+#if !defined OSALMEM_SLAB_CNT3
+#define OSALMEM_SLAB_CNT3          2
+#endif
+#if !defined OSALMEM_SLAB_CNT4
+#define OSALMEM_SLAB_CNT4          1
+#endif
+#define OSALMEM_SLAB_TOTAL        ((OSALMEM_SLAB_SZ0 * OSALMEM_SLAB_CNT0) + \
+                                   (OSALMEM_SLAB_SZ1 * OSALMEM_SLAB_CNT1) + \
+                                   (OSALMEM_SLAB_SZ2 * OSALMEM_SLAB_CNT2) + \
+                                   (OSALMEM_SLAB_SZ3 * OSALMEM_SLAB_CNT3) + \
+                                   (OSALMEM_SLAB_SZ4 * OSALMEM_SLAB_CNT4))
+#else
+#define OSALMEM_SLAB_TOTAL         0
+#endif
+
+/* Allocation trace: when enabled, every alloc and free is appended to a ring of compact records
+ * which is drained with osal_mem_trace_read(), e.g. by the MT_DEBUG_HEAP_TRACE command, so the
+ * sequence of a real run can be replayed off-target to size MAXMEMHEAP and the heap options.
+ * When the ring is full, new records are dropped and counted rather than overwriting old ones,
+ * and a gap marker with the count is recorded as soon as a read makes room for it.
+ */
+#if !defined OSALMEM_TRACE
+#define OSALMEM_TRACE              FALSE  // Enable/disable the allocation trace recorder.
+#endif
+
+#if OSALMEM_TRACE
+#if !defined OSALMEM_TRACE_CNT
+#define OSALMEM_TRACE_CNT          32     // Number of records buffered between reads.
+#endif
+#ifdef DPRINTF_OSALHEAPTRACE
+#define OSALMEM_TRACE_SITE_FILE    0
+#define OSALMEM_TRACE_SITE_LINE    ((uint16)lnum)
+#else
+#define OSALMEM_TRACE_SITE_FILE    file
+#define OSALMEM_TRACE_SITE_LINE    line
+#endif
+#endif
+
 /*
  * These numbers setup the size of the small-block bucket which is reserved at the front of the
  * heap for allocations of OSALMEM_SMALL_BLKSZ or smaller.
@@ -129,11 +193,13 @@
 // Index of the first available osalMemHdr_t after the small-block heap which will be set in-use in
 #define OSALMEM_BIGBLK_IDX        (OSALMEM_SMALLBLK_HDRCNT + 1)
 // The size of the wilderness after losing the small-block heap, the wasted header to block the
-// small-block heap from being coalesced, and the wasted header to mark the end of the heap.
-#define OSALMEM_BIGBLK_SZ         (MAXMEMHEAP - OSALMEM_SMALLBLK_BUCKET - OSALMEM_HDRSZ*2)
+// small-block heap from being coalesced, the wasted header to mark the end of the heap and the
+// size-class pools.
+#define OSALMEM_BIGBLK_SZ         (MAXMEMHEAP - OSALMEM_SMALLBLK_BUCKET - OSALMEM_HDRSZ*2 - \
+                                   OSALMEM_SLAB_TOTAL)
 // Index of the last available osalMemHdr_t at the end of the heap which will be set to zero for
-// fast comparisons with zero to determine the end of the heap.
-#define OSALMEM_LASTBLK_IDX      ((MAXMEMHEAP / OSALMEM_HDRSZ) - 1)
+// fast comparisons with zero to determine the end of the heap. The size-class pools follow it.
+#define OSALMEM_LASTBLK_IDX      (((MAXMEMHEAP - OSALMEM_SLAB_TOTAL) / OSALMEM_HDRSZ) - 1)
 
 // For information about memory profiling, refer to SWRA204 "Heap Memory Management", section 1.5.
 #if !defined OSALMEM_PROFILER
@@ -185,6 +251,27 @@ static osalMemHdr_t *ff1;  // First free block in the small-block bucket.
 
 static uint8 osalMemStat;            // Discrete status flags: 0x01 = kicked.
 
+#if OSALMEM_TRACE
+static osalMemTrace_t traceBuf[OSALMEM_TRACE_CNT];
+static uint8 traceHead;   // Index of the oldest record.
+static uint8 traceCnt;    // Number of records buffered.
+static uint8 traceHold;   // Set while allocs and frees are not recorded.
+static uint16 traceGap;   // Number of records dropped since the last gap marker.
+static uint16 traceLost;  // Number of records dropped in total.
+#endif
+
+#if OSALMEM_SLABS
+static CONST uint16 slabSz[OSALMEM_SLAB_CLASSES] = {
+OSALMEM_SLAB_SZ0, OSALMEM_SLAB_SZ1, OSALMEM_SLAB_SZ2, OSALMEM_SLAB_SZ3, OSALMEM_SLAB_SZ4 };
+static CONST uint8 slabCnt[OSALMEM_SLAB_CLASSES] = {
+OSALMEM_SLAB_CNT0, OSALMEM_SLAB_CNT1, OSALMEM_SLAB_CNT2, OSALMEM_SLAB_CNT3, OSALMEM_SLAB_CNT4 };
+static uint8 *slabBeg[OSALMEM_SLAB_CLASSES+1];  // First block of each pool, then the heap end.
+static void *slabFree[OSALMEM_SLAB_CLASSES];    // Free list of each pool, linked in the blocks.
+static uint8 slabCur[OSALMEM_SLAB_CLASSES];     // Current cnt of blocks in use.
+static uint8 slabMax[OSALMEM_SLAB_CLASSES];     // Max cnt of blocks ever in use at once.
+static uint16 slabMiss[OSALMEM_SLAB_CLASSES];   // Cnt of allocations passed to the heap.
+#endif
+
 #if OSALMEM_METRICS
 static uint16 blkMax;  // Max cnt of all blocks ever seen at once.
 static uint16 blkCnt;  // Current cnt of all blocks.
@@ -216,6 +303,96 @@ static uint16 proSmallBlkMiss;
 extern int dprintf(const char *fmt, ...);
 #endif /* DPRINTF_HEAPTRACE */
 
+#if OSALMEM_TRACE
+/**************************************************************************************************
+ * @fn          osalMemTracePut
+ *
+ * @brief       This function stores one record at the end of the allocation trace, which must have
+ *              room for it. Interrupts must be held off.
+ *
+ * input parameters
+ *
+ * @param size - The size field of the record.
+ * @param file - The file hash of the caller, or zero.
+ * @param line - The line number of the caller, or zero.
+ * @param id   - The id field of the record.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osalMemTracePut(uint16 size, uint16 file, uint16 line, uint16 id)
+{
+  uint8 idx = traceHead + traceCnt;
+  osalMemTrace_t *pRec;
+
+  if (idx >= OSALMEM_TRACE_CNT)
+  {
+    idx -= OSALMEM_TRACE_CNT;
+  }
+  pRec = traceBuf + idx;
+
+  pRec->time = (uint16)osal_GetSystemClock();
+  pRec->size = size;
+  pRec->file = file;
+  pRec->line = line;
+  pRec->id = id;
+  traceCnt++;
+}
+
+/**************************************************************************************************
+ * @fn          osalMemTraceAdd
+ *
+ * @brief       This function appends one record to the allocation trace, or drops it if the trace
+ *              is full or records were dropped since the last one stored.
+ *
+ * input parameters
+ *
+ * @param size - The requested size of an alloc, optionally with OSALMEM_TRACE_FAIL,
+ *               OSALMEM_TRACE_FREE for a free, or a marker.
+ * @param ptr  - The block allocated or freed, NULL for a failed alloc or a marker.
+ * @param file - The file hash of the caller, or zero.
+ * @param line - The line number of the caller, or zero.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+static void osalMemTraceAdd(uint16 size, void *ptr, uint16 file, uint16 line)
+{
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  if (!traceHold)
+  {
+    // Records must not be stored past a run of dropped ones before its gap marker.
+    if ((traceGap == 0) && (traceCnt < OSALMEM_TRACE_CNT))
+    {
+      osalMemTracePut(size, file, line, (ptr == NULL) ? OSALMEM_TRACE_NO_ID :
+                                        (uint16)((uint8 *)ptr - (uint8 *)theHeap));
+    }
+    else
+    {
+      if (traceGap != 0xFFFF)
+      {
+        traceGap++;
+      }
+      if (traceLost != 0xFFFF)
+      {
+        traceLost++;
+      }
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+}
+#endif
+
 /**************************************************************************************************
  * @fn          osal_mem_init
  *
@@ -236,6 +413,10 @@ void osal_mem_init(void)
   HAL_ASSERT(((OSALMEM_MIN_BLKSZ % OSALMEM_HDRSZ) == 0));
   HAL_ASSERT(((OSALMEM_LL_BLKSZ % OSALMEM_HDRSZ) == 0));
   HAL_ASSERT(((OSALMEM_SMALL_BLKSZ % OSALMEM_HDRSZ) == 0));
+#if OSALMEM_SLABS
+  HAL_ASSERT(((OSALMEM_SLAB_SZ0 % sizeof(halDataAlign_t)) == 0));
+  HAL_ASSERT((OSALMEM_SLAB_SZ0 >= sizeof(void *)));
+#endif
 
 #if OSALMEM_PROFILER
   (void)osal_memset(theHeap, OSALMEM_INIT, MAXMEMHEAP);
@@ -260,6 +441,30 @@ void osal_mem_init(void)
    */
   blkCnt = blkFree = 2;
 #endif
+
+#if OSALMEM_SLABS
+  {
+    // Thread the free list of each pool through its blocks.
+    uint8 *blk = (uint8 *)(theHeap + OSALMEM_LASTBLK_IDX + 1);
+    uint8 cls, cnt;
+
+    for (cls = 0; cls < OSALMEM_SLAB_CLASSES; cls++)
+    {
+      slabBeg[cls] = blk;
+      slabFree[cls] = NULL;
+      slabCur[cls] = slabMax[cls] = 0;
+      slabMiss[cls] = 0;
+
+      for (cnt = 0; cnt < slabCnt[cls]; cnt++)
+      {
+        *(void **)blk = slabFree[cls];
+        slabFree[cls] = blk;
+        blk += slabSz[cls];
+      }
+    }
+    slabBeg[OSALMEM_SLAB_CLASSES] = blk;
+  }
+#endif
 }
 
 /**************************************************************************************************
@@ -283,7 +488,16 @@ void osal_mem_init(void)
 void osal_mem_kick(void)
 {
   halIntState_t intState;
-  osalMemHdr_t *tmp = osal_mem_alloc(1);
+  osalMemHdr_t *tmp;
+#if OSALMEM_TRACE
+  uint8 hold = traceHold;
+
+  // The kick is recorded as a marker to be replayed as a kick, rather than as an alloc and a free.
+  osalMemTraceAdd(OSALMEM_TRACE_KICK, NULL, 0, 0);
+  traceHold = TRUE;
+#endif
+
+  tmp = osal_mem_alloc(1);
 
   HAL_ASSERT((tmp != NULL));
   HAL_ENTER_CRITICAL_SECTION(intState);  // Hold off interrupts.
@@ -297,6 +511,10 @@ void osal_mem_kick(void)
   osalMemStat = 0x01;  // Set 'osalMemStat' after the free because it enables memory profiling.
 
   HAL_EXIT_CRITICAL_SECTION(intState);  // Re-enable interrupts.
+
+#if OSALMEM_TRACE
+  traceHold = hold;
+#endif
 }
 
 /**************************************************************************************************
@@ -316,6 +534,8 @@ void osal_mem_kick(void)
  */
 #ifdef DPRINTF_OSALHEAPTRACE
 void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum )
+#elif OSALMEM_TRACE
+void *osal_mem_alloc_site( uint16 size, uint16 file, uint16 line )
 #else /* DPRINTF_OSALHEAPTRACE */
 void *osal_mem_alloc( uint16 size )
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -324,6 +544,50 @@ void *osal_mem_alloc( uint16 size )
   osalMemHdr_t *hdr;
   halIntState_t intState;
   uint8 coal = 0;
+#if OSALMEM_TRACE
+  const uint16 reqSize = (size > OSALMEM_TRACE_SIZE) ? OSALMEM_TRACE_SIZE : size;
+#endif
+
+#if OSALMEM_SLABS
+  // Long-lived allocations made before osal_mem_kick() stay in the LL block.
+  if ((osalMemStat != 0) && (size <= OSALMEM_SLAB_SZ4))
+  {
+    uint8 cls = 0;
+    void *blk;
+
+    while (size > slabSz[cls])
+    {
+      cls++;
+    }
+
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+    blk = slabFree[cls];
+    if (blk != NULL)
+    {
+      slabFree[cls] = *(void **)blk;
+      if (slabMax[cls] < ++slabCur[cls])
+      {
+        slabMax[cls] = slabCur[cls];
+      }
+    }
+    else
+    {
+      slabMiss[cls]++;
+    }
+    HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+    if (blk != NULL)
+    {
+#ifdef DPRINTF_OSALHEAPTRACE
+      dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) blk, fname, lnum);
+#endif /* DPRINTF_OSALHEAPTRACE */
+#if OSALMEM_TRACE
+      osalMemTraceAdd(reqSize, blk, OSALMEM_TRACE_SITE_FILE, OSALMEM_TRACE_SITE_LINE);
+#endif
+      return blk;  // EMBEDDED RETURN
+    }
+  }
+#endif
 
   size += OSALMEM_HDRSZ;
 
@@ -490,6 +754,10 @@ void *osal_mem_alloc( uint16 size )
 #ifdef DPRINTF_OSALHEAPTRACE
   dprintf("osal_mem_alloc(%u)->%lx:%s:%u\n", size, (unsigned) hdr, fname, lnum);
 #endif /* DPRINTF_OSALHEAPTRACE */
+#if OSALMEM_TRACE
+  osalMemTraceAdd(((hdr == NULL) ? (reqSize | OSALMEM_TRACE_FAIL) : reqSize), hdr,
+                  OSALMEM_TRACE_SITE_FILE, OSALMEM_TRACE_SITE_LINE);
+#endif
   return (void *)hdr;
 }
 
@@ -510,6 +778,8 @@ void *osal_mem_alloc( uint16 size )
  */
 #ifdef DPRINTF_OSALHEAPTRACE
 void osal_mem_free_dbg(void *ptr, const char *fname, unsigned lnum)
+#elif OSALMEM_TRACE
+void osal_mem_free_site(void *ptr, uint16 file, uint16 line)
 #else /* DPRINTF_OSALHEAPTRACE */
 void osal_mem_free(void *ptr)
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -522,6 +792,31 @@ void osal_mem_free(void *ptr)
 #endif /* DPRINTF_OSALHEAPTRACE */
 
   HAL_ASSERT(((uint8 *)ptr >= (uint8 *)theHeap) && ((uint8 *)ptr < (uint8 *)theHeap+MAXMEMHEAP));
+
+#if OSALMEM_TRACE
+  osalMemTraceAdd(OSALMEM_TRACE_FREE, ptr, OSALMEM_TRACE_SITE_FILE, OSALMEM_TRACE_SITE_LINE);
+#endif
+
+#if OSALMEM_SLABS
+  if ((uint8 *)ptr >= slabBeg[0])
+  {
+    uint8 cls = 0;
+
+    while ((uint8 *)ptr >= slabBeg[cls+1])
+    {
+      cls++;
+    }
+
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+    *(void **)ptr = slabFree[cls];
+    slabFree[cls] = ptr;
+    slabCur[cls]--;
+    HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+    return;  // EMBEDDED RETURN
+  }
+#endif
+
   HAL_ASSERT(hdr->hdr.inUse);
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
@@ -560,6 +855,52 @@ void osal_mem_free(void *ptr)
   HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
 }
 
+#if OSALMEM_TRACE && !defined DPRINTF_OSALHEAPTRACE
+#undef osal_mem_alloc
+#undef osal_mem_free
+/**************************************************************************************************
+ * @fn          osal_mem_alloc
+ *
+ * @brief       This function is the entry point of the stack libraries, which are not built with
+ *              the trace and so are recorded without a site.
+ *
+ * input parameters
+ *
+ * @param size - the number of bytes to allocate from the HEAP.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void *osal_mem_alloc( uint16 size )
+{
+  return osal_mem_alloc_site(size, 0, 0);
+}
+
+/**************************************************************************************************
+ * @fn          osal_mem_free
+ *
+ * @brief       This function is the entry point of the stack libraries, which are not built with
+ *              the trace and so are recorded without a site.
+ *
+ * input parameters
+ *
+ * @param ptr - A valid pointer (i.e. a pointer returned by osal_mem_alloc()) to the memory to free.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ */
+void osal_mem_free(void *ptr)
+{
+  osal_mem_free_site(ptr, 0, 0);
+}
+#endif
+
 #if OSALMEM_METRICS
 /*********************************************************************
  * @fn      osal_heap_block_max
@@ -618,6 +959,119 @@ uint16 osal_heap_mem_used( void )
 }
 #endif
 
+#if OSALMEM_SLABS
+/*********************************************************************
+ * @fn      osal_heap_slab_max
+ *
+ * @brief   Return the maximum number of blocks of a size class ever allocated at once.
+ *
+ * @param   cls - size class, 0 to 4 for 16, 32, 64, 128 and 256 byte blocks.
+ *
+ * @return  Maximum number of blocks ever allocated at once.
+ */
+uint8 osal_heap_slab_max( uint8 cls )
+{
+  return (cls < OSALMEM_SLAB_CLASSES) ? slabMax[cls] : 0;
+}
+
+/*********************************************************************
+ * @fn      osal_heap_slab_miss
+ *
+ * @brief   Return the number of allocations of a size class that found the pool empty
+ *          and were taken from the heap instead.
+ *
+ * @param   cls - size class, 0 to 4 for 16, 32, 64, 128 and 256 byte blocks.
+ *
+ * @return  Number of allocations passed to the heap.
+ */
+uint16 osal_heap_slab_miss( uint8 cls )
+{
+  return (cls < OSALMEM_SLAB_CLASSES) ? slabMiss[cls] : 0;
+}
+#endif
+
+#if OSALMEM_TRACE
+/*********************************************************************
+ * @fn      osal_mem_trace_read
+ *
+ * @brief   Move the oldest allocation trace records out of the trace. A gap marker for the
+ *          records dropped since the last one stored is added once there is room for it.
+ *
+ * @param   pRec - buffer for the records.
+ * @param   cnt - maximum number of records to read.
+ *
+ * @return  Number of records read.
+ */
+uint8 osal_mem_trace_read( osalMemTrace_t *pRec, uint8 cnt )
+{
+  halIntState_t intState;
+  uint8 num = 0;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  while ((num < cnt) && (traceCnt != 0))
+  {
+    *pRec++ = traceBuf[traceHead];
+
+    if (++traceHead >= OSALMEM_TRACE_CNT)
+    {
+      traceHead = 0;
+    }
+    traceCnt--;
+    num++;
+  }
+
+  // Mark the records dropped since the last one stored, now that there is room.
+  if ((traceGap != 0) && (traceCnt < OSALMEM_TRACE_CNT))
+  {
+    osalMemTracePut(OSALMEM_TRACE_GAP, 0, 0, traceGap);
+    traceGap = 0;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return num;
+}
+
+/*********************************************************************
+ * @fn      osal_mem_trace_lost
+ *
+ * @brief   Return the number of records dropped because the trace was full. Each run of
+ *          dropped records is also marked in the trace by an OSALMEM_TRACE_GAP record.
+ *
+ * @param   none
+ *
+ * @return  Number of records dropped since boot, saturated at 0xFFFF.
+ */
+uint16 osal_mem_trace_lost( void )
+{
+  halIntState_t intState;
+  uint16 lost;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+  lost = traceLost;
+  HAL_EXIT_CRITICAL_SECTION( intState );  // Re-enable interrupts.
+
+  return lost;
+}
+
+/*********************************************************************
+ * @fn      osal_mem_trace_hold
+ *
+ * @brief   Stop or restart recording allocs and frees. Allocs and frees made while the
+ *          trace is held are neither recorded nor counted as dropped, so a block must be
+ *          freed before the trace is released if it was allocated while it was held.
+ *
+ * @param   hold - TRUE to stop recording, FALSE to restart.
+ *
+ * @return  none
+ */
+void osal_mem_trace_hold( uint8 hold )
+{
+  traceHold = hold;
+}
+#endif
+
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
 /*********************************************************************
  * @fn      osal_heap_high_water
@@ -44,31 +44,63 @@
 #include "comdef.h"
 #include "OnBoard.h"
 #include "OSAL.h"
+#include "OSAL_Memory.h"
 #include "OSAL_Timers.h"
+#include "hal_assert.h"
 #include "hal_timer.h"
 
 /*********************************************************************
  * MACROS
  */
 
+// Wheel slot of an expiration time
+#define OSAL_TIMERS_SLOT( t )  ((uint16)(t) & (OSAL_TIMERS_SLOTS - 1))
+
+// Index chain of a task and event
+#define OSAL_TIMERS_CHAIN( task, event )  \
+  (((uint8)((task) << 2) ^ (uint8)(event) ^ (uint8)((event) >> 4) ^ \
+    (uint8)((event) >> 8) ^ (uint8)((event) >> 12)) & (OSAL_TIMERS_HASH - 1))
+
+// The system clock has reached a time, across a clock wrap
+#define OSAL_TIMERS_REACHED( t )  ((int32)(osal_systemClock - (t)) >= 0)
+
 /*********************************************************************
  * CONSTANTS
  */
 
+// Number of timer records in the static pool. When every record is in use,
+// further records are allocated from the heap.
+#if !defined ( OSAL_TIMERS_MAX )
+  #define OSAL_TIMERS_MAX  24
+#endif
+
+// Number of slots in the timer wheel, a power of 2.
+#if !defined ( OSAL_TIMERS_SLOTS )
+  #define OSAL_TIMERS_SLOTS  32
+#endif
+
+// Number of chains in the task and event index, a power of 2.
+#if !defined ( OSAL_TIMERS_HASH )
+  #define OSAL_TIMERS_HASH  16
+#endif
+
+// Longest timeout, so that expiration times still compare after a clock wrap
+#define OSAL_TIMERS_LONGEST  0x7FFFFFFF
+
 /*********************************************************************
  * TYPEDEFS
  */
 
-typedef union {
-  uint32 time32;
-  uint16 time16[2];
-  uint8 time8[4];
-} osalTime_t;
-
+// Active timers are kept in a timer wheel: a timer is linked, unsorted, into
+// the slot of the low bits of its expiration time, so starting or stopping a
+// timer never walks the others and a tick only looks at the slots of the
+// milliseconds that went by. Timers are also chained by task and event to
+// find the one to restart or stop.
 typedef struct
 {
-  void   *next;
-  osalTime_t timeout;
+  void   *next;          // Next record in the slot, or in the free list
+  void   *chainNext;     // Next record in the index chain
+  uint32 expire;         // System clock at expiration
   uint16 event_flag;
   uint8  task_id;
   uint32 reloadTimeout;
@@ -78,8 +110,6 @@ typedef struct
  * GLOBAL VARIABLES
  */
 
-osalTimerRec_t *timerHead;
-
 /*********************************************************************
  * EXTERNAL VARIABLES
  */
@@ -94,12 +124,30 @@ osalTimerRec_t *timerHead;
 // Milliseconds since last reboot
 static uint32 osal_systemClock;
 
+// Timer wheel and the task and event index
+static osalTimerRec_t *timerSlot[OSAL_TIMERS_SLOTS];
+static osalTimerRec_t *timerChain[OSAL_TIMERS_HASH];
+
+// Timer record pool and its free list
+static osalTimerRec_t osalTimerPool[OSAL_TIMERS_MAX];
+static osalTimerRec_t *timerFree;
+
+// Number of active timers
+static uint16 timerCount;
+
+// Earliest expiration time, when timerNextValid is set
+static uint32 timerNext;
+static uint8 timerNextValid;
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout );
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
 void osalDeleteTimer( osalTimerRec_t *rmTimer );
+static void osalInsertTimer( osalTimerRec_t *newTimer, uint32 timeout );
+static void osalUnlinkTimer( osalTimerRec_t *rmTimer );
+static void osalReleaseTimer( osalTimerRec_t *rmTimer );
 
 /*********************************************************************
  * FUNCTIONS
@@ -116,7 +164,154 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer );
  */
 void osalTimerInit( void )
 {
+  uint16 i;
+
   osal_systemClock = 0;
+
+  for ( i = 0; i < OSAL_TIMERS_SLOTS; i++ )
+  {
+    timerSlot[i] = NULL;
+  }
+  for ( i = 0; i < OSAL_TIMERS_HASH; i++ )
+  {
+    timerChain[i] = NULL;
+  }
+  timerCount = 0;
+  timerNextValid = FALSE;
+
+  // Chain every pool record into the free list
+  timerFree = NULL;
+  for ( i = 0; i < OSAL_TIMERS_MAX; i++ )
+  {
+    osalTimerPool[i].next = timerFree;
+    timerFree = &osalTimerPool[i];
+  }
+}
+
+/*********************************************************************
+ * @fn      osalInsertTimer
+ *
+ * @brief   Link a timer record into the wheel slot of its expiration.
+ *          Ints must be disabled.
+ *
+ * @param   newTimer - record not currently in the wheel
+ * @param   timeout - milliseconds from now
+ *
+ * @return  none
+ */
+static void osalInsertTimer( osalTimerRec_t *newTimer, uint32 timeout )
+{
+  uint16 slot;
+
+  if ( timeout > OSAL_TIMERS_LONGEST )
+  {
+    timeout = OSAL_TIMERS_LONGEST;
+  }
+
+  newTimer->expire = osal_systemClock + timeout;
+
+  slot = OSAL_TIMERS_SLOT( newTimer->expire );
+  newTimer->next = timerSlot[slot];
+  timerSlot[slot] = newTimer;
+
+  // Keep the earliest expiration up to date while it is known
+  if ( timerCount == 0 )
+  {
+    timerNext = newTimer->expire;
+    timerNextValid = TRUE;
+  }
+  else if ( timerNextValid && ((int32)(newTimer->expire - timerNext) < 0) )
+  {
+    timerNext = newTimer->expire;
+  }
+
+  timerCount++;
+}
+
+/*********************************************************************
+ * @fn      osalUnlinkTimer
+ *
+ * @brief   Take a timer record out of its wheel slot.
+ *          Ints must be disabled.
+ *
+ * @param   rmTimer - record to remove
+ *
+ * @return  none
+ */
+static void osalUnlinkTimer( osalTimerRec_t *rmTimer )
+{
+  uint16 slot = OSAL_TIMERS_SLOT( rmTimer->expire );
+  osalTimerRec_t *srchTimer = timerSlot[slot];
+  osalTimerRec_t *prevTimer = NULL;
+
+  while ( srchTimer != rmTimer )
+  {
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->next;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerSlot[slot] = rmTimer->next;
+  }
+  else
+  {
+    prevTimer->next = rmTimer->next;
+  }
+
+  // The earliest expiration is looked up again if this was it
+  if ( rmTimer->expire == timerNext )
+  {
+    timerNextValid = FALSE;
+  }
+
+  rmTimer->next = NULL;
+  timerCount--;
+}
+
+/*********************************************************************
+ * @fn      osalReleaseTimer
+ *
+ * @brief   Take a timer record that is not in the wheel out of the
+ *          index and return it to the pool, or to the heap.
+ *          Ints must be disabled.
+ *
+ * @param   rmTimer - record to release
+ *
+ * @return  none
+ */
+static void osalReleaseTimer( osalTimerRec_t *rmTimer )
+{
+  uint8 chain = OSAL_TIMERS_CHAIN( rmTimer->task_id, rmTimer->event_flag );
+  osalTimerRec_t *srchTimer = timerChain[chain];
+  osalTimerRec_t *prevTimer = NULL;
+
+  while ( srchTimer != rmTimer )
+  {
+    prevTimer = srchTimer;
+    srchTimer = srchTimer->chainNext;
+  }
+
+  if ( prevTimer == NULL )
+  {
+    timerChain[chain] = rmTimer->chainNext;
+  }
+  else
+  {
+    prevTimer->chainNext = rmTimer->chainNext;
+  }
+
+  rmTimer->event_flag = 0;
+
+  if ( (rmTimer >= osalTimerPool) && (rmTimer < (osalTimerPool + OSAL_TIMERS_MAX)) )
+  {
+    rmTimer->next = timerFree;
+    timerFree = rmTimer;
+  }
+  else
+  {
+    osal_mem_free( rmTimer );
+  }
 }
 
 /*********************************************************************
@@ -134,57 +329,45 @@ void osalTimerInit( void )
 osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint32 timeout )
 {
   osalTimerRec_t *newTimer;
-  osalTimerRec_t *srchTimer;
 
   // Look for an existing timer first
   newTimer = osalFindTimer( task_id, event_flag );
+
   if ( newTimer )
   {
-    // Timer is found - update it.
-    newTimer->timeout.time32 = timeout;
-
-    return ( newTimer );
+    // Timer is found - move it to its new slot.
+    osalUnlinkTimer( newTimer );
   }
   else
   {
-    // New Timer
-    newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
-
-    if ( newTimer )
+    // New Timer - take a record from the pool, or from the heap once the pool is used up
+    newTimer = timerFree;
+    if ( newTimer != NULL )
     {
-      // Fill in new timer
-      newTimer->task_id = task_id;
-      newTimer->event_flag = event_flag;
-      newTimer->timeout.time32 = timeout;
-      newTimer->next = (void *)NULL;
-      newTimer->reloadTimeout = 0;
-
-      // Does the timer list already exist
-      if ( timerHead == NULL )
-      {
-        // Start task list
-        timerHead = newTimer;
-      }
-      else
-      {
-        // Add it to the end of the timer list
-        srchTimer = timerHead;
-
-        // Stop at the last record
-        while ( srchTimer->next )
-          srchTimer = srchTimer->next;
-
-        // Add to the list
-        srchTimer->next = newTimer;
-      }
-
-      return ( newTimer );
+      timerFree = newTimer->next;
     }
     else
     {
-      return ( (osalTimerRec_t *)NULL );
+      newTimer = osal_mem_alloc( sizeof( osalTimerRec_t ) );
+      HAL_ASSERT( newTimer != NULL );
+      if ( newTimer == NULL )
+      {
+        return ( (osalTimerRec_t *)NULL );
+      }
     }
+
+    // Fill in new timer
+    newTimer->task_id = task_id;
+    newTimer->event_flag = event_flag;
+    newTimer->reloadTimeout = 0;
+
+    newTimer->chainNext = timerChain[OSAL_TIMERS_CHAIN( task_id, event_flag )];
+    timerChain[OSAL_TIMERS_CHAIN( task_id, event_flag )] = newTimer;
   }
+
+  osalInsertTimer( newTimer, timeout );
+
+  return ( newTimer );
 }
 
 /*********************************************************************
@@ -202,8 +385,8 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
 {
   osalTimerRec_t *srchTimer;
 
-  // Head of the timer list
-  srchTimer = timerHead;
+  // Head of the index chain of the task and event
+  srchTimer = timerChain[OSAL_TIMERS_CHAIN( task_id, event_flag )];
 
   // Stop when found or at the end
   while ( srchTimer )
@@ -215,7 +398,7 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
     }
 
     // Not this one, check another
-    srchTimer = srchTimer->next;
+    srchTimer = srchTimer->chainNext;
   }
 
   return ( srchTimer );
@@ -224,9 +407,10 @@ osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag )
 /*********************************************************************
  * @fn      osalDeleteTimer
  *
- * @brief   Delete a timer from a timer list.
+ * @brief   Delete a timer from a timer list and return its record
+ *          to the pool or the heap.
+ *          Ints must be disabled.
  *
- * @param   table
  * @param   rmTimer
  *
  * @return  none
@@ -236,9 +420,8 @@ void osalDeleteTimer( osalTimerRec_t *rmTimer )
   // Does the timer list really exist
   if ( rmTimer )
   {
-    // Clear the event flag and osalTimerUpdate() will delete
-    // the timer from the list.
-    rmTimer->event_flag = 0;
+    osalUnlinkTimer( rmTimer );
+    osalReleaseTimer( rmTimer );
   }
 }
 
@@ -353,15 +536,15 @@ uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
 {
   halIntState_t intState;
   uint32 rtrn = 0;
-  osalTimerRec_t *tmr;
+  osalTimerRec_t *srchTimer;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-  tmr = osalFindTimer( task_id, event_id );
+  srchTimer = osalFindTimer( task_id, event_id );
 
-  if ( tmr )
+  if ( srchTimer && !OSAL_TIMERS_REACHED( srchTimer->expire ) )
   {
-    rtrn = tmr->timeout.time32;
+    rtrn = srchTimer->expire - osal_systemClock;
   }
 
   HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
@@ -380,25 +563,7 @@ uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
  */
 uint8 osal_timer_num_active( void )
 {
-  halIntState_t intState;
-  uint8 num_timers = 0;
-  osalTimerRec_t *srchTimer;
-
-  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
-
-  // Head of the timer list
-  srchTimer = timerHead;
-
-  // Count timers in the list
-  while ( srchTimer != NULL )
-  {
-    num_timers++;
-    srchTimer = srchTimer->next;
-  }
-
-  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
-
-  return num_timers;
+  return ( (timerCount > 0xFF) ? 0xFF : (uint8)timerCount );
 }
 
 /*********************************************************************
@@ -413,116 +578,77 @@ uint8 osal_timer_num_active( void )
 void osalTimerUpdate( uint32 updateTime )
 {
   halIntState_t intState;
+  osalTimerRec_t *expTimer;
   osalTimerRec_t *srchTimer;
   osalTimerRec_t *prevTimer;
-
-  osalTime_t timeUnion;
-  timeUnion.time32 = updateTime;
+  osalTimerRec_t *reloadList = NULL;
+  uint32 slotTime;
+  uint16 slots, slot;
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
   // Update the system time
+  slotTime = osal_systemClock;
   osal_systemClock += updateTime;
-  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 
-  // Look for open timer slot
-  if ( timerHead != NULL )
+  // Every timer that has expired is in the slot of one of the milliseconds
+  // from the previous update on, or anywhere once the wheel has gone round.
+  slots = ( updateTime < OSAL_TIMERS_SLOTS ) ? (uint16)(updateTime + 1) : OSAL_TIMERS_SLOTS;
+
+  while ( timerCount && slots-- )
   {
-    // Add it to the end of the timer list
-    srchTimer = timerHead;
-    prevTimer = (void *)NULL;
+    slot = OSAL_TIMERS_SLOT( slotTime++ );
+    srchTimer = timerSlot[slot];
+    prevTimer = NULL;
 
-    // Look for open timer slot
     while ( srchTimer )
     {
-      osalTimerRec_t *freeTimer = NULL;
+      expTimer = srchTimer;
+      srchTimer = srchTimer->next;
 
-      HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+      // Timers for a later turn of the wheel stay in the slot
+      if ( !OSAL_TIMERS_REACHED( expTimer->expire ) )
+      {
+        prevTimer = expTimer;
+        continue;
+      }
 
-      // To minimize time in this critical section, avoid 32-bit math
-      if ((timeUnion.time16[1] == 0) && (timeUnion.time8[1] == 0))
+      if ( prevTimer == NULL )
       {
-        // If upper 24 bits are zero, check lower 8 bits for roll over
-        if (srchTimer->timeout.time8[0] >= timeUnion.time8[0])
-        {
-          // 8-bit math
-          srchTimer->timeout.time8[0] -= timeUnion.time8[0];
-        }
-        else
-        {
-          // 32-bit math
-          if (srchTimer->timeout.time32 > timeUnion.time32)
-          {
-            srchTimer->timeout.time32 -= timeUnion.time32;
-          }
-          else
-          {
-            srchTimer->timeout.time32 = 0;
-          }
-        }
+        timerSlot[slot] = srchTimer;
       }
       else
       {
-          // 32-bit math
-        if (srchTimer->timeout.time32 > timeUnion.time32)
-        {
-          srchTimer->timeout.time32 -= timeUnion.time32;
-        }
-        else
-        {
-          srchTimer->timeout.time32 = 0;
-        }
+        prevTimer->next = srchTimer;
       }
+      timerCount--;
+      timerNextValid = FALSE;
 
-      // Check for reloading
-      if ( (srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0) &&
-           (srchTimer->reloadTimeout) && (srchTimer->event_flag) )
-      {
-        // Notify the task of a timeout
-        osal_set_event( srchTimer->task_id, srchTimer->event_flag );
-
-        // Reload the timer timeout value
-        srchTimer->timeout.time32 = srchTimer->reloadTimeout;
-      }
+      // Notify the task of a timeout
+      osal_set_event( expTimer->task_id, expTimer->event_flag );
 
-      // When timeout or delete (event_flag == 0)
-      if ( ((srchTimer->timeout.time16[0] == 0) && (srchTimer->timeout.time16[1] == 0)) ||
-            (srchTimer->event_flag == 0) )
+      if ( expTimer->reloadTimeout )
       {
-        // Take out of list
-        if ( prevTimer == NULL )
-        {
-          timerHead = srchTimer->next;
-        }
-        else
-        {
-          prevTimer->next = srchTimer->next;
-        }
-
-        // Setup to free memory
-        freeTimer = srchTimer;
-
-        // Next
-        srchTimer = srchTimer->next;
+        // Hold reloading timers until the elapsed time has been applied
+        expTimer->next = reloadList;
+        reloadList = expTimer;
       }
       else
       {
-        // Get next
-        prevTimer = srchTimer;
-        srchTimer = srchTimer->next;
-      }
-
-      HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
-
-      if ( freeTimer )
-      {
-        if ( (freeTimer->timeout.time16[0] == 0) && (freeTimer->timeout.time16[1] == 0) )
-        {
-          osal_set_event( freeTimer->task_id, freeTimer->event_flag );
-        }
-        osal_mem_free( freeTimer );
+        osalReleaseTimer( expTimer );
       }
     }
   }
+
+  // Reload the timer timeout values
+  while ( reloadList )
+  {
+    expTimer = reloadList;
+    reloadList = expTimer->next;
+    osalInsertTimer( expTimer, expTimer->reloadTimeout );
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
 }
 
 #ifdef POWER_SAVING
@@ -539,7 +665,7 @@ void osal_adjust_timers( void )
 {
   uint32 eTime;
 
-  if ( timerHead != NULL )
+  if ( timerCount != 0 )
   {
     // Compute elapsed time (msec)
     eTime = TimerElapsed() / TICK_COUNT;
@@ -558,8 +684,10 @@ void osal_adjust_timers( void )
  *
  * @brief
  *
- *   Search timer table to return the lowest timeout value. If the
- *   timer list is empty, then the returned timeout will be zero.
+ *   Return the lowest timeout value. If there are no timers, then the
+ *   returned timeout will be zero. The earliest expiration is kept up
+ *   to date as timers start, and looked up in the wheel again only
+ *   after it has expired or been stopped.
  *
  * @param   none
  *
@@ -567,24 +695,35 @@ void osal_adjust_timers( void )
  *********************************************************************/
 uint32 osal_next_timeout( void )
 {
-  uint32 nextTimeout;
+  halIntState_t intState;
   osalTimerRec_t *srchTimer;
+  uint32 nextTimeout;
+  uint16 slot;
 
-  if ( timerHead != NULL )
-  {
-    // Head of the timer list
-    srchTimer = timerHead;
-    nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
 
-    // Look for the next timeout timer
-    while ( srchTimer != NULL )
+  if ( (timerCount != 0) && !timerNextValid )
+  {
+    timerNext = osal_systemClock + OSAL_TIMERS_LONGEST;
+    for ( slot = 0; slot < OSAL_TIMERS_SLOTS; slot++ )
     {
-      if (srchTimer->timeout.time32 < nextTimeout)
+      for ( srchTimer = timerSlot[slot]; srchTimer; srchTimer = srchTimer->next )
       {
-        nextTimeout = srchTimer->timeout.time32;
+        if ( (int32)(srchTimer->expire - timerNext) < 0 )
+        {
+          timerNext = srchTimer->expire;
+        }
       }
-      // Check next timer
-      srchTimer = srchTimer->next;
+    }
+    timerNextValid = TRUE;
+  }
+
+  if ( timerCount != 0 )
+  {
+    nextTimeout = OSAL_TIMERS_REACHED( timerNext ) ? 0 : (timerNext - osal_systemClock);
+    if ( nextTimeout > OSAL_TIMERS_MAX_TIMEOUT )
+    {
+      nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
     }
   }
   else
@@ -593,6 +732,8 @@ uint32 osal_next_timeout( void )
     nextTimeout = 0;
   }
 
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
   return ( nextTimeout );
 }
 #endif // POWER_SAVING || USE_ICALL
@@ -90,6 +90,11 @@ extern "C"
 /*** Interrupts ***/
 #define INTS_ALL    0xFF
 
+/*** Message Priorities ***/
+#define OSAL_MSG_PRI_NORMAL   0     // Queued behind all waiting messages
+#define OSAL_MSG_PRI_HIGH     1     // Queued behind the waiting high priority messages only
+#define OSAL_MSG_PRI_FRONT    0xFF  // Queued ahead of all waiting messages
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -159,6 +164,11 @@ extern void (*osal_eventloop_hook)(void);
    */
   extern uint8 osal_msg_push_front( uint8 destination_task, uint8 *msg_ptr );
 
+  /*
+   * Send a Task Message with a priority
+   */
+  extern uint8 osal_msg_send_pri( uint8 destination_task, uint8 *msg_ptr, uint8 pri );
+
   /*
    * Receive a Task Message
    */
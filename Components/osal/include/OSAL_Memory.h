@@ -58,16 +58,64 @@ extern "C"
   #define OSALMEM_METRICS  FALSE
 #endif
 
+#if !defined ( OSALMEM_SLABS )
+  #define OSALMEM_SLABS  FALSE
+#endif
+
+#if !defined ( OSALMEM_TRACE )
+  #define OSALMEM_TRACE  FALSE
+#endif
+
+// Flags in the size field of an allocation trace record.
+#define OSALMEM_TRACE_FREE   0x8000  // The record is a free, the size is not recorded.
+#define OSALMEM_TRACE_FAIL   0x4000  // The alloc of the recorded size returned NULL.
+#define OSALMEM_TRACE_SIZE   0x3FFF  // Mask of the size, larger sizes are recorded as the mask.
+
+// Marker records have both flags set in the size field.
+#define OSALMEM_TRACE_GAP    0xC000  // Records were dropped here, the id is how many.
+#define OSALMEM_TRACE_KICK   0xC001  // osal_mem_kick() was called here.
+
+// Block id of a failed alloc.
+#define OSALMEM_TRACE_NO_ID  0xFFFF
+
+// Number of characters at the end of the file name hashed into the site of a record.
+#define OSALMEM_TRACE_FILE_CHARS  10
+
 /*********************************************************************
  * MACROS
  */
   
 #define osal_stack_used()  OnBoard_stack_used()
 
+#if ( OSALMEM_TRACE )
+/* Hash of the last OSALMEM_TRACE_FILE_CHARS characters of the calling file name, with '\\' read
+ * as '/', which is folded to a constant by the compiler: h = h * 31 + c from the first character.
+ */
+#define OSALMEM_TRACE_IDX(n)  ((sizeof(__FILE__) > (n)) ? (sizeof(__FILE__) - (n)) : 0)
+#define OSALMEM_TRACE_CHR(n)  ((uint16)((__FILE__[OSALMEM_TRACE_IDX(n)] == '\\') ? \
+                               '/' : __FILE__[OSALMEM_TRACE_IDX(n)]))
+#define OSALMEM_TRACE_FILE    ((uint16)(((((((((OSALMEM_TRACE_CHR(11)  * 31u + \
+                                OSALMEM_TRACE_CHR(10)) * 31u + OSALMEM_TRACE_CHR(9)) * 31u + \
+                                OSALMEM_TRACE_CHR(8))  * 31u + OSALMEM_TRACE_CHR(7)) * 31u + \
+                                OSALMEM_TRACE_CHR(6))  * 31u + OSALMEM_TRACE_CHR(5)) * 31u + \
+                                OSALMEM_TRACE_CHR(4))  * 31u + OSALMEM_TRACE_CHR(3)) * 31u + \
+                                OSALMEM_TRACE_CHR(2)))
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+// One alloc or free in the allocation trace.
+typedef struct
+{
+  uint16 time;  // Low 16 bits of the OSAL system clock in msec.
+  uint16 size;  // Requested size with OSALMEM_TRACE_FAIL, OSALMEM_TRACE_FREE or a marker.
+  uint16 file;  // OSALMEM_TRACE_FILE of the caller, zero for the stack libraries.
+  uint16 line;  // Line number of the caller, zero for the stack libraries.
+  uint16 id;    // Heap offset of the block, pairs an alloc with its free.
+} osalMemTrace_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -92,6 +140,10 @@ extern "C"
 #ifdef DPRINTF_OSALHEAPTRACE
   void *osal_mem_alloc_dbg( uint16 size, const char *fname, unsigned lnum );
 #define osal_mem_alloc(_size ) osal_mem_alloc_dbg(_size, __FILE__, __LINE__)
+#elif ( OSALMEM_TRACE )
+  void *osal_mem_alloc( uint16 size );
+  void *osal_mem_alloc_site( uint16 size, uint16 file, uint16 line );
+#define osal_mem_alloc(_size ) osal_mem_alloc_site(_size, OSALMEM_TRACE_FILE, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
   void *osal_mem_alloc( uint16 size );
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -102,6 +154,10 @@ extern "C"
 #ifdef DPRINTF_OSALHEAPTRACE
   void osal_mem_free_dbg( void *ptr, const char *fname, unsigned lnum );
 #define osal_mem_free(_ptr ) osal_mem_free_dbg(_ptr, __FILE__, __LINE__)
+#elif ( OSALMEM_TRACE )
+  void osal_mem_free( void *ptr );
+  void osal_mem_free_site( void *ptr, uint16 file, uint16 line );
+#define osal_mem_free(_ptr ) osal_mem_free_site(_ptr, OSALMEM_TRACE_FILE, __LINE__)
 #else /* DPRINTF_OSALHEAPTRACE */
   void osal_mem_free( void *ptr );
 #endif /* DPRINTF_OSALHEAPTRACE */
@@ -128,6 +184,35 @@ extern "C"
   uint16 osal_heap_mem_used( void );
 #endif
 
+#if ( OSALMEM_SLABS )
+ /*
+  * Return the maximum number of blocks of a size class ever allocated at once.
+  */
+  uint8 osal_heap_slab_max( uint8 cls );
+
+ /*
+  * Return the number of allocations of a size class taken from the heap instead.
+  */
+  uint16 osal_heap_slab_miss( uint8 cls );
+#endif
+
+#if ( OSALMEM_TRACE )
+ /*
+  * Move the oldest allocation trace records out of the trace.
+  */
+  uint8 osal_mem_trace_read( osalMemTrace_t *pRec, uint8 cnt );
+
+ /*
+  * Return the number of trace records dropped because the trace was full.
+  */
+  uint16 osal_mem_trace_lost( void );
+
+ /*
+  * Stop recording allocs and frees, e.g. while the trace is being read out, or start again.
+  */
+  void osal_mem_trace_hold( uint8 hold );
+#endif
+
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
  /*
   * Return the highest number of bytes ever used in the heap.
@@ -55,6 +55,10 @@ extern "C"
  * CONSTANTS
  */
 
+#if !defined ( OSAL_NV_METRICS )
+  #define OSAL_NV_METRICS  FALSE
+#endif
+
 /*********************************************************************
  * MACROS
  */
@@ -63,6 +67,19 @@ extern "C"
  * TYPEDEFS
  */
 
+#if ( OSAL_NV_METRICS )
+// NV flash usage counters
+typedef struct
+{
+  uint32 bytesRequested;   // Item data bytes passed to osal_nv_item_init() and osal_nv_write()
+  uint32 bytesProgrammed;  // Bytes programmed into flash, including headers and compaction
+  uint32 bytesErased;      // Bytes erased
+  uint16 itemWrites;       // Item writes that changed the data in flash
+  uint16 compactions;      // Pages compacted
+  uint16 pageErases;       // NV pages erased
+} osalNvMetrics_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -101,6 +118,23 @@ extern uint16 osal_nv_item_len( uint16 id );
  */
 extern uint8 osal_nv_delete( uint16 id, uint16 len );
 
+#if ( OSAL_NV_METRICS )
+/*
+ * Get the NV flash usage counters.
+ */
+extern void osal_nv_metrics( osalNvMetrics_t *pMetrics );
+
+/*
+ * Clear the NV flash usage counters. The per-page erase counts are kept.
+ */
+extern void osal_nv_metrics_reset( void );
+
+/*
+ * Get the number of times an NV page has been erased since reset.
+ */
+extern uint16 osal_nv_page_erases( uint8 pg );
+#endif
+
 #if defined ( OSAL_NV_EXTENDED )
 /*
  * Initialize an item in NV (extended format)
@@ -159,6 +159,7 @@ extern "C"
 
 // System statistics and metrics NV ID
 #define ZCD_NV_DIAGNOSTIC_STATS           0x0050
+#define ZCD_NV_DIAGNOSTIC_JOURNAL         0x0057
 
 // Additional NWK Layer NV item IDs
 #define ZCD_NV_NWK_PARENT_INFO            0x0051
@@ -83,6 +83,24 @@
 
 #define OSAL_NV_PAGE_HDR_OFFSET 0
 
+/* RAM directory of NV item locations. OSAL_NV_DIR_SIZE bounds the RAM used; when there are
+ * more live items than entries, the least recently used entry is evicted and lookups that miss
+ * fall back to scanning the pages. A bit per hashed item Id records which Ids have been seen in
+ * flash, so that a miss on an Id that was never seen still returns without a scan.
+ */
+#if !defined OSAL_NV_DIR_SIZE
+  #define OSAL_NV_DIR_SIZE      32
+#endif
+#if (OSAL_NV_DIR_SIZE > 254)
+#error OSAL_NV_DIR_SIZE must fit an 8-bit entry index.
+#endif
+#define OSAL_NV_DIR_BUCKETS     16  // Must be a power of 2
+#define OSAL_NV_DIR_NULL        0xFF
+#define OSAL_NV_DIR_SEEN_SIZE   32  // Bytes of the seen Id bit map, indexed by an 8-bit hash
+#define OSAL_NV_DIR_SEEN_IDX(ID)  ((uint8)((ID) ^ ((ID) >> 8)))
+#define OSAL_NV_DIR_SEEN(ID)  \
+  (dirSeen[OSAL_NV_DIR_SEEN_IDX(ID) >> 3] & (1 << (OSAL_NV_DIR_SEEN_IDX(ID) & 7)))
+
 #define OSAL_NV_MAX_HOT         3
 static const uint16 hotIds[OSAL_NV_MAX_HOT] = {
   ZCD_NV_NWKKEY,
@@ -108,6 +126,15 @@ static const uint16 hotIds[OSAL_NV_MAX_HOT] = {
              ((uint16)(65536UL - OSAL_NV_WORD_SIZE))  : \
              ((((LEN) + OSAL_NV_WORD_SIZE - 1) / OSAL_NV_WORD_SIZE) * OSAL_NV_WORD_SIZE))
 
+#if ( OSAL_NV_METRICS )
+#define OSAL_NV_METRIC_ADD( FIELD, CNT )  (nvMetrics.FIELD += (CNT))
+#else
+#define OSAL_NV_METRIC_ADD( FIELD, CNT )
+#endif
+
+#define OSAL_NV_DIR_HASH( ID )  \
+  ((uint8)((ID) ^ ((ID) >> 8)) & (OSAL_NV_DIR_BUCKETS - 1))
+
 #define OSAL_NV_ITEM_SIZE( LEN )                                         \
   (((LEN) >= ((uint16)(65536UL - OSAL_NV_WORD_SIZE - OSAL_NV_HDR_SIZE))) ? \
              ((uint16)(65536UL - OSAL_NV_WORD_SIZE))                     : \
@@ -168,6 +195,15 @@ typedef enum
   eNvZero
 } eNvHdrEnum;
 
+typedef struct
+{
+  uint16 id;
+  uint16 off;    // Offset of the item data
+  uint16 stamp;  // Time of last use, for LRU eviction
+  uint8  pg;
+  uint8  next;   // Next entry in the hash chain or in the free list
+} osalNvDirEnt_t;
+
 typedef enum
 {
   ePgActive,
@@ -207,6 +243,25 @@ static uint8 findPg;
 static uint8 hotPg[OSAL_NV_MAX_HOT];
 static uint16 hotOff[OSAL_NV_MAX_HOT];
 
+#if ( OSAL_NV_METRICS )
+static osalNvMetrics_t nvMetrics;
+static uint16 pgErases[OSAL_NV_PAGES_USED];
+#endif
+
+// Directory of item locations, hashed by item Id.
+static osalNvDirEnt_t dirEnt[OSAL_NV_DIR_SIZE];
+static uint8 dirHash[OSAL_NV_DIR_BUCKETS];
+static uint8 dirFree;
+static uint16 dirClock;
+
+// TRUE while every live item has a directory entry, so that a directory miss means
+// the item does not exist.
+static uint8 dirComplete;
+
+// Bit map of the hashed Ids of every item seen in flash since the directory was built. Bits are
+// never cleared, so a clear bit means the item does not exist even after entries are evicted.
+static uint8 dirSeen[OSAL_NV_DIR_SEEN_SIZE];
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -236,6 +291,13 @@ static uint8  writeItem( uint8 pg, uint16 id, uint16 len, void *buf, uint8 flag
 static uint8  hotItem(uint16 id);
 static void   hotItemUpdate(uint8 pg, uint16 off, uint16 id);
 
+static void   dirInit( void );
+static void   dirScanPage( uint8 pg, uint8 srcItems );
+static uint8  dirFind( uint16 id );
+static void   dirRemove( uint16 id );
+static void   dirUpdate( uint8 pg, uint16 off, uint16 id );
+static void   dirDropPage( uint8 pg );
+
 /*********************************************************************
  * @fn      initNV
  *
@@ -253,6 +315,7 @@ static uint8 initNV( void )
   uint8 pg;
 
   pgRes = OSAL_NV_PAGE_NULL;
+  dirInit();
 
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
@@ -352,6 +415,29 @@ static uint8 initNV( void )
     erasePage( pgRes );  // The last page erase had been interrupted by a power-cycle.
   }
 
+  /* Build the item directory: current copies first, then the source copies left by writes
+   * that were interrupted before the new copy was made.
+   */
+  dirComplete = TRUE;
+  for ( pg = 0; pg < OSAL_NV_DIR_SEEN_SIZE; pg++ )
+  {
+    dirSeen[pg] = 0;
+  }
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    if ( pg != pgRes )
+    {
+      dirScanPage( pg, FALSE );
+    }
+  }
+  for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
+  {
+    if ( pg != pgRes )
+    {
+      dirScanPage( pg, TRUE );
+    }
+  }
+
   return TRUE;
 }
 
@@ -509,6 +595,14 @@ static void erasePage( uint8 pg )
 
   pgOff[pg - OSAL_NV_PAGE_BEG] = OSAL_NV_PAGE_HDR_SIZE;
   pgLost[pg - OSAL_NV_PAGE_BEG] = 0;
+
+#if ( OSAL_NV_METRICS )
+  pgErases[pg - OSAL_NV_PAGE_BEG]++;
+  nvMetrics.pageErases++;
+  nvMetrics.bytesErased += OSAL_NV_PAGE_SIZE;
+#endif
+
+  dirDropPage( pg );
 }
 
 /*********************************************************************
@@ -557,6 +651,8 @@ static uint8 compactPage( uint8 srcPg, uint16 skipId )
   srcOff = OSAL_NV_PAGE_HDR_SIZE;
   rtrn = TRUE;
 
+  OSAL_NV_METRIC_ADD( compactions, 1 );
+
   while ( srcOff < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE ) )
   {
     osalNvHdr_t hdr;
@@ -663,11 +759,42 @@ static uint16 findItem( uint16 id )
   uint16 off;
   uint8 pg;
 
+  if ( (id & OSAL_NV_SOURCE_ID) == 0 )
+  {
+    uint8 idx = dirFind( id );
+
+    if ( idx != OSAL_NV_DIR_NULL )
+    {
+      osalNvHdr_t hdr;
+
+      // Only trust the entry if the header there still holds the live item.
+      HalFlashRead(dirEnt[idx].pg, (dirEnt[idx].off - OSAL_NV_HDR_SIZE), (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+      if ( hdr.id == id )
+      {
+        dirEnt[idx].stamp = dirClock++;
+        findPg = dirEnt[idx].pg;
+        return dirEnt[idx].off;
+      }
+
+      dirRemove( id );
+    }
+
+    if ( dirComplete || !OSAL_NV_DIR_SEEN( id ) )
+    {
+      findPg = OSAL_NV_PAGE_NULL;
+      return OSAL_NV_ITEM_NULL;
+    }
+  }
+
   for ( pg = OSAL_NV_PAGE_BEG; pg <= OSAL_NV_PAGE_END; pg++ )
   {
     if ( (off = initPage( pg, id, FALSE )) != OSAL_NV_ITEM_NULL )
     {
       findPg = pg;
+      if ( (id & OSAL_NV_SOURCE_ID) == 0 )
+      {
+        dirUpdate( pg, off, id );
+      }
       return off;
     }
   }
@@ -675,7 +802,11 @@ static uint16 findItem( uint16 id )
   // Now attempt to find the item as the "old" item of a failed/interrupted NV write.
   if ( (id & OSAL_NV_SOURCE_ID) == 0 )
   {
-    return findItem( id | OSAL_NV_SOURCE_ID );
+    if ( (off = findItem( id | OSAL_NV_SOURCE_ID )) != OSAL_NV_ITEM_NULL )
+    {
+      dirUpdate( findPg, off, id );
+    }
+    return off;
   }
   else
   {
@@ -925,6 +1056,7 @@ static void writeWord( uint8 pg, uint16 offset, uint8 *buf )
   offset = (offset / HAL_FLASH_WORD_SIZE) +
           ((uint16)pg * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE));
 
+  OSAL_NV_METRIC_ADD( bytesProgrammed, OSAL_NV_WORD_SIZE );
   HalFlashWrite(offset, buf, 1);
 }
 
@@ -944,6 +1076,7 @@ static void writeWordM( uint8 pg, uint16 offset, uint8 *buf, uint16 cnt )
 {
   offset = (offset / HAL_FLASH_WORD_SIZE) +
           ((uint16)pg * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE));
+  OSAL_NV_METRIC_ADD( bytesProgrammed, ((uint32)cnt * OSAL_NV_WORD_SIZE) );
   HalFlashWrite(offset, buf, cnt);
 }
 
@@ -1193,6 +1326,239 @@ static void hotItemUpdate(uint8 pg, uint16 off, uint16 id)
       hotOff[hotIdx] = off;
     }
   }
+
+  // Every item (re)location passes through here, so keep the directory current as well.
+  dirUpdate(pg, off, id);
+}
+
+/*********************************************************************
+ * @fn      dirInit
+ *
+ * @brief   Empty the item directory.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void dirInit( void )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < OSAL_NV_DIR_BUCKETS; idx++ )
+  {
+    dirHash[idx] = OSAL_NV_DIR_NULL;
+  }
+
+  dirFree = OSAL_NV_DIR_NULL;
+  for ( idx = 0; idx < OSAL_NV_DIR_SIZE; idx++ )
+  {
+    dirEnt[idx].next = dirFree;
+    dirFree = idx;
+  }
+
+  dirClock = 0;
+  dirComplete = FALSE;
+
+  // Until the pages have been scanned, any Id may exist.
+  for ( idx = 0; idx < OSAL_NV_DIR_SEEN_SIZE; idx++ )
+  {
+    dirSeen[idx] = 0xFF;
+  }
+}
+
+/*********************************************************************
+ * @fn      dirScanPage
+ *
+ * @brief   Walk the page items and enter the live ones into the directory.
+ *
+ * @param   pg - Valid NV page.
+ * @param   srcItems - FALSE to enter the current copies of items.
+ *                     TRUE to enter the "old" source copies of items that have no current copy.
+ *
+ * @return  none
+ */
+static void dirScanPage( uint8 pg, uint8 srcItems )
+{
+  uint16 offset = OSAL_NV_PAGE_HDR_SIZE;
+  uint16 sz;
+  osalNvHdr_t hdr;
+
+  while ( offset < (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE) )
+  {
+    HalFlashRead(pg, offset, (uint8 *)(&hdr), OSAL_NV_HDR_SIZE);
+
+    if ( hdr.id == OSAL_NV_ERASED_ID )
+    {
+      break;
+    }
+
+    sz = OSAL_NV_DATA_SIZE( hdr.len );
+    if ( sz > (OSAL_NV_PAGE_SIZE - OSAL_NV_HDR_SIZE - offset) )
+    {
+      break;
+    }
+
+    offset += OSAL_NV_HDR_SIZE;
+
+    if ( hdr.id != OSAL_NV_ZEROED_ID )
+    {
+      if ( srcItems == FALSE )
+      {
+        if ( hdr.stat == OSAL_NV_ERASED_ID )
+        {
+          dirUpdate( pg, offset, hdr.id );
+        }
+      }
+      // A complete directory or a clear seen bit proves that no current copy exists.
+      else if ( (hdr.stat != OSAL_NV_ERASED_ID) && (dirFind( hdr.id ) == OSAL_NV_DIR_NULL) &&
+                (dirComplete || !OSAL_NV_DIR_SEEN( hdr.id )) )
+      {
+        dirUpdate( pg, offset, hdr.id );
+      }
+    }
+
+    offset += sz;
+  }
+}
+
+/*********************************************************************
+ * @fn      dirFind
+ *
+ * @brief   Look for an item Id in the directory.
+ *
+ * @param   id - Valid NV item Id.
+ *
+ * @return  Index of the directory entry, OSAL_NV_DIR_NULL if not found.
+ */
+static uint8 dirFind( uint16 id )
+{
+  uint8 idx = dirHash[OSAL_NV_DIR_HASH( id )];
+
+  while ( (idx != OSAL_NV_DIR_NULL) && (dirEnt[idx].id != id) )
+  {
+    idx = dirEnt[idx].next;
+  }
+
+  return idx;
+}
+
+/*********************************************************************
+ * @fn      dirRemove
+ *
+ * @brief   Remove an item Id from the directory.
+ *
+ * @param   id - Valid NV item Id.
+ *
+ * @return  none
+ */
+static void dirRemove( uint16 id )
+{
+  uint8 *pIdx = &dirHash[OSAL_NV_DIR_HASH( id )];
+
+  while ( *pIdx != OSAL_NV_DIR_NULL )
+  {
+    uint8 idx = *pIdx;
+
+    if ( dirEnt[idx].id == id )
+    {
+      *pIdx = dirEnt[idx].next;
+      dirEnt[idx].next = dirFree;
+      dirFree = idx;
+      break;
+    }
+
+    pIdx = &dirEnt[idx].next;
+  }
+}
+
+/*********************************************************************
+ * @fn      dirUpdate
+ *
+ * @brief   Record the location of an item, evicting the least recently used entry
+ *          if the directory is full.
+ *
+ * @param   pg - The NV page of the item.
+ * @param   off - The NV page offset of the item data.
+ * @param   id - A valid NV item Id.
+ *
+ * @return  none
+ */
+static void dirUpdate( uint8 pg, uint16 off, uint16 id )
+{
+  uint8 idx = dirFind( id );
+
+  dirSeen[OSAL_NV_DIR_SEEN_IDX( id ) >> 3] |= (1 << (OSAL_NV_DIR_SEEN_IDX( id ) & 7));
+
+  if ( idx == OSAL_NV_DIR_NULL )
+  {
+    if ( dirFree == OSAL_NV_DIR_NULL )
+    {
+      uint16 age, oldest = 0;
+      uint8 lru = 0;
+
+      for ( idx = 0; idx < OSAL_NV_DIR_SIZE; idx++ )
+      {
+        age = dirClock - dirEnt[idx].stamp;
+        if ( age >= oldest )
+        {
+          oldest = age;
+          lru = idx;
+        }
+      }
+
+      dirRemove( dirEnt[lru].id );
+
+      // Misses can no longer be trusted to mean that an item does not exist.
+      dirComplete = FALSE;
+    }
+
+    idx = dirFree;
+    dirFree = dirEnt[idx].next;
+
+    dirEnt[idx].id = id;
+    dirEnt[idx].next = dirHash[OSAL_NV_DIR_HASH( id )];
+    dirHash[OSAL_NV_DIR_HASH( id )] = idx;
+  }
+
+  dirEnt[idx].pg = pg;
+  dirEnt[idx].off = off;
+  dirEnt[idx].stamp = dirClock++;
+}
+
+/*********************************************************************
+ * @fn      dirDropPage
+ *
+ * @brief   Remove the entries of a page that is being erased.
+ *
+ * @param   pg - Valid NV page.
+ *
+ * @return  none
+ */
+static void dirDropPage( uint8 pg )
+{
+  uint8 idx;
+
+  for ( idx = 0; idx < OSAL_NV_DIR_SIZE; idx++ )
+  {
+    if ( dirEnt[idx].pg == pg )
+    {
+      uint8 *pIdx = &dirHash[OSAL_NV_DIR_HASH( dirEnt[idx].id )];
+
+      // Entries on the free list are not in any hash chain.
+      while ( (*pIdx != OSAL_NV_DIR_NULL) && (*pIdx != idx) )
+      {
+        pIdx = &dirEnt[*pIdx].next;
+      }
+
+      if ( *pIdx == idx )
+      {
+        dirRemove( dirEnt[idx].id );
+
+        // A live item may still be on the page, as when a compaction is aborted.
+        dirComplete = FALSE;
+      }
+    }
+  }
 }
 
 /*********************************************************************
@@ -1243,6 +1609,7 @@ uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
   }
   else if ( initItem( TRUE, id, len, buf ) != OSAL_NV_PAGE_NULL )
   {
+    OSAL_NV_METRIC_ADD( bytesRequested, len );
     return NV_ITEM_UNINIT;
   }
   else
@@ -1322,6 +1689,8 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
       return NV_OPER_FAILED;
     }
 
+    OSAL_NV_METRIC_ADD( bytesRequested, len );
+
     srcOff += ndx;
     ptr = buf;
     cnt = len;
@@ -1346,6 +1715,8 @@ uint8 osal_nv_write( uint16 id, uint16 ndx, uint16 len, void *buf )
       uint8 comPg = OSAL_NV_PAGE_NULL;
       uint8 dstPg = initItem( FALSE, id, hdr.len, &comPg );
 
+      OSAL_NV_METRIC_ADD( itemWrites, 1 );
+
       if ( dstPg != OSAL_NV_PAGE_NULL )
       {
         uint16 tmp = OSAL_NV_DATA_SIZE( hdr.len );
@@ -1509,5 +1880,56 @@ uint8 osal_nv_delete( uint16 id, uint16 len )
   }
 }
 
+#if ( OSAL_NV_METRICS )
+/*********************************************************************
+ * @fn      osal_nv_metrics
+ *
+ * @brief   Copy the NV flash usage counters.
+ *
+ * @param   pMetrics - Buffer to receive the counters.
+ *
+ * @return  none
+ */
+void osal_nv_metrics( osalNvMetrics_t *pMetrics )
+{
+  *pMetrics = nvMetrics;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_metrics_reset
+ *
+ * @brief   Clear the NV flash usage counters, except the per-page erase counts.
+ *          All of the counters are kept in RAM only, so they also restart from
+ *          zero on every power-up or reset.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+void osal_nv_metrics_reset( void )
+{
+  nvMetrics.bytesRequested = 0;
+  nvMetrics.bytesProgrammed = 0;
+  nvMetrics.bytesErased = 0;
+  nvMetrics.itemWrites = 0;
+  nvMetrics.compactions = 0;
+  nvMetrics.pageErases = 0;
+}
+
+/*********************************************************************
+ * @fn      osal_nv_page_erases
+ *
+ * @brief   Get the number of times an NV page has been erased since reset.
+ *
+ * @param   pg - NV page number, 0 to OSAL_NV_PAGES_USED-1.
+ *
+ * @return  Erase count, or zero if 'pg' is out of range.
+ */
+uint16 osal_nv_page_erases( uint8 pg )
+{
+  return ( pg < OSAL_NV_PAGES_USED ) ? pgErases[pg] : 0;
+}
+#endif
+
 /*********************************************************************
  */
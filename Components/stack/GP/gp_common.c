@@ -67,6 +67,22 @@
 
 #define PGG_COMMISSIONING_WINDOW   180  //180 seconds by defaut
 
+// Number of GPDFs remembered for duplicate filtering, must be a power of 2
+#if !defined ( GP_DUPLICATE_CACHE_SIZE )
+  #define GP_DUPLICATE_CACHE_SIZE  16
+#endif
+
+// Number of entries a GPDF can be remembered in
+#define GP_DUPLICATE_CACHE_WAYS    2
+
+#if ( (GP_DUPLICATE_CACHE_SIZE / GP_DUPLICATE_CACHE_WAYS) == 0 ) || \
+    ( (GP_DUPLICATE_CACHE_SIZE / GP_DUPLICATE_CACHE_WAYS) > 256 ) || \
+    ( ((GP_DUPLICATE_CACHE_SIZE / GP_DUPLICATE_CACHE_WAYS) & \
+       ((GP_DUPLICATE_CACHE_SIZE / GP_DUPLICATE_CACHE_WAYS) - 1)) != 0 ) || \
+    ( (GP_DUPLICATE_CACHE_SIZE % GP_DUPLICATE_CACHE_WAYS) != 0 )
+  #error "GP_DUPLICATE_CACHE_SIZE must be GP_DUPLICATE_CACHE_WAYS times a power of 2 up to 256"
+#endif
+
 
 #ifdef GP_SHARED_KEY
   CONFIG_ITEM uint8 zgpSharedKey[SEC_KEY_LEN] = GP_SHARED_KEY;
@@ -77,6 +93,15 @@
 /*********************************************************************
  * TYPEDEFS
  */
+
+// Duplicate filtering cache entry
+typedef struct
+{
+  gpd_ID_t gpd_ID;
+  uint32   counter;   // MAC sequence number, or GPD security frame counter
+  uint32   expiry;    // System clock when the entry expires
+  uint8    handle;    // dGP stub handle of the first GPDF received
+} gpDuplicateEntry_t;
    
  /*********************************************************************
  * GLOBAL VARIABLES
@@ -309,6 +334,10 @@ static SimpleDescriptionFormat_t greenPower_EP_SimpleDesc =
   (cId_t *)greenPower_EP_OutClusterList  //  byte *pAppInClusterList;
 };
 
+// Duplicate filtering cache, the set of entries is selected by a hash of
+// the GPD ID and counter
+static gpDuplicateEntry_t gp_DuplicateCache[GP_DUPLICATE_CACHE_SIZE];
+
 
 
 
@@ -328,7 +357,11 @@ static void gp_u8CastPointer( uint8 *data, uint8 *p );
 static void gp_ZclPairingParse( zclGpPairing_t* pCmd, gpPairingCmd_t* payload );
 static void gp_ZclProxyTableReqParse( zclGpProxyTableRequest_t* pCmd, gpProxyTableReqCmd_t* payload );
 static uint8 gp_SecurityOperationProxy( gp_DataInd_t* pInd, uint8* pKeyType, uint8* pKey);
-static gp_DataInd_t* gp_DataIndFindDuplicate(uint8 handle, uint8 secLvl);
+static void gp_DataIndGetGpdId(gp_DataInd_t *gp_DataInd, gpd_ID_t *gpd_ID);
+static gpDuplicateEntry_t* gp_DuplicateCacheSet(gpd_ID_t *gpd_ID, uint32 counter);
+static gpDuplicateEntry_t* gp_DuplicateCacheFind(gpDuplicateEntry_t *pSet, gpd_ID_t *gpd_ID, uint32 counter);
+static void gp_DuplicateCacheAdd(gp_DataInd_t *gp_DataInd);
+static bool gp_DataIndFindDuplicate(uint8 handle);
 static uint8 GP_RecoveryKey(uint8 GPDFKeyType,uint8 KeyType, uint8 status, uint8 *Key);
  
 
@@ -1741,15 +1774,9 @@ uint8 GP_DataInd(gp_DataInd_t *gp_DataInd)
     osal_start_timerEx(gp_TaskID,GP_DUPLICATE_FILTERING_TIMEOUT_EVENT,gp_DataInd->SecReqHandling.timeout);
   }  
 
-  gpd_ID.AppID = gp_DataInd->appID;
-  if(gp_DataInd->appID == GP_OPT_APP_ID_IEEE)
-  {
-    osal_memcpy(gpd_ID.GPDId.GPDExtAddr, gp_DataInd->srcAddr.addr.extAddr, Z_EXTADDR_LEN);
-  }
-  else
-  {
-    gpd_ID.GPDId.SrcID = gp_DataInd->SrcId;
-  }
+  gp_DuplicateCacheAdd(gp_DataInd);
+
+  gp_DataIndGetGpdId(gp_DataInd, &gpd_ID);
 
   if(gp_getProxyTableByGpId(&gpd_ID,ProxyTableEntryTemp,&ProxyTableEntryIndex) == ZSuccess)
   {
@@ -1876,7 +1903,7 @@ uint8 GP_SecReq(gp_SecReq_t *gp_SecReq)
   gp_SecRsp->Status = GP_SEC_RSP_DROP_FRAME;
  
   //Find duplicates A.3.6.1.2 Duplicate filtering
-  if( gp_DataIndFindDuplicate(gp_SecReq->dGPStubHandle, gp_SecReq->gp_SecData.GPDFSecLvl) )
+  if( gp_DataIndFindDuplicate(gp_SecReq->dGPStubHandle) )
   {  //Check if the entry exist
     if ( gp_getProxyTableByGpId(&gp_SecReq->gpd_ID, ProxyTableEntryTemp, NULL) == ZSuccess )
     {
@@ -2001,41 +2028,164 @@ uint8 GP_RecoveryKey(uint8 GPDFKeyType,uint8 KeyType, uint8 status, uint8 *Key)
 }
 
 
-gp_DataInd_t* gp_DataIndFindDuplicate(uint8 handle, uint8 secLvl)
+/*********************************************************************
+ * @fn          gp_DataIndGetGpdId
+ *
+ * @brief       Get the GPD ID of the sender of a GPDF
+ *
+ * @param       gp_DataInd - GPDF received
+ * @param       gpd_ID - GPD ID to fill
+ *
+ * @return      none
+ */
+static void gp_DataIndGetGpdId(gp_DataInd_t *gp_DataInd, gpd_ID_t *gpd_ID)
 {
-  gp_DataInd_t* temp;
-  gp_DataInd_t* tempList;
-  temp = gp_DataIndGet(handle);
-  
-  if(temp != NULL)
+  osal_memset(gpd_ID, 0, sizeof(gpd_ID_t));
+
+  gpd_ID->AppID = gp_DataInd->appID;
+  if(gp_DataInd->appID == GP_OPT_APP_ID_IEEE)
   {
-    tempList = gp_DataIndList;
-    
-    while(tempList != NULL)
+    osal_memcpy(gpd_ID->GPDId.GPDExtAddr, gp_DataInd->srcAddr.addr.extAddr, Z_EXTADDR_LEN);
+  }
+  else
+  {
+    gpd_ID->GPDId.SrcID = gp_DataInd->SrcId;
+  }
+}
+
+/*********************************************************************
+ * @fn          gp_DuplicateCacheSet
+ *
+ * @brief       Get the set of duplicate filtering cache entries a GPDF
+ *              with this GPD ID and counter can be remembered in.
+ *
+ * @param       gpd_ID - GPD ID of the GPDF
+ * @param       counter - MAC sequence number or security frame counter
+ *
+ * @return      first entry of the set
+ */
+static gpDuplicateEntry_t* gp_DuplicateCacheSet(gpd_ID_t *gpd_ID, uint32 counter)
+{
+  uint8 *pId = gpd_ID->GPDId.GPDExtAddr;
+  uint8 len = (gpd_ID->AppID == GP_OPT_APP_ID_IEEE) ? Z_EXTADDR_LEN : sizeof(uint32);
+  uint8 hash = gpd_ID->AppID;
+
+  while(len--)
+  {
+    hash = (uint8)((hash << 1) | (hash >> 7)) ^ *pId++;
+  }
+
+  //Fold the counter in last, it is what changes between GPDFs of a GPD
+  hash ^= (uint8)counter ^ (uint8)(counter >> 8);
+  hash ^= (hash >> 4);
+
+  hash &= (GP_DUPLICATE_CACHE_SIZE / GP_DUPLICATE_CACHE_WAYS) - 1;
+
+  return &gp_DuplicateCache[hash * GP_DUPLICATE_CACHE_WAYS];
+}
+
+/*********************************************************************
+ * @fn          gp_DuplicateCacheFind
+ *
+ * @brief       Find the entry, not expired, remembering a GPDF
+ *
+ * @param       pSet - set of entries the GPDF can be remembered in
+ * @param       gpd_ID - GPD ID of the GPDF
+ * @param       counter - MAC sequence number or security frame counter
+ *
+ * @return      cache entry, NULL if not found
+ */
+static gpDuplicateEntry_t* gp_DuplicateCacheFind(gpDuplicateEntry_t *pSet, gpd_ID_t *gpd_ID, uint32 counter)
+{
+  uint32 now = osal_GetSystemClock();
+  uint8 i;
+
+  for(i = 0; i < GP_DUPLICATE_CACHE_WAYS; i++, pSet++)
+  {
+    if(((int32)(pSet->expiry - now) > 0) && (pSet->counter == counter) &&
+       osal_memcmp(&pSet->gpd_ID, gpd_ID, sizeof(gpd_ID_t)))
     {
-      //search for MAC seq num
-      if(secLvl == 0)
-      {
-        if((temp->SeqNumber == tempList->SeqNumber) && (temp->appID == tempList->appID)&&
-           (temp->SecReqHandling.dGPStubHandle != tempList->SecReqHandling.dGPStubHandle))
-        {
-          break;
-        }
-      }
-      //Other secLevels uses SecFrameCounter
-      else
-      {
-        if((temp->GPDSecFrameCounter == tempList->GPDSecFrameCounter) && 
-           (temp->SecReqHandling.dGPStubHandle != tempList->SecReqHandling.dGPStubHandle))
-        {
-          
-          break;
-        }
-      }
-      tempList = tempList->SecReqHandling.next;
+      return pSet;
     }
   }
-  return tempList;
+
+  return NULL;
+}
+
+/*********************************************************************
+ * @fn          gp_DuplicateCacheAdd
+ *
+ * @brief       Remember a GPDF for duplicate filtering. The first GPDF
+ *              received is kept until it expires. If the set is full, the
+ *              entry closest to expire is replaced.
+ *
+ * @param       gp_DataInd - GPDF received
+ *
+ * @return      none
+ */
+static void gp_DuplicateCacheAdd(gp_DataInd_t *gp_DataInd)
+{
+  gpd_ID_t gpd_ID;
+  gpDuplicateEntry_t *pSet;
+  gpDuplicateEntry_t *pEntry;
+  uint32 counter;
+  uint8 i;
+
+  //Security level 0 uses the MAC seq num, other levels use SecFrameCounter
+  counter = (gp_DataInd->GPDFSecLvl == 0) ? gp_DataInd->SeqNumber : gp_DataInd->GPDSecFrameCounter;
+
+  gp_DataIndGetGpdId(gp_DataInd, &gpd_ID);
+  pSet = gp_DuplicateCacheSet(&gpd_ID, counter);
+
+  if(gp_DuplicateCacheFind(pSet, &gpd_ID, counter) != NULL)
+  {
+    return;
+  }
+
+  pEntry = pSet;
+  for(i = 1; i < GP_DUPLICATE_CACHE_WAYS; i++)
+  {
+    if((int32)(pSet[i].expiry - pEntry->expiry) < 0)
+    {
+      pEntry = &pSet[i];
+    }
+  }
+
+  osal_memcpy(&pEntry->gpd_ID, &gpd_ID, sizeof(gpd_ID_t));
+  pEntry->counter = counter;
+  pEntry->expiry = osal_GetSystemClock() + gpDuplicateTimeout;
+  pEntry->handle = gp_DataInd->SecReqHandling.dGPStubHandle;
+}
+
+/*********************************************************************
+ * @fn          gp_DataIndFindDuplicate
+ *
+ * @brief       Check if a GPDF is a duplicate of a GPDF received before
+ *              (A.3.6.1.2 Duplicate filtering)
+ *
+ * @param       handle - dGP stub handle of the GPDF
+ *
+ * @return      TRUE if the GPDF is a duplicate, FALSE otherwise
+ */
+static bool gp_DataIndFindDuplicate(uint8 handle)
+{
+  gp_DataInd_t* temp;
+  gpd_ID_t gpd_ID;
+  gpDuplicateEntry_t *pEntry;
+  uint32 counter;
+
+  temp = gp_DataIndGet(handle);
+  if(temp == NULL)
+  {
+    return FALSE;
+  }
+
+  counter = (temp->GPDFSecLvl == 0) ? temp->SeqNumber : temp->GPDSecFrameCounter;
+
+  gp_DataIndGetGpdId(temp, &gpd_ID);
+  pEntry = gp_DuplicateCacheFind(gp_DuplicateCacheSet(&gpd_ID, counter), &gpd_ID, counter);
+
+  return ((pEntry != NULL) && (pEntry->handle != handle));
 }
  
 /*********************************************************************
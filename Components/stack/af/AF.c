@@ -111,6 +111,10 @@ static epList_t *afFindEndPointDescList( uint8 EndPoint );
 
 static pDescCB afGetDescCB( endPointDesc_t *epDesc );
 
+#if !defined ( APS_NO_GROUPS )
+static apsGroupItem_t *afFindGroupItem( apsGroupItem_t *pItem, uint16 groupID );
+#endif
+
 /*********************************************************************
  * PUBLIC FUNCTIONS
  */
@@ -158,7 +162,7 @@ epList_t *afRegisterExtended( endPointDesc_t *epDesc, pDescCB descFn, pApplCB ap
     
   #if (BDB_FINDING_BINDING_CAPABILITY_ENABLED==1) 
     //Make sure we add at least one application endpoint
-    if ((epDesc->endPoint != 0)  || (epDesc->endPoint < BDB_ZIGBEE_RESERVED_ENDPOINTS_START))
+    if ((epDesc->endPoint != 0)  && (epDesc->endPoint < BDB_ZIGBEE_RESERVED_ENDPOINTS_START))
     {
       bdb_HeadEpDescriptorList = epList;
       ep->epDesc->epType = bdb_zclFindingBindingEpType(ep->epDesc);
@@ -397,18 +401,19 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
   endPointDesc_t *epDesc = NULL;
   epList_t *pList = epList;
 #if !defined ( APS_NO_GROUPS )
-  uint8 grpEp = APS_GROUPS_EP_NOT_FOUND;
+  apsGroupItem_t *pGrp = NULL;
 #endif
 
   if ( ((aff->FrmCtrl & APS_DELIVERYMODE_MASK) == APS_FC_DM_GROUP) )
   {
 #if !defined ( APS_NO_GROUPS )
-    // Find the first endpoint for this group
-    grpEp = aps_FindGroupForEndpoint( aff->GroupID, APS_GROUPS_FIND_FIRST );
-    if ( grpEp == APS_GROUPS_EP_NOT_FOUND )
+    // Find the first endpoint for this group. The group table is walked
+    // once for all the endpoints, rather than once per endpoint.
+    pGrp = afFindGroupItem( apsGroupTable, aff->GroupID );
+    if ( pGrp == NULL )
       return;   // No endpoint found
 
-    epDesc = afFindEndPointDesc( grpEp );
+    epDesc = afFindEndPointDesc( pGrp->endpoint );
     if ( epDesc == NULL )
       return;   // Endpoint descriptor not found
 
@@ -474,11 +479,11 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
     {
 #if !defined ( APS_NO_GROUPS )
       // Find the next endpoint for this group
-      grpEp = aps_FindGroupForEndpoint( aff->GroupID, grpEp );
-      if ( grpEp == APS_GROUPS_EP_NOT_FOUND )
+      pGrp = afFindGroupItem( pGrp->next, aff->GroupID );
+      if ( pGrp == NULL )
         return;   // No endpoint found
 
-      epDesc = afFindEndPointDesc( grpEp );
+      epDesc = afFindEndPointDesc( pGrp->endpoint );
       if ( epDesc == NULL )
         return;   // Endpoint descriptor not found
 
@@ -897,6 +902,32 @@ static epList_t *afFindEndPointDescList( uint8 EndPoint )
   return epSearch;
 }
 
+#if !defined ( APS_NO_GROUPS )
+/*********************************************************************
+ * @fn      afFindGroupItem
+ *
+ * @brief   Find the next group table item for a group ID.
+ *
+ * @param   pItem - group table item to start the search at
+ * @param   groupID - group ID to look for
+ *
+ * @return  pointer to group table item, NULL if not found
+ */
+static apsGroupItem_t *afFindGroupItem( apsGroupItem_t *pItem, uint16 groupID )
+{
+  while ( pItem != NULL )
+  {
+    if ( pItem->group.ID == groupID )
+    {
+      break;
+    }
+    pItem = pItem->next;
+  }
+
+  return ( pItem );
+}
+#endif
+
 /*********************************************************************
  * @fn      afFindEndPointDesc
  *
@@ -481,34 +481,41 @@ void bdb_RepProcessEvent( void )
  * @return  TRUE if conditions are meet (attr found, memory available, etc.),
  *          FALSE if not
  */
-uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
+uint8 bdb_ProcessInConfigReportCmd( zclIncoming_t *pInMsg )
 {
-  zclCfgReportCmd_t *cfgReportCmd;
-  zclCfgReportRec_t *reportRec;
+  zclParseCmd_t parseCmd;
+  zclCfgReportRec_t rec;
+  zclCfgReportRec_t *reportRec = &rec;
   zclCfgReportRspCmd_t *cfgReportRspCmd;
   zclAttrRec_t attrRec;
   uint8 status = ZCL_STATUS_SUCCESS;
-  uint8 i;
+  uint8 numAttr = 0;
   uint8 iNumRspRecords;
 
   // Find Ep Descriptor
-  endPointDesc_t* epDescriptor = bdb_FindEpDesc( pInMsg->endPoint );
+  endPointDesc_t* epDescriptor = bdb_FindEpDesc( pInMsg->msg->endPoint );
   if( epDescriptor == NULL )
   {
     return ( FALSE );
   }
   
-  // get a pointer to the report configuration record
-  cfgReportCmd = (zclCfgReportCmd_t *)pInMsg->attrCmd;
+  // The report configuration records are read in place from the command
+  parseCmd.endpoint = pInMsg->msg->endPoint;
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+  while ( zclParseNextCfgReportRec( &parseCmd, reportRec ) )
+  {
+    numAttr++;
+  }
   
-  if( cfgReportCmd->numAttr == 0 )
+  if( numAttr == 0 )
   {
     return ( FALSE );
   }
   
   // Allocate space for the response command
   cfgReportRspCmd = (zclCfgReportRspCmd_t *)osal_mem_alloc( sizeof ( zclCfgReportRspCmd_t ) + 
-                                                            ( cfgReportCmd->numAttr * sizeof ( zclCfgReportStatus_t) ) );
+                                                            ( numAttr * sizeof ( zclCfgReportStatus_t) ) );
   if ( cfgReportRspCmd == NULL )
   {
     return ( FALSE );
@@ -528,14 +535,14 @@ uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
   // Process each Attribute Reporting Configuration record
   uint8 confchanged = BDBREPORTING_FALSE;
   iNumRspRecords = 0;
-  for ( i = 0; i < cfgReportCmd->numAttr; i++ )
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+  while ( zclParseNextCfgReportRec( &parseCmd, reportRec ) )
   {
-    reportRec = &(cfgReportCmd->attrList[i]);
-
     status = ZCL_STATUS_SUCCESS;  // assume success for this rsp record
     
-    uint8 atrrCfgRecordIndex =  bdb_repAttrCfgRecordsArraySearch( pInMsg->endPoint, pInMsg->clusterId, reportRec->attrID );
-    uint8 status2 = zclFindAttrRec( pInMsg->endPoint, pInMsg->clusterId, reportRec->attrID, &attrRec );
+    uint8 atrrCfgRecordIndex =  bdb_repAttrCfgRecordsArraySearch( pInMsg->msg->endPoint, pInMsg->msg->clusterId, reportRec->attrID );
+    uint8 status2 = zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId, reportRec->attrID, &attrRec );
     if( atrrCfgRecordIndex == BDBREPORTING_INVALIDINDEX || status2 == 0 )
     {
       //No cfg record found, 
@@ -567,6 +574,7 @@ uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
               bdb_reportingAttrCfgRecordsArray[atrrCfgRecordIndex].minReportInt = reportRec->minReportInt;
               bdb_reportingAttrCfgRecordsArray[atrrCfgRecordIndex].maxReportInt = reportRec->maxReportInt;
               // For attributes of 'discrete' data types this field is omitted
+              // (it is copied as sent over the air, little endian like the targets)
               if ( zclAnalogDataType( reportRec->dataType ) )
               {
                 osal_memset( bdb_reportingAttrCfgRecordsArray[atrrCfgRecordIndex].reportableChange, 0x00, BDBREPORTING_MAX_ANALOG_ATTR_SIZE );
@@ -631,9 +639,9 @@ uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
   }
 
   // Send the response back
-  zcl_SendConfigReportRspCmd( pInMsg->endPoint, &(pInMsg->srcAddr),
-                              pInMsg->clusterId, cfgReportRspCmd, ZCL_FRAME_SERVER_CLIENT_DIR,
-                              true, pInMsg->zclHdr.transSeqNum );
+  zcl_SendConfigReportRspCmd( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                              pInMsg->msg->clusterId, cfgReportRspCmd, ZCL_FRAME_SERVER_CLIENT_DIR,
+                              true, pInMsg->hdr.transSeqNum );
   osal_mem_free( cfgReportRspCmd );
 
   bdb_repAttrCfgRecordsArrayFreeAll( ); //Free reporting conf array from memory, its saved in NV
@@ -653,34 +661,40 @@ uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
  *
  * @return  TRUE if conditions are meet (attr found, memory available, etc.) or FALSE
  */
-uint8 bdb_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg )
+uint8 bdb_ProcessInReadReportCfgCmd( zclIncoming_t *pInMsg )
 {
-  zclReadReportCfgCmd_t *readReportCfgCmd;
+  zclParseCmd_t parseCmd;
+  zclReadReportCfgRec_t readReportCfgRec;
   zclReadReportCfgRspCmd_t *readReportCfgRspCmd;
   zclReportCfgRspRec_t *reportRspRec;
   uint8 hdrLen;
   uint8 dataLen = 0;
   zclAttrRec_t attrRec;
-  uint8 i;
+  uint8 numAttr = 0;
   uint8 reportChangeLen;
   uint8 status;
   
   // Find Ep Descriptor
-  endPointDesc_t* epDescriptor = bdb_FindEpDesc( pInMsg->endPoint );
+  endPointDesc_t* epDescriptor = bdb_FindEpDesc( pInMsg->msg->endPoint );
   if( epDescriptor==NULL )
   {
     return ( FALSE ); // EMBEDDED RETURN
   }
   
-  readReportCfgCmd = (zclReadReportCfgCmd_t *)pInMsg->attrCmd;
+  // The records are read in place from the command
+  parseCmd.endpoint = pInMsg->msg->endPoint;
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
   
   // Find out the response length (Reportable Change field is of variable length)
-  for ( i = 0; i < readReportCfgCmd->numAttr; i++ )
+  while ( zclParseNextReadReportCfgRec( &parseCmd, &readReportCfgRec ) )
   {
+    numAttr++;
+
     // For supported attributes with 'analog' data type, find out the length of
     // the Reportable Change field
-    if ( zclFindAttrRec( epDescriptor->endPoint, pInMsg->clusterId,
-                         readReportCfgCmd->attrList[i].attrID, &attrRec ) )
+    if ( zclFindAttrRec( epDescriptor->endPoint, pInMsg->msg->clusterId,
+                         readReportCfgRec.attrID, &attrRec ) )
     {
       if ( zclAnalogDataType( attrRec.attr.dataType ) )
       {
@@ -696,7 +710,7 @@ uint8 bdb_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg )
     }
   }
 
-  hdrLen = sizeof( zclReadReportCfgRspCmd_t ) + ( readReportCfgCmd->numAttr * sizeof( zclReportCfgRspRec_t ) );
+  hdrLen = sizeof( zclReadReportCfgRspCmd_t ) + ( numAttr * sizeof( zclReportCfgRspRec_t ) );
 
   // Allocate space for the response command
   readReportCfgRspCmd = (zclReadReportCfgRspCmd_t *)osal_mem_alloc( hdrLen + dataLen );
@@ -714,13 +728,15 @@ uint8 bdb_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg )
   }
 
   readReportCfgRspCmd->numAttr=0;
-  for ( i = 0; i < readReportCfgCmd->numAttr; i++ )
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+  while ( zclParseNextReadReportCfgRec( &parseCmd, &readReportCfgRec ) )
   {
-    reportRspRec = &(readReportCfgRspCmd->attrList[i]);
+    reportRspRec = &(readReportCfgRspCmd->attrList[readReportCfgRspCmd->numAttr]);
     status = ZCL_STATUS_SUCCESS;  // assume success for this rsp record
     
-    uint8 atrrCfgRecordIndex =  bdb_repAttrCfgRecordsArraySearch( pInMsg->endPoint, pInMsg->clusterId, readReportCfgCmd->attrList[i].attrID );
-    uint8 status2 = zclFindAttrRec( pInMsg->endPoint, pInMsg->clusterId, readReportCfgCmd->attrList[i].attrID, &attrRec );
+    uint8 atrrCfgRecordIndex =  bdb_repAttrCfgRecordsArraySearch( pInMsg->msg->endPoint, pInMsg->msg->clusterId, readReportCfgRec.attrID );
+    uint8 status2 = zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId, readReportCfgRec.attrID, &attrRec );
     if( atrrCfgRecordIndex != BDBREPORTING_INVALIDINDEX && status2 )
     {
       if ( attrRec.attr.accessControl & ACCESS_REPORTABLE )
@@ -743,15 +759,15 @@ uint8 bdb_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg )
       status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
     }
     reportRspRec->status = status;
-    reportRspRec->direction = readReportCfgCmd->attrList[i].direction;
-    reportRspRec->attrID = readReportCfgCmd->attrList[i].attrID;
+    reportRspRec->direction = readReportCfgRec.direction;
+    reportRspRec->attrID = readReportCfgRec.attrID;
     readReportCfgRspCmd->numAttr++;
   }
   
   // Send the response back
-  zcl_SendReadReportCfgRspCmd( pInMsg->endPoint, &(pInMsg->srcAddr),
-                               pInMsg->clusterId, readReportCfgRspCmd, ZCL_FRAME_SERVER_CLIENT_DIR,
-                               true, pInMsg->zclHdr.transSeqNum );
+  zcl_SendReadReportCfgRspCmd( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
+                               pInMsg->msg->clusterId, readReportCfgRspCmd, ZCL_FRAME_SERVER_CLIENT_DIR,
+                               true, pInMsg->hdr.transSeqNum );
   osal_mem_free( readReportCfgRspCmd );
   
   bdb_repAttrCfgRecordsArrayFreeAll( );//Free reporting cfg array from memory, its saved in NV
@@ -77,8 +77,8 @@ void bdb_RepConstructReportingData( void );
 void bdb_RepProcessEvent( void );
 void bdb_RepStartOrContinueReporting( void );
 void bdb_RepMarkHasBindingInEndpointClusterArray( uint8 endpoint, uint16 cluster, uint8 unMark, uint8 setNoNextIncrementFlag );
-uint8 bdb_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg );
-uint8 bdb_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg );
+uint8 bdb_ProcessInConfigReportCmd( zclIncoming_t *pInMsg );
+uint8 bdb_ProcessInReadReportCfgCmd( zclIncoming_t *pInMsg );
 void bdb_RepUpdateMarkBindings( void );
 
 #endif //BDB_REPORTING
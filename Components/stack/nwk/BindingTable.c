@@ -64,6 +64,18 @@
 #define NV_BIND_REC_SIZE (gBIND_REC_SIZE)
 #define NV_BIND_ITEM_SIZE  (gBIND_REC_SIZE * gNWK_MAX_BINDING_ENTRIES)
 
+// One node per cluster ID of each binding entry
+#define BIND_INDEX_MAX     (NWK_MAX_BINDING_ENTRIES * MAX_BINDING_CLUSTER_IDS)
+
+// One bit per binding entry that differs from its NV record
+#define BIND_DIRTY_LEN     ((NWK_MAX_BINDING_ENTRIES + 7) / 8)
+#define BIND_DIRTY_SET(x)  (bindDirty[(x) >> 3] |= (uint8)(1 << ((x) & 0x07)))
+#define BIND_DIRTY_CLR(x)  (bindDirty[(x) >> 3] &= (uint8)~(1 << ((x) & 0x07)))
+#define BIND_IS_DIRTY(x)   (bindDirty[(x) >> 3] & (uint8)(1 << ((x) & 0x07)))
+
+// Number of records in the NV header is not known
+#define BIND_NV_RECS_UNKNOWN  0xFFFF
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -77,6 +89,14 @@ typedef struct
   uint16*      clusterIDList;
 } bindFields_t;
 
+// Binding index node, sorted by srcEP, clusterID and then table position
+typedef struct
+{
+  uint16           clusterID;
+  uint8            srcEP;
+  bindTableIndex_t entryIdx;
+} bindIndex_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -93,6 +113,12 @@ BindingEntry_t *bindFindEmpty( void );
 uint16 bindingAddrMgsHelperFind( zAddrType_t *addr );
 uint8 bindingAddrMgsHelperConvert( uint16 idx, zAddrType_t *addr );
 void bindAddrMgrLocalLoad( void );
+static uint16 bindIndexFind( uint8 ep, uint16 clusterID );
+static void bindIndexAdd( BindingEntry_t *pBind, uint16 clusterID );
+static void bindIndexRemove( BindingEntry_t *pBind, uint16 clusterID );
+static void bindIndexRemoveEntry( BindingEntry_t *pBind );
+static void bindIndexBuild( void );
+static void bindSetDirty( BindingEntry_t *pBind );
 
 #if !defined ( BINDINGTABLE_NV_SINGLES )
   #if !defined ( DONT_UPGRADE_BIND )
@@ -107,6 +133,16 @@ void bindAddrMgrLocalLoad( void );
  */
 static uint8 bindAddrMgrLocalLoaded = FALSE;
 
+// Index of the binding entries by source endpoint and cluster ID
+static bindIndex_t bindIndex[BIND_INDEX_MAX];
+static uint16 bindIndexCnt = 0;
+
+// Binding entries changed since they were last written to NV
+static uint8 bindDirty[BIND_DIRTY_LEN];
+#if !defined ( BINDINGTABLE_NV_SINGLES )
+static uint16 bindNvNumRecs = BIND_NV_RECS_UNKNOWN;
+#endif
+
 /*********************************************************************
  * Function Pointers
  */
@@ -163,6 +199,13 @@ void InitBindingTable( void )
   pBindWriteNV = BindWriteNV;
 
   bindAddrMgrLocalLoaded = FALSE;
+  bindIndexCnt = 0;
+
+  // Nothing is known about the NV records yet
+  osal_memset( bindDirty, 0xFF, BIND_DIRTY_LEN );
+#if !defined ( BINDINGTABLE_NV_SINGLES )
+  bindNvNumRecs = BIND_NV_RECS_UNKNOWN;
+#endif
 
 #if ( ADDRMGR_CALLBACK_ENABLED == 1 )
   // Register with the address manager
@@ -170,6 +213,185 @@ void InitBindingTable( void )
 #endif
 }
 
+/*********************************************************************
+ * @fn      bindSetDirty()
+ *
+ * @brief   Mark a binding entry to be written by the next BindWriteNV().
+ *
+ * @param   pBind - binding table entry
+ *
+ * @return  none
+ */
+static void bindSetDirty( BindingEntry_t *pBind )
+{
+  bindTableIndex_t x = (bindTableIndex_t)(pBind - BindingTable);
+
+  BIND_DIRTY_SET( x );
+}
+
+/*********************************************************************
+ * @fn      bindIndexFind()
+ *
+ * @brief   Binary search of the binding index.
+ *
+ * @param   ep - source endpoint
+ * @param   clusterID - cluster ID
+ *
+ * @return  position of the first node of ep and clusterID, or of the
+ *          node where they would be inserted
+ */
+static uint16 bindIndexFind( uint8 ep, uint16 clusterID )
+{
+  uint16 low = 0;
+  uint16 high = bindIndexCnt;
+
+  while ( low < high )
+  {
+    uint16 mid = low + ((high - low) >> 1);
+
+    if ( ( bindIndex[mid].srcEP < ep ) ||
+         ( ( bindIndex[mid].srcEP == ep ) && ( bindIndex[mid].clusterID < clusterID ) ) )
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  return ( low );
+}
+
+/*********************************************************************
+ * @fn      bindIndexAdd()
+ *
+ * @brief   Add a cluster ID of a binding entry to the binding index.
+ *
+ * @param   pBind - binding table entry
+ * @param   clusterID - cluster ID
+ *
+ * @return  none
+ */
+static void bindIndexAdd( BindingEntry_t *pBind, uint16 clusterID )
+{
+  bindTableIndex_t entryIdx = (bindTableIndex_t)(pBind - BindingTable);
+  uint16 pos = bindIndexFind( pBind->srcEP, clusterID );
+  uint16 x;
+
+  // Keep the nodes of the same key in binding table order
+  while ( ( pos < bindIndexCnt ) && ( bindIndex[pos].srcEP == pBind->srcEP ) &&
+          ( bindIndex[pos].clusterID == clusterID ) && ( bindIndex[pos].entryIdx <= entryIdx ) )
+  {
+    if ( bindIndex[pos].entryIdx == entryIdx )
+    {
+      return;  // Already indexed
+    }
+    pos++;
+  }
+
+  if ( bindIndexCnt >= BIND_INDEX_MAX )
+  {
+    return;
+  }
+
+  for ( x = bindIndexCnt; x > pos; x-- )
+  {
+    bindIndex[x] = bindIndex[x-1];
+  }
+  bindIndex[pos].clusterID = clusterID;
+  bindIndex[pos].srcEP = pBind->srcEP;
+  bindIndex[pos].entryIdx = entryIdx;
+  bindIndexCnt++;
+}
+
+/*********************************************************************
+ * @fn      bindIndexRemove()
+ *
+ * @brief   Remove a cluster ID of a binding entry from the binding index.
+ *
+ * @param   pBind - binding table entry
+ * @param   clusterID - cluster ID
+ *
+ * @return  none
+ */
+static void bindIndexRemove( BindingEntry_t *pBind, uint16 clusterID )
+{
+  bindTableIndex_t entryIdx = (bindTableIndex_t)(pBind - BindingTable);
+  uint16 pos = bindIndexFind( pBind->srcEP, clusterID );
+
+  while ( ( pos < bindIndexCnt ) && ( bindIndex[pos].srcEP == pBind->srcEP ) &&
+          ( bindIndex[pos].clusterID == clusterID ) )
+  {
+    if ( bindIndex[pos].entryIdx == entryIdx )
+    {
+      bindIndexCnt--;
+      for ( ; pos < bindIndexCnt; pos++ )
+      {
+        bindIndex[pos] = bindIndex[pos+1];
+      }
+      break;
+    }
+    pos++;
+  }
+}
+
+/*********************************************************************
+ * @fn      bindIndexRemoveEntry()
+ *
+ * @brief   Remove all the cluster IDs of a binding entry from the
+ *          binding index.
+ *
+ * @param   pBind - binding table entry
+ *
+ * @return  none
+ */
+static void bindIndexRemoveEntry( BindingEntry_t *pBind )
+{
+  bindTableIndex_t entryIdx = (bindTableIndex_t)(pBind - BindingTable);
+  uint16 x;
+  uint16 cnt = 0;
+
+  for ( x = 0; x < bindIndexCnt; x++ )
+  {
+    if ( bindIndex[x].entryIdx != entryIdx )
+    {
+      bindIndex[cnt++] = bindIndex[x];
+    }
+  }
+  bindIndexCnt = cnt;
+}
+
+/*********************************************************************
+ * @fn      bindIndexBuild()
+ *
+ * @brief   Rebuild the binding index from the binding table.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void bindIndexBuild( void )
+{
+  bindTableIndex_t x;
+  uint8 i;
+
+  bindIndexCnt = 0;
+
+  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  {
+    BindingEntry_t *pBind = &BindingTable[x];
+
+    if ( pBind->srcEP != NV_BIND_EMPTY )
+    {
+      for ( i = 0; ( i < pBind->numClusterIds ) && ( i < gMAX_BINDING_CLUSTER_IDS ); i++ )
+      {
+        bindIndexAdd( pBind, pBind->clusterIdList[i] );
+      }
+    }
+  }
+}
+
 /*********************************************************************
  * @fn      bindFindEmpty()
  *
@@ -406,6 +628,12 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
         osal_memcpy( entry->clusterIdList,
                      clusterIds,
                      numClusterIds * sizeof(uint16) );
+
+        for ( index = 0; index < numClusterIds; index++ )
+        {
+          bindIndexAdd( entry, clusterIds[index] );
+        }
+        bindSetDirty( entry );
       }
     }
   }
@@ -429,6 +657,11 @@ BindingEntry_t *bindAddEntry( byte srcEpInt,
  */
 byte bindRemoveEntry( BindingEntry_t *pBind )
 {
+  if ( pBind->srcEP != NV_BIND_EMPTY )
+  {
+    bindIndexRemoveEntry( pBind );
+    bindSetDirty( pBind );
+  }
   osal_memset( pBind, 0xFF, gBIND_REC_SIZE );
 #ifdef BDB_REPORTING
   bdb_RepUpdateMarkBindings();
@@ -479,10 +712,8 @@ byte bindRemoveClusterIdFromList( BindingEntry_t *entry, uint16 clusterId )
   byte x;
   uint16 *listPtr;
   byte numIds;
-
-#ifdef BDB_REPORTING
   uint8 numRemoved = 0;
-#endif
+
   if ( entry )
   {
     if ( entry->numClusterIds > 0 )
@@ -500,10 +731,8 @@ byte bindRemoveClusterIdFromList( BindingEntry_t *entry, uint16 clusterId )
         else
         {
           entry->numClusterIds--;
-          
-#ifdef BDB_REPORTING
-           numRemoved++;
-#endif          
+          numRemoved++;
+
           if ( entry->numClusterIds == 0 )
           {
             break;
@@ -514,10 +743,14 @@ byte bindRemoveClusterIdFromList( BindingEntry_t *entry, uint16 clusterId )
     }
   }
 
+  if ( numRemoved > 0 )
+  {
+    bindIndexRemove( entry, clusterId );
+    bindSetDirty( entry );
 #ifdef BDB_REPORTING
-  if(numRemoved>0)
     bdb_RepUpdateMarkBindings();
-#endif 
+#endif
+  }
   
   if ( entry && (entry->numClusterIds > 0) )
   {
@@ -546,6 +779,8 @@ byte bindAddClusterIdToList( BindingEntry_t *entry, uint16 clusterId )
     // Add the new one
     entry->clusterIdList[entry->numClusterIds] = clusterId;
     entry->numClusterIds++;
+    bindIndexAdd( entry, clusterId );
+    bindSetDirty( entry );
     return ( TRUE );
   }
   return ( FALSE );
@@ -753,20 +988,14 @@ byte bindNumBoundTo( zAddrType_t *devAddr, byte devEpInt, byte srcMode )
  */
 uint16 bindNumReflections( uint8 ep, uint16 clusterID )
 {
-  bindTableIndex_t x;
-  BindingEntry_t *pBind;
+  uint16 pos = bindIndexFind( ep, clusterID );
   uint16 cnt = 0;
-  uint8 bindEP;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  while ( ( pos < bindIndexCnt ) && ( bindIndex[pos].srcEP == ep ) &&
+          ( bindIndex[pos].clusterID == clusterID ) )
   {
-    pBind = &BindingTable[x];
-    bindEP = pBind->srcEP;
-
-    if ( (bindEP == ep) && (bindIsClusterIDinList( pBind, clusterID )) )
-    {
-      cnt++;
-    }
+    cnt++;
+    pos++;
   }
 
   return ( cnt );
@@ -786,25 +1015,57 @@ uint16 bindNumReflections( uint8 ep, uint16 clusterID )
  */
 BindingEntry_t *bindFind( uint8 ep, uint16 clusterID, uint8 skipping )
 {
-  BindingEntry_t *pBind;
-  byte skipped = 0;
-  bindTableIndex_t x;
+  uint16 pos = bindIndexFind( ep, clusterID ) + skipping;
 
-  for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
+  if ( ( pos < bindIndexCnt ) && ( bindIndex[pos].srcEP == ep ) &&
+       ( bindIndex[pos].clusterID == clusterID ) )
   {
-    pBind = &BindingTable[x];
+    return ( &BindingTable[bindIndex[pos].entryIdx] );
+  }
 
-    if ( ( pBind->srcEP == ep) && bindIsClusterIDinList( pBind, clusterID ))
-    {
-      if ( skipped < skipping )
-      {
-        skipped++;
-      }
-      else
-      {
-        return ( pBind );
-      }
-    }
+  return ( (BindingEntry_t *)NULL );
+}
+
+/*********************************************************************
+ * @fn          bindFindFirst
+ *
+ * @brief       Starts an iteration over the binding entries of a source
+ *              endpoint and cluster ID, in binding table order. The
+ *              binding table must not be changed during the iteration.
+ *
+ * @param       pIter - iterator to initialize
+ * @param       ep - source endpoint
+ * @param       clusterID - matching clusterID
+ *
+ * @return      pointer to the first binding table entry, NULL if none
+ */
+BindingEntry_t *bindFindFirst( bindIter_t *pIter, uint8 ep, uint16 clusterID )
+{
+  pIter->ep = ep;
+  pIter->clusterID = clusterID;
+  pIter->pos = bindIndexFind( ep, clusterID );
+
+  return ( bindFindNext( pIter ) );
+}
+
+/*********************************************************************
+ * @fn          bindFindNext
+ *
+ * @brief       Continues an iteration started by bindFindFirst().
+ *
+ * @param       pIter - iterator
+ *
+ * @return      pointer to the next binding table entry, NULL if none
+ */
+BindingEntry_t *bindFindNext( bindIter_t *pIter )
+{
+  uint16 pos = pIter->pos;
+
+  if ( ( pos < bindIndexCnt ) && ( bindIndex[pos].srcEP == pIter->ep ) &&
+       ( bindIndex[pos].clusterID == pIter->clusterID ) )
+  {
+    pIter->pos++;
+    return ( &BindingTable[bindIndex[pos].entryIdx] );
   }
 
   return ( (BindingEntry_t *)NULL );
@@ -882,6 +1143,7 @@ void bindUpdateAddr( uint16 oldAddr, uint16 newAddr )
     if ( pBind->dstIdx == oldIdx )
     {
       pBind->dstIdx = newIdx;
+      bindSetDirty( pBind );
     }
   }
 }
@@ -1137,6 +1399,10 @@ void BindSetDefaultNV( void )
 
   // Save off the header
   osal_nv_write( ZCD_NV_BINDING_TABLE, 0, sizeof( nvBindingHdr_t ), &hdr );
+  bindNvNumRecs = 0;
+
+  // The records in NV are stale, write them all out with the next update
+  osal_memset( bindDirty, 0xFF, BIND_DIRTY_LEN );
 }
 
 #if !defined ( DONT_UPGRADE_BIND )
@@ -1360,6 +1626,8 @@ uint16 BindRestoreFromNV( void )
       bindTableIndex_t x;
       uint16 validRecsCount = 0;
 
+      bindNvNumRecs = hdr.numRecs;
+
       // Read in the device list
       for ( x = 0; ( x < gNWK_MAX_BINDING_ENTRIES ) && ( validRecsCount < hdr.numRecs ); x++ )
       {
@@ -1367,6 +1635,9 @@ uint16 BindRestoreFromNV( void )
                            (uint16)(sizeof(nvBindingHdr_t) + (x * NV_BIND_REC_SIZE)),
                            NV_BIND_REC_SIZE, &BindingTable[x] ) == ZSUCCESS )
         {
+          // The record now matches NV
+          BIND_DIRTY_CLR( x );
+
           if ( BindingTable[x].srcEP != NV_BIND_EMPTY )
           {
             validRecsCount++;
@@ -1375,13 +1646,17 @@ uint16 BindRestoreFromNV( void )
       }
     }
   }
+  bindIndexBuild();
+
   return ( hdr.numRecs );
 }
 
 /*********************************************************************
  * @fn          BindWriteNV
  *
- * @brief       Save the Binding Table in NV
+ * @brief       Save the Binding Table in NV. Only the records changed
+ *              since the last save are written, and the header only
+ *              when the number of records changed.
  *
  * @param       none
  *
@@ -1400,12 +1675,18 @@ void BindWriteNV( void )
   {
     pBind = &BindingTable[x];
 
-    osal_memcpy( &bind, pBind, gBIND_REC_SIZE );
+    if ( BIND_IS_DIRTY( x ) )
+    {
+      osal_memcpy( &bind, pBind, gBIND_REC_SIZE );
 
-    // Save the record to NV
-    osal_nv_write( ZCD_NV_BINDING_TABLE,
-                   (uint16)((sizeof(nvBindingHdr_t)) + (x * NV_BIND_REC_SIZE)),
-                   NV_BIND_REC_SIZE, &bind );
+      // Save the record to NV
+      if ( osal_nv_write( ZCD_NV_BINDING_TABLE,
+                          (uint16)((sizeof(nvBindingHdr_t)) + (x * NV_BIND_REC_SIZE)),
+                          NV_BIND_REC_SIZE, &bind ) == ZSuccess )
+      {
+        BIND_DIRTY_CLR( x );
+      }
+    }
 
     if ( pBind->srcEP != NV_BIND_EMPTY )
     {
@@ -1413,8 +1694,14 @@ void BindWriteNV( void )
     }
   }
 
-  // Save off the header
-  osal_nv_write( ZCD_NV_BINDING_TABLE, 0, sizeof(nvBindingHdr_t), &hdr );
+  if ( hdr.numRecs != bindNvNumRecs )
+  {
+    // Save off the header
+    if ( osal_nv_write( ZCD_NV_BINDING_TABLE, 0, sizeof(nvBindingHdr_t), &hdr ) == ZSuccess )
+    {
+      bindNvNumRecs = hdr.numRecs;
+    }
+  }
 }
 
 #else // !BINDINGTABLE_NV_SINGLES
@@ -1462,6 +1749,9 @@ void BindSetDefaultNV( void )
     // Over write each binding record with an "empty" record
     osal_nv_write_ex( ZCD_NV_EX_BINDING_TABLE, x, 0, NV_BIND_REC_SIZE, &bind );
   }
+
+  // The table must be written out in full with the next update
+  osal_memset( bindDirty, 0xFF, BIND_DIRTY_LEN );
 }
 
 /*********************************************************************
@@ -1484,6 +1774,9 @@ uint16 BindRestoreFromNV( void )
     if ( osal_nv_read_ex( ZCD_NV_EX_BINDING_TABLE, x, 0,
                      (uint16)NV_BIND_REC_SIZE, &BindingTable[x] ) == ZSUCCESS )
     {
+      // The record now matches NV
+      BIND_DIRTY_CLR( x );
+
       // Check for non-empty record
       if ( BindingTable[x].srcEP != NV_BIND_EMPTY )
       {
@@ -1492,13 +1785,15 @@ uint16 BindRestoreFromNV( void )
       }
     }
   }
+  bindIndexBuild();
+
   return ( validRecsCount );
 }
 
 /*********************************************************************
  * @fn          BindWriteNV
  *
- * @brief       Copy the Binding Table in NV
+ * @brief       Copy the changed records of the Binding Table in NV
  *
  * @param       none
  *
@@ -1510,9 +1805,15 @@ void BindWriteNV( void )
 
   for ( x = 0; x < gNWK_MAX_BINDING_ENTRIES; x++ )
   {
-    // Save the record to NV
-    osal_nv_write_ex( ZCD_NV_EX_BINDING_TABLE, x, 0,
-                     (uint16)NV_BIND_REC_SIZE, &BindingTable[x] );
+    if ( BIND_IS_DIRTY( x ) )
+    {
+      // Save the record to NV
+      if ( osal_nv_write_ex( ZCD_NV_EX_BINDING_TABLE, x, 0,
+                             (uint16)NV_BIND_REC_SIZE, &BindingTable[x] ) == ZSuccess )
+      {
+        BIND_DIRTY_CLR( x );
+      }
+    }
   }
 }
 #endif // BINDINGTABLE_NV_SINGLES
@@ -92,6 +92,14 @@ typedef struct
                       // gMAX_BINDING_CLUSTER_IDS
 } BindingEntry_t;
 
+// Iterator over the binding entries of a source endpoint and cluster ID
+typedef struct
+{
+  uint8  ep;
+  uint16 clusterID;
+  uint16 pos;
+} bindIter_t;
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -162,6 +170,17 @@ extern uint16 bindNumReflections( uint8 ep, uint16 clusterID );
  */
 extern BindingEntry_t *bindFind( uint8 ep, uint16 clusterID, uint8 skipping );
 
+/*
+ * Starts an iteration over the binding entries of the source
+ * endpoint and clusterID passed in as a parameter.
+ */
+extern BindingEntry_t *bindFindFirst( bindIter_t *pIter, uint8 ep, uint16 clusterID );
+
+/*
+ * Continues an iteration over binding entries.
+ */
+extern BindingEntry_t *bindFindNext( bindIter_t *pIter );
+
 /*
  * Lookup a binding entry by specific Idx, if none is found
  * clears the BINDING user from Address Manager.
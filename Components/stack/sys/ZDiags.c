@@ -37,9 +37,12 @@
   contact Texas Instruments Incorporated at www.TI.com.
 **************************************************************************************************/
 
+
 /*********************************************************************
  * INCLUDES
  */
+#include <stddef.h>
+
 #include "OSAL.h"
 #include "OSAL_Nv.h"
 #include "OSAL_Timers.h"
@@ -49,14 +52,64 @@
 /*********************************************************************
  * MACROS
  */
+#define ZDIAGS_DIRTY_SET( idx )    ( zdiagsDirty[(idx) >> 3] |= (uint8)(1 << ((idx) & 0x07)) )
+#define ZDIAGS_IS_DIRTY( idx )     ( zdiagsDirty[(idx) >> 3] & (uint8)(1 << ((idx) & 0x07)) )
 
 /*********************************************************************
  * CONSTANTS
  */
+// Attribute index constants, based on the attribute ID ranges
+#define ZDIAGS_ATTR_SET1_START    ZDIAGS_SYSTEM_CLOCK
+#define ZDIAGS_ATTR_SET1_END      ZDIAGS_PERSISTENT_MEMORY_WRITES
+#define ZDIAGS_ATTR_SET1_OFFSET   0
+#define ZDIAGS_ATTR_SET2_START    ZDIAGS_MAC_RX_CRC_PASS
+#define ZDIAGS_ATTR_SET2_END      ZDIAGS_MAC_TX_UCAST_FAIL
+#define ZDIAGS_ATTR_SET2_OFFSET   (ZDIAGS_ATTR_SET1_END - ZDIAGS_ATTR_SET1_START + ZDIAGS_ATTR_SET1_OFFSET + 1)
+#define ZDIAGS_ATTR_SET3_START    ZDIAGS_ROUTE_DISC_INITIATED
+#define ZDIAGS_ATTR_SET3_END      ZDIAGS_PACKET_VALIDATE_DROP_COUNT
+#define ZDIAGS_ATTR_SET3_OFFSET   (ZDIAGS_ATTR_SET2_END - ZDIAGS_ATTR_SET2_START + ZDIAGS_ATTR_SET2_OFFSET + 1)
+#define ZDIAGS_ATTR_SET4_START    ZDIAGS_APS_RX_BCAST
+#define ZDIAGS_ATTR_SET4_END      ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS
+#define ZDIAGS_ATTR_SET4_OFFSET   (ZDIAGS_ATTR_SET3_END - ZDIAGS_ATTR_SET3_START + ZDIAGS_ATTR_SET3_OFFSET + 1)
+
+#define ZDIAGS_ATTR_CNT           (ZDIAGS_ATTR_SET4_END - ZDIAGS_ATTR_SET4_START + ZDIAGS_ATTR_SET4_OFFSET + 1)
+#define ZDIAGS_ATTR_INVALID       0xFF
+
+// Offset of an attribute that is not kept in DiagsStatsTable
+#define ZDIAGS_ATTR_NO_FIELD      0xFF
+
+#define ZDIAGS_DIRTY_LEN          ((ZDIAGS_ATTR_CNT + 7) / 8)
+
+// Number of different counters the journal holds before it is folded into
+// the statistics table in NV
+#if !defined ( ZDIAGS_JOURNAL_CNT )
+  #define ZDIAGS_JOURNAL_CNT      8
+#endif
 
 /*********************************************************************
  * TYPEDEFS
  */
+// Statistics table access type
+typedef struct
+{
+  uint8 offset;
+  uint8 len;
+} zdiagsAttrTbl_t;
+
+// Journal record, holds the value of a counter when it was saved
+typedef struct
+{
+  uint8 idx;
+  uint8 value[4];
+} zdiagsJournalRec_t;
+
+// Journal item, the records only apply to the table saved with tableClock
+typedef struct
+{
+  uint32 tableClock;
+  uint8 cnt;
+  zdiagsJournalRec_t rec[ZDIAGS_JOURNAL_CNT];
+} zdiagsJournal_t;
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -68,11 +121,72 @@ static DiagStatistics_t DiagsStatsTable;
 /*********************************************************************
  * LOCAL VARIABLES
  */
+#if defined ( FEATURE_SYSTEM_STATS )
+// Statistics table access table, in attribute index order
+static CONST zdiagsAttrTbl_t zdiagsAttrTbl[ZDIAGS_ATTR_CNT] =
+{
+  { offsetof( DiagStatistics_t, SysClock ),                     sizeof( uint32 ) },  // ZDIAGS_SYSTEM_CLOCK
+  { ZDIAGS_ATTR_NO_FIELD,                                       sizeof( uint16 ) },  // ZDIAGS_NUMBER_OF_RESETS
+  { offsetof( DiagStatistics_t, PersistentMemoryWrites ),       sizeof( uint16 ) },  // ZDIAGS_PERSISTENT_MEMORY_WRITES
+
+  { offsetof( DiagStatistics_t, MacRxCrcPass ),                 sizeof( uint32 ) },  // ZDIAGS_MAC_RX_CRC_PASS
+  { offsetof( DiagStatistics_t, MacRxCrcFail ),                 sizeof( uint32 ) },  // ZDIAGS_MAC_RX_CRC_FAIL
+  { offsetof( DiagStatistics_t, MacRxBcast ),                   sizeof( uint32 ) },  // ZDIAGS_MAC_RX_BCAST
+  { offsetof( DiagStatistics_t, MacTxBcast ),                   sizeof( uint32 ) },  // ZDIAGS_MAC_TX_BCAST
+  { offsetof( DiagStatistics_t, MacRxUcast ),                   sizeof( uint32 ) },  // ZDIAGS_MAC_RX_UCAST
+  { offsetof( DiagStatistics_t, MacTxUcast ),                   sizeof( uint32 ) },  // ZDIAGS_MAC_TX_UCAST
+  { offsetof( DiagStatistics_t, MacTxUcastRetry ),              sizeof( uint32 ) },  // ZDIAGS_MAC_TX_UCAST_RETRY
+  { offsetof( DiagStatistics_t, MacTxUcastFail ),               sizeof( uint32 ) },  // ZDIAGS_MAC_TX_UCAST_FAIL
+
+  { offsetof( DiagStatistics_t, RouteDiscInitiated ),           sizeof( uint16 ) },  // ZDIAGS_ROUTE_DISC_INITIATED
+  { offsetof( DiagStatistics_t, NeighborAdded ),                sizeof( uint16 ) },  // ZDIAGS_NEIGHBOR_ADDED
+  { offsetof( DiagStatistics_t, NeighborRemoved ),              sizeof( uint16 ) },  // ZDIAGS_NEIGHBOR_REMOVED
+  { offsetof( DiagStatistics_t, NeighborStale ),                sizeof( uint16 ) },  // ZDIAGS_NEIGHBOR_STALE
+  { offsetof( DiagStatistics_t, JoinIndication ),               sizeof( uint16 ) },  // ZDIAGS_JOIN_INDICATION
+  { offsetof( DiagStatistics_t, ChildMoved ),                   sizeof( uint16 ) },  // ZDIAGS_CHILD_MOVED
+  { offsetof( DiagStatistics_t, NwkFcFailure ),                 sizeof( uint16 ) },  // ZDIAGS_NWK_FC_FAILURE
+  { offsetof( DiagStatistics_t, NwkDecryptFailures ),           sizeof( uint16 ) },  // ZDIAGS_NWK_DECRYPT_FAILURES
+  { offsetof( DiagStatistics_t, PacketBufferAllocateFailures ), sizeof( uint16 ) },  // ZDIAGS_PACKET_BUFFER_ALLOCATE_FAILURES
+  { offsetof( DiagStatistics_t, RelayedUcast ),                 sizeof( uint16 ) },  // ZDIAGS_RELAYED_UCAST
+  { offsetof( DiagStatistics_t, PhyToMacQueueLimitReached ),    sizeof( uint16 ) },  // ZDIAGS_PHY_TO_MAC_QUEUE_LIMIT_REACHED
+  { offsetof( DiagStatistics_t, PacketValidateDropCount ),      sizeof( uint16 ) },  // ZDIAGS_PACKET_VALIDATE_DROP_COUNT
+
+  { offsetof( DiagStatistics_t, ApsRxBcast ),                   sizeof( uint16 ) },  // ZDIAGS_APS_RX_BCAST
+  { offsetof( DiagStatistics_t, ApsTxBcast ),                   sizeof( uint16 ) },  // ZDIAGS_APS_TX_BCAST
+  { offsetof( DiagStatistics_t, ApsRxUcast ),                   sizeof( uint16 ) },  // ZDIAGS_APS_RX_UCAST
+  { offsetof( DiagStatistics_t, ApsTxUcastSuccess ),            sizeof( uint16 ) },  // ZDIAGS_APS_TX_UCAST_SUCCESS
+  { offsetof( DiagStatistics_t, ApsTxUcastRetry ),              sizeof( uint16 ) },  // ZDIAGS_APS_TX_UCAST_RETRY
+  { offsetof( DiagStatistics_t, ApsTxUcastFail ),               sizeof( uint16 ) },  // ZDIAGS_APS_TX_UCAST_FAIL
+  { offsetof( DiagStatistics_t, ApsFcFailure ),                 sizeof( uint16 ) },  // ZDIAGS_APS_FC_FAILURE
+  { offsetof( DiagStatistics_t, ApsUnauthorizedKey ),           sizeof( uint16 ) },  // ZDIAGS_APS_UNAUTHORIZED_KEY
+  { offsetof( DiagStatistics_t, ApsDecryptFailures ),           sizeof( uint16 ) },  // ZDIAGS_APS_DECRYPT_FAILURES
+  { offsetof( DiagStatistics_t, ApsInvalidPackets ),            sizeof( uint16 ) },  // ZDIAGS_APS_INVALID_PACKETS
+  { offsetof( DiagStatistics_t, MacRetriesPerApsTxSuccess ),    sizeof( uint16 ) },  // ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS
+};
+
+// Counters changed since they were last saved to NV
+static uint8 zdiagsDirty[ZDIAGS_DIRTY_LEN];
+
+// RAM copy of the journal item in NV, tableClock always matches the NV copy
+static zdiagsJournal_t zdiagsJournal;
+
+// SysClock of the table in NV
+static uint32 zdiagsTableClock;
+
+// TRUE when the table in NV has to be rewritten on the next save
+static uint8 zdiagsTableStale;
+#endif // FEATURE_SYSTEM_STATS
 
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
-
+#if defined ( FEATURE_SYSTEM_STATS )
+static uint8 zdiagsAttrIndex( uint16 attributeId );
+static uint32 zdiagsReadField( uint8 idx );
+static void zdiagsWriteField( uint8 idx, uint32 value );
+static void zdiagsUpdateMacStats( void );
+static zdiagsJournalRec_t *zdiagsJournalFind( uint8 idx );
+#endif
 
 /****************************************************************************
  * @fn          ZDiagsInitStats
@@ -106,14 +220,38 @@ uint8 ZDiagsInitStats( void )
   }
   else
   {
+    uint8 journalStatus;
+
+    if ( status != SUCCESS )
+    {
+      // Table was just created from the RAM table
+      zdiagsTableClock = zdiagsJournal.tableClock = DiagsStatsTable.SysClock;
+      zdiagsTableStale = FALSE;
+    }
+
+    // An empty journal is written if the item did not exist yet
+    journalStatus = osal_nv_item_init( ZCD_NV_DIAGNOSTIC_JOURNAL,
+                                       (uint16)sizeof( zdiagsJournal_t ),
+                                       &zdiagsJournal );
+
+    if ( journalStatus == NV_OPER_FAILED )
+    {
+      retValue = ZFailure;
+    }
     // Item existed, restore NV values into RAM table
-    if ( status == SUCCESS )
+    else if ( status == SUCCESS )
     {
       if ( NV_OPER_FAILED == ZDiagsRestoreStatsFromNV() )
       {
         retValue = ZFailure;
       }
     }
+    else if ( journalStatus == SUCCESS )
+    {
+      // Table was just created, drop the records left in the old journal
+      osal_nv_write( ZCD_NV_DIAGNOSTIC_JOURNAL, 0,
+                     offsetof( zdiagsJournal_t, rec ), &zdiagsJournal );
+    }
   }
 #endif // FEATURE_SYSTEM_STATS
 
@@ -136,10 +274,15 @@ uint32 ZDiagsClearStats( bool clearNV )
 #if defined ( FEATURE_SYSTEM_STATS )
   // clears statistics table
   osal_memset( &DiagsStatsTable, 0, sizeof( DiagStatistics_t ) );
+  osal_memset( zdiagsDirty, 0, sizeof( zdiagsDirty ) );
+  zdiagsJournal.cnt = 0;
 
   // saves System Clock when statistics were cleared
   retValue = DiagsStatsTable.SysClock = osal_GetSystemClock();
 
+  // The table in NV no longer matches, unless it is cleared below
+  zdiagsTableStale = !clearNV;
+
   if ( clearNV )
   {
     uint16 bootCnt = 0;
@@ -147,6 +290,10 @@ uint32 ZDiagsClearStats( bool clearNV )
     // Boot count is not part of DiagsStatsTable, it has to be initialized separately
     osal_nv_write( ZCD_NV_BOOTCOUNTER, 0, sizeof(bootCnt), &bootCnt );
 
+    // Empty the journal first, so it can't be replayed over the cleared table
+    zdiagsTableClock = zdiagsJournal.tableClock = DiagsStatsTable.SysClock;
+    osal_nv_write( ZCD_NV_DIAGNOSTIC_JOURNAL, 0, offsetof( zdiagsJournal_t, rec ), &zdiagsJournal );
+
     // Clears values in NV and saves the system clock for the last time stats were cleared
     osal_nv_write( ZCD_NV_DIAGNOSTIC_STATS, 0, sizeof( DiagStatistics_t ), &DiagsStatsTable );
   }
@@ -167,114 +314,27 @@ uint32 ZDiagsClearStats( bool clearNV )
 void ZDiagsUpdateStats( uint16 attributeId )
 {
 #if defined ( FEATURE_SYSTEM_STATS )
-  switch ( attributeId )
+  uint8 idx = zdiagsAttrIndex( attributeId );
+
+  if ( (idx == ZDIAGS_ATTR_INVALID) || (zdiagsAttrTbl[idx].offset == ZDIAGS_ATTR_NO_FIELD) )
   {
-    // System and Hardware Diagnostics
-    case ZDIAGS_SYSTEM_CLOCK:
-      DiagsStatsTable.SysClock = osal_GetSystemClock();
-      break;
-
-    case ZDIAGS_PERSISTENT_MEMORY_WRITES:
-      DiagsStatsTable.PersistentMemoryWrites++;
-      break;
-
-    // NWK Diagnostics
-    case ZDIAGS_ROUTE_DISC_INITIATED:
-      DiagsStatsTable.RouteDiscInitiated++;
-      break;
-
-    case ZDIAGS_NEIGHBOR_ADDED:
-      DiagsStatsTable.NeighborAdded++;
-      break;
-
-    case ZDIAGS_NEIGHBOR_REMOVED:
-      DiagsStatsTable.NeighborRemoved++;
-      break;
-
-    case ZDIAGS_NEIGHBOR_STALE:
-      DiagsStatsTable.NeighborStale++;
-      break;
-
-    case ZDIAGS_JOIN_INDICATION:
-      DiagsStatsTable.JoinIndication++;
-      break;
-
-    case ZDIAGS_CHILD_MOVED:
-      DiagsStatsTable.ChildMoved++;
-      break;
-
-    case ZDIAGS_NWK_FC_FAILURE:
-      DiagsStatsTable.NwkFcFailure++;
-      break;
-
-    case ZDIAGS_NWK_DECRYPT_FAILURES:
-      DiagsStatsTable.NwkDecryptFailures++;
-      break;
-
-    case ZDIAGS_PACKET_BUFFER_ALLOCATE_FAILURES:
-      DiagsStatsTable.PacketBufferAllocateFailures++;
-      break;
-
-    case ZDIAGS_RELAYED_UCAST:
-      DiagsStatsTable.RelayedUcast++;
-      break;
-
-    case ZDIAGS_PHY_TO_MAC_QUEUE_LIMIT_REACHED:
-      DiagsStatsTable.PhyToMacQueueLimitReached++;
-      break;
-
-    case ZDIAGS_PACKET_VALIDATE_DROP_COUNT:
-      DiagsStatsTable.PacketValidateDropCount++;
-      break;
-
-    // APS Diagnostics
-    case ZDIAGS_APS_RX_BCAST:
-      DiagsStatsTable.ApsRxBcast++;
-      break;
-
-    case ZDIAGS_APS_TX_BCAST:
-      DiagsStatsTable.ApsTxBcast++;
-      break;
-
-    case ZDIAGS_APS_RX_UCAST:
-      DiagsStatsTable.ApsRxUcast++;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_SUCCESS:
-      DiagsStatsTable.ApsTxUcastSuccess++;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_RETRY:
-      DiagsStatsTable.ApsTxUcastRetry++;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_FAIL:
-      DiagsStatsTable.ApsTxUcastFail++;
-      break;
-
-    case ZDIAGS_APS_FC_FAILURE:
-      DiagsStatsTable.ApsFcFailure++;
-      break;
-
-    case ZDIAGS_APS_UNAUTHORIZED_KEY:
-      DiagsStatsTable.ApsUnauthorizedKey++;
-      break;
-
-    case ZDIAGS_APS_DECRYPT_FAILURES:
-      DiagsStatsTable.ApsDecryptFailures++;
-      break;
-
-    case ZDIAGS_APS_INVALID_PACKETS:
-      DiagsStatsTable.ApsInvalidPackets++;
-      break;
-
-    case ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS:
-      DiagsStatsTable.MacRetriesPerApsTxSuccess++;
-      break;
+    return;
+  }
 
-    default:
-      break;
+  if ( attributeId == ZDIAGS_SYSTEM_CLOCK )
+  {
+    DiagsStatsTable.SysClock = osal_GetSystemClock();
+  }
+  else if ( zdiagsAttrTbl[idx].len == sizeof( uint16 ) )
+  {
+    (*(uint16 *)((uint8 *)&DiagsStatsTable + zdiagsAttrTbl[idx].offset))++;
   }
+  else
+  {
+    (*(uint32 *)((uint8 *)&DiagsStatsTable + zdiagsAttrTbl[idx].offset))++;
+  }
+
+  ZDIAGS_DIRTY_SET( idx );
 #endif // FEATURE_SYSTEM_STATS
 }
 
@@ -296,169 +356,33 @@ uint32 ZDiagsGetStatsAttr( uint16 attributeId )
   uint32 diagsValue = 0;
 
 #if defined ( FEATURE_SYSTEM_STATS )
-  switch ( attributeId )
-  {
-    // System and Hardware Diagnostics
-    case ZDIAGS_SYSTEM_CLOCK:
-      // this is the system clock when statistics were cleared;
-      diagsValue = DiagsStatsTable.SysClock;
-      break;
-
-    case ZDIAGS_NUMBER_OF_RESETS:
-      // Get the value from NV memory
-      osal_nv_read( ZCD_NV_BOOTCOUNTER, 0, sizeof(uint16), &diagsValue );
-      break;
-
-    case ZDIAGS_PERSISTENT_MEMORY_WRITES:
-      diagsValue = DiagsStatsTable.PersistentMemoryWrites;
-      break;
-
-    // MAC Diagnostics
-    case ZDIAGS_MAC_RX_CRC_PASS:
-      ZMacGetReq( ZMacDiagsRxCrcPass, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacRxCrcPass = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_RX_CRC_FAIL:
-      ZMacGetReq( ZMacDiagsRxCrcFail, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacRxCrcFail = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_RX_BCAST:
-      ZMacGetReq( ZMacDiagsRxBcast, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacRxBcast = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_TX_BCAST:
-      ZMacGetReq( ZMacDiagsTxBcast, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacTxBcast = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_RX_UCAST:
-      ZMacGetReq( ZMacDiagsRxUcast, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacRxUcast = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_TX_UCAST:
-      ZMacGetReq( ZMacDiagsTxUcast, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacTxUcast = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_TX_UCAST_RETRY:
-      ZMacGetReq( ZMacDiagsTxUcastRetry, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacTxUcastRetry = diagsValue;
-      break;
-
-    case ZDIAGS_MAC_TX_UCAST_FAIL:
-      ZMacGetReq( ZMacDiagsTxUcastFail, (uint8 *)&diagsValue );
-      // Update the statistics table with this value from MAC
-      DiagsStatsTable.MacTxUcastFail = diagsValue;
-      break;
-
-    // NWK Diagnostics
-    case ZDIAGS_ROUTE_DISC_INITIATED:
-      diagsValue = DiagsStatsTable.RouteDiscInitiated;
-      break;
-
-    case ZDIAGS_NEIGHBOR_ADDED:
-      diagsValue = DiagsStatsTable.NeighborAdded;
-      break;
-
-    case ZDIAGS_NEIGHBOR_REMOVED:
-      diagsValue = DiagsStatsTable.NeighborRemoved;
-      break;
-
-    case ZDIAGS_NEIGHBOR_STALE:
-      diagsValue = DiagsStatsTable.NeighborStale;
-      break;
-
-    case ZDIAGS_JOIN_INDICATION:
-      diagsValue = DiagsStatsTable.JoinIndication;
-      break;
-
-    case ZDIAGS_CHILD_MOVED:
-      diagsValue = DiagsStatsTable.ChildMoved;
-      break;
-
-    case ZDIAGS_NWK_FC_FAILURE:
-      diagsValue = DiagsStatsTable.NwkFcFailure;
-      break;
-
-    case ZDIAGS_NWK_DECRYPT_FAILURES:
-      diagsValue = DiagsStatsTable.NwkDecryptFailures;
-      break;
-
-    case ZDIAGS_PACKET_BUFFER_ALLOCATE_FAILURES:
-      diagsValue = DiagsStatsTable.PacketBufferAllocateFailures;
-      break;
-
-    case ZDIAGS_RELAYED_UCAST:
-      diagsValue = DiagsStatsTable.RelayedUcast;
-      break;
-
-    case ZDIAGS_PHY_TO_MAC_QUEUE_LIMIT_REACHED:
-      diagsValue = DiagsStatsTable.PhyToMacQueueLimitReached;
-      break;
-
-    case ZDIAGS_PACKET_VALIDATE_DROP_COUNT:
-      diagsValue = DiagsStatsTable.PacketValidateDropCount;
-      break;
-
-    // APS Diagnostics
-    case ZDIAGS_APS_RX_BCAST:
-      diagsValue = DiagsStatsTable.ApsRxBcast;
-      break;
-
-    case ZDIAGS_APS_TX_BCAST:
-      diagsValue = DiagsStatsTable.ApsTxBcast;
-      break;
-
-    case ZDIAGS_APS_RX_UCAST:
-      diagsValue = DiagsStatsTable.ApsRxUcast;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_SUCCESS:
-      diagsValue = DiagsStatsTable.ApsTxUcastSuccess;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_RETRY:
-      diagsValue = DiagsStatsTable.ApsTxUcastRetry;
-      break;
-
-    case ZDIAGS_APS_TX_UCAST_FAIL:
-      diagsValue = DiagsStatsTable.ApsTxUcastFail;
-      break;
-
-    case ZDIAGS_APS_FC_FAILURE:
-      diagsValue = DiagsStatsTable.ApsFcFailure;
-      break;
-
-    case ZDIAGS_APS_UNAUTHORIZED_KEY:
-      diagsValue = DiagsStatsTable.ApsUnauthorizedKey;
-      break;
-
-    case ZDIAGS_APS_DECRYPT_FAILURES:
-      diagsValue = DiagsStatsTable.ApsDecryptFailures;
-      break;
-
-    case ZDIAGS_APS_INVALID_PACKETS:
-      diagsValue = DiagsStatsTable.ApsInvalidPackets;
-      break;
-
-    case ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS:
-      diagsValue = DiagsStatsTable.MacRetriesPerApsTxSuccess;
-      break;
+  uint8 idx = zdiagsAttrIndex( attributeId );
 
+  if ( idx == ZDIAGS_ATTR_INVALID )
+  {
+    return ( diagsValue );
+  }
 
-    default:
-      break;
+  if ( attributeId == ZDIAGS_NUMBER_OF_RESETS )
+  {
+    // Get the value from NV memory
+    osal_nv_read( ZCD_NV_BOOTCOUNTER, 0, sizeof(uint16), &diagsValue );
+  }
+  else if ( (attributeId >= ZDIAGS_ATTR_SET2_START) && (attributeId <= ZDIAGS_ATTR_SET2_END) )
+  {
+    // MAC counters are kept by the MAC, the MAC diagnostics PIB attributes
+    // follow the same order as the attribute IDs
+    ZMacGetReq( (ZMacAttributes_t)(ZMacDiagsRxCrcPass + (attributeId - ZDIAGS_MAC_RX_CRC_PASS)),
+                (uint8 *)&diagsValue );
+
+    // Update the statistics table with this value from MAC. MAC counters
+    // move with every frame and restart from zero after a reset, so they are
+    // not journalled, only saved with the table.
+    zdiagsWriteField( idx, diagsValue );
+  }
+  else
+  {
+    diagsValue = zdiagsReadField( idx );
   }
 #endif // FEATURE_SYSTEM_STATS
 
@@ -475,17 +399,8 @@ uint32 ZDiagsGetStatsAttr( uint16 attributeId )
 DiagStatistics_t *ZDiagsGetStatsTable( void )
 {
 #if defined ( FEATURE_SYSTEM_STATS )
-  // call this function to update the DiagsStatsTable with MAC values,
-  // the return value does not need to be saved because the function
-  // is updating the value in DiagsStatsTable
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_CRC_PASS );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_CRC_FAIL );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_BCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_BCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_UCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST_RETRY );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST_FAIL );
+  // update the DiagsStatsTable with MAC values
+  zdiagsUpdateMacStats();
 
   return ( &DiagsStatsTable );
 #else
@@ -493,10 +408,64 @@ DiagStatistics_t *ZDiagsGetStatsTable( void )
 #endif  // FEATURE_SYSTEM_STATS
 }
 
+/****************************************************************************
+ * @fn          ZDiagsGetStatsSnapshot
+ *
+ * @brief       Copies all the statistics and metrics into a buffer, in
+ *              attribute ID order. Each value is little endian and takes
+ *              the size of its attribute (2 or 4 bytes).
+ *
+ * @param       pBuf - buffer of at least ZDIAGS_SNAPSHOT_LEN bytes
+ *
+ * @return      Number of bytes copied into pBuf.
+ */
+uint8 ZDiagsGetStatsSnapshot( uint8 *pBuf )
+{
+  uint8 len = 0;
+
+#if defined ( FEATURE_SYSTEM_STATS )
+  uint32 value;
+  uint16 bootCnt = 0;
+  uint8 idx;
+
+  zdiagsUpdateMacStats();
+
+  for ( idx = 0; idx < ZDIAGS_ATTR_CNT; idx++ )
+  {
+    if ( zdiagsAttrTbl[idx].offset == ZDIAGS_ATTR_NO_FIELD )
+    {
+      // Number of resets, the only attribute kept outside DiagsStatsTable
+      osal_nv_read( ZCD_NV_BOOTCOUNTER, 0, sizeof(bootCnt), &bootCnt );
+      value = bootCnt;
+    }
+    else
+    {
+      value = zdiagsReadField( idx );
+    }
+
+    if ( zdiagsAttrTbl[idx].len == sizeof( uint16 ) )
+    {
+      pBuf[len++] = LO_UINT16( (uint16)value );
+      pBuf[len++] = HI_UINT16( (uint16)value );
+    }
+    else
+    {
+      osal_buffer_uint32( &pBuf[len], value );
+      len += sizeof( uint32 );
+    }
+  }
+#else
+  (void)pBuf;
+#endif // FEATURE_SYSTEM_STATS
+
+  return ( len );
+}
+
 /****************************************************************************
  * @fn          ZDiagsRestoreStatsFromNV
  *
  * @brief       Restores the statistics table from NV into the RAM table.
+ *              The counters saved in the journal are applied over the table.
  *
  * @param       none.
  *
@@ -514,6 +483,8 @@ uint8 ZDiagsRestoreStatsFromNV( void )
                          (uint16)sizeof( DiagStatistics_t ),
                          &DiagsStatsTable ) == SUCCESS )
   {
+    uint8 i;
+
     // restore MAC values into the PIB
     /*
     ZMacSetReq( ZMacDiagsRxCrcPass, (uint8 *)&(DiagsStatsTable.MacRxCrcPass) );
@@ -525,6 +496,31 @@ uint8 ZDiagsRestoreStatsFromNV( void )
     ZMacSetReq( ZMacDiagsTxUcastRetry, (uint8 *)&(DiagsStatsTable.MacTxUcastRetry) );
     ZMacSetReq( ZMacDiagsTxUcastFail, (uint8 *)&(DiagsStatsTable.MacTxUcastFail) );
 */
+
+    // replay the counters saved since the table was last written, records
+    // left from before that table was written carry an older table clock
+    if ( (osal_nv_read( ZCD_NV_DIAGNOSTIC_JOURNAL, 0,
+                        (uint16)sizeof( zdiagsJournal_t ), &zdiagsJournal ) != SUCCESS) ||
+         (zdiagsJournal.cnt > ZDIAGS_JOURNAL_CNT) ||
+         (zdiagsJournal.tableClock != DiagsStatsTable.SysClock) )
+    {
+      zdiagsJournal.cnt = 0;
+    }
+    zdiagsTableClock = DiagsStatsTable.SysClock;
+
+    for ( i = 0; i < zdiagsJournal.cnt; i++ )
+    {
+      uint8 idx = zdiagsJournal.rec[i].idx;
+
+      if ( (idx < ZDIAGS_ATTR_CNT) && (zdiagsAttrTbl[idx].offset != ZDIAGS_ATTR_NO_FIELD) )
+      {
+        zdiagsWriteField( idx, osal_build_uint32( zdiagsJournal.rec[i].value, 4 ) );
+      }
+    }
+
+    osal_memset( zdiagsDirty, 0, sizeof( zdiagsDirty ) );
+    zdiagsTableStale = FALSE;
+
     retValue = ZSuccess;
   }
 #endif // FEATURE_SYSTEM_STATS
@@ -535,7 +531,11 @@ uint8 ZDiagsRestoreStatsFromNV( void )
 /****************************************************************************
  * @fn          ZDiagsSaveStatsToNV
  *
- * @brief       Saves the statistics table from RAM to NV.
+ * @brief       Saves the statistics table from RAM to NV. Only the counters
+ *              that changed since the last save are written, as records in
+ *              the journal item; a counter that already has a record is
+ *              updated in place. The whole table, with the MAC counters, is
+ *              written instead once the journal is full.
  *
  * @param       none.
  *
@@ -546,29 +546,210 @@ uint32 ZDiagsSaveStatsToNV( void )
   uint32 sysClock = 0;
 
 #if defined ( FEATURE_SYSTEM_STATS )
-  // call this function to update the DiagsStatsTable with MAC values,
-  // the return value does not need to be saved because the function
-  // is updating the value in DiagsStatsTable
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_CRC_PASS );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_CRC_FAIL );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_BCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_BCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_RX_UCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST_RETRY );
-  (void)ZDiagsGetStatsAttr( ZDIAGS_MAC_TX_UCAST_FAIL );
+  uint8 newCnt = 0;
+  uint8 idx;
+
+  // update the DiagsStatsTable with MAC values
+  zdiagsUpdateMacStats();
 
   // System Clock when statistics were saved
   sysClock = DiagsStatsTable.SysClock = osal_GetSystemClock();
 
-  // save the statistics table from RAM to NV
-  osal_nv_write( ZCD_NV_DIAGNOSTIC_STATS, 0,
-                 sizeof( DiagStatistics_t ), &DiagsStatsTable );
+  // Nothing to save if no journalled counter moved since the last save
+  if ( !zdiagsTableStale && osal_isbufset( zdiagsDirty, 0, sizeof( zdiagsDirty ) ) )
+  {
+    return ( sysClock );
+  }
+
+  ZDIAGS_DIRTY_SET( zdiagsAttrIndex( ZDIAGS_SYSTEM_CLOCK ) );
+
+  // Only the counters without a record yet take up journal space
+  for ( idx = 0; idx < ZDIAGS_ATTR_CNT; idx++ )
+  {
+    if ( ZDIAGS_IS_DIRTY( idx ) && (zdiagsJournalFind( idx ) == NULL) )
+    {
+      newCnt++;
+    }
+  }
+
+  if ( zdiagsTableStale || ((zdiagsJournal.cnt + newCnt) > ZDIAGS_JOURNAL_CNT) )
+  {
+    // Journal is full, fold it into the statistics table. The records in NV
+    // stop applying once the table is saved with another clock, so the
+    // journal only has to be emptied first if it carries this clock.
+    zdiagsJournal.cnt = 0;
+    if ( zdiagsJournal.tableClock == sysClock )
+    {
+      osal_nv_write( ZCD_NV_DIAGNOSTIC_JOURNAL, 0,
+                     offsetof( zdiagsJournal_t, rec ), &zdiagsJournal );
+    }
+
+    // save the statistics table from RAM to NV
+    osal_nv_write( ZCD_NV_DIAGNOSTIC_STATS, 0,
+                   sizeof( DiagStatistics_t ), &DiagsStatsTable );
+    zdiagsTableClock = sysClock;
+    zdiagsTableStale = FALSE;
+  }
+  else
+  {
+    for ( idx = 0; idx < ZDIAGS_ATTR_CNT; idx++ )
+    {
+      if ( ZDIAGS_IS_DIRTY( idx ) )
+      {
+        zdiagsJournalRec_t *pRec = zdiagsJournalFind( idx );
+
+        if ( pRec == NULL )
+        {
+          pRec = &zdiagsJournal.rec[zdiagsJournal.cnt++];
+          pRec->idx = idx;
+        }
+
+        osal_buffer_uint32( pRec->value, zdiagsReadField( idx ) );
+      }
+    }
+
+    // Only the header and the used records are written
+    zdiagsJournal.tableClock = zdiagsTableClock;
+    osal_nv_write( ZCD_NV_DIAGNOSTIC_JOURNAL, 0,
+                   (uint16)(offsetof( zdiagsJournal_t, rec ) +
+                            (zdiagsJournal.cnt * sizeof( zdiagsJournalRec_t ))),
+                   &zdiagsJournal );
+  }
+
+  osal_memset( zdiagsDirty, 0, sizeof( zdiagsDirty ) );
 #endif
 
   // returns the System Time
   return ( sysClock );
 }
 
+#if defined ( FEATURE_SYSTEM_STATS )
+/****************************************************************************
+ * @fn          zdiagsAttrIndex
+ *
+ * @brief       Look up the index of an attribute in zdiagsAttrTbl.
+ *
+ * @param       attributeId - attribute to look up
+ *
+ * @return      Index into zdiagsAttrTbl, ZDIAGS_ATTR_INVALID if not found.
+ */
+static uint8 zdiagsAttrIndex( uint16 attributeId )
+{
+  // ZDIAGS_ATTR_SET1_START is 0, an unsigned ID can't be below it
+  if ( attributeId <= ZDIAGS_ATTR_SET1_END )
+  {
+    return ( (uint8)(attributeId - ZDIAGS_ATTR_SET1_START + ZDIAGS_ATTR_SET1_OFFSET) );
+  }
+  else if ( (attributeId >= ZDIAGS_ATTR_SET2_START) && (attributeId <= ZDIAGS_ATTR_SET2_END) )
+  {
+    return ( (uint8)(attributeId - ZDIAGS_ATTR_SET2_START + ZDIAGS_ATTR_SET2_OFFSET) );
+  }
+  else if ( (attributeId >= ZDIAGS_ATTR_SET3_START) && (attributeId <= ZDIAGS_ATTR_SET3_END) )
+  {
+    return ( (uint8)(attributeId - ZDIAGS_ATTR_SET3_START + ZDIAGS_ATTR_SET3_OFFSET) );
+  }
+  else if ( (attributeId >= ZDIAGS_ATTR_SET4_START) && (attributeId <= ZDIAGS_ATTR_SET4_END) )
+  {
+    return ( (uint8)(attributeId - ZDIAGS_ATTR_SET4_START + ZDIAGS_ATTR_SET4_OFFSET) );
+  }
+  else
+  {
+    return ( ZDIAGS_ATTR_INVALID );
+  }
+}
+
+/****************************************************************************
+ * @fn          zdiagsReadField
+ *
+ * @brief       Read a counter from the statistics table.
+ *
+ * @param       idx - index into zdiagsAttrTbl
+ *
+ * @return      Value of the counter.
+ */
+static uint32 zdiagsReadField( uint8 idx )
+{
+  uint8 *pField = (uint8 *)&DiagsStatsTable + zdiagsAttrTbl[idx].offset;
+
+  if ( zdiagsAttrTbl[idx].len == sizeof( uint16 ) )
+  {
+    return ( *(uint16 *)pField );
+  }
+  else
+  {
+    return ( *(uint32 *)pField );
+  }
+}
+
+/****************************************************************************
+ * @fn          zdiagsWriteField
+ *
+ * @brief       Write a counter in the statistics table.
+ *
+ * @param       idx - index into zdiagsAttrTbl
+ * @param       value - new value of the counter
+ *
+ * @return      none.
+ */
+static void zdiagsWriteField( uint8 idx, uint32 value )
+{
+  uint8 *pField = (uint8 *)&DiagsStatsTable + zdiagsAttrTbl[idx].offset;
+
+  if ( zdiagsAttrTbl[idx].len == sizeof( uint16 ) )
+  {
+    *(uint16 *)pField = (uint16)value;
+  }
+  else
+  {
+    *(uint32 *)pField = value;
+  }
+}
+
+/****************************************************************************
+ * @fn          zdiagsUpdateMacStats
+ *
+ * @brief       Update the statistics table with the MAC counters.
+ *
+ * @param       none.
+ *
+ * @return      none.
+ */
+static void zdiagsUpdateMacStats( void )
+{
+  uint16 attributeId;
+
+  // the return value does not need to be saved because the function
+  // is updating the value in DiagsStatsTable
+  for ( attributeId = ZDIAGS_ATTR_SET2_START; attributeId <= ZDIAGS_ATTR_SET2_END; attributeId++ )
+  {
+    (void)ZDiagsGetStatsAttr( attributeId );
+  }
+}
+
+/****************************************************************************
+ * @fn          zdiagsJournalFind
+ *
+ * @brief       Look up the journal record of a counter.
+ *
+ * @param       idx - index into zdiagsAttrTbl
+ *
+ * @return      Pointer to the record, NULL if the counter has none.
+ */
+static zdiagsJournalRec_t *zdiagsJournalFind( uint8 idx )
+{
+  uint8 i;
+
+  for ( i = 0; i < zdiagsJournal.cnt; i++ )
+  {
+    if ( zdiagsJournal.rec[i].idx == idx )
+    {
+      return ( &zdiagsJournal.rec[i] );
+    }
+  }
+
+  return ( NULL );
+}
+#endif // FEATURE_SYSTEM_STATS
+
 /****************************************************************************
-****************************************************************************/
\ No newline at end of file
+****************************************************************************/
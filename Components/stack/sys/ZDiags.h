@@ -103,6 +103,10 @@ extern "C"
 #define ZDIAGS_APS_INVALID_PACKETS                      0x0135  // APS invalid packet dropped
 #define ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS           0x0136  // Number of MAC retries per APS message successfully Tx
 
+// Size of the buffer needed by ZDiagsGetStatsSnapshot(), the statistics
+// table plus the number of resets
+#define ZDIAGS_SNAPSHOT_LEN                             ( sizeof( DiagStatistics_t ) + sizeof( uint16 ) )
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -165,6 +169,8 @@ extern uint32 ZDiagsGetStatsAttr( uint16 attributeId );
 
 extern DiagStatistics_t *ZDiagsGetStatsTable( void );
 
+extern uint8 ZDiagsGetStatsSnapshot( uint8 *pBuf );
+
 extern uint8 ZDiagsRestoreStatsFromNV( void );
 
 extern uint32 ZDiagsSaveStatsToNV( void );
@@ -78,6 +78,14 @@
 #define zclParseCmd( a, b )           zclCmdTable[(a)].pfnParseInProfile( (b) )
 #define zclProcessCmd( a, b )         zclCmdTable[(a)].pfnProcessInProfile( (b) )
 
+#if !defined ( ZCL_STANDALONE )
+  // zcl_HandleExternal() parses the commands it forwards itself, and only
+  // when a task is registered to receive them
+  #define zclParseDeferred( a )       ( zclCmdTable[(a)].pfnProcessInProfile == zcl_HandleExternal )
+#else
+  #define zclParseDeferred( a )       ( FALSE )
+#endif
+
 #define zcl_DefaultRspCmd( zclHdr )   ( zcl_ProfileCmd( (zclHdr).fc.type )     && \
                                         (zclHdr).fc.manuSpecific == 0          && \
                                         (zclHdr).commandID == ZCL_CMD_DEFAULT_RSP )
@@ -100,6 +108,9 @@
 /*********************************************************************
  * CONSTANTS
  */
+// Endpoint of the dispatch records that hand a plugin's clusters to it on
+// endpoints nothing else was registered for
+#define ZCL_DISPATCH_ANY_EP  0x00
 
 /*********************************************************************
  * TYPEDEFS
@@ -112,6 +123,27 @@ typedef struct zclLibPlugin
   zclInHdlr_t         pfnIncomingHdlr;    // function to handle incoming message
 } zclLibPlugin_t;
 
+// Plugin, application callbacks and cluster option of a range of an
+// endpoint's clusters
+typedef struct
+{
+  zclLibPlugin_t *pPlugin;        // NULL if no plugin handles the clusters
+  void           *pCBs;           // plugin's callbacks for the endpoint, NULL if none
+  zclOptionRec_t *pOption;        // NULL if the clusters have no option record
+  uint16         startClusterID;  // starting cluster ID
+  uint16         endClusterID;    // ending cluster ID
+  uint8          endpoint;        // ZCL_DISPATCH_ANY_EP for a plugin's own record
+} zclDispatchRec_t;
+
+// Plugin command callbacks list item
+typedef struct zclCmdCBsList
+{
+  struct zclCmdCBsList *next;
+  uint8                endpoint;          // application's endpoint
+  zclInHdlr_t          pfnIncomingHdlr;   // handler of the plugin the callbacks are for
+  void                 *pCBs;             // plugin specific callback record
+} zclCmdCBsList;
+
 // Command record list
 typedef struct zclCmdRecsList
 {
@@ -187,8 +219,19 @@ static zclLibPlugin_t *plugins = (zclLibPlugin_t *)NULL;
 #endif
 
 static zclAttrRecsList *attrList = (zclAttrRecsList *)NULL;
+static zclAttrRecsList *lastAttrList = (zclAttrRecsList *)NULL;
 static zclClusterOptionList *clusterOptionList = (zclClusterOptionList *)NULL;
 
+static zclCmdCBsList *cmdCBsList = (zclCmdCBsList *)NULL;
+
+// Sorted by endpoint and starting cluster ID, rebuilt whenever a plugin,
+// command callbacks or a cluster option list is registered
+static zclDispatchRec_t *zclDispatchTable = (zclDispatchRec_t *)NULL;
+static uint16 zclDispatchCount = 0;
+
+// Dispatch record of the message being processed
+static zclDispatchRec_t *zclInDispatch = (zclDispatchRec_t *)NULL;
+
 static zclConfigReportRecsList *configReportRecsList = (zclConfigReportRecsList *)NULL;
 
 static afIncomingMSGPacket_t *rawAFMsg = (afIncomingMSGPacket_t *)NULL;
@@ -203,6 +246,11 @@ static zclExternalFoundationHandlerList *externalEndPointHandlerList = (zclExter
 static uint8 *zclBuildHdr( zclFrameHdr_t *hdr, uint8 *pData );
 static uint8 zclCalcHdrSize( zclFrameHdr_t *hdr );
 static zclLibPlugin_t *zclFindPlugin( uint16 clusterID, uint16 profileID );
+static uint16 zclDispatchPos( zclDispatchRec_t *pTable, uint16 numRecs, uint8 endpoint, uint16 clusterID );
+static zclDispatchRec_t *zclSearchDispatch( zclDispatchRec_t *pTable, uint16 numRecs, uint8 endpoint, uint16 clusterID );
+static void zclInsertDispatch( zclDispatchRec_t *pTable, uint16 *pNumRecs, zclDispatchRec_t *pNewRec );
+static ZStatus_t zclBuildDispatchTable( void );
+static zclDispatchRec_t *zclFindDispatch( uint8 endpoint, uint16 clusterID );
 
 #if !defined ( ZCL_STANDALONE )
 static uint8 zcl_addExternalFoundationHandler( uint8 taskId, uint8 endPointId );
@@ -214,7 +262,8 @@ static uint8 zcl_getExternalFoundationHandler( afIncomingMSGPacket_t *pInMsg );
 #endif
 
 zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint );
-static zclOptionRec_t *zclFindClusterOption( uint8 endpoint, uint16 clusterID );
+static void zclBuildAttrIndex( zclAttrRecsList *pRecsList );
+static uint8 zclGetDispatchOption( zclDispatchRec_t *pRec );
 static uint8 zclGetClusterOption( uint8 endpoint, uint16 clusterID );
 static void zclSetSecurityOption( uint8 endpoint, uint16 clusterID, uint8 enable );
 
@@ -226,7 +275,7 @@ static zclAuthorizeCB_t zclGetAuthorizeCB( uint8 endpoint );
 #endif // ZCL_READ || ZCL_WRITE
 
 #ifdef ZCL_READ
-ZStatus_t zclReadAttrData( uint8 *pAttrData, zclAttrRec_t *pAttr, uint16 *pDataLen );
+ZStatus_t zclReadAttrData( uint8 *pAttrData, CONST zclAttrRec_t *pAttr, uint16 *pDataLen );
 static uint16 zclGetAttrDataLengthUsingCB( uint8 endpoint, uint16 clusterID, uint16 attrId );
 static ZStatus_t zclReadAttrDataUsingCB( uint8 endpoint, uint16 clusterId, uint16 attrId,
                                          uint8 *pAttrData, uint16 *pDataLen );
@@ -237,10 +286,10 @@ static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg );
 
 #ifdef ZCL_WRITE
 static ZStatus_t zclWriteAttrData( uint8 endpoint, afAddrType_t *srcAddr,
-                                   zclAttrRec_t *pAttr, zclWriteRec_t *pWriteRec );
+                                   CONST zclAttrRec_t *pAttr, zclWriteRec_t *pWriteRec );
 static ZStatus_t zclWriteAttrDataUsingCB( uint8 endpoint, afAddrType_t *srcAddr,
-                                          zclAttrRec_t *pAttr, uint8 *pAttrData );
-static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, zclAttrRec_t *pAttr );
+                                          CONST zclAttrRec_t *pAttr, uint8 *pAttrData );
+static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, CONST zclAttrRec_t *pAttr );
 static void *zclParseInWriteRspCmd( zclParseCmd_t *pCmd );
 static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg );
 static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg );
@@ -272,7 +321,7 @@ static void zclProcessInDiscAttrsExtCmd( zclIncoming_t *pInMsg, zclDiscoverAttrs
 static CONST zclCmdItems_t zclCmdTable[] =
 {
 #ifdef ZCL_READ
-  /* ZCL_CMD_READ */                { zclParseInReadCmd,             zclProcessInReadCmd             },
+  /* ZCL_CMD_READ */                { (zclParseInProfileCmd_t)NULL,  zclProcessInReadCmd             },
   /* ZCL_CMD_READ_RSP */            { zclParseInReadRspCmd,          zcl_HandleExternal              },
 #else
   /* ZCL_CMD_READ */                { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
@@ -280,10 +329,10 @@ static CONST zclCmdItems_t zclCmdTable[] =
 #endif // ZCL_READ
 
 #ifdef ZCL_WRITE
-  /* ZCL_CMD_WRITE */               { zclParseInWriteCmd,            zclProcessInWriteCmd            },
-  /* ZCL_CMD_WRITE_UNDIVIDED */     { zclParseInWriteCmd,            zclProcessInWriteUndividedCmd   },
+  /* ZCL_CMD_WRITE */               { (zclParseInProfileCmd_t)NULL,  zclProcessInWriteCmd            },
+  /* ZCL_CMD_WRITE_UNDIVIDED */     { (zclParseInProfileCmd_t)NULL,  zclProcessInWriteUndividedCmd   },
   /* ZCL_CMD_WRITE_RSP */           { zclParseInWriteRspCmd,         zcl_HandleExternal              },
-  /* ZCL_CMD_WRITE_NO_RSP */        { zclParseInWriteCmd,            zclProcessInWriteCmd            },
+  /* ZCL_CMD_WRITE_NO_RSP */        { (zclParseInProfileCmd_t)NULL,  zclProcessInWriteCmd            },
 #else
   /* ZCL_CMD_WRITE */               { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
   /* ZCL_CMD_WRITE_UNDIVIDED */     { (zclParseInProfileCmd_t)NULL,  (zclProcessInProfileCmd_t)NULL  },
@@ -671,7 +720,11 @@ static uint8 zcl_getExternalFoundationHandler( afIncomingMSGPacket_t *pInMsg )
 /*********************************************************************
  * @fn      zcl_HandleExternal
  *
- * @brief
+ * @brief   Send a foundation command to the task registered to handle it.
+ *          The command is parsed here, into the structure the task gets
+ *          in pCmd->attrCmd, so nothing is allocated when no task is
+ *          registered. With BDB_REPORTING, the reporting configuration
+ *          commands are processed in place instead.
  *
  * @param   pInMsg - incoming message to process
  *
@@ -689,6 +742,36 @@ uint8 zcl_HandleExternal( zclIncoming_t *pInMsg )
     return ( TRUE );
   }
 
+#ifdef BDB_REPORTING
+  if ( pInMsg->hdr.commandID == ZCL_CMD_CONFIG_REPORT )
+  {
+    bdb_ProcessInConfigReportCmd( pInMsg );
+    return ( TRUE );
+  }
+  if ( pInMsg->hdr.commandID == ZCL_CMD_READ_REPORT_CFG )
+  {
+    bdb_ProcessInReadReportCfgCmd( pInMsg );
+    return ( TRUE );
+  }
+#endif
+
+  if ( ( pInMsg->attrCmd == NULL ) &&
+       ( zclCmdTable[pInMsg->hdr.commandID].pfnParseInProfile != NULL ) )
+  {
+    zclParseCmd_t parseCmd;
+
+    parseCmd.endpoint = pInMsg->msg->endPoint;
+    parseCmd.dataLen = pInMsg->pDataLen;
+    parseCmd.pData = pInMsg->pData;
+
+    // zcl_ProcessMessageMSG() frees the parsed command if it isn't sent
+    pInMsg->attrCmd = zclParseCmd( pInMsg->hdr.commandID, &parseCmd );
+    if ( pInMsg->attrCmd == NULL )
+    {
+      return ( TRUE );
+    }
+  }
+
   pCmd = (zclIncomingMsg_t *)osal_msg_allocate( sizeof ( zclIncomingMsg_t ) );
   if ( pCmd != NULL )
   {
@@ -699,21 +782,7 @@ uint8 zcl_HandleExternal( zclIncoming_t *pInMsg )
     pCmd->srcAddr   = pInMsg->msg->srcAddr;
     pCmd->endPoint  = pInMsg->msg->endPoint;
     pCmd->attrCmd   = pInMsg->attrCmd;
-    
-#ifdef BDB_REPORTING
-    if(pCmd->zclHdr.commandID == ZCL_CMD_CONFIG_REPORT)
-    {
-      bdb_ProcessInConfigReportCmd(pCmd);
-      osal_msg_deallocate((uint8*)pCmd);
-      return TRUE;          
-    }
-    if(pCmd->zclHdr.commandID == ZCL_CMD_READ_REPORT_CFG)
-    {
-      bdb_ProcessInReadReportCfgCmd(pCmd);
-      osal_msg_deallocate((uint8*)pCmd);
-      return TRUE;
-    }
-#endif
+
     // Application will free the attrCmd buffer
     pInMsg->attrCmd = NULL;
 
@@ -811,7 +880,82 @@ ZStatus_t zcl_registerPlugin( uint16 startClusterID,
     pLoop->next = pNewItem;
   }
 
-  return ( ZSuccess );
+  return ( zclBuildDispatchTable() );
+}
+
+/*********************************************************************
+ * @fn          zcl_registerCmdCallbacks
+ *
+ * @brief       Register an application's command callbacks for the
+ *              clusters of a plugin
+ *
+ * @param       endpoint - application's endpoint
+ * @param       pfnIncomingHdlr - handler the plugin was registered with
+ * @param       pCBs - pointer to the plugin specific callback record
+ *
+ * @return      ZSuccess if OK
+ */
+ZStatus_t zcl_registerCmdCallbacks( uint8 endpoint, zclInHdlr_t pfnIncomingHdlr, void *pCBs )
+{
+  zclCmdCBsList *pNewItem;
+  zclCmdCBsList *pLoop;
+
+  // Fill in the new callbacks list
+  pNewItem = zcl_mem_alloc( sizeof( zclCmdCBsList ) );
+  if ( pNewItem == NULL )
+  {
+    return (ZMemError);
+  }
+
+  pNewItem->next = (zclCmdCBsList *)NULL;
+  pNewItem->endpoint = endpoint;
+  pNewItem->pfnIncomingHdlr = pfnIncomingHdlr;
+  pNewItem->pCBs = pCBs;
+
+  // Find spot in list
+  if ( cmdCBsList == NULL )
+  {
+    cmdCBsList = pNewItem;
+  }
+  else
+  {
+    // Look for end of list
+    pLoop = cmdCBsList;
+    while ( pLoop->next != NULL )
+    {
+      pLoop = pLoop->next;
+    }
+
+    // Put new item at end of list
+    pLoop->next = pNewItem;
+  }
+
+  return ( zclBuildDispatchTable() );
+}
+
+/*********************************************************************
+ * @fn          zcl_FindCallbacks
+ *
+ * @brief       Find the command callbacks an application registered
+ *              for an endpoint's cluster
+ *
+ * @param       endpoint - application's endpoint
+ * @param       clusterID - cluster ID
+ *
+ * @return      pointer to the callbacks, NULL if not found
+ */
+void *zcl_FindCallbacks( uint8 endpoint, uint16 clusterID )
+{
+  zclDispatchRec_t *pRec = zclInDispatch;
+
+  // Plugins normally ask for the callbacks of the message being processed
+  if ( ( pRec == NULL ) || ( pRec->endpoint != endpoint ) ||
+       ( clusterID < pRec->startClusterID ) || ( clusterID > pRec->endClusterID ) )
+  {
+    pRec = zclSearchDispatch( zclDispatchTable, zclDispatchCount, endpoint, clusterID );
+  }
+
+  return ( ( pRec != NULL ) ? pRec->pCBs : NULL );
 }
 
 #ifdef ZCL_DISCOVER
@@ -893,8 +1037,12 @@ ZStatus_t zcl_registerAttrList( uint8 endpoint, uint8 numAttr, CONST zclAttrRec_
   pNewItem->next = (zclAttrRecsList *)NULL;
   pNewItem->endpoint = endpoint;
   pNewItem->pfnReadWriteCB = NULL;
+  pNewItem->pfnAuthorizeCB = NULL;
   pNewItem->numAttributes = numAttr;
   pNewItem->attrs = newAttrList;
+  pNewItem->attrIndex = NULL;
+
+  zclBuildAttrIndex( pNewItem );
 
   // Find spot in list
   if ( attrList == NULL )
@@ -970,7 +1118,7 @@ ZStatus_t zcl_registerClusterOptionList( uint8 endpoint, uint8 numOption, zclOpt
     pLoop->next = pNewItem;
   }
 
-  return ( ZSuccess );
+  return ( zclBuildDispatchTable() );
 }
 
 /*********************************************************************
@@ -1083,6 +1231,9 @@ static uint8 zcl_DeviceOperational( uint8 srcEP, uint16 clusterID,
  *          NOTE: The calling application is responsible for incrementing
  *                the Sequence Number.
  *
+ *          The command is copied behind the ZCL header. Use zcl_CmdBufAlloc()
+ *          and zcl_SendCommandBuf() to serialize it in place instead.
+ *
  * @param   srcEp - source endpoint
  * @param   destAddr - destination address
  * @param   clusterID - cluster ID
@@ -1101,14 +1252,99 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
                            uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
                            uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
                            uint16 cmdFormatLen, uint8 *cmdFormat )
+{
+  uint8 *buf;
+  ZStatus_t status;
+
+  buf = zcl_CmdBufAlloc( cmdFormatLen );
+  if ( buf != NULL )
+  {
+    zcl_memcpy( buf, cmdFormat, cmdFormatLen );
+
+    status = zcl_SendCommandBuf( srcEP, destAddr, clusterID, cmd, specific, direction,
+                                 disableDefaultRsp, manuCode, seqNum, cmdFormatLen, buf );
+    zcl_CmdBufFree( buf );
+  }
+  else
+  {
+    status = ZMemError;
+  }
+
+  return ( status );
+}
+
+/*********************************************************************
+ * @fn      zcl_CmdBufAlloc
+ *
+ * @brief   Allocate a buffer to serialize a command into, with room for
+ *          the ZCL header in front of it.
+ *
+ * @param   cmdFormatLen - length of the command
+ *
+ * @return  pointer to the command area of the buffer, NULL if out of memory
+ */
+uint8 *zcl_CmdBufAlloc( uint16 cmdFormatLen )
+{
+  uint8 *buf = zcl_mem_alloc( ZCL_FRAME_HDR_MAX_LEN + cmdFormatLen );
+
+  if ( buf == NULL )
+  {
+    return ( NULL ); // EMBEDDED RETURN
+  }
+
+  return ( buf + ZCL_FRAME_HDR_MAX_LEN );
+}
+
+/*********************************************************************
+ * @fn      zcl_CmdBufFree
+ *
+ * @brief   Free a buffer allocated by zcl_CmdBufAlloc().
+ *
+ * @param   cmdFormat - pointer returned by zcl_CmdBufAlloc()
+ *
+ * @return  none
+ */
+void zcl_CmdBufFree( uint8 *cmdFormat )
+{
+  zcl_mem_free( cmdFormat - ZCL_FRAME_HDR_MAX_LEN );
+}
+
+/*********************************************************************
+ * @fn      zcl_SendCommandBuf
+ *
+ * @brief   Used to send Profile and Cluster Specific Command messages that
+ *          were serialized into a buffer from zcl_CmdBufAlloc(). The ZCL
+ *          header is built in the room in front of the command, so the
+ *          frame is sent without another allocation or copy. The caller
+ *          still owns the buffer.
+ *
+ *          NOTE: The calling application is responsible for incrementing
+ *                the Sequence Number.
+ *
+ * @param   srcEp - source endpoint
+ * @param   destAddr - destination address
+ * @param   clusterID - cluster ID
+ * @param   cmd - command ID
+ * @param   specific - whether the command is Cluster Specific
+ * @param   direction - client/server direction of the command
+ * @param   disableDefaultRsp - disable Default Response command
+ * @param   manuCode - manufacturer code for proprietary extensions to a profile
+ * @param   seqNumber - identification number for the transaction
+ * @param   cmdFormatLen - length of the command to be sent
+ * @param   cmdFormat - command to be sent, from zcl_CmdBufAlloc()
+ *
+ * @return  ZSuccess if OK
+ */
+ZStatus_t zcl_SendCommandBuf( uint8 srcEP, afAddrType_t *destAddr,
+                              uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                              uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                              uint16 cmdFormatLen, uint8 *cmdFormat )
 {
   endPointDesc_t *epDesc;
   zclFrameHdr_t hdr;
   uint8 *msgBuf;
   uint16 msgLen;
-  uint8 *pBuf;
   uint8 options;
-  ZStatus_t status;
 
   epDesc = afFindEndPointDesc( srcEP );
   if ( epDesc == NULL )
@@ -1192,30 +1428,14 @@ ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *destAddr,
   // Fill in the command
   hdr.commandID = cmd;
 
-  // calculate the needed buffer size
+  // Fill in the ZCL Header, ending right at the command frame
   msgLen = zclCalcHdrSize( &hdr );
+  msgBuf = cmdFormat - msgLen;
+  (void)zclBuildHdr( &hdr, msgBuf );
   msgLen += cmdFormatLen;
 
-  // Allocate the buffer needed
-  msgBuf = zcl_mem_alloc( msgLen );
-  if ( msgBuf != NULL )
-  {
-    // Fill in the ZCL Header
-    pBuf = zclBuildHdr( &hdr, msgBuf );
-
-    // Fill in the command frame
-    zcl_memcpy( pBuf, cmdFormat, cmdFormatLen );
-
-    status = AF_DataRequest( destAddr, epDesc, clusterID, msgLen, msgBuf,
-                             &APS_Counter, options, zcl_radius );
-    zcl_mem_free ( msgBuf );
-  }
-  else
-  {
-    status = ZMemError;
-  }
-
-  return ( status );
+  return ( AF_DataRequest( destAddr, epDesc, clusterID, msgLen, msgBuf,
+                           &APS_Counter, options, zcl_radius ) );
 }
 
 #ifdef ZCL_READ
@@ -1244,7 +1464,7 @@ ZStatus_t zcl_SendRead( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = readCmd->numAttr * 2; // Attribute ID
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     uint8 i;
@@ -1257,9 +1477,9 @@ ZStatus_t zcl_SendRead( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = HI_UINT16( readCmd->attrID[i] );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_READ, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1315,7 +1535,7 @@ ZStatus_t zcl_SendReadRsp( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = zcl_mem_alloc( len );
+  buf = zcl_CmdBufAlloc( len );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1349,9 +1569,9 @@ ZStatus_t zcl_SendReadRsp( uint8 srcEP, afAddrType_t *dstAddr,
       }
     } // for loop
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, len, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_READ_RSP, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, len, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1396,7 +1616,7 @@ ZStatus_t zcl_SendWriteRequest( uint8 srcEP, afAddrType_t *dstAddr, uint16 clust
     dataLen += zclGetAttrDataLength( statusRec->dataType, statusRec->attrData );
   }
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1412,9 +1632,9 @@ ZStatus_t zcl_SendWriteRequest( uint8 srcEP, afAddrType_t *dstAddr, uint16 clust
       pBuf = zclSerializeData( statusRec->dataType, statusRec->attrData, pBuf );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, cmd, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, cmd, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1447,7 +1667,7 @@ ZStatus_t zcl_SendWriteRsp( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = writeRspCmd->numAttr * ( 1 + 2 ); // status + attribute id
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1467,9 +1687,9 @@ ZStatus_t zcl_SendWriteRsp( uint8 srcEP, afAddrType_t *dstAddr,
       dataLen = 1;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_WRITE_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_WRITE_RSP, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1526,7 +1746,7 @@ ZStatus_t zcl_SendConfigReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1560,9 +1780,9 @@ ZStatus_t zcl_SendConfigReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
       }
     } // for loop
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_CONFIG_REPORT, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_CONFIG_REPORT, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1598,7 +1818,7 @@ ZStatus_t zcl_SendConfigReportRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   // Atrribute list (Status, Direction and Attribute ID)
   dataLen = cfgReportRspCmd->numAttr * ( 1 + 1 + 2 );
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1620,10 +1840,10 @@ ZStatus_t zcl_SendConfigReportRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       dataLen = 1;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID,
-                              ZCL_CMD_CONFIG_REPORT_RSP, FALSE, direction,
-                              disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID,
+                                 ZCL_CMD_CONFIG_REPORT_RSP, FALSE, direction,
+                                 disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1658,7 +1878,7 @@ ZStatus_t zcl_SendReadReportCfgCmd( uint8 srcEP, afAddrType_t *dstAddr,
 
   dataLen = readReportCfgCmd->numAttr * ( 1 + 2 ); // Direction + Atrribute ID
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1672,9 +1892,9 @@ ZStatus_t zcl_SendReadReportCfgCmd( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = HI_UINT16( readReportCfgCmd->attrList[i].attrID );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_READ_REPORT_CFG, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_READ_REPORT_CFG, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1734,7 +1954,7 @@ ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
     }
   }
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1773,10 +1993,10 @@ ZStatus_t zcl_SendReadReportCfgRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       }
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID,
-                              ZCL_CMD_READ_REPORT_CFG_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID,
+                                 ZCL_CMD_READ_REPORT_CFG_RSP, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1819,7 +2039,7 @@ ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
     dataLen += zclGetAttrDataLength( reportRec->dataType, reportRec->attrData );
   }
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -1836,9 +2056,9 @@ ZStatus_t zcl_SendReportCmd( uint8 srcEP, afAddrType_t *dstAddr,
       pBuf = zclSerializeData( reportRec->dataType, reportRec->attrData, pBuf );
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_REPORT, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -1944,7 +2164,7 @@ ZStatus_t zcl_SendDiscoverCmdsRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   ZStatus_t status = ZSuccess;
 
   // allocate memory
-  pCmdBuf = zcl_mem_alloc( payloadSize );
+  pCmdBuf = zcl_CmdBufAlloc( payloadSize );
   if ( pCmdBuf != NULL )
   {
     uint8 *pBuf = pCmdBuf;
@@ -1959,16 +2179,16 @@ ZStatus_t zcl_SendDiscoverCmdsRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
     // Send response message for either commands received or generated
     if( pDiscoverRspCmd->cmdType == ZCL_CMD_DISCOVER_CMDS_RECEIVED )
     {
-      status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_CMDS_RECEIVED_RSP, FALSE,
-                                direction, disableDefaultRsp, 0, seqNum, payloadSize, pCmdBuf );
+      status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_CMDS_RECEIVED_RSP, FALSE,
+                                   direction, disableDefaultRsp, 0, seqNum, payloadSize, pCmdBuf );
     }
     else if ( pDiscoverRspCmd->cmdType == ZCL_CMD_DISCOVER_CMDS_GEN )
     {
-      status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_CMDS_GEN_RSP, FALSE,
-                                direction, disableDefaultRsp, 0, seqNum, payloadSize, pCmdBuf );
+      status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_CMDS_GEN_RSP, FALSE,
+                                   direction, disableDefaultRsp, 0, seqNum, payloadSize, pCmdBuf );
     }
 
-    zcl_mem_free( pCmdBuf );
+    zcl_CmdBufFree( pCmdBuf );
   }
   else
   {
@@ -1999,7 +2219,7 @@ ZStatus_t zcl_SendDiscoverAttrsCmd( uint8 srcEP, afAddrType_t *dstAddr,
   uint8 *buf;
   ZStatus_t status;
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -2008,9 +2228,9 @@ ZStatus_t zcl_SendDiscoverAttrsCmd( uint8 srcEP, afAddrType_t *dstAddr,
     *pBuf++ = HI_UINT16(pDiscoverCmd->startAttr);
     *pBuf++ = pDiscoverCmd->maxAttrIDs;
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -2044,7 +2264,7 @@ ZStatus_t zcl_SendDiscoverAttrsRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
   // calculate the size of the command
   dataLen += pDiscoverRspCmd->numAttr * (2 + 1); // Attribute ID and Data Type
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -2060,9 +2280,9 @@ ZStatus_t zcl_SendDiscoverAttrsRspCmd( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = pDiscoverRspCmd->attrList[i].dataType;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS_RSP, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -2134,7 +2354,7 @@ ZStatus_t zcl_SendDiscoverAttrsExtRsp( uint8 srcEP, afAddrType_t *dstAddr,
   // calculate the size of the command
   dataLen += pDiscoverRspCmd->numAttr * (2 + 1 + 1); // Attribute ID, Data Type, and Access Control
 
-  buf = zcl_mem_alloc( dataLen );
+  buf = zcl_CmdBufAlloc( dataLen );
   if ( buf != NULL )
   {
     // Load the buffer - serially
@@ -2148,9 +2368,9 @@ ZStatus_t zcl_SendDiscoverAttrsExtRsp( uint8 srcEP, afAddrType_t *dstAddr,
       *pBuf++ = pDiscoverRspCmd->aExtAttrInfo[i].attrAccessControl;
     }
 
-    status = zcl_SendCommand( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS_EXT_RSP, FALSE,
-                              direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
-    zcl_mem_free( buf );
+    status = zcl_SendCommandBuf( srcEP, dstAddr, clusterID, ZCL_CMD_DISCOVER_ATTRS_EXT_RSP, FALSE,
+                                 direction, disableDefaultRsp, 0, seqNum, dataLen, buf );
+    zcl_CmdBufFree( buf );
   }
   else
   {
@@ -2176,6 +2396,7 @@ zclProcMsgStatus_t zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt )
 {
   endPointDesc_t *epDesc;
   zclIncoming_t inMsg;
+  zclDispatchRec_t *pDispatch;
   zclLibPlugin_t *pInPlugin;
   zclDefaultRspCmd_t defautlRspCmd;
   uint8 options;
@@ -2205,17 +2426,30 @@ zclProcMsgStatus_t zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt )
   // zcl_getParsedTransSeqNum() to retrieve this number.
   savedZCLTransSeqNum = inMsg.hdr.transSeqNum;
 
-  // Find the wanted endpoint
-  epDesc = afFindEndPointDesc( pkt->endPoint );
-  if ( epDesc == NULL )
+  // Find the plugin, callbacks and cluster option of the endpoint's cluster
+  pDispatch = zclFindDispatch( pkt->endPoint, pkt->clusterId );
+  zclInDispatch = pDispatch;
+
+  // AF only delivers messages to its own endpoints, so the endpoint is only
+  // looked up when the application registered nothing with ZCL for it
+  if ( ( pDispatch == NULL ) || ( pDispatch->endpoint == ZCL_DISPATCH_ANY_EP ) )
   {
-    rawAFMsg = NULL;
-    return ( ZCL_PROC_EP_NOT_FOUND );   // Error, ignore the message
+    epDesc = afFindEndPointDesc( pkt->endPoint );
+    if ( epDesc == NULL )
+    {
+      rawAFMsg = NULL;
+      return ( ZCL_PROC_EP_NOT_FOUND );   // Error, ignore the message
+    }
+
+    if ( epDesc->simpleDesc == NULL )
+    {
+      rawAFMsg = NULL;
+      return ( ZCL_PROC_NOT_OPERATIONAL ); // Error, ignore the message
+    }
   }
 
-  if ( ( epDesc->simpleDesc == NULL ) ||
-       ( zcl_DeviceOperational( pkt->endPoint, pkt->clusterId, inMsg.hdr.fc.type,
-                                inMsg.hdr.commandID, epDesc->simpleDesc->AppProfId ) == FALSE ) )
+  if ( zcl_DeviceOperational( pkt->endPoint, pkt->clusterId, inMsg.hdr.fc.type,
+                              inMsg.hdr.commandID, 0 ) == FALSE )
   {
     rawAFMsg = NULL;
     return ( ZCL_PROC_NOT_OPERATIONAL ); // Error, ignore the message
@@ -2241,11 +2475,10 @@ zclProcMsgStatus_t zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt )
 #endif
   {
     interPanMsg = FALSE;
-    options = zclGetClusterOption( pkt->endPoint, pkt->clusterId );
+    options = zclGetDispatchOption( pDispatch );
   }
 
-  // Find the appropriate plugin
-  pInPlugin = zclFindPlugin( pkt->clusterId, epDesc->simpleDesc->AppProfId );
+  pInPlugin = ( pDispatch != NULL ) ? pDispatch->pPlugin : NULL;
 
   // Local and remote Security options must match except for Default Response command
   if ( ( pInPlugin != NULL ) && !zcl_DefaultRspCmd( inMsg.hdr ) )
@@ -2285,17 +2518,26 @@ zclProcMsgStatus_t zcl_ProcessMessageMSG( afIncomingMSGPacket_t *pkt )
       status = ZCL_STATUS_UNSUP_MANU_GENERAL_COMMAND;
     }
     else if ( ( inMsg.hdr.commandID <= ZCL_CMD_MAX ) &&
-              ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL ) )
+              ( ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL ) ||
+                ( zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL ) ) )
     {
-      zclParseCmd_t parseCmd;
+      if ( ( zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile != NULL ) &&
+           !zclParseDeferred( inMsg.hdr.commandID ) )
+      {
+        zclParseCmd_t parseCmd;
 
-      parseCmd.endpoint = pkt->endPoint;
-      parseCmd.dataLen = inMsg.pDataLen;
-      parseCmd.pData = inMsg.pData;
+        parseCmd.endpoint = pkt->endPoint;
+        parseCmd.dataLen = inMsg.pDataLen;
+        parseCmd.pData = inMsg.pData;
+
+        // Parse the command, remember that the return value is a pointer to allocated memory
+        inMsg.attrCmd = zclParseCmd( inMsg.hdr.commandID, &parseCmd );
+      }
 
-      // Parse the command, remember that the return value is a pointer to allocated memory
-      inMsg.attrCmd = zclParseCmd( inMsg.hdr.commandID, &parseCmd );
-      if ( (inMsg.attrCmd != NULL) && (zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL) )
+      // Commands without a parse function are processed in place, from inMsg.pData
+      if ( ( (inMsg.attrCmd != NULL) || (zclCmdTable[inMsg.hdr.commandID].pfnParseInProfile == NULL) ||
+             zclParseDeferred( inMsg.hdr.commandID ) ) &&
+           ( zclCmdTable[inMsg.hdr.commandID].pfnProcessInProfile != NULL ) )
       {
         // Process the command
         if ( zclProcessCmd( inMsg.hdr.commandID, &inMsg ) == FALSE )
@@ -2537,125 +2779,524 @@ static zclLibPlugin_t *zclFindPlugin( uint16 clusterID, uint16 profileID )
   return ( (zclLibPlugin_t *)NULL );
 }
 
-#ifdef ZCL_DISCOVER
 /*********************************************************************
- * @fn      zclFindCmdRecsList
+ * @fn      zclDispatchPos
  *
- * @brief   Find the right command record list for an endpoint
+ * @brief   Find where a cluster of an endpoint goes in a dispatch table
  *
- * @param   endpoint - endpoint to look for
+ * @param   pTable - dispatch records, sorted by endpoint and cluster ID
+ * @param   numRecs - number of records
+ * @param   endpoint - Application's endpoint
+ * @param   clusterID - cluster ID looking for
  *
- * @return  pointer to record list, NULL if not found
+ * @return  number of records starting at or before the cluster
  */
-static zclCmdRecsList_t *zclFindCmdRecsList( uint8 endpoint )
+static uint16 zclDispatchPos( zclDispatchRec_t *pTable, uint16 numRecs,
+                              uint8 endpoint, uint16 clusterID )
 {
-  zclCmdRecsList_t *pLoop = gpCmdList;
+  uint16 low = 0;
+  uint16 high = numRecs;
+  uint16 mid;
 
-  while ( pLoop != NULL )
+  while ( low < high )
   {
-    if ( pLoop->endpoint == endpoint )
+    mid = ( low + high ) / 2;
+    if ( ( pTable[mid].endpoint < endpoint ) ||
+         ( ( pTable[mid].endpoint == endpoint ) && ( pTable[mid].startClusterID <= clusterID ) ) )
     {
-      return ( pLoop );
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
     }
-
-    pLoop = pLoop->pNext;
   }
 
-  return ( NULL );
+  return ( low );
 }
 
 /*********************************************************************
- * @fn      zclFindCmdRec
+ * @fn      zclSearchDispatch
  *
- * @brief   Find the command record that matchs the parameters
+ * @brief   Find the dispatch record of an endpoint's cluster
  *
+ * @param   pTable - dispatch records, sorted by endpoint and cluster ID
+ * @param   numRecs - number of records
  * @param   endpoint - Application's endpoint
- * @param   clusterID - cluster ID
- * @param   attrId - attribute looking for
- * @param   pAttr - attribute record to be returned
+ * @param   clusterID - cluster ID looking for
  *
- * @return  TRUE if record found. FALSE, otherwise.
+ * @return  pointer to the record, NULL if not found
  */
-uint8 zclFindCmdRec( uint8 endpoint, uint16 clusterID, uint8 cmdID, zclCommandRec_t *pCmd )
+static zclDispatchRec_t *zclSearchDispatch( zclDispatchRec_t *pTable, uint16 numRecs,
+                                            uint8 endpoint, uint16 clusterID )
 {
-  uint8 i;
-  zclCmdRecsList_t *pRec = zclFindCmdRecsList( endpoint );
+  uint16 pos;
 
-  if ( pRec != NULL )
+  pos = zclDispatchPos( pTable, numRecs, endpoint, clusterID );
+  if ( ( pos > 0 ) && ( pTable[pos-1].endpoint == endpoint ) &&
+       ( clusterID <= pTable[pos-1].endClusterID ) )
   {
-    for ( i = 0; i < pRec->numCommands; i++ )
-    {
-      if ( pRec->pCmdRecs[i].clusterID == clusterID && pRec->pCmdRecs[i].cmdID == cmdID )
-      {
-        *pCmd = pRec->pCmdRecs[i];
-
-        return ( TRUE ); // EMBEDDED RETURN
-      }
-    }
+    return ( &pTable[pos-1] );
   }
 
-  return ( FALSE );
+  return ( (zclDispatchRec_t *)NULL );
 }
-#endif // ZCL_DISCOVER
 
 /*********************************************************************
- * @fn      zclFindAttrRecsList
+ * @fn      zclInsertDispatch
  *
- * @brief   Find the right attribute record list for an endpoint
+ * @brief   Add a record to a dispatch table, keeping it sorted
  *
- * @param   clusterID - endpointto look for
+ * @param   pTable - dispatch records, with room for one more
+ * @param   pNumRecs - number of records, incremented
+ * @param   pNewRec - record to add
  *
- * @return  pointer to record list, NULL if not found
+ * @return  none
  */
-zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint )
+static void zclInsertDispatch( zclDispatchRec_t *pTable, uint16 *pNumRecs,
+                               zclDispatchRec_t *pNewRec )
 {
-  zclAttrRecsList *pLoop = attrList;
+  uint16 pos;
+  uint16 i;
 
-  while ( pLoop != NULL )
+  pos = zclDispatchPos( pTable, *pNumRecs, pNewRec->endpoint, pNewRec->startClusterID );
+  for ( i = *pNumRecs; i > pos; i-- )
   {
-    if ( pLoop->endpoint == endpoint )
-    {
-      return ( pLoop );
-    }
-
-    pLoop = pLoop->next;
+    pTable[i] = pTable[i-1];
   }
 
-  return ( NULL );
+  pTable[pos] = *pNewRec;
+  (*pNumRecs)++;
 }
 
 /*********************************************************************
- * @fn      zclFindAttrRec
+ * @fn      zclBuildDispatchTable
  *
- * @brief   Find the attribute record that matchs the parameters
+ * @brief   Build the dispatch table from the registered plugins,
+ *          command callbacks and cluster option lists. Each plugin
+ *          gets a record for any endpoint, and each endpoint its
+ *          callbacks were registered for a record of its own. An
+ *          option record splits out a record of its own cluster.
  *
- * @param   endpoint - Application's endpoint
- * @param   clusterID - cluster ID
- * @param   attrId - attribute looking for
- * @param   pAttr - attribute record to be returned
+ * @param   none
  *
- * @return  TRUE if record found. FALSE, otherwise.
+ * @return  ZSuccess if OK, ZMemError if the old table is kept
  */
-uint8 zclFindAttrRec( uint8 endpoint, uint16 clusterID, uint16 attrId, zclAttrRec_t *pAttr )
+static ZStatus_t zclBuildDispatchTable( void )
 {
+  zclLibPlugin_t *pPlugin;
+  zclCmdCBsList *pCBsItem;
+  zclClusterOptionList *pOptionItem;
+  zclDispatchRec_t *pTable;
+  zclDispatchRec_t *pRec;
+  zclDispatchRec_t newRec;
+  zclDispatchRec_t splitRec;
+  uint16 maxRecs = 0;
+  uint16 numRecs = 0;
   uint8 x;
-  zclAttrRecsList *pRec = zclFindAttrRecsList( endpoint );
 
-  if ( pRec != NULL )
+  // Count the records, an option record may split a range in three
+  for ( pPlugin = plugins; pPlugin != NULL; pPlugin = pPlugin->next )
   {
-    for ( x = 0; x < pRec->numAttributes; x++ )
+    maxRecs++;
+    for ( pCBsItem = cmdCBsList; pCBsItem != NULL; pCBsItem = pCBsItem->next )
     {
-      if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
+      if ( pCBsItem->pfnIncomingHdlr == pPlugin->pfnIncomingHdlr )
       {
-        *pAttr = pRec->attrs[x];
+        maxRecs++;
+      }
+    }
+  }
 
-        return ( TRUE ); // EMBEDDED RETURN
+  for ( pOptionItem = clusterOptionList; pOptionItem != NULL; pOptionItem = pOptionItem->next )
+  {
+    maxRecs += 2 * pOptionItem->numOptions;
+  }
+
+  pTable = NULL;
+  if ( maxRecs > 0 )
+  {
+    pTable = zcl_mem_alloc( maxRecs * sizeof( zclDispatchRec_t ) );
+    if ( pTable == NULL )
+    {
+      return ( ZMemError );
+    }
+  }
+
+  // Plugins handle their clusters on any endpoint
+  for ( pPlugin = plugins; pPlugin != NULL; pPlugin = pPlugin->next )
+  {
+    newRec.pPlugin = pPlugin;
+    newRec.pCBs = NULL;
+    newRec.pOption = NULL;
+    newRec.startClusterID = pPlugin->startClusterID;
+    newRec.endClusterID = pPlugin->endClusterID;
+    newRec.endpoint = ZCL_DISPATCH_ANY_EP;
+    zclInsertDispatch( pTable, &numRecs, &newRec );
+  }
+
+  // The first callbacks registered for an endpoint's plugin are used
+  for ( pCBsItem = cmdCBsList; pCBsItem != NULL; pCBsItem = pCBsItem->next )
+  {
+    for ( pPlugin = plugins; pPlugin != NULL; pPlugin = pPlugin->next )
+    {
+      if ( ( pCBsItem->pfnIncomingHdlr == pPlugin->pfnIncomingHdlr ) &&
+           ( zclSearchDispatch( pTable, numRecs, pCBsItem->endpoint,
+                                pPlugin->startClusterID ) == NULL ) )
+      {
+        newRec.pPlugin = pPlugin;
+        newRec.pCBs = pCBsItem->pCBs;
+        newRec.pOption = NULL;
+        newRec.startClusterID = pPlugin->startClusterID;
+        newRec.endClusterID = pPlugin->endClusterID;
+        newRec.endpoint = pCBsItem->endpoint;
+        zclInsertDispatch( pTable, &numRecs, &newRec );
       }
     }
   }
 
-  return ( FALSE );
-}
+  // As is the first option record registered for an endpoint's cluster
+  for ( pOptionItem = clusterOptionList; pOptionItem != NULL; pOptionItem = pOptionItem->next )
+  {
+    for ( x = 0; x < pOptionItem->numOptions; x++ )
+    {
+      zclOptionRec_t *pOption = &(pOptionItem->options[x]);
+
+      pRec = zclSearchDispatch( pTable, numRecs, pOptionItem->endpoint, pOption->clusterID );
+      if ( pRec == NULL )
+      {
+        newRec.pPlugin = zclFindPlugin( pOption->clusterID, 0 );
+        newRec.pCBs = NULL;
+        newRec.pOption = pOption;
+        newRec.startClusterID = pOption->clusterID;
+        newRec.endClusterID = pOption->clusterID;
+        newRec.endpoint = pOptionItem->endpoint;
+        zclInsertDispatch( pTable, &numRecs, &newRec );
+      }
+      else if ( pRec->pOption == NULL )
+      {
+        // Narrow the range down to the cluster and add what is left of it
+        splitRec = *pRec;
+        pRec->pOption = pOption;
+        pRec->startClusterID = pOption->clusterID;
+        pRec->endClusterID = pOption->clusterID;
+
+        if ( splitRec.startClusterID < pOption->clusterID )
+        {
+          newRec = splitRec;
+          newRec.endClusterID = pOption->clusterID - 1;
+          zclInsertDispatch( pTable, &numRecs, &newRec );
+        }
+
+        if ( splitRec.endClusterID > pOption->clusterID )
+        {
+          newRec = splitRec;
+          newRec.startClusterID = pOption->clusterID + 1;
+          zclInsertDispatch( pTable, &numRecs, &newRec );
+        }
+      }
+    }
+  }
+
+  if ( zclDispatchTable != NULL )
+  {
+    zcl_mem_free( zclDispatchTable );
+  }
+
+  zclDispatchTable = pTable;
+  zclDispatchCount = numRecs;
+  zclInDispatch = NULL;
+
+  return ( ZSuccess );
+}
+
+/*********************************************************************
+ * @fn      zclFindDispatch
+ *
+ * @brief   Find the plugin, callbacks and cluster option of an
+ *          endpoint's cluster
+ *
+ * @param   endpoint - Application's endpoint
+ * @param   clusterID - cluster ID looking for
+ *
+ * @return  pointer to the dispatch record, NULL if not found
+ */
+static zclDispatchRec_t *zclFindDispatch( uint8 endpoint, uint16 clusterID )
+{
+  zclDispatchRec_t *pRec;
+
+  pRec = zclSearchDispatch( zclDispatchTable, zclDispatchCount, endpoint, clusterID );
+  if ( pRec == NULL )
+  {
+    // Nothing registered for the endpoint's cluster, just the plugin
+    pRec = zclSearchDispatch( zclDispatchTable, zclDispatchCount, ZCL_DISPATCH_ANY_EP, clusterID );
+  }
+
+  return ( pRec );
+}
+
+#ifdef ZCL_DISCOVER
+/*********************************************************************
+ * @fn      zclFindCmdRecsList
+ *
+ * @brief   Find the right command record list for an endpoint
+ *
+ * @param   endpoint - endpoint to look for
+ *
+ * @return  pointer to record list, NULL if not found
+ */
+static zclCmdRecsList_t *zclFindCmdRecsList( uint8 endpoint )
+{
+  zclCmdRecsList_t *pLoop = gpCmdList;
+
+  while ( pLoop != NULL )
+  {
+    if ( pLoop->endpoint == endpoint )
+    {
+      return ( pLoop );
+    }
+
+    pLoop = pLoop->pNext;
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      zclFindCmdRec
+ *
+ * @brief   Find the command record that matchs the parameters
+ *
+ * @param   endpoint - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   attrId - attribute looking for
+ * @param   pAttr - attribute record to be returned
+ *
+ * @return  TRUE if record found. FALSE, otherwise.
+ */
+uint8 zclFindCmdRec( uint8 endpoint, uint16 clusterID, uint8 cmdID, zclCommandRec_t *pCmd )
+{
+  uint8 i;
+  zclCmdRecsList_t *pRec = zclFindCmdRecsList( endpoint );
+
+  if ( pRec != NULL )
+  {
+    for ( i = 0; i < pRec->numCommands; i++ )
+    {
+      if ( pRec->pCmdRecs[i].clusterID == clusterID && pRec->pCmdRecs[i].cmdID == cmdID )
+      {
+        *pCmd = pRec->pCmdRecs[i];
+
+        return ( TRUE ); // EMBEDDED RETURN
+      }
+    }
+  }
+
+  return ( FALSE );
+}
+#endif // ZCL_DISCOVER
+
+/*********************************************************************
+ * @fn      zclFindAttrRecsList
+ *
+ * @brief   Find the right attribute record list for an endpoint
+ *
+ * @param   clusterID - endpointto look for
+ *
+ * @return  pointer to record list, NULL if not found
+ */
+zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint )
+{
+  zclAttrRecsList *pLoop;
+
+  // Consecutive lookups are nearly always for the same endpoint
+  if ( ( lastAttrList != NULL ) && ( lastAttrList->endpoint == endpoint ) )
+  {
+    return ( lastAttrList );
+  }
+
+  pLoop = attrList;
+  while ( pLoop != NULL )
+  {
+    if ( pLoop->endpoint == endpoint )
+    {
+      lastAttrList = pLoop;
+      return ( pLoop );
+    }
+
+    pLoop = pLoop->next;
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      zclAttrRecCompare
+ *
+ * @brief   Order an attribute record against a (cluster, attribute) key
+ *
+ * @param   pAttr - attribute record
+ * @param   clusterID - cluster ID of the key
+ * @param   attrId - attribute ID of the key
+ *
+ * @return  negative if the record sorts before the key, positive if
+ *          after, 0 if it matches
+ */
+static int8 zclAttrRecCompare( CONST zclAttrRec_t *pAttr, uint16 clusterID, uint16 attrId )
+{
+  if ( pAttr->clusterID != clusterID )
+  {
+    return ( ( pAttr->clusterID < clusterID ) ? -1 : 1 );
+  }
+
+  if ( pAttr->attr.attrId != attrId )
+  {
+    return ( ( pAttr->attr.attrId < attrId ) ? -1 : 1 );
+  }
+
+  return ( 0 );
+}
+
+/*********************************************************************
+ * @fn      zclBuildAttrIndex
+ *
+ * @brief   Build the sorted index used to binary search an endpoint's
+ *          attribute records. If there is not enough memory for the
+ *          index, lookups fall back to a linear scan.
+ *
+ * @param   pRecsList - attribute record list to index
+ *
+ * @return  none
+ */
+static void zclBuildAttrIndex( zclAttrRecsList *pRecsList )
+{
+  uint8 *pIndex;
+  uint8 i;
+  uint8 j;
+
+  if ( pRecsList->attrIndex != NULL )
+  {
+    zcl_mem_free( pRecsList->attrIndex );
+    pRecsList->attrIndex = NULL;
+  }
+
+  if ( pRecsList->numAttributes == 0 )
+  {
+    return;
+  }
+
+  pIndex = zcl_mem_alloc( pRecsList->numAttributes );
+  if ( pIndex == NULL )
+  {
+    return;
+  }
+
+  // Insertion sort - attribute tables are normally grouped by cluster
+  // already, so this is close to linear.
+  for ( i = 0; i < pRecsList->numAttributes; i++ )
+  {
+    CONST zclAttrRec_t *pAttr = &(pRecsList->attrs[i]);
+
+    j = i;
+    while ( ( j > 0 ) &&
+            ( zclAttrRecCompare( &(pRecsList->attrs[pIndex[j-1]]),
+                                 pAttr->clusterID, pAttr->attr.attrId ) > 0 ) )
+    {
+      pIndex[j] = pIndex[j-1];
+      j--;
+    }
+
+    pIndex[j] = i;
+  }
+
+  pRecsList->attrIndex = pIndex;
+}
+
+/*********************************************************************
+ * @fn      zclFindAttrRecPtr
+ *
+ * @brief   Find the attribute record that matchs the parameters
+ *
+ * @param   endpoint - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   attrId - attribute looking for
+ *
+ * @return  pointer to the registered record, NULL if not found
+ */
+CONST zclAttrRec_t *zclFindAttrRecPtr( uint8 endpoint, uint16 clusterID, uint16 attrId )
+{
+  zclAttrRecsList *pRec = zclFindAttrRecsList( endpoint );
+
+  if ( pRec != NULL )
+  {
+    if ( pRec->attrIndex != NULL )
+    {
+      uint8 low = 0;
+      uint8 high = pRec->numAttributes;
+
+      // Binary search over the sorted index
+      while ( low < high )
+      {
+        uint8 mid = low + ( ( high - low ) >> 1 );
+        CONST zclAttrRec_t *pAttr = &(pRec->attrs[pRec->attrIndex[mid]]);
+        int8 cmp = zclAttrRecCompare( pAttr, clusterID, attrId );
+
+        if ( cmp == 0 )
+        {
+          return ( pAttr ); // EMBEDDED RETURN
+        }
+        else if ( cmp < 0 )
+        {
+          low = mid + 1;
+        }
+        else
+        {
+          high = mid;
+        }
+      }
+    }
+    else
+    {
+      uint8 x;
+
+      for ( x = 0; x < pRec->numAttributes; x++ )
+      {
+        if ( pRec->attrs[x].clusterID == clusterID && pRec->attrs[x].attr.attrId == attrId )
+        {
+          return ( &(pRec->attrs[x]) ); // EMBEDDED RETURN
+        }
+      }
+    }
+  }
+
+  return ( NULL );
+}
+
+/*********************************************************************
+ * @fn      zclFindAttrRec
+ *
+ * @brief   Find the attribute record that matchs the parameters
+ *
+ * @param   endpoint - Application's endpoint
+ * @param   clusterID - cluster ID
+ * @param   attrId - attribute looking for
+ * @param   pAttr - attribute record to be returned
+ *
+ * @return  TRUE if record found. FALSE, otherwise.
+ */
+uint8 zclFindAttrRec( uint8 endpoint, uint16 clusterID, uint16 attrId, zclAttrRec_t *pAttr )
+{
+  CONST zclAttrRec_t *pFound = zclFindAttrRecPtr( endpoint, clusterID, attrId );
+
+  if ( pFound != NULL )
+  {
+    *pAttr = *pFound;
+
+    return ( TRUE );
+  }
+
+  return ( FALSE );
+}
 
 #if defined ( ZCL_STANDALONE )
 /*********************************************************************
@@ -2681,6 +3322,7 @@ uint8 zclSetAttrRecList( uint8 endpoint, uint8 numAttr, CONST zclAttrRec_t attrL
   {
     pRecsList->numAttributes = numAttr;
     pRecsList->attrs = attrList;
+    zclBuildAttrIndex( pRecsList );
     return ( TRUE );
   }
 
@@ -2735,38 +3377,30 @@ static zclAuthorizeCB_t zclGetAuthorizeCB( uint8 endpoint )
 #endif // ZCL_READ || ZCL_WRITE
 
 /*********************************************************************
- * @fn      zclFindClusterOption
+ * @fn      zclGetDispatchOption
  *
- * @brief   Find the option record that matchs the cluster id
+ * @brief   Get the cluster option of a dispatch record
  *
- * @param   endpoint - Application's endpoint
- * @param   clusterID - cluster ID looking for
+ * @param   pRec - dispatch record, may be NULL
  *
- * @return  pointer to clutser option, NULL if not found
+ * @return  clutser option, AF_TX_OPTIONS_NONE if not found
  */
-static zclOptionRec_t *zclFindClusterOption( uint8 endpoint, uint16 clusterID )
+static uint8 zclGetDispatchOption( zclDispatchRec_t *pRec )
 {
-  zclClusterOptionList *pLoop;
+  uint8 option;
 
-  pLoop = clusterOptionList;
-  while ( pLoop != NULL )
+  if ( ( pRec != NULL ) && ( pRec->pOption != NULL ) )
   {
-    if ( pLoop->endpoint == endpoint )
+    option = pRec->pOption->option;
+    if ( !ZG_SECURE_ENABLED )
     {
-      uint8 x;
-      for ( x = 0; x < pLoop->numOptions; x++ )
-      {
-        if ( pLoop->options[x].clusterID == clusterID )
-        {
-          return ( &(pLoop->options[x]) ); // EMBEDDED RETURN
-        }
-      }
+      option &= (AF_EN_SECURITY ^ 0xFF); // make sure Application Link Key security is off
     }
 
-    pLoop = pLoop->next;
+    return ( option ); // EMBEDDED RETURN
   }
 
-  return ( NULL );
+  return ( AF_TX_OPTIONS_NONE );
 }
 
 /*********************************************************************
@@ -2781,22 +3415,7 @@ static zclOptionRec_t *zclFindClusterOption( uint8 endpoint, uint16 clusterID )
  */
 static uint8 zclGetClusterOption( uint8 endpoint, uint16 clusterID )
 {
-  uint8 option;
-  zclOptionRec_t *pOption;
-
-  pOption = zclFindClusterOption( endpoint, clusterID );
-  if ( pOption != NULL )
-  {
-    option = pOption->option;
-    if ( !ZG_SECURE_ENABLED )
-    {
-      option &= (AF_EN_SECURITY ^ 0xFF); // make sure Application Link Key security is off
-    }
-
-    return ( option ); // EMBEDDED RETURN
-  }
-
-  return ( AF_TX_OPTIONS_NONE );
+  return ( zclGetDispatchOption( zclFindDispatch( endpoint, clusterID ) ) );
 }
 
 /*********************************************************************
@@ -2812,9 +3431,15 @@ static uint8 zclGetClusterOption( uint8 endpoint, uint16 clusterID )
  */
 static void zclSetSecurityOption( uint8 endpoint, uint16 clusterID, uint8 enable )
 {
-  zclOptionRec_t *pOption;
+  zclDispatchRec_t *pRec;
+  zclOptionRec_t *pOption = NULL;
+
+  pRec = zclFindDispatch( endpoint, clusterID );
+  if ( pRec != NULL )
+  {
+    pOption = pRec->pOption;
+  }
 
-  pOption = zclFindClusterOption( endpoint, clusterID );
   if ( pOption != NULL )
   {
     if ( enable )
@@ -3322,7 +3947,7 @@ uint16 zclGetAttrDataLength( uint8 dataType, uint8 *pData )
  *
  * @return Success
  */
-ZStatus_t zclReadAttrData( uint8 *pAttrData, zclAttrRec_t *pAttr, uint16 *pDataLen )
+ZStatus_t zclReadAttrData( uint8 *pAttrData, CONST zclAttrRec_t *pAttr, uint16 *pDataLen )
 {
   uint16 dataLen;
 
@@ -3359,16 +3984,16 @@ ZStatus_t zclReadAttrData( uint8 *pAttrData, zclAttrRec_t *pAttr, uint16 *pDataL
 ZStatus_t zcl_ReadAttrData( uint8 endpoint, uint16 clusterId, uint16 attrId,
                                          uint8 *pAttrData, uint16 *pDataLen )
 {
-  zclAttrRec_t attrRec;
+  CONST zclAttrRec_t *pAttr = zclFindAttrRecPtr( endpoint, clusterId, attrId );
 
-  if ( zclFindAttrRec( endpoint, clusterId, attrId, &attrRec ) == FALSE )
+  if ( pAttr == NULL )
   {
     return ( ZCL_STATUS_FAILURE );
   }
 
-  if ( attrRec.attr.dataPtr != NULL )
+  if ( pAttr->attr.dataPtr != NULL )
   {
-    return zclReadAttrData( pAttrData, &attrRec, pDataLen );
+    return zclReadAttrData( pAttrData, pAttr, pDataLen );
   }
   else
   {
@@ -3477,7 +4102,7 @@ static ZStatus_t zclAuthorizeRead( uint8 endpoint, afAddrType_t *srcAddr, zclAtt
  * @return  Successful if data was written
  */
 static ZStatus_t zclWriteAttrData( uint8 endpoint, afAddrType_t *srcAddr,
-                                   zclAttrRec_t *pAttr, zclWriteRec_t *pWriteRec )
+                                   CONST zclAttrRec_t *pAttr, zclWriteRec_t *pWriteRec )
 {
   uint8 status;
 
@@ -3486,7 +4111,17 @@ static ZStatus_t zclWriteAttrData( uint8 endpoint, afAddrType_t *srcAddr,
     status = zclAuthorizeWrite( endpoint, srcAddr, pAttr );
     if ( status == ZCL_STATUS_SUCCESS )
     {
-      if ( ( zcl_ValidateAttrDataCB == NULL ) || zcl_ValidateAttrDataCB( pAttr, pWriteRec ) )
+      uint8 valid = TRUE;
+
+      if ( zcl_ValidateAttrDataCB != NULL )
+      {
+        // The validate callback takes a modifiable record
+        zclAttrRec_t attrRec = *pAttr;
+
+        valid = zcl_ValidateAttrDataCB( &attrRec, pWriteRec );
+      }
+
+      if ( valid )
       {
         // Write the attribute value
         uint16 len = zclGetAttrDataLength( pAttr->attr.dataType, pWriteRec->attrData );
@@ -3521,7 +4156,7 @@ static ZStatus_t zclWriteAttrData( uint8 endpoint, afAddrType_t *srcAddr,
  * @return  Successful if data was written
  */
 static ZStatus_t zclWriteAttrDataUsingCB( uint8 endpoint, afAddrType_t *srcAddr,
-                                          zclAttrRec_t *pAttr, uint8 *pAttrData )
+                                          CONST zclAttrRec_t *pAttr, uint8 *pAttrData )
 {
   uint8 status;
 
@@ -3564,7 +4199,7 @@ static ZStatus_t zclWriteAttrDataUsingCB( uint8 endpoint, afAddrType_t *srcAddr,
  * @return  ZCL_STATUS_SUCCESS: Operation authorized
  *          ZCL_STATUS_NOT_AUTHORIZED: Operation not authorized
  */
-static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, zclAttrRec_t *pAttr )
+static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, CONST zclAttrRec_t *pAttr )
 {
   if ( zcl_AccessCtrlAuthWrite( pAttr->attr.accessControl ) )
   {
@@ -3572,7 +4207,10 @@ static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, zclAt
 
     if ( pfnAuthorizeCB != NULL )
     {
-      return ( (*pfnAuthorizeCB)( srcAddr, pAttr, ZCL_OPER_WRITE ) );
+      // The authorize callback takes a modifiable record
+      zclAttrRec_t attrRec = *pAttr;
+
+      return ( (*pfnAuthorizeCB)( srcAddr, &attrRec, ZCL_OPER_WRITE ) );
     }
   }
 
@@ -3580,6 +4218,205 @@ static ZStatus_t zclAuthorizeWrite( uint8 endpoint, afAddrType_t *srcAddr, zclAt
 }
 #endif // ZCL_WRITE
 
+/*********************************************************************
+ * @fn      zclParseNextAttrID
+ *
+ * @brief   Get the next attribute ID of a received command (Read,
+ *          Read Reporting Configuration, ...) in place, without copying
+ *          the command.
+ *
+ * @param   pCmd - received data left to parse, updated to the next record
+ * @param   pAttrID - where to put the attribute ID
+ *
+ * @return  TRUE if an attribute ID was found, FALSE at the end of the data
+ */
+uint8 zclParseNextAttrID( zclParseCmd_t *pCmd, uint16 *pAttrID )
+{
+  if ( pCmd->dataLen < 2 )
+  {
+    return ( FALSE );
+  }
+
+  *pAttrID = BUILD_UINT16( pCmd->pData[0], pCmd->pData[1] );
+
+  pCmd->pData += 2;
+  pCmd->dataLen -= 2;
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      zclParseNextAttrRec
+ *
+ * @brief   Get the next attribute record (attribute ID, data type and
+ *          data) of a received command (Write, Report, ...) in place,
+ *          without copying the command. A record that doesn't fit in the
+ *          data left is not returned.
+ *
+ *      NOTE: *ppAttrData points into the received data, it is only valid
+ *            while the received message is, and is not aligned.
+ *
+ * @param   pCmd - received data left to parse, updated to the next record
+ * @param   pAttrID - where to put the attribute ID
+ * @param   pDataType - where to put the attribute data type
+ * @param   ppAttrData - where to put the pointer to the attribute data
+ *
+ * @return  TRUE if a record was found, FALSE at the end of the data
+ */
+uint8 zclParseNextAttrRec( zclParseCmd_t *pCmd, uint16 *pAttrID,
+                           uint8 *pDataType, uint8 **ppAttrData )
+{
+  uint8 *pBuf = pCmd->pData;
+  uint16 dataLeft;
+  uint16 attrDataLen;
+  uint8 dataType;
+
+  // attribute ID and data type
+  if ( pCmd->dataLen < 3 )
+  {
+    return ( FALSE );
+  }
+
+  dataType = pBuf[2];
+  dataLeft = pCmd->dataLen - 3;
+
+  // The length of a string is in its data, it has to be there to read it
+  if ( ( ( dataType == ZCL_DATATYPE_LONG_CHAR_STR || dataType == ZCL_DATATYPE_LONG_OCTET_STR ) &&
+         ( dataLeft < 2 ) ) ||
+       ( ( dataType == ZCL_DATATYPE_CHAR_STR || dataType == ZCL_DATATYPE_OCTET_STR ) &&
+         ( dataLeft < 1 ) ) )
+  {
+    return ( FALSE );
+  }
+
+  attrDataLen = zclGetAttrDataLength( dataType, &pBuf[3] );
+  if ( attrDataLen > dataLeft )
+  {
+    return ( FALSE );
+  }
+
+  *pAttrID = BUILD_UINT16( pBuf[0], pBuf[1] );
+  *pDataType = dataType;
+  *ppAttrData = &pBuf[3];
+
+  pCmd->pData += 3 + attrDataLen;
+  pCmd->dataLen = dataLeft - attrDataLen;
+
+  return ( TRUE );
+}
+
+#ifdef ZCL_REPORTING_DEVICE
+/*********************************************************************
+ * @fn      zclParseNextCfgReportRec
+ *
+ * @brief   Get the next attribute reporting configuration record of a
+ *          received Configure Reporting command in place, without copying
+ *          the command. A record that doesn't fit in the data left is not
+ *          returned.
+ *
+ *      NOTE: pRec->reportableChange points into the received data, it is
+ *            only valid while the received message is, and holds the
+ *            value as sent over the air (little endian, not aligned).
+ *
+ * @param   pCmd - received data left to parse, updated to the next record
+ * @param   pRec - where to put the record
+ *
+ * @return  TRUE if a record was found, FALSE at the end of the data
+ */
+uint8 zclParseNextCfgReportRec( zclParseCmd_t *pCmd, zclCfgReportRec_t *pRec )
+{
+  uint8 *pBuf = pCmd->pData;
+  uint16 recLen;
+
+  // direction and attribute ID
+  if ( pCmd->dataLen < 3 )
+  {
+    return ( FALSE );
+  }
+
+  if ( pBuf[0] == ZCL_SEND_ATTR_REPORTS )
+  {
+    // data type, Min and Max Reporting Intervals
+    recLen = 3 + 5;
+    if ( pCmd->dataLen < recLen )
+    {
+      return ( FALSE );
+    }
+
+    // For attributes of 'discrete' data types the Reportable Change is omitted
+    if ( zclAnalogDataType( pBuf[3] ) )
+    {
+      recLen += zclGetDataTypeLength( pBuf[3] );
+      if ( pCmd->dataLen < recLen )
+      {
+        return ( FALSE );
+      }
+    }
+  }
+  else
+  {
+    // Timeout Period
+    recLen = 3 + 2;
+    if ( pCmd->dataLen < recLen )
+    {
+      return ( FALSE );
+    }
+  }
+
+  zcl_memset( pRec, 0, sizeof( zclCfgReportRec_t ) );
+
+  pRec->direction = pBuf[0];
+  pRec->attrID = BUILD_UINT16( pBuf[1], pBuf[2] );
+  if ( pRec->direction == ZCL_SEND_ATTR_REPORTS )
+  {
+    pRec->dataType = pBuf[3];
+    pRec->minReportInt = BUILD_UINT16( pBuf[4], pBuf[5] );
+    pRec->maxReportInt = BUILD_UINT16( pBuf[6], pBuf[7] );
+    if ( recLen > 3 + 5 )
+    {
+      pRec->reportableChange = &pBuf[8];
+    }
+  }
+  else
+  {
+    pRec->timeoutPeriod = BUILD_UINT16( pBuf[3], pBuf[4] );
+  }
+
+  pCmd->pData += recLen;
+  pCmd->dataLen -= recLen;
+
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn      zclParseNextReadReportCfgRec
+ *
+ * @brief   Get the next record (direction and attribute ID) of a received
+ *          Read Reporting Configuration command in place, without copying
+ *          the command.
+ *
+ * @param   pCmd - received data left to parse, updated to the next record
+ * @param   pRec - where to put the record
+ *
+ * @return  TRUE if a record was found, FALSE at the end of the data
+ */
+uint8 zclParseNextReadReportCfgRec( zclParseCmd_t *pCmd, zclReadReportCfgRec_t *pRec )
+{
+  if ( pCmd->dataLen < 3 )
+  {
+    return ( FALSE );
+  }
+
+  pRec->direction = pCmd->pData[0];
+  pRec->attrID = BUILD_UINT16( pCmd->pData[1], pCmd->pData[2] );
+
+  pCmd->pData += 3;
+  pCmd->dataLen -= 3;
+
+  return ( TRUE );
+}
+#endif // ZCL_REPORTING_DEVICE
+
 #ifdef ZCL_READ
 /*********************************************************************
  * @fn      zclParseInReadCmd
@@ -3722,7 +4559,10 @@ static void *zclParseInReadRspCmd( zclParseCmd_t *pCmd )
 void *zclParseInWriteCmd( zclParseCmd_t *pCmd )
 {
   zclWriteCmd_t *writeCmd;
-  uint8 *pBuf = pCmd->pData;
+  zclParseCmd_t parseCmd = *pCmd;
+  uint16 attrID;
+  uint8 dataType;
+  uint8 *pAttrData;
   uint16 attrDataLen;
   uint8 *dataPtr;
   uint8 numAttr = 0;
@@ -3730,17 +4570,11 @@ void *zclParseInWriteCmd( zclParseCmd_t *pCmd )
   uint16 dataLen = 0;
 
   // find out the number of attributes and the length of attribute data
-  while ( pBuf < ( pCmd->pData + pCmd->dataLen ) )
+  while ( zclParseNextAttrRec( &parseCmd, &attrID, &dataType, &pAttrData ) )
   {
-    uint8 dataType;
-
     numAttr++;
-    pBuf += 2; // move pass attribute id
-
-    dataType = *pBuf++;
 
-    attrDataLen = zclGetAttrDataLength( dataType, pBuf );
-    pBuf += attrDataLen; // move pass attribute data
+    attrDataLen = zclGetAttrDataLength( dataType, pAttrData );
 
     // add padding if needed
     if ( PADDING_NEEDED( attrDataLen ) )
@@ -3758,7 +4592,7 @@ void *zclParseInWriteCmd( zclParseCmd_t *pCmd )
   if ( writeCmd != NULL )
   {
     uint8 i;
-    pBuf = pCmd->pData;
+    parseCmd = *pCmd;
     dataPtr = (uint8 *)( (uint8 *)writeCmd + hdrLen );
 
     writeCmd->numAttr = numAttr;
@@ -3766,16 +4600,13 @@ void *zclParseInWriteCmd( zclParseCmd_t *pCmd )
     {
       zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
 
-      statusRec->attrID = BUILD_UINT16( pBuf[0], pBuf[1] );
-      pBuf += 2;
-      statusRec->dataType = *pBuf++;
+      (void)zclParseNextAttrRec( &parseCmd, &(statusRec->attrID),
+                                 &(statusRec->dataType), &pAttrData );
 
-      attrDataLen = zclGetAttrDataLength( statusRec->dataType, pBuf );
-      zcl_memcpy( dataPtr, pBuf, attrDataLen);
+      attrDataLen = zclGetAttrDataLength( statusRec->dataType, pAttrData );
+      zcl_memcpy( dataPtr, pAttrData, attrDataLen);
       statusRec->attrData = dataPtr;
 
-      pBuf += attrDataLen; // move pass attribute data
-
       // advance attribute data pointer
       if ( PADDING_NEEDED( attrDataLen ) )
       {
@@ -3848,53 +4679,32 @@ static void *zclParseInWriteRspCmd( zclParseCmd_t *pCmd )
 void *zclParseInConfigReportCmd( zclParseCmd_t *pCmd )
 {
   zclCfgReportCmd_t *cfgReportCmd;
-  uint8 *pBuf = pCmd->pData;
+  zclParseCmd_t parseCmd = *pCmd;
+  zclCfgReportRec_t reportRec;
   uint8 *dataPtr;
   uint8 numAttr = 0;
-  uint8 dataType;
   uint8 hdrLen;
   uint16 dataLen = 0;
   uint8 reportChangeLen; // length of Reportable Change field
 
   // Calculate the length of the Request command
-  while ( pBuf < ( pCmd->pData + pCmd->dataLen ) )
+  while ( zclParseNextCfgReportRec( &parseCmd, &reportRec ) )
   {
-    uint8 direction;
-
     numAttr++;
-    direction = *pBuf++;
-    pBuf += 2; // move pass the attribute ID
 
-    // Is there a Reportable Change field?
-    if ( direction == ZCL_SEND_ATTR_REPORTS )
+    if ( reportRec.reportableChange != NULL )
     {
-      dataType = *pBuf++;
-      pBuf += 4; // move pass the Min and Max Reporting Intervals
-
-      // For attributes of 'discrete' data types this field is omitted
-      if ( zclAnalogDataType( dataType ) )
-      {
-        reportChangeLen = zclGetDataTypeLength( dataType );
-        pBuf += reportChangeLen;
-
-        // add padding if needed
-        if ( PADDING_NEEDED( reportChangeLen ) )
-        {
-          reportChangeLen++;
-        }
+      reportChangeLen = zclGetDataTypeLength( reportRec.dataType );
 
-        dataLen += reportChangeLen;
-      }
-      else
+      // add padding if needed
+      if ( PADDING_NEEDED( reportChangeLen ) )
       {
-        pBuf++; // move past reportable change field
+        reportChangeLen++;
       }
+
+      dataLen += reportChangeLen;
     }
-    else
-    {
-      pBuf += 2; // move pass the Timeout Period
-    }
-  } // while loop
+  }
 
   hdrLen = sizeof( zclCfgReportCmd_t ) + ( numAttr * sizeof( zclCfgReportRec_t ) );
 
@@ -3902,53 +4712,33 @@ void *zclParseInConfigReportCmd( zclParseCmd_t *pCmd )
   if ( cfgReportCmd != NULL )
   {
     uint8 i;
-    pBuf = pCmd->pData;
+    parseCmd = *pCmd;
     dataPtr = (uint8 *)( (uint8 *)cfgReportCmd + hdrLen );
 
     cfgReportCmd->numAttr = numAttr;
     for ( i = 0; i < numAttr; i++ )
     {
-      zclCfgReportRec_t *reportRec = &(cfgReportCmd->attrList[i]);
+      zclCfgReportRec_t *pReportRec = &(cfgReportCmd->attrList[i]);
 
-      zcl_memset( reportRec, 0, sizeof( zclCfgReportRec_t ) );
+      (void)zclParseNextCfgReportRec( &parseCmd, pReportRec );
 
-      reportRec->direction = *pBuf++;
-      reportRec->attrID = BUILD_UINT16( pBuf[0], pBuf[1] );
-      pBuf += 2;
-      if ( reportRec->direction == ZCL_SEND_ATTR_REPORTS )
+      // The application gets the Reportable Change in its own byte order
+      if ( pReportRec->reportableChange != NULL )
       {
-        // Attribute to be reported
-        reportRec->dataType = *pBuf++;
-        reportRec->minReportInt = BUILD_UINT16( pBuf[0], pBuf[1] );
-        pBuf += 2;
-        reportRec->maxReportInt = BUILD_UINT16( pBuf[0], pBuf[1] );
-        pBuf += 2;
-
-        // For attributes of 'discrete' data types this field is omitted
-        if ( zclAnalogDataType( reportRec->dataType ) )
-        {
-          zcl_BuildAnalogData( reportRec->dataType, dataPtr, pBuf);
-          reportRec->reportableChange = dataPtr;
+        zcl_BuildAnalogData( pReportRec->dataType, dataPtr, pReportRec->reportableChange );
+        pReportRec->reportableChange = dataPtr;
 
-          reportChangeLen = zclGetDataTypeLength( reportRec->dataType );
-          pBuf += reportChangeLen;
+        reportChangeLen = zclGetDataTypeLength( pReportRec->dataType );
 
-          // advance attribute data pointer
-          if ( PADDING_NEEDED( reportChangeLen ) )
-          {
-            reportChangeLen++;
-          }
-
-          dataPtr += reportChangeLen;
+        // advance attribute data pointer
+        if ( PADDING_NEEDED( reportChangeLen ) )
+        {
+          reportChangeLen++;
         }
+
+        dataPtr += reportChangeLen;
       }
-      else
-      {
-        // Attribute reports to be received
-        reportRec->timeoutPeriod = BUILD_UINT16( pBuf[0], pBuf[1] );
-        pBuf += 2;
-      }
-    } // while loop
+    }
   }
 
   return ( (void *)cfgReportCmd );
@@ -4011,7 +4801,7 @@ static void *zclParseInConfigReportRspCmd( zclParseCmd_t *pCmd )
 void *zclParseInReadReportCfgCmd( zclParseCmd_t *pCmd )
 {
   zclReadReportCfgCmd_t *readReportCfgCmd;
-  uint8 *pBuf = pCmd->pData;
+  zclParseCmd_t parseCmd = *pCmd;
   uint8 numAttr;
 
   numAttr = pCmd->dataLen / ( 1 + 2 ); // Direction + Attribute ID
@@ -4024,9 +4814,7 @@ void *zclParseInReadReportCfgCmd( zclParseCmd_t *pCmd )
     readReportCfgCmd->numAttr = numAttr;
     for ( i = 0; i < readReportCfgCmd->numAttr; i++)
     {
-      readReportCfgCmd->attrList[i].direction = *pBuf++;;
-      readReportCfgCmd->attrList[i].attrID = BUILD_UINT16( pBuf[0], pBuf[1] );
-      pBuf += 2;
+      (void)zclParseNextReadReportCfgRec( &parseCmd, &(readReportCfgCmd->attrList[i]) );
     }
   }
 
@@ -4172,7 +4960,10 @@ static void *zclParseInReadReportCfgRspCmd( zclParseCmd_t *pCmd )
 void *zclParseInReportCmd( zclParseCmd_t *pCmd )
 {
   zclReportCmd_t *reportCmd;
-  uint8 *pBuf = pCmd->pData;
+  zclParseCmd_t parseCmd = *pCmd;
+  uint16 attrID;
+  uint8 dataType;
+  uint8 *pAttrData;
   uint16 attrDataLen;
   uint8 *dataPtr;
   uint8 numAttr = 0;
@@ -4180,17 +4971,11 @@ void *zclParseInReportCmd( zclParseCmd_t *pCmd )
   uint16 dataLen = 0;
 
   // find out the number of attributes and the length of attribute data
-  while ( pBuf < ( pCmd->pData + pCmd->dataLen ) )
+  while ( zclParseNextAttrRec( &parseCmd, &attrID, &dataType, &pAttrData ) )
   {
-    uint8 dataType;
-
     numAttr++;
-    pBuf += 2; // move pass attribute id
-
-    dataType = *pBuf++;
 
-    attrDataLen = zclGetAttrDataLength( dataType, pBuf );
-    pBuf += attrDataLen; // move pass attribute data
+    attrDataLen = zclGetAttrDataLength( dataType, pAttrData );
 
     // add padding if needed
     if ( PADDING_NEEDED( attrDataLen ) )
@@ -4207,7 +4992,7 @@ void *zclParseInReportCmd( zclParseCmd_t *pCmd )
   if (reportCmd != NULL )
   {
     uint8 i;
-    pBuf = pCmd->pData;
+    parseCmd = *pCmd;
     dataPtr = (uint8 *)( (uint8 *)reportCmd + hdrLen );
 
     reportCmd->numAttr = numAttr;
@@ -4215,16 +5000,13 @@ void *zclParseInReportCmd( zclParseCmd_t *pCmd )
     {
       zclReport_t *reportRec = &(reportCmd->attrList[i]);
 
-      reportRec->attrID = BUILD_UINT16( pBuf[0], pBuf[1] );
-      pBuf += 2;
-      reportRec->dataType = *pBuf++;
+      (void)zclParseNextAttrRec( &parseCmd, &(reportRec->attrID),
+                                 &(reportRec->dataType), &pAttrData );
 
-      attrDataLen = zclGetAttrDataLength( reportRec->dataType, pBuf );
-      zcl_memcpy( dataPtr, pBuf, attrDataLen );
+      attrDataLen = zclGetAttrDataLength( reportRec->dataType, pAttrData );
+      zcl_memcpy( dataPtr, pAttrData, attrDataLen );
       reportRec->attrData = dataPtr;
 
-      pBuf += attrDataLen; // move pass attribute data
-
       // advance attribute data pointer
       if ( PADDING_NEEDED( attrDataLen ) )
       {
@@ -4452,17 +5234,22 @@ static void *zclParseInDiscAttrsExtRspCmd( zclParseCmd_t *pCmd )
  */
 static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
 {
-  zclReadCmd_t *readCmd;
+  zclParseCmd_t parseCmd;
   zclReadRspCmd_t *readRspCmd;
-  zclAttrRec_t attrRec;
+  CONST zclAttrRec_t *pAttr;
   uint16 len;
+  uint8 numAttr;
   uint8 i;
-  uint8 attrFound;
 
-  readCmd = (zclReadCmd_t *)pInMsg->attrCmd;
+  // The attribute IDs are read in place, from the received message
+  parseCmd.endpoint = pInMsg->msg->endPoint;
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+
+  numAttr = (uint8)(pInMsg->pDataLen / 2); // Atrribute ID
 
   // calculate the length of the response status record
-  len = sizeof( zclReadRspCmd_t ) + (readCmd->numAttr * sizeof( zclReadRspStatus_t ));
+  len = sizeof( zclReadRspCmd_t ) + (numAttr * sizeof( zclReadRspStatus_t ));
 
   readRspCmd = zcl_mem_alloc( len );
   if ( readRspCmd == NULL )
@@ -4470,28 +5257,35 @@ static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
     return FALSE; // EMBEDDED RETURN
   }
 
-  readRspCmd->numAttr = readCmd->numAttr;
-  for ( i = 0; i < readCmd->numAttr; i++ )
+  readRspCmd->numAttr = numAttr;
+  for ( i = 0; i < numAttr; i++ )
   {
     zclReadRspStatus_t *statusRec = &(readRspCmd->attrList[i]);
 
-    statusRec->attrID = readCmd->attrID[i];
+    (void)zclParseNextAttrID( &parseCmd, &(statusRec->attrID) );
     
-    attrFound = zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId, readCmd->attrID[i], &attrRec );
+    pAttr = zclFindAttrRecPtr( pInMsg->msg->endPoint, pInMsg->msg->clusterId, statusRec->attrID );
     
     //Validate the attribute is found and the access control
-    if ( ( attrFound == TRUE ) && 
-         (  (attrRec.attr.accessControl & ACCESS_GLOBAL) || 
-            (GET_BIT( &attrRec.attr.accessControl, ACCESS_CONTROL_MASK ) == pInMsg->hdr.fc.direction ) ) )
+    if ( ( pAttr != NULL ) && 
+         (  (pAttr->attr.accessControl & ACCESS_GLOBAL) || 
+            (GET_BIT( &pAttr->attr.accessControl, ACCESS_CONTROL_MASK ) == pInMsg->hdr.fc.direction ) ) )
     {
-      if ( zcl_AccessCtrlRead( attrRec.attr.accessControl ) )
+      if ( zcl_AccessCtrlRead( pAttr->attr.accessControl ) )
       {
-        statusRec->status = zclAuthorizeRead( pInMsg->msg->endPoint,
-                                              &(pInMsg->msg->srcAddr), &attrRec );
+        statusRec->status = ZCL_STATUS_SUCCESS;
+        if ( zcl_AccessCtrlAuthRead( pAttr->attr.accessControl ) )
+        {
+          // The authorize callback takes a modifiable record
+          zclAttrRec_t attrRec = *pAttr;
+
+          statusRec->status = zclAuthorizeRead( pInMsg->msg->endPoint,
+                                                &(pInMsg->msg->srcAddr), &attrRec );
+        }
         if ( statusRec->status == ZCL_STATUS_SUCCESS )
         {
-          statusRec->data = attrRec.attr.dataPtr;
-          statusRec->dataType = attrRec.attr.dataType;
+          statusRec->data = pAttr->attr.dataPtr;
+          statusRec->dataType = pAttr->attr.dataType;
         }
       }
       else
@@ -4519,7 +5313,11 @@ static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
 /*********************************************************************
  * @fn      processInWriteCmd
  *
- * @brief   Process the "Profile" Write and Write No Response Commands
+ * @brief   Process the "Profile" Write and Write No Response Commands.
+ *          The write records are read in place from pInMsg->pData.
+ *
+ *      NOTE: The data handed to the validate and write callbacks points
+ *            into the received message, and is not aligned.
  *
  * @param   pInMsg - incoming message to process
  *
@@ -4527,18 +5325,34 @@ static uint8 zclProcessInReadCmd( zclIncoming_t *pInMsg )
  */
 static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
 {
-  zclWriteCmd_t *writeCmd;
+  zclParseCmd_t parseCmd;
+  zclWriteRec_t writeRec;
+  zclWriteRec_t *statusRec = &writeRec;
   zclWriteRspCmd_t *writeRspCmd;
   uint8 sendRsp = FALSE;
   uint8 j = 0;
-  uint8 i;
 
-  writeCmd = (zclWriteCmd_t *)pInMsg->attrCmd;
+  parseCmd.endpoint = pInMsg->msg->endPoint;
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+
   if ( pInMsg->hdr.commandID == ZCL_CMD_WRITE )
   {
-    // We need to send a response back - allocate space for it
+    uint8 numAttr = 0;
+
+    // Count the write records to size the response
+    while ( zclParseNextAttrRec( &parseCmd, &(writeRec.attrID),
+                                 &(writeRec.dataType), &(writeRec.attrData) ) )
+    {
+      numAttr++;
+    }
+    parseCmd.dataLen = pInMsg->pDataLen;
+    parseCmd.pData = pInMsg->pData;
+
+    // We need to send a response back - allocate space for it, with at
+    // least the single SUCCESS record
     writeRspCmd = (zclWriteRspCmd_t *)zcl_mem_alloc( sizeof( zclWriteRspCmd_t )
-            + sizeof( zclWriteRspStatus_t ) * writeCmd->numAttr );
+            + sizeof( zclWriteRspStatus_t ) * ( numAttr ? numAttr : 1 ) );
     if ( writeRspCmd == NULL )
     {
       return FALSE; // EMBEDDED RETURN
@@ -4547,26 +5361,29 @@ static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
     sendRsp = TRUE;
   }
 
-  for ( i = 0; i < writeCmd->numAttr; i++ )
+  while ( zclParseNextAttrRec( &parseCmd, &(statusRec->attrID),
+                               &(statusRec->dataType), &(statusRec->attrData) ) )
   {
-    zclAttrRec_t attrRec;
-    zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
+    CONST zclAttrRec_t *pAttr;
 
-    if ( zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
-                         statusRec->attrID, &attrRec ) )
+    if ( ( pAttr = zclFindAttrRecPtr( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                      statusRec->attrID ) ) != NULL )
     {
-      if ( GET_BIT( &attrRec.attr.accessControl, ACCESS_CONTROLEXT_MASK ) != pInMsg->hdr.fc.direction )
+      if ( GET_BIT( &pAttr->attr.accessControl, ACCESS_CONTROLEXT_MASK ) != pInMsg->hdr.fc.direction )
       {
-        writeRspCmd->attrList[j].status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
-        writeRspCmd->attrList[j++].attrID = statusRec->attrID;
+        if ( sendRsp )
+        {
+          writeRspCmd->attrList[j].status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
+          writeRspCmd->attrList[j++].attrID = statusRec->attrID;
+        }
         break;
       }
-      if ( statusRec->dataType == attrRec.attr.dataType )
+      if ( statusRec->dataType == pAttr->attr.dataType )
       {
         uint8 status;
 
         // Write the new attribute value
-        if ( attrRec.attr.dataPtr != NULL )
+        if ( pAttr->attr.dataPtr != NULL )
         {
           //Handle special case for Identify
           if((pInMsg->msg->clusterId == ZCL_CLUSTER_ID_GEN_IDENTIFY) && (statusRec->attrID == ATTRID_IDENTIFY_TIME))
@@ -4582,13 +5399,13 @@ static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
           else
           {                
             status = zclWriteAttrData( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                                       &attrRec, statusRec );
+                                       pAttr, statusRec );
           }
         }
         else // Use CB
         {
           status = zclWriteAttrDataUsingCB( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                                            &attrRec, statusRec->attrData );
+                                            pAttr, statusRec->attrData );
         }
 
         // If successful, a write attribute status record shall NOT be generated
@@ -4618,7 +5435,7 @@ static uint8 zclProcessInWriteCmd( zclIncoming_t *pInMsg )
         writeRspCmd->attrList[j++].attrID = statusRec->attrID;
       }
     }
-  } // for loop
+  } // while loop
 
   if ( sendRsp )
   {
@@ -4659,26 +5476,26 @@ static void zclRevertWriteUndividedCmd( zclIncoming_t *pInMsg,
 
   for ( i = 0; i < numAttr; i++ )
   {
-    zclAttrRec_t attrRec;
+    CONST zclAttrRec_t *pAttr;
     zclWriteRec_t *statusRec = &(curWriteRec[i]);
 
-    if ( !zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
-                          statusRec->attrID, &attrRec ) )
+    if ( ( pAttr = zclFindAttrRecPtr( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                      statusRec->attrID ) ) == NULL )
     {
       break; // should never happen
     }
 
-    if ( attrRec.attr.dataPtr != NULL )
+    if ( pAttr->attr.dataPtr != NULL )
     {
       // Just copy the old data back - no need to validate the data
-      uint16 dataLen = zclGetAttrDataLength( attrRec.attr.dataType, statusRec->attrData );
-      zcl_memcpy( attrRec.attr.dataPtr, statusRec->attrData, dataLen );
+      uint16 dataLen = zclGetAttrDataLength( pAttr->attr.dataType, statusRec->attrData );
+      zcl_memcpy( pAttr->attr.dataPtr, statusRec->attrData, dataLen );
     }
     else // Use CB
     {
       // Write the old data back
       zclWriteAttrDataUsingCB( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                               &attrRec, statusRec->attrData );
+                               pAttr, statusRec->attrData );
     }
   } // for loop
 }
@@ -4686,7 +5503,8 @@ static void zclRevertWriteUndividedCmd( zclIncoming_t *pInMsg,
 /*********************************************************************
  * @fn      zclProcessInWriteUndividedCmd
  *
- * @brief   Process the "Profile" Write Undivided Command
+ * @brief   Process the "Profile" Write Undivided Command. The write
+ *          records are read in place from pInMsg->pData.
  *
  * @param   pInMsg - incoming message to process
  *
@@ -4694,32 +5512,39 @@ static void zclRevertWriteUndividedCmd( zclIncoming_t *pInMsg,
  */
 static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
 {
-  zclWriteCmd_t *writeCmd;
+  zclParseCmd_t parseCmd;
+  zclWriteRec_t writeRec;
+  zclWriteRec_t *statusRec = &writeRec;
   zclWriteRspCmd_t *writeRspCmd;
-  zclAttrRec_t attrRec;
+  CONST zclAttrRec_t *pAttr;
   uint16 dataLen;
   uint16 curLen = 0;
+  uint8 numAttr = 0;
   uint8 j = 0;
   uint8 i;
 
-  writeCmd = (zclWriteCmd_t *)pInMsg->attrCmd;
-
-  // Allocate space for Write Response Command
+  // Allocate space for Write Response Command, the first record that can't
+  // be written is the only one reported
   writeRspCmd = (zclWriteRspCmd_t *)zcl_mem_alloc( sizeof( zclWriteRspCmd_t )
-                   + sizeof( zclWriteRspStatus_t )* writeCmd->numAttr );
+                   + sizeof( zclWriteRspStatus_t ) );
   if ( writeRspCmd == NULL )
   {
     return FALSE; // EMBEDDED RETURN
   }
 
+  parseCmd.endpoint = pInMsg->msg->endPoint;
+  parseCmd.dataLen = pInMsg->pDataLen;
+  parseCmd.pData = pInMsg->pData;
+
   // If any attribute cannot be written, no attribute values are changed. Hence,
   // make sure all the attributes are supported and writable
-  for ( i = 0; i < writeCmd->numAttr; i++ )
+  while ( zclParseNextAttrRec( &parseCmd, &(statusRec->attrID),
+                               &(statusRec->dataType), &(statusRec->attrData) ) )
   {
-    zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
+    numAttr++;
 
-    if ( !zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
-                          statusRec->attrID, &attrRec ) )
+    if ( ( pAttr = zclFindAttrRecPtr( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                      statusRec->attrID ) ) == NULL )
     {
       // Attribute is not supported - stop here
       writeRspCmd->attrList[j].status = ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
@@ -4727,7 +5552,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
       break;
     }
 
-    if ( statusRec->dataType != attrRec.attr.dataType )
+    if ( statusRec->dataType != pAttr->attr.dataType )
     {
       // Attribute data type is incorrect - stope here
       writeRspCmd->attrList[j].status = ZCL_STATUS_INVALID_DATA_TYPE;
@@ -4735,7 +5560,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
       break;
     }
 
-    if ( !zcl_AccessCtrlWrite( attrRec.attr.accessControl ) )
+    if ( !zcl_AccessCtrlWrite( pAttr->attr.accessControl ) )
     {
       // Attribute is not writable - stop here
       writeRspCmd->attrList[j].status = ZCL_STATUS_READ_ONLY;
@@ -4743,7 +5568,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
       break;
     }
 
-    if ( zcl_AccessCtrlAuthWrite( attrRec.attr.accessControl ) )
+    if ( zcl_AccessCtrlAuthWrite( pAttr->attr.accessControl ) )
     {
       // Not authorized to write - stop here
       writeRspCmd->attrList[j].status = ZCL_STATUS_NOT_AUTHORIZED;
@@ -4752,9 +5577,9 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
     }
 
     // Attribute Data length
-    if ( attrRec.attr.dataPtr != NULL )
+    if ( pAttr->attr.dataPtr != NULL )
     {
-      dataLen = zclGetAttrDataLength( attrRec.attr.dataType, attrRec.attr.dataPtr );
+      dataLen = zclGetAttrDataLength( pAttr->attr.dataType, pAttr->attr.dataPtr );
     }
     else // Use CB
     {
@@ -4769,7 +5594,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
     }
 
     curLen += dataLen;
-  } // for loop
+  } // while loop
 
   writeRspCmd->numAttr = j;
   if ( writeRspCmd->numAttr == 0 ) // All attributes can be written
@@ -4778,7 +5603,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
     zclWriteRec_t *curWriteRec;
 
     // calculate the length of the current data header
-    uint8 hdrLen = j * sizeof( zclWriteRec_t );
+    uint16 hdrLen = numAttr * sizeof( zclWriteRec_t );
 
     // Allocate space to keep a copy of the current data
     curWriteRec = (zclWriteRec_t *) zcl_mem_alloc( hdrLen + curLen );
@@ -4790,15 +5615,20 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
 
     curDataPtr = (uint8 *)((uint8 *)curWriteRec + hdrLen);
 
+    parseCmd.dataLen = pInMsg->pDataLen;
+    parseCmd.pData = pInMsg->pData;
+
     // Write the new data over
-    for ( i = 0; i < writeCmd->numAttr; i++ )
+    for ( i = 0; i < numAttr; i++ )
     {
       uint8 status;
-      zclWriteRec_t *statusRec = &(writeCmd->attrList[i]);
       zclWriteRec_t *curStatusRec = &(curWriteRec[i]);
 
-      if ( !zclFindAttrRec( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
-                            statusRec->attrID, &attrRec ) )
+      (void)zclParseNextAttrRec( &parseCmd, &(statusRec->attrID),
+                                 &(statusRec->dataType), &(statusRec->attrData) );
+
+      if ( ( pAttr = zclFindAttrRecPtr( pInMsg->msg->endPoint, pInMsg->msg->clusterId,
+                                        statusRec->attrID ) ) == NULL )
       {
         break; // should never happen
       }
@@ -4807,14 +5637,14 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
       curStatusRec->attrID = statusRec->attrID;
       curStatusRec->attrData = curDataPtr;
 
-      if ( attrRec.attr.dataPtr != NULL )
+      if ( pAttr->attr.dataPtr != NULL )
       {
         // Read the current value
-        zclReadAttrData( curDataPtr, &attrRec, &dataLen );
+        zclReadAttrData( curDataPtr, pAttr, &dataLen );
 
         // Write the new attribute value
         status = zclWriteAttrData( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                                   &attrRec, statusRec );
+                                   pAttr, statusRec );
       }
       else // Use CBs
       {
@@ -4823,7 +5653,7 @@ static uint8 zclProcessInWriteUndividedCmd( zclIncoming_t *pInMsg )
                                 statusRec->attrID, curDataPtr, &dataLen );
         // Write the new attribute value
         status = zclWriteAttrDataUsingCB( pInMsg->msg->endPoint, &(pInMsg->msg->srcAddr),
-                                          &attrRec, statusRec->attrData );
+                                          pAttr, statusRec->attrData );
       }
 
       // If successful, a write attribute status record shall NOT be generated
@@ -218,6 +218,9 @@ extern "C"
 #define ZCL_FRAME_CLIENT_SERVER_DIR                     0x00
 #define ZCL_FRAME_SERVER_CLIENT_DIR                     0x01
 
+/*** Largest ZCL frame header: frame control, manufacturer code, sequence number, command ***/
+#define ZCL_FRAME_HDR_MAX_LEN                           5
+
 /*** Chipcon Manufacturer Code ***/
 #define CC_MANUFACTURER_CODE                            0x1001
 
@@ -836,6 +839,7 @@ typedef struct zclAttrRecsList
   zclAuthorizeCB_t       pfnAuthorizeCB;// Authorize Read or Write operation
   uint8                  numAttributes; // Number of the following records
   CONST zclAttrRec_t     *attrs;        // attribute records
+  uint8                  *attrIndex;    // attrs indices sorted by (clusterID, attrId), NULL if none
 } zclAttrRecsList;
 
 /*********************************************************************
@@ -940,6 +944,19 @@ extern uint8 zcl_registerForMsgExt( uint8 taskId, uint8 endPointId  );
 extern ZStatus_t zcl_registerPlugin( uint16 startLogCluster, uint16 endLogCluster,
                                      zclInHdlr_t pfnIncomingHdlr );
 
+/*
+ *  Function for Plugins' to register an application's command callbacks
+ *  for their clusters on an endpoint
+ */
+extern ZStatus_t zcl_registerCmdCallbacks( uint8 endpoint, zclInHdlr_t pfnIncomingHdlr,
+                                           void *pCBs );
+
+/*
+ *  Function for Plugins' to find the command callbacks registered for
+ *  an endpoint's cluster
+ */
+extern void *zcl_FindCallbacks( uint8 endpoint, uint16 clusterID );
+
 /*
  *  Register Application's Command table
  */
@@ -979,6 +996,24 @@ extern ZStatus_t zcl_SendCommand( uint8 srcEP, afAddrType_t *dstAddr,
                                   uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
                                   uint16 cmdFormatLen, uint8 *cmdFormat );
 
+/*
+ *  Allocate a command buffer with room for the ZCL header in front of it
+ */
+extern uint8 *zcl_CmdBufAlloc( uint16 cmdFormatLen );
+
+/*
+ *  Free a buffer allocated by zcl_CmdBufAlloc()
+ */
+extern void zcl_CmdBufFree( uint8 *cmdFormat );
+
+/*
+ *  Function for Sending a Command serialized into a buffer from zcl_CmdBufAlloc()
+ */
+extern ZStatus_t zcl_SendCommandBuf( uint8 srcEP, afAddrType_t *dstAddr,
+                                     uint16 clusterID, uint8 cmd, uint8 specific, uint8 direction,
+                                     uint8 disableDefaultRsp, uint16 manuCode, uint8 seqNum,
+                                     uint16 cmdFormatLen, uint8 *cmdFormat );
+
 #ifdef ZCL_READ
 /*
  *  Function for Reading an Attribute
@@ -1113,6 +1148,17 @@ extern ZStatus_t zcl_SendDiscoverAttrsExtRsp( uint8 srcEP, afAddrType_t *dstAddr
                                          uint8 direction, uint8 disableDefaultRsp, uint8 seqNum );
 #endif // ZCL_DISCOVER
 
+/*
+ * Functions to walk the records of a received command in place
+ */
+extern uint8 zclParseNextAttrID( zclParseCmd_t *pCmd, uint16 *pAttrID );
+extern uint8 zclParseNextAttrRec( zclParseCmd_t *pCmd, uint16 *pAttrID,
+                                  uint8 *pDataType, uint8 **ppAttrData );
+#ifdef ZCL_REPORTING_DEVICE
+extern uint8 zclParseNextCfgReportRec( zclParseCmd_t *pCmd, zclCfgReportRec_t *pRec );
+extern uint8 zclParseNextReadReportCfgRec( zclParseCmd_t *pCmd, zclReadReportCfgRec_t *pRec );
+#endif
+
 #ifdef ZCL_READ
 /*
  * Function to parse the "Profile" Read Commands
@@ -1181,6 +1227,11 @@ extern uint8 *zclParseHdr( zclFrameHdr_t *hdr, uint8 *pData );
  */
 extern uint8 zclFindAttrRec( uint8 endpoint, uint16 realClusterID, uint16 attrId, zclAttrRec_t *pAttr );
 
+/*
+ * Function to find the attribute record that matchs the parameters, without copying it
+ */
+extern CONST zclAttrRec_t *zclFindAttrRecPtr( uint8 endpoint, uint16 realClusterID, uint16 attrId );
+
 #if defined ( ZCL_STANDALONE )
 /*
  *  Set attribute record list for end point
@@ -1191,7 +1242,7 @@ extern uint8 zclSetAttrRecList( uint8 endpoint, uint8 numAttr, CONST zclAttrRec_
 /*
  * Function to read the attribute's current value
  */
-extern ZStatus_t zclReadAttrData( uint8 *pAttrData, zclAttrRec_t *pAttr, uint16 *pDataLen );
+extern ZStatus_t zclReadAttrData( uint8 *pAttrData, CONST zclAttrRec_t *pAttr, uint16 *pDataLen );
 
 /*
  * Function to return the length of the datatype in length.
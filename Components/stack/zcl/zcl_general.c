@@ -69,13 +69,6 @@
 /*********************************************************************
  * TYPEDEFS
  */
-typedef struct zclGenCBRec
-{
-  struct zclGenCBRec        *next;
-  uint8                     endpoint; // Used to link it into the endpoint descriptor
-  zclGeneral_AppCallbacks_t *CBs;     // Pointer to Callback function
-} zclGenCBRec_t;
-
 typedef struct zclGenSceneItem
 {
   struct zclGenSceneItem    *next;
@@ -113,7 +106,6 @@ typedef struct zclGenSceneNVItem
 /*********************************************************************
  * LOCAL VARIABLES
  */
-static zclGenCBRec_t *zclGenCBs = (zclGenCBRec_t *)NULL;
 static uint8 zclGenPluginRegisted = FALSE;
 
 #if defined( ZCL_SCENES )
@@ -131,7 +123,6 @@ static zclGenAlarmItem_t *zclGenAlarmTable = (zclGenAlarmItem_t *)NULL;
  */
 static ZStatus_t zclGeneral_HdlIncoming( zclIncoming_t *pInMsg );
 static ZStatus_t zclGeneral_HdlInSpecificCommands( zclIncoming_t *pInMsg );
-static zclGeneral_AppCallbacks_t *zclGeneral_FindCallbacks( uint8 endpoint );
 
 // Device Configuration and Installation clusters
 #ifdef ZCL_BASIC
@@ -196,9 +187,6 @@ static ZStatus_t zclGeneral_ProcessInLocationClient( zclIncoming_t *pInMsg, zclG
  */
 ZStatus_t zclGeneral_RegisterCmdCallbacks( uint8 endpoint, zclGeneral_AppCallbacks_t *callbacks )
 {
-  zclGenCBRec_t *pNewItem;
-  zclGenCBRec_t *pLoop;
-
   // Register as a ZCL Plugin
   if ( zclGenPluginRegisted == FALSE )
   {
@@ -214,32 +202,7 @@ ZStatus_t zclGeneral_RegisterCmdCallbacks( uint8 endpoint, zclGeneral_AppCallbac
     zclGenPluginRegisted = TRUE;
   }
 
-  // Fill in the new profile list
-  pNewItem = zcl_mem_alloc( sizeof( zclGenCBRec_t ) );
-  if ( pNewItem == NULL )
-    return (ZMemError);
-
-  pNewItem->next = (zclGenCBRec_t *)NULL;
-  pNewItem->endpoint = endpoint;
-  pNewItem->CBs = callbacks;
-
-  // Find spot in list
-  if (  zclGenCBs == NULL )
-  {
-    zclGenCBs = pNewItem;
-  }
-  else
-  {
-    // Look for end of list
-    pLoop = zclGenCBs;
-    while ( pLoop->next != NULL )
-      pLoop = pLoop->next;
-
-    // Put new item at end of list
-    pLoop->next = pNewItem;
-  }
-
-  return ( ZSuccess );
+  return ( zcl_registerCmdCallbacks( endpoint, zclGeneral_HdlIncoming, callbacks ) );
 }
 
 #ifdef ZCL_IDENTIFY
@@ -1541,29 +1504,6 @@ ZStatus_t zclGeneral_SendLocationData( uint8 srcEP, afAddrType_t *dstAddr, uint8
 }
 #endif // ZCL_LOCATION
 
-/*********************************************************************
- * @fn      zclGeneral_FindCallbacks
- *
- * @brief   Find the callbacks for an endpoint
- *
- * @param   endpoint - endpoint to find the application callbacks for
- *
- * @return  pointer to the callbacks
- */
-static zclGeneral_AppCallbacks_t *zclGeneral_FindCallbacks( uint8 endpoint )
-{
-  zclGenCBRec_t *pCBs;
-
-  pCBs = zclGenCBs;
-  while ( pCBs )
-  {
-    if ( pCBs->endpoint == endpoint )
-      return ( pCBs->CBs );
-    pCBs = pCBs->next;
-  }
-  return ( (zclGeneral_AppCallbacks_t *)NULL );
-}
-
 /*********************************************************************
  * @fn      zclGeneral_HdlIncoming
  *
@@ -1621,7 +1561,7 @@ static ZStatus_t zclGeneral_HdlInSpecificCommands( zclIncoming_t *pInMsg )
   zclGeneral_AppCallbacks_t *pCBs;
 
   // make sure endpoint exists
-  pCBs = zclGeneral_FindCallbacks( pInMsg->msg->endPoint );
+  pCBs = zcl_FindCallbacks( pInMsg->msg->endPoint, pInMsg->msg->clusterId );
   if ( pCBs == NULL )
     return ( ZFailure );
 
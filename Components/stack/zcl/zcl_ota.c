@@ -77,6 +77,62 @@
 #define ZCL_OTA_STK_VER_OFFSET      18 // Stack version location in OTA upgrade image
 
 #define OTA_NEW_IMAGE_QUERY_RATE    30000 // ms - 5 minutes
+
+#if (defined OTA_SERVER) && (OTA_SERVER == TRUE)
+// Number of image windows the server keeps for Image Block Requests
+#if !defined ( ZCL_OTA_BLOCK_CACHE_CNT )
+  #define ZCL_OTA_BLOCK_CACHE_CNT     2
+#endif
+
+// Bytes read from the OTA console per window, anything past the requested
+// block is read ahead for the next request. The read response has to fit in
+// MT_UART_RX_BUFF_MAX, see MT_OtaFileReadReq().
+#if !defined ( ZCL_OTA_BLOCK_CACHE_LEN )
+  #define ZCL_OTA_BLOCK_CACHE_LEN     ( OTA_MAX_MTU * 2 )
+#endif
+
+#if ( ZCL_OTA_BLOCK_CACHE_LEN < OTA_MAX_MTU ) || \
+    ( ( ZCL_OTA_BLOCK_CACHE_LEN + MT_OTA_FILE_READ_RSP_LEN ) > MT_RPC_DATA_MAX ) || \
+    ( ( defined MT_UART_RX_BUFF_MAX ) && \
+      ( ( ZCL_OTA_BLOCK_CACHE_LEN + MT_OTA_FILE_READ_RSP_LEN + SPI_0DATA_MSG_LEN ) > MT_UART_RX_BUFF_MAX ) )
+  #error "ZCL_OTA_BLOCK_CACHE_LEN must be at least OTA_MAX_MTU and fit in an MT OTA file read response"
+#endif
+
+// Number of clients answered by one read from the OTA console
+#if !defined ( ZCL_OTA_BLOCK_CACHE_WAITERS )
+  #define ZCL_OTA_BLOCK_CACHE_WAITERS 4
+#endif
+
+// ms to wait for the OTA console before a window can be read again
+#if !defined ( ZCL_OTA_BLOCK_CACHE_TIMEOUT )
+  #define ZCL_OTA_BLOCK_CACHE_TIMEOUT 2000
+#endif
+
+/******************************************************************************
+ * TYPEDEFS
+ */
+// Client waiting for a window to be read
+typedef struct
+{
+  afAddrType_t addr;
+  uint32 offset;
+  uint8 len;
+} zclOTA_BlockWaiter_t;
+
+// Window of an image read from the OTA console
+typedef struct
+{
+  zclOTA_FileID_t fileId;
+  uint32 offset;             // image offset of data[0]
+  uint32 time;               // when read if pending, else when last used
+  uint8 len;                 // bytes in data
+  uint8 pending;             // TRUE while the read is outstanding
+  uint8 numWaiters;
+  zclOTA_BlockWaiter_t waiters[ZCL_OTA_BLOCK_CACHE_WAITERS];
+  uint8 data[ZCL_OTA_BLOCK_CACHE_LEN];
+} zclOTA_BlockCache_t;
+#endif // (defined OTA_SERVER) && (OTA_SERVER == TRUE)
+
 /******************************************************************************
  * GLOBAL VARIABLES
  */
@@ -155,6 +211,10 @@ static uint8 zclOTA_SeqNo = 0;
 
 static uint8 zclOTA_Permit = TRUE;
 
+#if (defined OTA_SERVER) && (OTA_SERVER == TRUE)
+static zclOTA_BlockCache_t zclOTA_BlockCache[ZCL_OTA_BLOCK_CACHE_CNT];
+#endif
+
 #if defined OTA_MMO_SIGN
 static OTA_MmoCtrl_t zclOTA_MmoHash;
 static uint8 zclOTA_DataToHash[OTA_MMO_HASH_SIZE];
@@ -209,6 +269,10 @@ static void zclOTA_ImageBlockWaitExpired ( void );
 static void zclOTA_UpgradeComplete ( uint8 status );
 static uint8 zclOTA_CmpFileId ( zclOTA_FileID_t *f1, zclOTA_FileID_t *f2 );
 static uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len );
+static uint8 zclOTA_ImageSpan ( uint32 oset, uint8 avail );
+#if defined OTA_MMO_SIGN
+static void zclOTA_HashData ( uint8 *pData, uint8 len );
+#endif
 
 static ZStatus_t zclOTA_SendQueryNextImageReq ( afAddrType_t *dstAddr, zclOTA_QueryNextImageReqParams_t *pParams );
 static ZStatus_t zclOTA_SendImageBlockReq ( afAddrType_t *dstAddr, zclOTA_ImageBlockReqParams_t *pParams );
@@ -232,6 +296,8 @@ static ZStatus_t zclOTA_Srv_QuerySpecificFileReq ( afAddrType_t *pSrcAddr, zclOT
 static void zclOTA_ProcessNextImgRsp ( uint8* pMSGpkt, zclOTA_FileID_t *pFileId, afAddrType_t *pAddr );
 static void zclOTA_ProcessFileReadRsp ( uint8* pMSGpkt, zclOTA_FileID_t *pFileId, afAddrType_t *pAddr );
 static void zclOTA_ServerHandleFileSysCb ( OTA_MtMsg_t* pMSGpkt );
+static uint8 zclOTA_BlockCacheReq ( afAddrType_t *pAddr, zclOTA_FileID_t *pFileId, uint8 len, uint32 offset );
+static ZStatus_t zclOTA_BlockCacheSend ( afAddrType_t *pAddr, zclOTA_BlockCache_t *pWin, uint8 len, uint32 offset );
 
 static ZStatus_t zclOTA_ServerHdlIncoming ( zclIncoming_t *pInMsg );
 
@@ -1350,7 +1416,10 @@ static ZStatus_t sendImageBlockReq ( afAddrType_t *dstAddr )
  */
 uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
 {
-  int8 i;
+  uint32 left;
+  uint8 avail;
+  uint8 n;
+  uint8 i = 0;
 #if defined OTA_MMO_SIGN
   uint8 skipHash = FALSE;
 #endif
@@ -1368,8 +1437,19 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
   // write data to secondary storage
   HalOTAWrite ( zclOTA_FileOffset, pData, len, HAL_OTA_DL );
 
-  for ( i=0; i<len; i++ )
+  while ( i < len )
   {
+    // Bytes of the block that are still part of the image
+    avail = len - i;
+    if ( ( zclOTA_FileOffset < zclOTA_DownloadedImageSize ) &&
+         ( avail > ( zclOTA_DownloadedImageSize - zclOTA_FileOffset ) ) )
+    {
+      avail = (uint8)( zclOTA_DownloadedImageSize - zclOTA_FileOffset );
+    }
+
+    // Header and tag fields are taken a byte at a time, the rest in spans
+    n = 1;
+
     switch ( zclOTA_ClientPdState )
     {
         // verify header magic number
@@ -1398,6 +1478,10 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
           zclOTA_HeaderLen = pData[i];
           zclOTA_ClientPdState = ZCL_OTA_PD_HDR_LEN2_STATE;
         }
+        else
+        {
+          n = zclOTA_ImageSpan ( ZCL_OTA_HDR_LEN_OFFSET, avail );
+        }
         break;
 
       case ZCL_OTA_PD_HDR_LEN2_STATE:
@@ -1412,6 +1496,10 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
           zclOTA_DownloadedZigBeeStackVersion = pData[i];
           zclOTA_ClientPdState = ZCL_OTA_PD_STK_VER2_STATE;
         }
+        else
+        {
+          n = zclOTA_ImageSpan ( ZCL_OTA_STK_VER_OFFSET, avail );
+        }
         break;
 
       case ZCL_OTA_PD_STK_VER2_STATE:
@@ -1430,6 +1518,10 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
         {
           zclOTA_ClientPdState = ZCL_OTA_PD_ELEM_TAG1_STATE;
         }
+        else
+        {
+          n = zclOTA_ImageSpan ( zclOTA_HeaderLen-1, avail );
+        }
         break;
 
       case ZCL_OTA_PD_ELEM_TAG1_STATE:
@@ -1487,25 +1579,37 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
         break;
 
       case ZCL_OTA_PD_ELEMENT_STATE:
+        // Take as much of the element as the block holds
+        left = zclOTA_ElementLen - zclOTA_ElementPos;
+        n = ( left < avail ) ? (uint8)left : avail;
+
 #if defined OTA_MMO_SIGN
         if ( zclOTA_ElementTag == OTA_ECDSA_SIGNATURE_TAG_ID )
         {
           if ( zclOTA_ElementPos < Z_EXTADDR_LEN )
-            zclOTA_SignerIEEE[zclOTA_ElementPos] = pData[i];
+          {
+            // Stop at the end of the signer address
+            if ( n > ( Z_EXTADDR_LEN - zclOTA_ElementPos ) )
+            {
+              n = (uint8)( Z_EXTADDR_LEN - zclOTA_ElementPos );
+            }
+            osal_memcpy ( &zclOTA_SignerIEEE[zclOTA_ElementPos], &pData[i], n );
+          }
           else
           {
-            zclOTA_SignatureData[zclOTA_ElementPos - Z_EXTADDR_LEN] = pData[i];
+            osal_memcpy ( &zclOTA_SignatureData[zclOTA_ElementPos - Z_EXTADDR_LEN], &pData[i], n );
 
             skipHash = TRUE;
           }
         }
         else if ( zclOTA_ElementTag == OTA_ECDSA_CERT_TAG_ID )
         {
-          zclOTA_Certificate[zclOTA_ElementPos] = pData[i];
+          osal_memcpy ( &zclOTA_Certificate[zclOTA_ElementPos], &pData[i], n );
         }
 #endif
 
-        if ( ++zclOTA_ElementPos == zclOTA_ElementLen )
+        zclOTA_ElementPos += n;
+        if ( zclOTA_ElementPos == zclOTA_ElementLen )
         {
           // Element is complete
           if ( zclOTA_ElementTag == OTA_UPGRADE_IMAGE_TAG_ID )
@@ -1532,26 +1636,23 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
         break;
 
       default:
+        // Nothing to parse, take the rest of the block
+        n = avail;
         break;
     }
 
 #if defined OTA_MMO_SIGN
     if ( !skipHash )
     {
-      // Maintain a buffer of data to hash
-      zclOTA_DataToHash[zclOTA_HashPos++] = pData[i];
-
-      // When the buffer reaches OTA_MMO_HASH_SIZE, update the Hash
-      if ( zclOTA_HashPos == OTA_MMO_HASH_SIZE )
-      {
-        OTA_CalculateMmoR3 ( &zclOTA_MmoHash, zclOTA_DataToHash, OTA_MMO_HASH_SIZE, FALSE );
-        zclOTA_HashPos = 0;
-      }
+      zclOTA_HashData ( &pData[i], n );
     }
 #endif
 
+    i += n;
+
     // Check if the download is complete
-    if ( ++zclOTA_FileOffset >= zclOTA_DownloadedImageSize )
+    zclOTA_FileOffset += n;
+    if ( zclOTA_FileOffset >= zclOTA_DownloadedImageSize )
     {
       zclOTA_ImageUpgradeStatus = OTA_STATUS_COMPLETE;
 
@@ -1572,6 +1673,75 @@ uint8 zclOTA_ProcessImageData ( uint8 *pData, uint8 len )
   return ZSuccess;
 }
 
+/******************************************************************************
+ * @fn      zclOTA_ImageSpan
+ *
+ * @brief   Get the number of bytes to skip to reach an offset in the image.
+ *
+ * @param   oset - image offset to stop at
+ * @param   avail - bytes left in the block
+ *
+ * @return  bytes before the offset, or avail if the offset is not in the rest
+ *          of the block
+ */
+static uint8 zclOTA_ImageSpan ( uint32 oset, uint8 avail )
+{
+  if ( ( oset > zclOTA_FileOffset ) && ( ( oset - zclOTA_FileOffset ) < avail ) )
+  {
+    return (uint8)( oset - zclOTA_FileOffset );
+  }
+
+  return avail;
+}
+
+#if defined OTA_MMO_SIGN
+/******************************************************************************
+ * @fn      zclOTA_HashData
+ *
+ * @brief   Add image data to the MMO hash. Whole hash blocks are hashed in
+ *          place, the rest is kept until a hash block is filled.
+ *
+ * @param   pData - pointer to the data
+ * @param   len - length of the data
+ *
+ * @return  none
+ */
+static void zclOTA_HashData ( uint8 *pData, uint8 len )
+{
+  uint8 n;
+
+  while ( len > 0 )
+  {
+    if ( ( zclOTA_HashPos == 0 ) && ( len >= OTA_MMO_HASH_SIZE ) )
+    {
+      OTA_CalculateMmoR3 ( &zclOTA_MmoHash, pData, OTA_MMO_HASH_SIZE, FALSE );
+      n = OTA_MMO_HASH_SIZE;
+    }
+    else
+    {
+      n = OTA_MMO_HASH_SIZE - zclOTA_HashPos;
+      if ( n > len )
+      {
+        n = len;
+      }
+
+      osal_memcpy ( &zclOTA_DataToHash[zclOTA_HashPos], pData, n );
+      zclOTA_HashPos += n;
+
+      // When the buffer reaches OTA_MMO_HASH_SIZE, update the Hash
+      if ( zclOTA_HashPos == OTA_MMO_HASH_SIZE )
+      {
+        OTA_CalculateMmoR3 ( &zclOTA_MmoHash, zclOTA_DataToHash, OTA_MMO_HASH_SIZE, FALSE );
+        zclOTA_HashPos = 0;
+      }
+    }
+
+    pData += n;
+    len -= n;
+  }
+}
+#endif // OTA_MMO_SIGN
+
 /******************************************************************************
  * @fn      zclOTA_ProcessImageNotify
  *
@@ -2312,10 +2482,63 @@ void zclOTA_ProcessFileReadRsp ( uint8* pMsg, zclOTA_FileID_t *pFileId,
                                  afAddrType_t *pAddr )
 {
   zclOTA_ImageBlockRspParams_t blockRsp;
+  zclOTA_BlockCache_t *pWin = NULL;
+  uint8 i;
 
   // Set the status
   blockRsp.status = *pMsg++;
 
+  // Find the window that was read, the first waiter is the one it was read for
+  for ( i = 0; i < ZCL_OTA_BLOCK_CACHE_CNT; i++ )
+  {
+    if ( zclOTA_BlockCache[i].pending &&
+         osal_memcmp ( &zclOTA_BlockCache[i].fileId, pFileId, sizeof ( zclOTA_FileID_t ) ) &&
+         ( zclOTA_BlockCache[i].waiters[0].addr.addr.shortAddr == pAddr->addr.shortAddr ) &&
+         ( ( blockRsp.status != ZSuccess ) ||
+           ( zclOTA_BlockCache[i].offset == BUILD_UINT32 ( pMsg[0], pMsg[1], pMsg[2], pMsg[3] ) ) ) )
+    {
+      pWin = &zclOTA_BlockCache[i];
+      break;
+    }
+  }
+
+  if ( pWin != NULL )
+  {
+    pWin->pending = FALSE;
+    pWin->len = 0;
+
+    if ( blockRsp.status == ZSuccess )
+    {
+      // Keep the window and answer every client waiting on it
+      pWin->len = pMsg[4];
+      if ( pWin->len > ZCL_OTA_BLOCK_CACHE_LEN )
+      {
+        pWin->len = ZCL_OTA_BLOCK_CACHE_LEN;
+      }
+      osal_memcpy ( pWin->data, &pMsg[5], pWin->len );
+      pWin->time = osal_GetSystemClock ();
+
+      for ( i = 0; i < pWin->numWaiters; i++ )
+      {
+        zclOTA_BlockCacheSend ( &pWin->waiters[i].addr, pWin,
+                                pWin->waiters[i].len, pWin->waiters[i].offset );
+      }
+    }
+    else
+    {
+      blockRsp.status = ZOtaAbort;
+
+      for ( i = 0; i < pWin->numWaiters; i++ )
+      {
+        zclOTA_SendImageBlockRsp ( &pWin->waiters[i].addr, &blockRsp );
+      }
+    }
+
+    pWin->numWaiters = 0;
+
+    return;
+  }
+
   // Check the status of the file read
   if ( blockRsp.status == ZSuccess )
   {
@@ -2325,6 +2548,12 @@ void zclOTA_ProcessFileReadRsp ( uint8* pMsg, zclOTA_FileID_t *pFileId,
     pMsg += 4;
     blockRsp.rsp.success.dataSize = *pMsg++;
     blockRsp.rsp.success.pData = pMsg;
+
+    // The window was given up on, answer its first client with one block
+    if ( blockRsp.rsp.success.dataSize > OTA_MAX_MTU )
+    {
+      blockRsp.rsp.success.dataSize = OTA_MAX_MTU;
+    }
   }
   else
   {
@@ -2335,6 +2564,143 @@ void zclOTA_ProcessFileReadRsp ( uint8* pMsg, zclOTA_FileID_t *pFileId,
   zclOTA_SendImageBlockRsp ( pAddr, &blockRsp );
 }
 
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheReq
+ *
+ * @brief   Answer an Image Block Request from the window cache. When the
+ *          block is not cached, wait on the window being read for it or
+ *          read a new window from the OTA Console.
+ *
+ * @param   pAddr - The source of the request
+ *          pFileId - The ID of the OTA File
+ *          len - Maximum number of bytes to send
+ *          offset - Offset of the block in the image
+ *
+ * @return  ZSuccess if the block was sent or will be when read
+ */
+static uint8 zclOTA_BlockCacheReq ( afAddrType_t *pAddr, zclOTA_FileID_t *pFileId,
+                                    uint8 len, uint32 offset )
+{
+  zclOTA_BlockCache_t *pWin;
+  zclOTA_BlockCache_t *pFree = NULL;
+  uint32 now = osal_GetSystemClock ();
+  uint8 status;
+  uint8 i;
+
+  for ( i = 0; i < ZCL_OTA_BLOCK_CACHE_CNT; i++ )
+  {
+    pWin = &zclOTA_BlockCache[i];
+
+    // The OTA Console did not answer, the window can be read again
+    if ( pWin->pending && ( ( now - pWin->time ) > ZCL_OTA_BLOCK_CACHE_TIMEOUT ) )
+    {
+      pWin->pending = FALSE;
+      pWin->numWaiters = 0;
+    }
+
+    if ( ( pWin->pending || ( pWin->len > 0 ) ) && ( offset >= pWin->offset ) &&
+         osal_memcmp ( &pWin->fileId, pFileId, sizeof ( zclOTA_FileID_t ) ) )
+    {
+      if ( pWin->pending )
+      {
+        // Wait on the read if the block will be in the window
+        if ( ( ( offset + len ) <= ( pWin->offset + ZCL_OTA_BLOCK_CACHE_LEN ) ) &&
+             ( pWin->numWaiters < ZCL_OTA_BLOCK_CACHE_WAITERS ) )
+        {
+          pWin->waiters[pWin->numWaiters].addr = *pAddr;
+          pWin->waiters[pWin->numWaiters].offset = offset;
+          pWin->waiters[pWin->numWaiters].len = len;
+          pWin->numWaiters++;
+
+          return ZSuccess;
+        }
+      }
+      // Send if the whole block is cached, or the window ends the image
+      else if ( ( ( offset + len ) <= ( pWin->offset + pWin->len ) ) ||
+                ( ( pWin->len < ZCL_OTA_BLOCK_CACHE_LEN ) &&
+                  ( offset < ( pWin->offset + pWin->len ) ) ) )
+      {
+        pWin->time = now;
+
+        return zclOTA_BlockCacheSend ( pAddr, pWin, len, offset );
+      }
+    }
+
+    // Reuse the least recently used window
+    if ( !pWin->pending &&
+         ( ( pFree == NULL ) || ( (int32)( pWin->time - pFree->time ) < 0 ) ) )
+    {
+      pFree = pWin;
+    }
+  }
+
+  if ( pFree == NULL )
+  {
+    return ZFailure;
+  }
+
+  // Read the window starting at this block from the OTA Console
+  status = MT_OtaFileReadReq ( pAddr, pFileId, ZCL_OTA_BLOCK_CACHE_LEN, offset );
+
+  if ( status == ZSuccess )
+  {
+    osal_memcpy ( &pFree->fileId, pFileId, sizeof ( zclOTA_FileID_t ) );
+    pFree->offset = offset;
+    pFree->time = now;
+    pFree->len = 0;
+    pFree->pending = TRUE;
+    pFree->waiters[0].addr = *pAddr;
+    pFree->waiters[0].offset = offset;
+    pFree->waiters[0].len = len;
+    pFree->numWaiters = 1;
+  }
+
+  return status;
+}
+
+/******************************************************************************
+ * @fn      zclOTA_BlockCacheSend
+ *
+ * @brief   Send an Image Block Response with data from a window.
+ *
+ * @param   pAddr - The destination of the response
+ *          pWin - The window holding the block
+ *          len - Maximum number of bytes to send
+ *          offset - Offset of the block in the image
+ *
+ * @return  ZStatus_t
+ */
+static ZStatus_t zclOTA_BlockCacheSend ( afAddrType_t *pAddr, zclOTA_BlockCache_t *pWin,
+                                         uint8 len, uint32 offset )
+{
+  zclOTA_ImageBlockRspParams_t blockRsp;
+  uint8 pos;
+
+  if ( ( offset < pWin->offset ) || ( offset >= ( pWin->offset + pWin->len ) ) )
+  {
+    // The block is past the end of the image
+    blockRsp.status = ZOtaAbort;
+  }
+  else
+  {
+    pos = (uint8)( offset - pWin->offset );
+
+    if ( len > ( pWin->len - pos ) )
+    {
+      len = pWin->len - pos;
+    }
+
+    // Fill in the response parameters
+    blockRsp.status = ZSuccess;
+    osal_memcpy ( &blockRsp.rsp.success.fileId, &pWin->fileId, sizeof ( zclOTA_FileID_t ) );
+    blockRsp.rsp.success.fileOffset = offset;
+    blockRsp.rsp.success.dataSize = len;
+    blockRsp.rsp.success.pData = &pWin->data[pos];
+  }
+
+  return zclOTA_SendImageBlockRsp ( pAddr, &blockRsp );
+}
+
 /******************************************************************************
  * @fn      OTA_HandleFileSysCb
  *
@@ -2452,10 +2818,6 @@ ZStatus_t zclOTA_Srv_ImageBlockReq ( afAddrType_t *pSrcAddr, zclOTA_ImageBlockRe
         len = OTA_MAX_MTU;
       }
 
-      // The item already exists in NV memory, read it from NV memory
-      osal_nv_read ( ZCD_NV_OTA_BLOCK_REQ_DELAY, 0,
-                     sizeof ( zclOTA_MinBlockReqDelay ), &zclOTA_MinBlockReqDelay );
-
       // check if client supports rate limiting feature, and if client rate needs to be set
       if ( ( ( pParam->fieldControl & OTA_BLOCK_FC_REQ_DELAY_PRESENT ) != 0 ) &&
            ( pParam->blockReqDelay != zclOTA_MinBlockReqDelay ) )
@@ -2474,8 +2836,8 @@ ZStatus_t zclOTA_Srv_ImageBlockReq ( afAddrType_t *pSrcAddr, zclOTA_ImageBlockRe
       }
       else
       {
-        // Read the data from the OTA Console
-        status = MT_OtaFileReadReq ( pSrcAddr, &pParam->fileId, len, pParam->fileOffset );
+        // Send the block from the window cache, or read it from the OTA Console
+        status = zclOTA_BlockCacheReq ( pSrcAddr, &pParam->fileId, len, pParam->fileOffset );
 
         // Send a wait response to the client
         if ( status != ZSuccess )
@@ -62,13 +62,6 @@
 /*********************************************************************
  * TYPEDEFS
  */
-typedef struct zclPartitionCBRec
-{
-  struct zclPartitionCBRec    *next;
-  uint8                        endpoint; // Used to link it into the endpoint descriptor
-  zclPartition_AppCallbacks_t *CBs;      // Pointer to Callback function
-} zclPartitionCBRec_t;
-
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -80,7 +73,6 @@ typedef struct zclPartitionCBRec
 /*********************************************************************
  * LOCAL VARIABLES
  */
-static zclPartitionCBRec_t *zclPartitionCBs = (zclPartitionCBRec_t *)NULL;
 static uint8 zclPartitionPluginRegisted = FALSE;
 
 /*********************************************************************
@@ -88,7 +80,6 @@ static uint8 zclPartitionPluginRegisted = FALSE;
  */
 static ZStatus_t zclPartition_HdlIncoming( zclIncoming_t *pInHdlrMsg );
 static ZStatus_t zclPartition_HdlInSpecificCommands( zclIncoming_t *pInMsg );
-static zclPartition_AppCallbacks_t *zclPartition_FindCallbacks( uint8 endpoint );
 static ZStatus_t zclPartition_ProcessInCmds( zclIncoming_t *pInMsg, zclPartition_AppCallbacks_t *pCBs );
 
 static ZStatus_t zclPartition_ProcessInCmd_TransferPartitionedFrame( zclIncoming_t *pInMsg, zclPartition_AppCallbacks_t *pCBs );
@@ -110,9 +101,6 @@ static ZStatus_t zclPartition_ProcessInCmd_ReadHandshakeParamRsp( zclIncoming_t
  */
 ZStatus_t zclPartition_RegisterCmdCallbacks( uint8 endpoint, zclPartition_AppCallbacks_t *callbacks )
 {
-  zclPartitionCBRec_t *pNewItem;
-  zclPartitionCBRec_t *pLoop;
-
   // Register as a ZCL Plugin
   if ( zclPartitionPluginRegisted == FALSE )
   {
@@ -122,34 +110,7 @@ ZStatus_t zclPartition_RegisterCmdCallbacks( uint8 endpoint, zclPartition_AppCal
     zclPartitionPluginRegisted = TRUE;
   }
 
-  // Fill in the new profile list
-  pNewItem = zcl_mem_alloc( sizeof( zclPartitionCBRec_t ) );
-  if ( pNewItem == NULL )
-  {
-    return ( ZMemError ); // memory error
-  }
-
-  pNewItem->next = (zclPartitionCBRec_t *)NULL;
-  pNewItem->endpoint = endpoint;
-  pNewItem->CBs = callbacks;
-
-  // Find spot in list
-  if ( zclPartitionCBs == NULL )
-  {
-    zclPartitionCBs = pNewItem;
-  }
-  else
-  {
-    // Look for end of list
-    pLoop = zclPartitionCBs;
-    while ( pLoop->next != NULL )
-      pLoop = pLoop->next;
-
-    // Put new item at end of list
-    pLoop->next = pNewItem;
-  }
-
-  return ( ZSuccess );
+  return ( zcl_registerCmdCallbacks( endpoint, zclPartition_HdlIncoming, callbacks ) );
 }
 
 /*********************************************************************
@@ -462,31 +423,6 @@ ZStatus_t zclPartition_Send_ReadHandshakeParamRsp( uint8 srcEP, afAddrType_t *ds
   return ( status );
 }
 
-/*********************************************************************
- * @fn      zclPartition_FindCallbacks
- *
- * @brief   Find the callbacks for an endpoint
- *
- * @param   endpoint - endpoint to find the application callbacks for
- *
- * @return  pointer to the callbacks
- */
-static zclPartition_AppCallbacks_t *zclPartition_FindCallbacks( uint8 endpoint )
-{
-  zclPartitionCBRec_t *pCBs;
-
-  pCBs = zclPartitionCBs;
-  while ( pCBs != NULL )
-  {
-    if ( pCBs->endpoint == endpoint )
-    {
-      return ( pCBs->CBs );
-    }
-    pCBs = pCBs->next;
-  }
-  return ( (zclPartition_AppCallbacks_t *)NULL );
-}
-
 /*********************************************************************
  * @fn      zclPartition_HdlIncoming
  *
@@ -545,7 +481,7 @@ static ZStatus_t zclPartition_HdlInSpecificCommands( zclIncoming_t *pInMsg )
   zclPartition_AppCallbacks_t *pCBs;
 
   // make sure endpoint exists
-  pCBs = zclPartition_FindCallbacks( pInMsg->msg->endPoint );
+  pCBs = zcl_FindCallbacks( pInMsg->msg->endPoint, pInMsg->msg->clusterId );
   if ( pCBs == NULL )
   {
     return ( ZFailure );
@@ -62,13 +62,6 @@
 /*********************************************************************
  * TYPEDEFS
  */
-typedef struct zclPollControlCBRec
-{
-  struct zclPollControlCBRec    *next;
-  uint8                         endpoint; // Used to link it into the endpoint descriptor
-  zclPollControl_AppCallbacks_t *CBs;     // Pointer to Callback function
-} zclPollControlCBRec_t;
-
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -80,7 +73,6 @@ typedef struct zclPollControlCBRec
 /*********************************************************************
  * LOCAL VARIABLES
  */
-static zclPollControlCBRec_t *zclPollControlCBs = (zclPollControlCBRec_t *)NULL;
 static uint8 zclPollControlPluginRegisted = FALSE;
 
 /*********************************************************************
@@ -88,7 +80,6 @@ static uint8 zclPollControlPluginRegisted = FALSE;
  */
 static ZStatus_t zclPollControl_HdlIncoming( zclIncoming_t *pInHdlrMsg );
 static ZStatus_t zclPollControl_HdlInSpecificCommands( zclIncoming_t *pInMsg );
-static zclPollControl_AppCallbacks_t *zclPollControl_FindCallbacks( uint8 endpoint );
 static ZStatus_t zclPollControl_ProcessInCmds( zclIncoming_t *pInMsg, zclPollControl_AppCallbacks_t *pCBs );
 
 static ZStatus_t zclPollControl_ProcessInCmd_CheckIn( zclIncoming_t *pInMsg, zclPollControl_AppCallbacks_t *pCBs );
@@ -110,9 +101,6 @@ static ZStatus_t zclPollControl_ProcessInCmd_SetShortPollInterval( zclIncoming_t
  */
 ZStatus_t zclPollControl_RegisterCmdCallbacks( uint8 endpoint, zclPollControl_AppCallbacks_t *callbacks )
 {
-  zclPollControlCBRec_t *pNewItem;
-  zclPollControlCBRec_t *pLoop;
-
   // Register as a ZCL Plugin
   if ( zclPollControlPluginRegisted == FALSE )
   {
@@ -122,34 +110,7 @@ ZStatus_t zclPollControl_RegisterCmdCallbacks( uint8 endpoint, zclPollControl_Ap
     zclPollControlPluginRegisted = TRUE;
   }
 
-  // Fill in the new profile list
-  pNewItem = zcl_mem_alloc( sizeof( zclPollControlCBRec_t ) );
-  if ( pNewItem == NULL )
-  {
-    return ( ZMemError );
-  }
-
-  pNewItem->next = (zclPollControlCBRec_t *)NULL;
-  pNewItem->endpoint = endpoint;
-  pNewItem->CBs = callbacks;
-
-  // Find spot in list
-  if ( zclPollControlCBs == NULL )
-  {
-    zclPollControlCBs = pNewItem;
-  }
-  else
-  {
-    // Look for end of list
-    pLoop = zclPollControlCBs;
-    while ( pLoop->next != NULL )
-      pLoop = pLoop->next;
-
-    // Put new item at end of list
-    pLoop->next = pNewItem;
-  }
-
-  return ( ZSuccess );
+  return ( zcl_registerCmdCallbacks( endpoint, zclPollControl_HdlIncoming, callbacks ) );
 }
 
 /*********************************************************************
@@ -284,31 +245,6 @@ ZStatus_t zclPollControl_Send_SetShortPollInterval( uint8 srcEP, afAddrType_t *d
 }
 
 
-/*********************************************************************
- * @fn      zclPollControl_FindCallbacks
- *
- * @brief   Find the callbacks for an endpoint
- *
- * @param   endpoint - endpoint to find the application callbacks for
- *
- * @return  pointer to the callbacks
- */
-static zclPollControl_AppCallbacks_t *zclPollControl_FindCallbacks( uint8 endpoint )
-{
-  zclPollControlCBRec_t *pCBs;
-
-  pCBs = zclPollControlCBs;
-  while ( pCBs != NULL )
-  {
-    if ( pCBs->endpoint == endpoint )
-    {
-      return ( pCBs->CBs );
-    }
-    pCBs = pCBs->next;
-  }
-  return ( (zclPollControl_AppCallbacks_t *)NULL );
-}
-
 /*********************************************************************
  * @fn      zclPollControl_HdlIncoming
  *
@@ -367,7 +303,7 @@ static ZStatus_t zclPollControl_HdlInSpecificCommands( zclIncoming_t *pInMsg )
   zclPollControl_AppCallbacks_t *pCBs;
 
   // make sure endpoint exists
-  pCBs = zclPollControl_FindCallbacks( pInMsg->msg->endPoint );
+  pCBs = zcl_FindCallbacks( pInMsg->msg->endPoint, pInMsg->msg->clusterId );
   if (pCBs == NULL )
   {
     return ( ZFailure );
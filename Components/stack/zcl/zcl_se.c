@@ -241,12 +241,6 @@
  * TYPEDEFS
  */
 
-typedef struct zclSE_CBRecType
-{
-  struct zclSE_CBRecType  *pNext;
-  uint8                   appEP;
-  zclSE_AppCallbacks_t    *pCBs;
-} zclSE_CBRec_t;
 
 
 /**************************************************************************************************
@@ -258,7 +252,6 @@ typedef struct zclSE_CBRecType
  * LOCAL VARIABLES
  */
 
-static zclSE_CBRec_t *zcl_SECBs = (zclSE_CBRec_t *)NULL;
 static uint8 zclSE_PluginRegisted = FALSE;
 
 
@@ -365,33 +358,6 @@ static uint8* zclSE_UTF8StringParse( uint8 *pBuf, uint8* pBufEnd, UTF8String_t *
   return pBuf;
 }
 
-/**************************************************************************************************
- * @fn      zclSE_FindCallbacks
- *
- * @brief   Find the callbacks for an application endpoint.
- *
- * @param   appEP - application endpoint
- *
- * @return  pointer to zclSE_AppCallbacks_t or NULL
- */
-static zclSE_AppCallbacks_t *zclSE_FindCallbacks( uint8 appEP )
-{
-  zclSE_CBRec_t *pRec;
-
-  pRec = zcl_SECBs;
-  while ( pRec )
-  {
-    if ( pRec->appEP == appEP )
-    {
-      return ( pRec->pCBs );
-    }
-
-    pRec = pRec->pNext;
-  }
-
-  return ( (zclSE_AppCallbacks_t *)NULL );
-}
-
 /**************************************************************************************************
  * @fn      zclSE_HdlIncoming
  *
@@ -17870,7 +17836,7 @@ ZStatus_t zclSE_HdlAppSpecificCmd( zclIncoming_t *pInMsg )
   zclSE_AppCallbacks_t *pCBs = NULL;
 
   // Look for endpoint callbacks
-  pCBs = zclSE_FindCallbacks( pInMsg->msg->endPoint );
+  pCBs = zcl_FindCallbacks( pInMsg->msg->endPoint, pInMsg->msg->clusterId );
   if ( pCBs != NULL )
   {
     status = zclSE_HdlSpecificCmd( pInMsg, pCBs );
@@ -17935,42 +17901,10 @@ void zclSE_RegisterPlugin( void )
  */
 ZStatus_t zclSE_RegisterCmdCallbacks( uint8 appEP, zclSE_AppCallbacks_t *pCBs )
 {
-  zclSE_CBRec_t *pNewRec;
-  zclSE_CBRec_t *pSelect;
-
   // Register as a ZCL Plugin
   zclSE_RegisterPlugin();
 
-  // Fill in the new profile list
-  pNewRec = osal_mem_alloc( sizeof( zclSE_CBRec_t ) );
-  if ( pNewRec == NULL )
-  {
-    return ZMemError;
-  }
-
-  pNewRec->pNext = (zclSE_CBRec_t *)NULL;
-  pNewRec->appEP = appEP;
-  pNewRec->pCBs = pCBs;
-
-  // Find spot in list
-  if ( zcl_SECBs == NULL )
-  {
-    zcl_SECBs = pNewRec;
-  }
-  else
-  {
-    // Look for end of list
-    pSelect = zcl_SECBs;
-    while ( pSelect->pNext != NULL )
-    {
-      pSelect = pSelect->pNext;
-    }
-
-    // Put new item at end of list
-    pSelect->pNext = pNewRec;
-  }
-
-  return ZSuccess;
+  return zcl_registerCmdCallbacks( appEP, zclSE_HdlIncoming, pCBs );
 }
 
 
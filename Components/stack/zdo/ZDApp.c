@@ -2417,7 +2417,7 @@ void ZDApp_SendMsg( uint8 taskID, uint8 cmd, uint8 len, uint8 *buf )
       osal_memcpy( msgPtr, buf, len );
 
     msgPtr->event = cmd;
-    osal_msg_send( taskID, (uint8 *)msgPtr );
+    osal_msg_send_pri( taskID, (uint8 *)msgPtr, OSAL_MSG_PRI_HIGH );
   }
 }
 
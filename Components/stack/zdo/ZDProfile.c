@@ -2026,7 +2026,7 @@ uint8 ZDO_SendMsgCBs( zdoIncomingMsg_t *inMsg )
         }
 
         msgPtr->hdr.event = ZDO_CB_MSG;
-        osal_msg_send( pList->taskID, (uint8 *)msgPtr );
+        osal_msg_send_pri( pList->taskID, (uint8 *)msgPtr, OSAL_MSG_PRI_HIGH );
         ret = TRUE;
       }
     }
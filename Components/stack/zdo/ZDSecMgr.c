@@ -73,6 +73,19 @@ extern "C"
 // maximum number of LINK keys this device may store
 #define ZDSECMGR_ENTRY_MAX ZDSECMGR_DEVICE_MAX
 
+// number of chains used to find an entry from its address index
+#if !defined ( ZDSECMGR_AMI_HASH_SIZE )
+  #define ZDSECMGR_AMI_HASH_SIZE ZDSECMGR_ENTRY_MAX
+#endif
+
+// end of an entry chain
+#define ZDSECMGR_ENTRY_NONE 0xFFFF
+
+// state of an entry's LINK key in NV, as last read or written
+#define ZDSECMGR_KEY_UNKNOWN 0
+#define ZDSECMGR_KEY_VALID   1
+#define ZDSECMGR_KEY_INVALID 2
+
 // total number of stored devices
 #if !defined ( ZDSECMGR_STORED_DEVICES )
   #define ZDSECMGR_STORED_DEVICES 3
@@ -146,6 +159,14 @@ uint8 ZDSecMgrTCAuthenticated = FALSE;
 
 ZDSecMgrEntry_t* ZDSecMgrEntries  = NULL;
 
+// Entries are chained by address index hash, free entries on their own chain
+static uint16 ZDSecMgrAmiHash[ZDSECMGR_AMI_HASH_SIZE];
+static uint16 ZDSecMgrFreeHead = ZDSECMGR_ENTRY_NONE;
+static uint16 ZDSecMgrEntryNext[ZDSECMGR_ENTRY_MAX];
+
+// LINK key state of each entry, saves reading the key to check it is set
+static uint8 ZDSecMgrKeyState[ZDSECMGR_ENTRY_MAX];
+
 void ZDSecMgrAddrMgrCB( uint8 update, AddrMgrEntry_t* newEntry, AddrMgrEntry_t* oldEntry );
 
 uint8 ZDSecMgrPermitJoiningEnabled;
@@ -214,6 +235,9 @@ ZStatus_t ZDSecMgrEntryLookupExtGetIndex( uint8* extAddr, ZDSecMgrEntry_t** entr
 ZStatus_t ZDSecMgrEntryLookupAMIGetIndex( uint16 ami, uint16* entryIndex );
 void ZDSecMgrEntryFree( ZDSecMgrEntry_t* entry );
 ZStatus_t ZDSecMgrEntryNew( ZDSecMgrEntry_t** entry );
+static uint16* ZDSecMgrEntryChain( uint16 ami );
+static void ZDSecMgrEntryChainBuild( void );
+static void ZDSecMgrEntryAmiSet( ZDSecMgrEntry_t* entry, uint16 ami );
 ZStatus_t ZDSecMgrAuthenticationSet( uint8* extAddr, ZDSecMgr_Authentication_Option option );
 void ZDSecMgrApsLinkKeyInit(uint8 setDefault);
 #if defined ( NV_RESTORE )
@@ -437,6 +461,8 @@ void ZDSecMgrEntryInit(uint8 state)
 
       ZDSecMgrEntries[index].keyNvId = SEC_NO_KEY_NV_ID;
     }
+
+    ZDSecMgrEntryChainBuild();
   }
 
 #if defined NV_RESTORE
@@ -449,6 +475,97 @@ void ZDSecMgrEntryInit(uint8 state)
 #endif
 }
 
+/******************************************************************************
+ * @fn          ZDSecMgrEntryChain
+ *
+ * @brief       Get the head of the chain holding entries of an address index.
+ *
+ * @param       ami - [in] Address Manager index, INVALID_NODE_ADDR for the
+ *                         chain of free entries
+ *
+ * @return      pointer to the index of the first entry in the chain
+ */
+static uint16* ZDSecMgrEntryChain( uint16 ami )
+{
+  if ( ami == INVALID_NODE_ADDR )
+  {
+    return &ZDSecMgrFreeHead;
+  }
+
+  return &ZDSecMgrAmiHash[ami % ZDSECMGR_AMI_HASH_SIZE];
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryChainBuild
+ *
+ * @brief       Chain all entries by their address index and forget the
+ *              state of their LINK keys.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+static void ZDSecMgrEntryChainBuild( void )
+{
+  uint16* chain;
+  uint16  index;
+
+  for ( index = 0; index < ZDSECMGR_AMI_HASH_SIZE; index++ )
+  {
+    ZDSecMgrAmiHash[index] = ZDSECMGR_ENTRY_NONE;
+  }
+  ZDSecMgrFreeHead = ZDSECMGR_ENTRY_NONE;
+
+  // add from the top so free entries are handed out lowest first
+  index = ZDSECMGR_ENTRY_MAX;
+  while ( index-- > 0 )
+  {
+    chain = ZDSecMgrEntryChain( ZDSecMgrEntries[index].ami );
+    ZDSecMgrEntryNext[index] = *chain;
+    *chain = index;
+
+    ZDSecMgrKeyState[index] = ZDSECMGR_KEY_UNKNOWN;
+  }
+}
+
+/******************************************************************************
+ * @fn          ZDSecMgrEntryAmiSet
+ *
+ * @brief       Set the address index of an entry, moving it to its new chain.
+ *
+ * @param       entry - [in] valid entry
+ * @param       ami   - [in] Address Manager index, INVALID_NODE_ADDR to free
+ *
+ * @return      none
+ */
+static void ZDSecMgrEntryAmiSet( ZDSecMgrEntry_t* entry, uint16 ami )
+{
+  uint16* chain;
+  uint16  index;
+
+  index = (uint16)(entry - ZDSecMgrEntries);
+
+  // unlink from the current chain
+  chain = ZDSecMgrEntryChain( entry->ami );
+  while ( *chain != ZDSECMGR_ENTRY_NONE )
+  {
+    if ( *chain == index )
+    {
+      *chain = ZDSecMgrEntryNext[index];
+      break;
+    }
+
+    chain = &ZDSecMgrEntryNext[*chain];
+  }
+
+  entry->ami = ami;
+
+  // link at the head of the new chain
+  chain = ZDSecMgrEntryChain( ami );
+  ZDSecMgrEntryNext[index] = *chain;
+  *chain = index;
+}
+
 /******************************************************************************
  * @fn          ZDSecMgrEntryLookup
  *
@@ -473,19 +590,13 @@ ZStatus_t ZDSecMgrEntryLookup( uint16 nwkAddr, ZDSecMgrEntry_t** entry )
     addrMgrEntry.user    = ADDRMGR_USER_SECURITY;
     addrMgrEntry.nwkAddr = nwkAddr;
 
-    if ( AddrMgrEntryLookupNwk( &addrMgrEntry ) == TRUE )
+    if ( ( AddrMgrEntryLookupNwk( &addrMgrEntry ) == TRUE ) &&
+         ( ZDSecMgrEntryLookupAMIGetIndex( addrMgrEntry.index, &index ) == ZSuccess ) )
     {
-      for ( index = 0; index < ZDSECMGR_ENTRY_MAX ; index++ )
-      {
-        if ( addrMgrEntry.index == ZDSecMgrEntries[index].ami )
-        {
-          // return successful results
-          *entry = &ZDSecMgrEntries[index];
+      // return successful results
+      *entry = &ZDSecMgrEntries[index];
 
-          // break from loop
-          return ZSuccess;
-        }
-      }
+      return ZSuccess;
     }
   }
 
@@ -509,20 +620,12 @@ ZStatus_t ZDSecMgrEntryLookupAMI( uint16 ami, ZDSecMgrEntry_t** entry )
   // initialize results
   *entry = NULL;
 
-  // verify data is available
-  if ( ZDSecMgrEntries != NULL )
+  if ( ZDSecMgrEntryLookupAMIGetIndex( ami, &index ) == ZSuccess )
   {
-    for ( index = 0; index < ZDSECMGR_ENTRY_MAX ; index++ )
-    {
-      if ( ZDSecMgrEntries[index].ami == ami )
-      {
-        // return successful results
-        *entry = &ZDSecMgrEntries[index];
+    // return successful results
+    *entry = &ZDSecMgrEntries[index];
 
-        // break from loop
-        return ZSuccess;
-      }
-    }
+    return ZSuccess;
   }
 
   return ZNwkUnknownDevice;
@@ -572,24 +675,14 @@ ZStatus_t ZDSecMgrEntryLookupExtGetIndex( uint8* extAddr, ZDSecMgrEntry_t** entr
   uint16 index;
 
   // lookup address index
-  if ( ZDSecMgrExtAddrLookup( extAddr, &ami ) == ZSuccess )
+  if ( ( ZDSecMgrExtAddrLookup( extAddr, &ami ) == ZSuccess ) &&
+       ( ZDSecMgrEntryLookupAMIGetIndex( ami, &index ) == ZSuccess ) )
   {
-    // verify data is available
-    if ( ZDSecMgrEntries != NULL )
-    {
-      for ( index = 0; index < ZDSECMGR_ENTRY_MAX ; index++ )
-      {
-        if ( ZDSecMgrEntries[index].ami == ami )
-        {
-          // return successful results
-          *entry = &ZDSecMgrEntries[index];
-          *entryIndex = index;
+    // return successful results
+    *entry = &ZDSecMgrEntries[index];
+    *entryIndex = index;
 
-          // break from loop
-          return ZSuccess;
-        }
-      }
-    }
+    return ZSuccess;
   }
 
   return ZNwkUnknownDevice;
@@ -610,18 +703,21 @@ ZStatus_t ZDSecMgrEntryLookupAMIGetIndex( uint16 ami, uint16* entryIndex )
   uint16 index;
 
   // verify data is available
-  if ( ZDSecMgrEntries != NULL )
+  if ( ( ZDSecMgrEntries != NULL ) && ( ami != INVALID_NODE_ADDR ) )
   {
-    for ( index = 0; index < ZDSECMGR_ENTRY_MAX ; index++ )
+    // walk the chain of entries hashed with this address index
+    index = *ZDSecMgrEntryChain( ami );
+    while ( index != ZDSECMGR_ENTRY_NONE )
     {
       if ( ZDSecMgrEntries[index].ami == ami )
       {
         // return successful results
         *entryIndex = index;
 
-        // break from loop
         return ZSuccess;
       }
+
+      index = ZDSecMgrEntryNext[index];
     }
   }
 
@@ -664,8 +760,10 @@ void ZDSecMgrEntryFree( ZDSecMgrEntry_t* entry )
     osal_mem_free(pApsLinkKey);
   }
 
+  ZDSecMgrKeyState[entry - ZDSecMgrEntries] = ZDSECMGR_KEY_UNKNOWN;
+
   // marking the entry as INVALID_NODE_ADDR
-  entry->ami = INVALID_NODE_ADDR;
+  ZDSecMgrEntryAmiSet( entry, INVALID_NODE_ADDR );
 
   // set to default value
   entry->authenticateOption = ZDSecMgr_Not_Authenticated;
@@ -694,24 +792,19 @@ ZStatus_t ZDSecMgrEntryNew( ZDSecMgrEntry_t** entry )
   // initialize results
   *entry = NULL;
 
-  // verify data is available
-  if ( ZDSecMgrEntries != NULL )
+  // verify data is available, free entries stay chained until an address
+  // index is set
+  if ( ( ZDSecMgrEntries != NULL ) && ( ZDSecMgrFreeHead != ZDSECMGR_ENTRY_NONE ) )
   {
-    // find available entry
-    for ( index = 0; index < ZDSECMGR_ENTRY_MAX ; index++ )
-    {
-      if ( ZDSecMgrEntries[index].ami == INVALID_NODE_ADDR )
-      {
-        // return successful result
-        *entry = &ZDSecMgrEntries[index];
+    index = ZDSecMgrFreeHead;
 
-        // Set the authentication option to default
-        ZDSecMgrEntries[index].authenticateOption = ZDSecMgr_Not_Authenticated;
+    // return successful result
+    *entry = &ZDSecMgrEntries[index];
 
-        // break from loop
-        return ZSuccess;
-      }
-    }
+    // Set the authentication option to default
+    ZDSecMgrEntries[index].authenticateOption = ZDSecMgr_Not_Authenticated;
+
+    return ZSuccess;
   }
 
   return ZNwkUnknownDevice;
@@ -1921,7 +2014,7 @@ void ZDSecMgrTransportKeyInd( ZDO_TransportKeyInd_t* ind )
         if ( ZDSecMgrEntryNew( &entry ) == ZSuccess )
         {
           // finish setting up entry
-          entry->ami = ami;
+          ZDSecMgrEntryAmiSet( entry, ami );
         }
       }
 
@@ -2435,8 +2528,17 @@ ZStatus_t ZDSecMgrLinkKeySet( uint8* extAddr, uint8* key )
       pApsLinkKey->rxFrmCntr = 0;
       pApsLinkKey->txFrmCntr = 0;
 
-      osal_nv_write( entry->keyNvId, 0,
-                    sizeof(APSME_LinkKeyData_t), pApsLinkKey );
+      if ( osal_nv_write( entry->keyNvId, 0,
+                          sizeof(APSME_LinkKeyData_t), pApsLinkKey ) == SUCCESS )
+      {
+        ZDSecMgrKeyState[Index] = osal_isbufset( key, 0x00, SEC_KEY_LEN ) ?
+                                    ZDSECMGR_KEY_INVALID : ZDSECMGR_KEY_VALID;
+      }
+      else
+      {
+        // NV content is unknown, check it again on the next lookup
+        ZDSecMgrKeyState[Index] = ZDSECMGR_KEY_UNKNOWN;
+      }
 
       // clear copy of key in RAM
       osal_memset(pApsLinkKey, 0x00, sizeof(APSME_LinkKeyData_t));
@@ -2588,6 +2690,7 @@ uint8 ZDSecMgrIsLinkKeyValid(uint8* extAddr)
 {
   APSME_LinkKeyData_t *pKeyData;
   uint16 apsLinkKeyNvId;
+  uint16 entryIndex;
   uint8 nullKey[SEC_KEY_LEN];
   uint8 status = FALSE;
 
@@ -2599,31 +2702,66 @@ uint8 ZDSecMgrIsLinkKeyValid(uint8* extAddr)
 
   if (apsLinkKeyNvId != SEC_NO_KEY_NV_ID )
   {
-    pKeyData = (APSME_LinkKeyData_t *)osal_mem_alloc(sizeof(APSME_LinkKeyData_t));
+    entryIndex = apsLinkKeyNvId - ZCD_NV_APS_LINK_KEY_DATA_START;
 
-    if (pKeyData != NULL)
+    // use the state of the key if it has already been read or written
+    if ( ( entryIndex < ZDSECMGR_ENTRY_MAX ) &&
+         ( ZDSecMgrKeyState[entryIndex] != ZDSECMGR_KEY_UNKNOWN ) )
     {
-      // retrieve key from NV
-      if ( osal_nv_read( apsLinkKeyNvId, 0,
-                        sizeof(APSME_LinkKeyData_t), pKeyData) == ZSUCCESS)
+      status = ( ZDSecMgrKeyState[entryIndex] == ZDSECMGR_KEY_VALID );
+    }
+    else
+    {
+      pKeyData = (APSME_LinkKeyData_t *)osal_mem_alloc(sizeof(APSME_LinkKeyData_t));
+
+      if (pKeyData != NULL)
       {
-        // if stored key is different than default value, then a key has been established
-        if (!osal_memcmp(pKeyData, nullKey, SEC_KEY_LEN))
+        // retrieve key from NV
+        if ( osal_nv_read( apsLinkKeyNvId, 0,
+                          sizeof(APSME_LinkKeyData_t), pKeyData) == ZSUCCESS)
         {
-          status = TRUE;
+          // if stored key is different than default value, then a key has been established
+          if (!osal_memcmp(pKeyData, nullKey, SEC_KEY_LEN))
+          {
+            status = TRUE;
+          }
+
+          if ( entryIndex < ZDSECMGR_ENTRY_MAX )
+          {
+            ZDSecMgrKeyState[entryIndex] = status ? ZDSECMGR_KEY_VALID : ZDSECMGR_KEY_INVALID;
+          }
         }
-      }
 
-      // clear copy of key in RAM
-      osal_memset(pKeyData, 0x00, sizeof(APSME_LinkKeyData_t));
+        // clear copy of key in RAM
+        osal_memset(pKeyData, 0x00, sizeof(APSME_LinkKeyData_t));
 
-      osal_mem_free(pKeyData);
+        osal_mem_free(pKeyData);
+      }
     }
   }
 
   return status;
 }
 
+/******************************************************************************
+ * @fn          ZDSecMgrLinkKeyStateClear
+ *
+ * @brief       Forget whether an APS Link Key has been set, so it is read
+ *              from NV the next time it is checked.
+ *
+ * @param       keyNvId - [in] NV ID of the APS Link Key
+ *
+ * @return      none
+ */
+void ZDSecMgrLinkKeyStateClear( uint16 keyNvId )
+{
+  if ( ( keyNvId >= ZCD_NV_APS_LINK_KEY_DATA_START ) &&
+       ( keyNvId < ZCD_NV_APS_LINK_KEY_DATA_START + ZDSECMGR_ENTRY_MAX ) )
+  {
+    ZDSecMgrKeyState[keyNvId - ZCD_NV_APS_LINK_KEY_DATA_START] = ZDSECMGR_KEY_UNKNOWN;
+  }
+}
+
 /******************************************************************************
  * @fn          ZDSecMgrKeyFwdToChild (stubs APSME_KeyFwdToChild)
  *
@@ -2685,7 +2823,7 @@ ZStatus_t ZDSecMgrAddLinkKey( uint16 shortAddr, uint8 *extAddr, uint8 *key)
   {
     if ( ZDSecMgrEntryNew( &entry ) == ZSuccess )
     {
-      entry->ami = ami;
+      ZDSecMgrEntryAmiSet( entry, ami );
     }
     else
     {
@@ -2839,6 +2977,8 @@ static void ZDSecMgrRestoreFromNV( void )
     {
       osal_mem_free(pApsLinkKey);
     }
+
+    ZDSecMgrEntryChainBuild();
   }
 
   osal_nv_read( ZCD_NV_TRUSTCENTER_ADDR, 0, Z_EXTADDR_LEN, zgApsTrustCenterAddr );
@@ -2892,6 +3032,9 @@ void ZDSecMgrSetDefaultNV( void )
 
     osal_mem_free(pApsLinkKey);
   }
+
+  // the keys have to be read again
+  osal_memset( ZDSecMgrKeyState, ZDSECMGR_KEY_UNKNOWN, sizeof( ZDSecMgrKeyState ) );
 }
 
 #if defined ( NV_RESTORE )
@@ -3554,6 +3697,9 @@ void ZDSecMgrApsLinkKeyInit(uint8 setDefault)
     }
 #endif // defined (NV_RESTORE)
   }
+
+  // the keys have to be read again
+  osal_memset( ZDSecMgrKeyState, ZDSECMGR_KEY_UNKNOWN, sizeof( ZDSecMgrKeyState ) );
 }
 
 
@@ -472,6 +472,19 @@ extern void ZDSecMgrInitNVKeyTables(uint8 setDefault);
  */
 extern void ZDSecMgrSaveApsLinkKey(void);
 
+/******************************************************************************
+ * @fn          ZDSecMgrLinkKeyStateClear
+ *
+ * @brief       Forget whether an APS Link Key has been set, so it is read
+ *              from NV the next time it is checked. Call after writing the
+ *              key's NV item from outside the Security Manager.
+ *
+ * @param       keyNvId - NV ID of the APS Link Key
+ *
+ * @return      none
+ */
+extern void ZDSecMgrLinkKeyStateClear( uint16 keyNvId );
+
 /******************************************************************************
  * @fn          ZDSecMgrSaveTCLinkKey
  *
@@ -93,10 +93,31 @@
  * CONSTANTS
  */
 
+#ifdef ZCL_REPORT
+// Number of config report records the report scheduler can track
+#if !defined ( MULTISENSOR_MAX_REPORT_RECS )
+  #define MULTISENSOR_MAX_REPORT_RECS   8
+#endif
+
+#define MULTISENSOR_REPORT_IDLE         0xFF    // Record is not in the report heap
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
 
+#ifdef ZCL_REPORT
+// Report scheduler state of a config report record
+typedef struct
+{
+  uint32 due;           // Time the record is next due to be reported, in seconds
+  uint32 lastReport;    // Time of the last report, in seconds
+  uint32 lastValue;     // Attribute value sent in the last report
+  uint32 change;        // Reportable change, cfgReportRec.reportableChange points here
+  uint8  heapPos;       // Position in reportHeap[], or MULTISENSOR_REPORT_IDLE
+} multiSensorReportState_t;
+#endif
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -105,7 +126,7 @@ afAddrType_t zclMultiSensor_dstAddr;
 extern int16 zdpExternalStateTaskID;
 static devStates_t NwkStateShadow = DEV_HOLD;
 
-uint16 gTimeCounter;
+uint32 gTimeCounter;    // Seconds since power-up, advanced by zclMultiSensor_ReportTime()
 uint8 holdKeyCounter;
 uint8 uartFlag;
 uint8 signTempFlag;
@@ -125,6 +146,15 @@ static endPointDesc_t multiSensor_Ep =
   (afNetworkLatencyReq_t)0                  // No Network Latency req
 };
 
+#ifdef ZCL_REPORT
+static uint32 reportClockMs;    // System clock at the last whole second counted in gTimeCounter
+
+// Config report records that have a report pending, as a min-heap on the due time
+static multiSensorReportState_t reportState[MULTISENSOR_MAX_REPORT_RECS];
+static uint8 reportHeap[MULTISENSOR_MAX_REPORT_RECS];
+static uint8 reportHeapCnt;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -154,8 +184,15 @@ static uint8 zclMultiSensor_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg
 static void zclMultiSensor_CheckReportConfig(void);
 static uint8 SendZclAttrReport(uint8 srcEp, uint16 clusterId, zclReportCmd_t *pReportCmd, uint8 datalen);
 static void zclMultiSensor_CheckAndSendClusterAttrReport( uint8 endpoint, uint16 clusterId,
-                                                          zclConfigReportRecsList *pConfigReportRecsList );
+                                                          zclConfigReportRecsList *pConfigReportRecsList,
+                                                          uint32 now );
 static void sendZclAttrChangeReport(uint16 clusterId, uint16 attrID, uint8 *currentValue);
+static uint32 zclMultiSensor_ReportTime( void );
+static void zclMultiSensor_ScheduleReport( uint8 idx, uint32 due );
+static void zclMultiSensor_UnscheduleReport( uint8 idx );
+static void zclMultiSensor_ArmReportTimer( void );
+static uint32 zclMultiSensor_ReportValue( CONST zclAttrRec_t *pAttr );
+static uint8 zclMultiSensor_ReportableChange( uint8 idx, CONST zclAttrRec_t *pAttr );
 //-- MOD END
 #endif
 
@@ -253,6 +290,16 @@ void zclMultiSensor_Init( byte task_id )
   // Register the application's config report record list
   zcl_registerConfigReportRecList( MULTISENSOR_ENDPOINT,
                                    zclMultiSensor_NumConfigReportRecs, zclMultiSensor_ConfigReportRecs );
+
+  // Nothing is scheduled until a record is configured to report
+  {
+    uint8 x;
+    for ( x = 0; x < MULTISENSOR_MAX_REPORT_RECS; x++ )
+    {
+      reportState[x].heapPos = MULTISENSOR_REPORT_IDLE;
+    }
+  }
+  reportClockMs = osal_GetSystemClock();
 #endif
   
   // Register commissioning status callback
@@ -725,6 +772,9 @@ void uartEventApplicationCB(uint8 port, uint8 event)
             zclMultiSensor_Light_MeasuredValue = valueOfSensors[INDEX_LIGHT];
             zclMultiSensor_TVOC_MeasuredValue = valueOfSensors[INDEX_TVOC];
             zclMultiSensor_CO2_MeasuredValue = valueOfSensors[INDEX_CO2];
+            sendZclAttrChangeReport( ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT, ATTRID_MS_ILLUMINANCE_LEVEL_STATUS, (uint8 *)&zclMultiSensor_Light_MeasuredValue);
+            sendZclAttrChangeReport( ZCL_CLUSTER_ID_MS_TVOC_MEASUREMENT, ATTRID_MS_TVOC_MEASURED_VALUE, (uint8 *)&zclMultiSensor_TVOC_MeasuredValue);
+            sendZclAttrChangeReport( ZCL_CLUSTER_ID_MS_CO2_MEASUREMENT, ATTRID_MS_CO2_MEASURED_VALUE, (uint8 *)&zclMultiSensor_CO2_MeasuredValue);
           }
           else if ( uartFlag == UART_HUM )
           {
@@ -760,77 +810,331 @@ void uartEventApplicationCB(uint8 port, uint8 event)
 /*********************************************************************
 * @fn      zclMultiSensor_CheckAndSendClusterAttrReport
 *
-* @brief   Check if there is a reportable attribute in all cluster is timeout to report
+* @brief   Send one report holding every attribute of a cluster that is due,
+*          and schedule the next periodic report of each of them.
 *
-* @param   none
+* @param   endpoint - endpoint of the config report records
+*          clusterId - cluster to report
+*          pConfigReportRecsList - config report records of the endpoint
+*          now - current time, in seconds
 *
 * @return  none
 */
 static void zclMultiSensor_CheckAndSendClusterAttrReport( uint8 endpoint, uint16 clusterId,
-                                                                     zclConfigReportRecsList *pConfigReportRecsList )
+                                                          zclConfigReportRecsList *pConfigReportRecsList,
+                                                          uint32 now )
 {
   uint8 numAttr = 0;
+  uint8 numRecs;
   uint8 x;
   uint16 len;
   zclReportCmd_t *pReportCmd;
-  zclConfigReportRec_t *pConfigReportRec = NULL;
-  zclAttrRec_t attrRec;
-  
-  for (x = 0; x < pConfigReportRecsList->numConfigReportRec; x++)
+  zclConfigReportRec_t *pConfigReportRec;
+  CONST zclAttrRec_t *pAttr;
+
+  numRecs = pConfigReportRecsList->numConfigReportRec;
+  if ( numRecs > MULTISENSOR_MAX_REPORT_RECS )
   {
-    pConfigReportRec = &(pConfigReportRecsList->configReportRecs[x]);
-    
-    if (pConfigReportRec->clusterId == clusterId &&
-        pConfigReportRec->cfgReportRec.maxReportInt != 0xFFFF)
+    numRecs = MULTISENSOR_MAX_REPORT_RECS;
+  }
+
+  for ( x = 0; x < numRecs; x++ )
+  {
+    if ( (pConfigReportRecsList->configReportRecs[x].clusterId == clusterId) &&
+         (reportState[x].heapPos != MULTISENSOR_REPORT_IDLE) && (reportState[x].due <= now) )
     {
-      if (pConfigReportRec->timeup == 0xFFFF || pConfigReportRec->timeup == gTimeCounter)
-      {
-        numAttr++;
-      }
+      numAttr++;
     }
   }
-  
-  if (numAttr != 0)
+
+  if ( numAttr == 0 )
   {
-    // we need to send a report - allocate space for it
-    len = sizeof(zclReportCmd_t) + (numAttr * sizeof(zclReport_t));
-    pReportCmd = (zclReportCmd_t *)zcl_mem_alloc( len );
-    pReportCmd->numAttr = numAttr;
+    return;
   }
-  
+
+  // we need to send a report - allocate space for it
+  len = sizeof(zclReportCmd_t) + (numAttr * sizeof(zclReport_t));
+  pReportCmd = (zclReportCmd_t *)zcl_mem_alloc( len );
+
+  if ( pReportCmd == NULL )
+  {
+    // Try again in a second
+    for ( x = 0; x < numRecs; x++ )
+    {
+      if ( (pConfigReportRecsList->configReportRecs[x].clusterId == clusterId) &&
+           (reportState[x].heapPos != MULTISENSOR_REPORT_IDLE) && (reportState[x].due <= now) )
+      {
+        zclMultiSensor_ScheduleReport( x, now + 1 );
+      }
+    }
+    return;
+  }
+
   numAttr = 0;
-  
-  for (x = 0; x < pConfigReportRecsList->numConfigReportRec; x++ )
+
+  for ( x = 0; x < numRecs; x++ )
   {
+    multiSensorReportState_t *pState = &reportState[x];
     zclReport_t *reportRec;
     pConfigReportRec = &(pConfigReportRecsList->configReportRecs[x]);
-    
-    if (pConfigReportRec->clusterId == clusterId && pConfigReportRec->cfgReportRec.maxReportInt != 0xFFFF)      // need report
+
+    if ( (pConfigReportRec->clusterId != clusterId) ||
+         (pState->heapPos == MULTISENSOR_REPORT_IDLE) || (pState->due > now) )
     {
-      if (pConfigReportRec->timeup == 0xFFFF || pConfigReportRec->timeup == gTimeCounter)       //timeup to report
-      {
-        // fill the record in *pReportCmd
-        reportRec = &(pReportCmd->attrList[numAttr]);
-        zcl_memset( reportRec, 0, sizeof(zclReport_t));
-        numAttr++;
-        zclFindAttrRec(endpoint, pConfigReportRec->clusterId, pConfigReportRec->cfgReportRec.attrID, &attrRec);
-        
-        reportRec->attrID = attrRec.attr.attrId;
-        reportRec->dataType = attrRec.attr.dataType;
-        reportRec->attrData = attrRec.attr.dataPtr;
-        
-        if (pConfigReportRec->cfgReportRec.minReportInt == 0)
-          pConfigReportRec->timeup = gTimeCounter + pConfigReportRec->cfgReportRec.maxReportInt;
-        else
-          pConfigReportRec->timeup = gTimeCounter + pConfigReportRec->cfgReportRec.minReportInt;
-      }
+      continue;
+    }
+
+    // fill the record in *pReportCmd
+    reportRec = &(pReportCmd->attrList[numAttr++]);
+    zcl_memset( reportRec, 0, sizeof(zclReport_t) );
+    reportRec->attrID = pConfigReportRec->cfgReportRec.attrID;
+
+    pAttr = zclFindAttrRecPtr( endpoint, clusterId, pConfigReportRec->cfgReportRec.attrID );
+    if ( pAttr != NULL )
+    {
+      reportRec->dataType = pAttr->attr.dataType;
+      reportRec->attrData = pAttr->attr.dataPtr;
+      pState->lastValue = zclMultiSensor_ReportValue( pAttr );
+    }
+    pState->lastReport = now;
+
+    // A maximum interval of zero turns periodic reports off, only changes are reported
+    if ( pConfigReportRec->cfgReportRec.maxReportInt == 0 )
+    {
+      zclMultiSensor_UnscheduleReport( x );
+    }
+    else
+    {
+      zclMultiSensor_ScheduleReport( x, now + pConfigReportRec->cfgReportRec.maxReportInt );
     }
   }
-  
-  if (numAttr != 0)
+
+  pReportCmd->numAttr = numAttr;
+  SendZclAttrReport( endpoint, clusterId, pReportCmd, len );
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_ReportTime
+*
+* @brief   Advance gTimeCounter by the whole seconds elapsed on the system clock.
+*
+* @param   none
+*
+* @return  current time, in seconds
+*/
+static uint32 zclMultiSensor_ReportTime( void )
+{
+  uint32 secs = (osal_GetSystemClock() - reportClockMs) / 1000;
+
+  gTimeCounter += secs;
+  reportClockMs += secs * 1000;
+
+  return gTimeCounter;
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_ScheduleReport
+*
+* @brief   Put a config report record in the report heap, or move it to a new due time.
+*
+* @param   idx - index of the config report record
+*          due - time the record is due to be reported, in seconds
+*
+* @return  none
+*/
+static void zclMultiSensor_ScheduleReport( uint8 idx, uint32 due )
+{
+  uint8 pos = reportState[idx].heapPos;
+
+  if ( pos == MULTISENSOR_REPORT_IDLE )
   {
-    SendZclAttrReport( endpoint, clusterId, pReportCmd, len);
+    pos = reportHeapCnt++;
   }
+  reportState[idx].due = due;
+
+  // Sift up
+  while ( pos != 0 )
+  {
+    uint8 parent = (pos - 1) / 2;
+
+    if ( reportState[reportHeap[parent]].due <= due )
+    {
+      break;
+    }
+    reportHeap[pos] = reportHeap[parent];
+    reportState[reportHeap[pos]].heapPos = pos;
+    pos = parent;
+  }
+
+  // Sift down
+  while ( TRUE )
+  {
+    uint8 child = (pos * 2) + 1;
+
+    if ( child >= reportHeapCnt )
+    {
+      break;
+    }
+    if ( (child + 1 < reportHeapCnt) &&
+         (reportState[reportHeap[child + 1]].due < reportState[reportHeap[child]].due) )
+    {
+      child++;
+    }
+    if ( due <= reportState[reportHeap[child]].due )
+    {
+      break;
+    }
+    reportHeap[pos] = reportHeap[child];
+    reportState[reportHeap[pos]].heapPos = pos;
+    pos = child;
+  }
+
+  reportHeap[pos] = idx;
+  reportState[idx].heapPos = pos;
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_UnscheduleReport
+*
+* @brief   Take a config report record out of the report heap.
+*
+* @param   idx - index of the config report record
+*
+* @return  none
+*/
+static void zclMultiSensor_UnscheduleReport( uint8 idx )
+{
+  uint8 pos = reportState[idx].heapPos;
+  uint8 last;
+
+  if ( pos == MULTISENSOR_REPORT_IDLE )
+  {
+    return;
+  }
+  reportState[idx].heapPos = MULTISENSOR_REPORT_IDLE;
+
+  // Refill the hole with the last record in the heap
+  last = reportHeap[--reportHeapCnt];
+  if ( last != idx )
+  {
+    reportHeap[pos] = last;
+    reportState[last].heapPos = pos;
+    zclMultiSensor_ScheduleReport( last, reportState[last].due );
+  }
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_ArmReportTimer
+*
+* @brief   Run the report check when the earliest record in the report heap is due.
+*
+* @param   none
+*
+* @return  none
+*/
+static void zclMultiSensor_ArmReportTimer( void )
+{
+  uint32 now;
+  uint32 due;
+
+  if ( reportHeapCnt == 0 )
+  {
+    osal_stop_timerEx( zclMultiSensor_TaskID, MULTISENSOR_CHECK_REPORT__EVT );
+    return;
+  }
+
+  now = zclMultiSensor_ReportTime();
+  due = reportState[reportHeap[0]].due;
+
+  if ( due <= now )
+  {
+    osal_stop_timerEx( zclMultiSensor_TaskID, MULTISENSOR_CHECK_REPORT__EVT );
+    osal_set_event( zclMultiSensor_TaskID, MULTISENSOR_CHECK_REPORT__EVT );
+  }
+  else
+  {
+    osal_start_timerEx( zclMultiSensor_TaskID, MULTISENSOR_CHECK_REPORT__EVT, (due - now) * 1000 );
+  }
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_ReportValue
+*
+* @brief   Get the value of an attribute for reportable change checks. Signed
+*          values are sign extended, values longer than 4 bytes are truncated.
+*
+* @param   pAttr - attribute record
+*
+* @return  attribute value
+*/
+static uint32 zclMultiSensor_ReportValue( CONST zclAttrRec_t *pAttr )
+{
+  uint8 len = zclGetDataTypeLength( pAttr->attr.dataType );
+  uint32 value;
+
+  if ( (len == 0) || (pAttr->attr.dataPtr == NULL) )
+  {
+    return 0;
+  }
+  if ( len > 4 )
+  {
+    len = 4;
+  }
+
+  value = osal_build_uint32( (uint8 *)pAttr->attr.dataPtr, len );
+
+  if ( (pAttr->attr.dataType >= ZCL_DATATYPE_INT8) && (pAttr->attr.dataType <= ZCL_DATATYPE_INT32) &&
+       (len < 4) && (value & ((uint32)1 << ((len * 8) - 1))) )
+  {
+    value |= (uint32)0xFFFFFFFF << (len * 8);
+  }
+
+  return value;
+}
+
+/*********************************************************************
+* @fn      zclMultiSensor_ReportableChange
+*
+* @brief   Check whether an attribute moved far enough from the last reported
+*          value to be reported. Analog attributes must change by at least the
+*          reportable change, any change of a discrete attribute is reportable.
+*
+* @param   idx - index of the config report record
+*          pAttr - attribute record
+*
+* @return  TRUE if the change is reportable
+*/
+static uint8 zclMultiSensor_ReportableChange( uint8 idx, CONST zclAttrRec_t *pAttr )
+{
+  multiSensorReportState_t *pState = &reportState[idx];
+  uint8 dataType = pAttr->attr.dataType;
+  uint32 value = zclMultiSensor_ReportValue( pAttr );
+  uint32 diff;
+
+  if ( value == pState->lastValue )
+  {
+    return FALSE;
+  }
+
+  if ( !zclAnalogDataType( dataType ) ||
+       (dataType == ZCL_DATATYPE_SEMI_PREC) || (dataType == ZCL_DATATYPE_SINGLE_PREC) ||
+       (dataType == ZCL_DATATYPE_DOUBLE_PREC) )
+  {
+    return TRUE;
+  }
+
+  if ( (dataType >= ZCL_DATATYPE_INT8) && (dataType <= ZCL_DATATYPE_INT32) )
+  {
+    diff = ( (int32)value > (int32)pState->lastValue ) ? (value - pState->lastValue)
+                                                       : (pState->lastValue - value);
+  }
+  else
+  {
+    diff = ( value > pState->lastValue ) ? (value - pState->lastValue)
+                                         : (pState->lastValue - value);
+  }
+
+  return ( diff >= pState->change );
 }
 
 /*********************************************************************
@@ -1004,6 +1308,21 @@ static uint8 zclMultiSensor_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
         pConfigReportRec->cfgReportRec.maxReportInt = pCfgReportCmd->attrList[i].maxReportInt;
         pConfigReportRec->cfgReportRec.timeoutPeriod = pCfgReportCmd->attrList[i].timeoutPeriod;
         pConfigReportRec->timeup = 0xFFFF;
+
+        // Keep a copy of the reportable change, the command buffer is freed after processing
+        if ( zclAnalogDataType( pCfgReportCmd->attrList[i].dataType ) &&
+             (pCfgReportCmd->attrList[i].reportableChange != NULL) )
+        {
+          uint8 idx = (uint8)(pConfigReportRec - zclMultiSensor_ConfigReportRecs);
+          uint8 changeLen = zclGetDataTypeLength( pCfgReportCmd->attrList[i].dataType );
+
+          if ( idx < MULTISENSOR_MAX_REPORT_RECS )
+          {
+            reportState[idx].change = osal_build_uint32( pCfgReportCmd->attrList[i].reportableChange,
+                                                         (changeLen > 4) ? 4 : changeLen );
+            pConfigReportRec->cfgReportRec.reportableChange = (uint8 *)&reportState[idx].change;
+          }
+        }
       }
     }
     else
@@ -1041,9 +1360,8 @@ static uint8 zclMultiSensor_ProcessInConfigReportCmd( zclIncomingMsg_t *pInMsg )
   //9. When configured, check report config immediately with function "xxx_CheckReportConfig()"
   // when configured, check report config immediately
   zclMultiSensor_CheckReportConfig();
-  // The MULTISENSOR_CHECK_REPORT_EVT will then be triggered again and again
-  // if we never received the ConfiReportCmd, the MULTISENSOR_CHECK_REPORT_EVT
-  // has no change to be triggered.
+  // MULTISENSOR_CHECK_REPORT_EVT is then armed for the next record due, and
+  // stays idle while no attribute is configured to report.
   
   // We think this makes sense, since there is no reason for your app to perform
   // constantly report unless the app is configured to report.
@@ -1139,7 +1457,9 @@ static uint8 zclMultiSensor_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg
 /*********************************************************************
 * @fn      zclMultiSensor_CheckReportConfig
 *
-* @brief   Check if there is a reportable attribute in all cluster is timeout to report
+* @brief   Schedule records configured since the last check, send a report for
+*          each cluster that has attributes due, then arm the report timer for
+*          the next record due.
 *
 * @param   none
 *
@@ -1147,68 +1467,119 @@ static uint8 zclMultiSensor_ProcessInReadReportCfgCmd( zclIncomingMsg_t *pInMsg
 */
 static void zclMultiSensor_CheckReportConfig(void)
 {
-  uint8 x, y;
-  uint8 stopChecking = TRUE;
-  
+  uint8 x;
+  uint8 numRecs;
+  uint32 now = zclMultiSensor_ReportTime();
+
   // Fill the "config. report rec list" for this endpoint
   zclConfigReportRecsList *pConfigReportRecsList = zclFindConfigReportRecsList( MULTISENSOR_ENDPOINT );
-  
+
   if ( pConfigReportRecsList != NULL )
   {
-    /* This piece of code will classify each luster in the list of endpoint, then send report
-     * command coressponding cluster 
-     */
-    for ( x = 0; x < pConfigReportRecsList->numConfigReportRec; x++)
+    numRecs = pConfigReportRecsList->numConfigReportRec;
+    if ( numRecs > MULTISENSOR_MAX_REPORT_RECS )
     {
-      uint8 cIDuplicate = 0;
-      
-      for (y = 0; y < x; y++)
-      {
-        if ( pConfigReportRecsList->configReportRecs[x].clusterId == 
-            pConfigReportRecsList->configReportRecs[y].clusterId)
-        {
-          cIDuplicate = 1;
-        }
-      }
-      
-      if (!cIDuplicate)
+      numRecs = MULTISENSOR_MAX_REPORT_RECS;
+    }
+
+    for ( x = 0; x < numRecs; x++ )
+    {
+      zclConfigReportRec_t *pConfigReportRec = &(pConfigReportRecsList->configReportRecs[x]);
+
+      if ( pConfigReportRec->cfgReportRec.maxReportInt == 0xFFFF )
       {
-        zclMultiSensor_CheckAndSendClusterAttrReport( MULTISENSOR_ENDPOINT, pConfigReportRecsList->configReportRecs[x].clusterId, pConfigReportRecsList);
+        zclMultiSensor_UnscheduleReport( x );
       }
-      
-      if (pConfigReportRecsList->configReportRecs[x].cfgReportRec.maxReportInt != 0xFFFF)
+      else if ( pConfigReportRec->timeup == 0xFFFF )
       {
-        stopChecking = FALSE;   // If there is any attribute setting to report, don't stop checking
+        // Just configured, report it now
+        pConfigReportRec->timeup = 0;
+        zclMultiSensor_ScheduleReport( x, now );
       }
     }
+
+    /* Send every record that is due. All attributes of a cluster that are due
+     * go out in one report.
+     */
+    while ( (reportHeapCnt != 0) && (reportState[reportHeap[0]].due <= now) )
+    {
+      zclMultiSensor_CheckAndSendClusterAttrReport( MULTISENSOR_ENDPOINT,
+                                                    pConfigReportRecsList->configReportRecs[reportHeap[0]].clusterId,
+                                                    pConfigReportRecsList, now );
+    }
   }
-  
-  gTimeCounter++;         // time ticks every second for checking attr report
-  if (!stopChecking)
-  {
-      osal_start_timerEx( zclMultiSensor_TaskID, MULTISENSOR_CHECK_REPORT__EVT, 1000); 
-  }
+
+  zclMultiSensor_ArmReportTimer();
 }
 
+/*********************************************************************
+* @fn      sendZclAttrChangeReport
+*
+* @brief   Report a changed attribute. If the attribute has a config report
+*          record, the report waits for the minimum reporting interval and is
+*          only sent for a reportable change. Otherwise it is sent now.
+*
+* @param   clusterId - cluster of the attribute
+*          attrID - attribute that changed
+*          currentValue - new value of the attribute
+*
+* @return  none
+*/
 static void sendZclAttrChangeReport(uint16 clusterId, uint16 attrID, uint8 *currentValue) 
 {
 
         zclReportCmd_t *pReportCmd;
         zclReport_t *reportRec;
-        zclAttrRec_t attrRec;
+        CONST zclAttrRec_t *pAttr;
+        zclConfigReportRec_t *pConfigReportRec;
         uint8 len;
     
+        pAttr = zclFindAttrRecPtr( MULTISENSOR_ENDPOINT, clusterId, attrID );
+        if ( pAttr == NULL )
+        {
+          return;
+        }
+
+        if ( zclFindConfigReportRec( MULTISENSOR_ENDPOINT, clusterId, attrID, &pConfigReportRec ) )
+        {
+          uint8 idx = (uint8)(pConfigReportRec - zclMultiSensor_ConfigReportRecs);
+          uint32 due;
+
+          if ( (idx >= MULTISENSOR_MAX_REPORT_RECS) ||
+               (pConfigReportRec->cfgReportRec.maxReportInt == 0xFFFF) ||
+               !zclMultiSensor_ReportableChange( idx, pAttr ) )
+          {
+            return;
+          }
+
+          due = reportState[idx].lastReport + pConfigReportRec->cfgReportRec.minReportInt;
+          if ( due < zclMultiSensor_ReportTime() )
+          {
+            due = gTimeCounter;
+          }
+
+          if ( (reportState[idx].heapPos == MULTISENSOR_REPORT_IDLE) || (due < reportState[idx].due) )
+          {
+            zclMultiSensor_ScheduleReport( idx, due );
+            zclMultiSensor_ArmReportTimer();
+          }
+          return;
+        }
+    
         len = sizeof( zclReportCmd_t ) + (1 * sizeof( zclReport_t ));
         pReportCmd = (zclReportCmd_t *)zcl_mem_alloc( len );
+        if ( pReportCmd == NULL )
+        {
+          return;
+        }
         pReportCmd->numAttr = 1;
     
         reportRec = &(pReportCmd->attrList[0]);
         zcl_memset( reportRec, 0, sizeof( zclReport_t ) );
-        zclFindAttrRec( MULTISENSOR_ENDPOINT, clusterId, attrID, &attrRec);
     
-        reportRec->attrID = attrRec.attr.attrId;
-        reportRec->dataType = attrRec.attr.dataType;
-        reportRec->attrData = attrRec.attr.dataPtr; 
+        reportRec->attrID = pAttr->attr.attrId;
+        reportRec->dataType = pAttr->attr.dataType;
+        reportRec->attrData = pAttr->attr.dataPtr; 
                 
         SendZclAttrReport(MULTISENSOR_ENDPOINT, clusterId, pReportCmd, len);
     
@@ -0,0 +1,97 @@
+/**************************************************************************************************
+  Filename:       OnBoard.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for OnBoard.h, for the parts the OSAL NV
+                  driver, the OTA client and MT use.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef ONBOARD_H
+#define ONBOARD_H
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_mcu.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Milliseconds per timer tick, as on the target
+#define TICK_COUNT  1
+
+// Watchdog interval, the host has no watchdog
+#define WDTIMX  0x00
+
+// MT UART buffers, as on the CC2538DB
+#define MT_UART_TX_BUFF_MAX  170
+#define MT_UART_RX_BUFF_MAX  120
+#define MT_UART_THRESHOLD    5
+#define MT_UART_IDLE_TIMEOUT 5
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Milliseconds the timer ran while asleep, for POWER_SAVING builds.
+ */
+extern uint32 TimerElapsed( void );
+
+/*
+ * The supply is always high enough to write flash on the host.
+ */
+#define OnBoard_CheckVoltage()  TRUE
+
+/*
+ * A reset is never expected in a test.
+ */
+#define SystemReset()  HAL_SYSTEM_RESET()
+
+/*
+ * The host has no watchdog to kick.
+ */
+#define WatchDogEnable( wdti )
+
+/*
+ * Random number for osal_rand().
+ */
+extern uint16 Onboard_rand( void );
+
+/*********************************************************************
+*********************************************************************/
+
+#endif // ONBOARD_H
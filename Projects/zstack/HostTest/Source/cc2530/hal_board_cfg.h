@@ -0,0 +1,71 @@
+/**************************************************************************************************
+  Filename:       hal_board_cfg.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host board configuration for building the CC2530 OSAL NV driver
+                  against the RAM flash in host_flash.c. Only the flash
+                  geometry of the CC2530EB board is kept.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HAL_BOARD_CFG_H
+#define HAL_BOARD_CFG_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#include "hal_defs.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                         OSAL NV implemented by internal flash pages.
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// Flash is constructed of 128 pages of 2 KB.
+#define HAL_FLASH_PAGE_CNT         128
+#define HAL_FLASH_PAGE_SIZE        2048
+#define HAL_FLASH_WORD_SIZE        4
+
+#define HAL_FLASH_LOCK_BITS        16
+#define HAL_NV_PAGE_END            126
+#define HAL_NV_PAGE_CNT            6
+
+#define HAL_NV_PAGE_BEG           (HAL_NV_PAGE_END-HAL_NV_PAGE_CNT+1)
+
+#endif
+/*******************************************************************************************************
+*/
@@ -0,0 +1,73 @@
+/**************************************************************************************************
+  Filename:       hal_mcu.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the MCU header: no interrupts, and a reset
+                  that ends the test.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef _HAL_MCU_H
+#define _HAL_MCU_H
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Includes
+ * ------------------------------------------------------------------------------------------------
+ */
+#include <stdlib.h>
+#include "hal_defs.h"
+#include "hal_types.h"
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Interrupt Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+#define HAL_ENABLE_INTERRUPTS()         st( ; )
+#define HAL_DISABLE_INTERRUPTS()        st( ; )
+#define HAL_INTERRUPTS_ARE_ENABLED()    (TRUE)
+
+typedef unsigned char halIntState_t;
+#define HAL_ENTER_CRITICAL_SECTION(x)   st( x = 1; (void)x; )
+#define HAL_EXIT_CRITICAL_SECTION(x)    st( (void)x; )
+#define HAL_CRITICAL_STATEMENT(x)       st( x; )
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Reset Macro
+ * ------------------------------------------------------------------------------------------------
+ */
+#define HAL_SYSTEM_RESET()  abort()
+
+/**************************************************************************************************
+ */
+#endif
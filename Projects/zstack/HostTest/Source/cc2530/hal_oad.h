@@ -0,0 +1,108 @@
+/**************************************************************************************************
+  Filename:       hal_oad.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the CC2530EB hal_oad.h. Same image layout,
+                  with the downloaded image kept in internal flash so that
+                  hal_oad.c reads it through the RAM flash in host_flash.c
+                  rather than the SPI port.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HAL_OAD_H
+#define HAL_OAD_H
+
+/*********************************************************************
+ * INCLUDES
+ */
+
+#include "hal_board_cfg.h"
+#include "hal_types.h"
+
+/*********************************************************************
+ * MACROS
+ */
+
+#if !defined HAL_OAD_BOOT_CODE
+#define HAL_OAD_BOOT_CODE  FALSE
+#endif
+
+#define PACK_1
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define HAL_OAD_RC_START           0x0800
+#define HAL_OAD_CRC_ADDR           0x0888
+#define HAL_OAD_CRC_OSET          (HAL_OAD_CRC_ADDR - HAL_OAD_RC_START)
+
+#define HAL_OAD_XNV_IS_INT         TRUE
+#define HAL_OAD_XNV_IS_SPI        !HAL_OAD_XNV_IS_INT
+
+#define HAL_OAD_BOOT_PG_CNT        2
+
+#define HAL_OAD_DL_MAX   (0x40000 - ((HAL_NV_PAGE_CNT+HAL_OAD_BOOT_PG_CNT)*HAL_FLASH_PAGE_SIZE))
+#define HAL_OAD_DL_SIZE  (HAL_OAD_DL_MAX / 2)
+#define HAL_OAD_DL_OSET  (HAL_OAD_DL_MAX / 2)
+
+#define PREAMBLE_OFFSET            0x8C
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef enum {
+  HAL_OAD_RC,  /* Run code / active image.          */
+  HAL_OAD_DL   /* Downloaded code to be activated later. */
+} image_t;
+
+typedef struct {
+  uint8 magic[2];
+  uint32 len;
+  uint16  vers;
+  uint16  manu;
+  uint16  prod;
+} preamble_t;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+uint8 HalOADChkDL(uint8 dlImagePreambleOffset);
+void HalOADInvRC(void);
+uint32 HalOADAvail(void);
+void HalOADRead(uint32 oset, uint8 *pBuf, uint16 len, image_t type);
+void HalOADWrite(uint32 oset, uint8 *pBuf, uint16 len, image_t type);
+#endif
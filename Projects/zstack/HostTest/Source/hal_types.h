@@ -0,0 +1,98 @@
+/**************************************************************************************************
+  Filename:       hal_types.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host build types. Takes the place of the target hal_types.h so that
+                  the stack types keep their on-target widths on a 64-bit host.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef _HAL_TYPES_H
+#define _HAL_TYPES_H
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------------------------------------------
+ *                                               Types
+ * ------------------------------------------------------------------------------------------------
+ */
+typedef int8_t             int8;
+typedef uint8_t            uint8;
+
+typedef int16_t            int16;
+typedef uint16_t           uint16;
+
+typedef int32_t            int32;
+typedef uint32_t           uint32;
+typedef uint64_t           uint64;
+typedef uint32             halDataAlign_t;
+#define bool               _Bool
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Compiler Macros
+ * ------------------------------------------------------------------------------------------------
+ */
+#define ASM_NOP            __asm__ __volatile__ ("nop")
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                        Standard Defines
+ * ------------------------------------------------------------------------------------------------
+ */
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef NULL
+#define NULL 0
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Memory Attributes
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define  XDATA
+#define  CODE
+
+
+/**************************************************************************************************
+ */
+#endif
@@ -0,0 +1,534 @@
+/**************************************************************************************************
+  Filename:       heap_replay.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Replays an OSAL heap allocation trace, as drained by
+                  MT_DEBUG_HEAP_TRACE, through the real OSAL_Memory.c built
+                  with the heap options of this target. Reports the peak
+                  usage, fragmentation, failed allocations, the busiest
+                  sites, the use of each size class with OSALMEM_SLABS, the
+                  time per alloc and free and the spread of alloc times.
+
+  Usage:          heap_replay <trace> [<source file>...]
+                  The source files name the sites whose file hash matches.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_test.h"
+
+// The heap is walked to measure the fragmentation
+#include "OSAL_Memory.c"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define REPLAY_REC_LEN  10     // Record size in a MT_DEBUG_HEAP_TRACE response
+#define REPLAY_IDS      0x10000
+#define REPLAY_SITES    512
+#define REPLAY_TOP      8      // Sites listed
+#define REPLAY_PASSES   20     // Timed passes
+#define REPLAY_LAT_BINS 2000   // Alloc time histogram, 10 ns bins, the last is everything above
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16 size;
+  uint16 file;
+  uint16 line;
+  uint16 id;
+} replayRec_t;
+
+typedef struct
+{
+  uint16 file;
+  uint16 line;
+  uint32 allocs;
+  uint32 bytes;
+} replaySite_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static replayRec_t *replayRecs;
+static long replayCnt;
+static uint8 replayKick;       // The trace has an osal_mem_kick() marker
+
+static void *replayBlk[REPLAY_IDS];
+static uint16 replaySize[REPLAY_IDS];
+
+static replaySite_t replaySites[REPLAY_SITES];
+static uint16 replaySiteCnt;
+
+static uint8 replayLatency;    // Time each alloc into replayLat
+static uint32 replayLat[REPLAY_LAT_BINS];
+static uint32 replayLatOverhead; // ns taken by the clock reads around an alloc
+
+static int replayArgc;
+static char **replayArgv;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double replayUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+static uint32 replayNsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (uint32)((ts.tv_sec * 1000000000LL) + ts.tv_nsec) );
+}
+
+/*
+ * osal_mem_alloc(), timed into the histogram when replayLatency is set.
+ */
+static void *replayAlloc( uint16 size )
+{
+  uint32 start, ns;
+  void *blk;
+
+  if ( !replayLatency )
+  {
+    return ( osal_mem_alloc( size ) );
+  }
+
+  start = replayNsec();
+  blk = osal_mem_alloc( size );
+  ns = replayNsec() - start;
+
+  ns = ( ns > replayLatOverhead ) ? (ns - replayLatOverhead) : 0;
+  replayLat[( ns / 10 < REPLAY_LAT_BINS ) ? (ns / 10) : (REPLAY_LAT_BINS - 1)]++;
+
+  return ( blk );
+}
+
+/*
+ * The alloc time below which a fraction of the allocs took, in ns.
+ */
+static uint32 replayLatPct( double frac )
+{
+  uint32 total = 0, sum = 0;
+  uint16 x;
+
+  for ( x = 0; x < REPLAY_LAT_BINS; x++ )
+  {
+    total += replayLat[x];
+  }
+
+  for ( x = 0; x < REPLAY_LAT_BINS; x++ )
+  {
+    sum += replayLat[x];
+    if ( sum >= (frac * total) )
+    {
+      break;
+    }
+  }
+
+  return ( (x + 1) * 10 );
+}
+
+/*
+ * The file hash OSALMEM_TRACE_FILE gives for a file name.
+ */
+static uint16 replayFileHash( const char *name )
+{
+  size_t len = strlen( name );
+  uint16 hash = 0;
+  int n;
+
+  for ( n = OSALMEM_TRACE_FILE_CHARS; n > 0; n-- )
+  {
+    char c = name[(len >= (size_t)n) ? (len - n) : 0];
+
+    hash = (uint16)((hash * 31u) + ((c == '\\') ? '/' : c));
+  }
+
+  return ( hash );
+}
+
+/*
+ * Read the MT_DEBUG_HEAP_TRACE responses of a trace file.
+ */
+static void replayLoad( const char *path )
+{
+  FILE *in = fopen( path, "rb" );
+  uint8 hdr[3], rec[REPLAY_REC_LEN];
+  long max = 0;
+
+  if ( in == NULL )
+  {
+    printf( "heap_replay: cannot open %s\n", path );
+    exit( 1 );
+  }
+
+  while ( fread( hdr, 1, sizeof( hdr ), in ) == sizeof( hdr ) )
+  {
+    uint8 cnt = hdr[2];
+
+    while ( cnt-- )
+    {
+      HOST_CHECK( fread( rec, 1, sizeof( rec ), in ) == sizeof( rec ) );
+
+      if ( replayCnt == max )
+      {
+        max = ( max != 0 ) ? (max * 2) : 4096;
+        replayRecs = realloc( replayRecs, max * sizeof( replayRec_t ) );
+        HOST_CHECK( replayRecs != NULL );
+      }
+
+      replayRecs[replayCnt].size = BUILD_UINT16( rec[2], rec[3] );
+      replayRecs[replayCnt].file = BUILD_UINT16( rec[4], rec[5] );
+      replayRecs[replayCnt].line = BUILD_UINT16( rec[6], rec[7] );
+      replayRecs[replayCnt].id = BUILD_UINT16( rec[8], rec[9] );
+
+      if ( replayRecs[replayCnt].size == OSALMEM_TRACE_KICK )
+      {
+        replayKick = TRUE;
+      }
+      replayCnt++;
+    }
+  }
+
+  fclose( in );
+}
+
+/*
+ * Count an alloc against its site.
+ */
+static void replaySiteAdd( const replayRec_t *rec )
+{
+  uint16 x;
+
+  for ( x = 0; x < replaySiteCnt; x++ )
+  {
+    if ( (replaySites[x].file == rec->file) && (replaySites[x].line == rec->line) )
+    {
+      break;
+    }
+  }
+
+  if ( x == replaySiteCnt )
+  {
+    if ( replaySiteCnt == REPLAY_SITES )
+    {
+      return;
+    }
+    replaySites[replaySiteCnt].file = rec->file;
+    replaySites[replaySiteCnt].line = rec->line;
+    replaySiteCnt++;
+  }
+
+  replaySites[x].allocs++;
+  replaySites[x].bytes += rec->size & OSALMEM_TRACE_SIZE;
+}
+
+static int replaySiteCmp( const void *a, const void *b )
+{
+  const replaySite_t *sa = a, *sb = b;
+
+  return ( sb->bytes > sa->bytes ) - ( sb->bytes < sa->bytes );
+}
+
+/*
+ * Free bytes and the largest free block of the first-fit heap.
+ */
+static void replayWalk( uint16 *freeBytes, uint16 *largest )
+{
+  osalMemHdr_t *hdr = theHeap;
+
+  *freeBytes = *largest = 0;
+
+  while ( hdr->val != 0 )
+  {
+    if ( !hdr->hdr.inUse )
+    {
+      *freeBytes += hdr->hdr.len - OSALMEM_HDRSZ;
+      if ( *largest < hdr->hdr.len - OSALMEM_HDRSZ )
+      {
+        *largest = hdr->hdr.len - OSALMEM_HDRSZ;
+      }
+    }
+    hdr = (osalMemHdr_t *)((uint8 *)hdr + hdr->hdr.len);
+  }
+}
+
+/*
+ * Replay the trace once. With 'measure', the usage and fragmentation are
+ * reported, otherwise only the allocs and frees are made.
+ */
+static void replayRun( uint8 measure )
+{
+  uint32 live = 0, livePeak = 0, allocs = 0, frees = 0;
+  uint32 targetFails = 0, replayFails = 0, unmatched = 0, implied = 0, dropped = 0, gaps = 0;
+  uint16 freeBytes, largest, fragFree = 0, fragLargest = 0, minLargest = 0xFFFF;
+  long x;
+
+  memset( replayBlk, 0, sizeof( replayBlk ) );
+  osal_mem_init();
+  if ( !replayKick )
+  {
+    osal_mem_kick();  // The trace started after the boot
+  }
+
+  for ( x = 0; x < replayCnt; x++ )
+  {
+    const replayRec_t *rec = &replayRecs[x];
+
+    if ( rec->size == OSALMEM_TRACE_GAP )
+    {
+      gaps++;
+      dropped += rec->id;
+    }
+    else if ( rec->size == OSALMEM_TRACE_KICK )
+    {
+      osal_mem_kick();
+    }
+    else if ( rec->size == OSALMEM_TRACE_FREE )
+    {
+      if ( replayBlk[rec->id] == NULL )
+      {
+        unmatched++;  // Its alloc was dropped, or failed in the replay
+        continue;
+      }
+      osal_mem_free( replayBlk[rec->id] );
+      replayBlk[rec->id] = NULL;
+      live -= replaySize[rec->id];
+      frees++;
+    }
+    else
+    {
+      uint16 size = rec->size & OSALMEM_TRACE_SIZE;
+      void *blk = replayAlloc( size );
+
+      allocs++;
+      if ( measure )
+      {
+        replaySiteAdd( rec );
+      }
+
+      if ( rec->size & OSALMEM_TRACE_FAIL )
+      {
+        // The caller got nothing on the target, so the block is not kept
+        targetFails++;
+        if ( blk != NULL )
+        {
+          osal_mem_free( blk );
+        }
+        continue;
+      }
+
+      if ( blk == NULL )
+      {
+        replayFails++;
+        continue;
+      }
+
+      if ( replayBlk[rec->id] != NULL )
+      {
+        // The target reused the block, so its free was dropped
+        osal_mem_free( replayBlk[rec->id] );
+        live -= replaySize[rec->id];
+        implied++;
+      }
+
+      replayBlk[rec->id] = blk;
+      replaySize[rec->id] = size;
+      live += size;
+
+      if ( measure )
+      {
+        replayWalk( &freeBytes, &largest );
+        if ( minLargest > largest )
+        {
+          minLargest = largest;
+        }
+        if ( livePeak < live )
+        {
+          livePeak = live;
+          fragFree = freeBytes;
+          fragLargest = largest;
+        }
+      }
+    }
+  }
+
+  if ( measure )
+  {
+    uint16 cnt = replaySiteCnt;
+
+    // A free without its alloc, or an alloc of a block still held, stands for a dropped record
+    HOST_CHECK( (unmatched + implied) <= (dropped + replayFails) );
+
+    printf( "%ld records: %lu allocs, %lu frees, %lu dropped in %lu gaps, "
+            "%lu frees unmatched, %lu implied\n",
+            replayCnt, (unsigned long)allocs, (unsigned long)frees, (unsigned long)dropped,
+            (unsigned long)gaps, (unsigned long)unmatched, (unsigned long)implied );
+    printf( "heap %u B: peak %lu B requested, %u B first-fit high-water, "
+            "%lu failed on the target, %lu failed in the replay\n",
+            MAXMEMHEAP, (unsigned long)livePeak, memMax, (unsigned long)targetFails,
+            (unsigned long)replayFails );
+    printf( "fragmentation at the peak %.0f%% (%u B free, largest block %u B), "
+            "largest block never below %u B\n",
+            (fragFree != 0) ? (100.0 * (fragFree - fragLargest) / fragFree) : 0.0,
+            fragFree, fragLargest, minLargest );
+
+#if OSALMEM_SLABS
+    for ( x = 0; x < OSALMEM_SLAB_CLASSES; x++ )
+    {
+      printf( "  class %3u B: %2u blocks, at most %2u in use, %6u allocs taken from the heap\n",
+              slabSz[x], slabCnt[x], osal_heap_slab_max( x ), osal_heap_slab_miss( x ) );
+    }
+#endif
+
+    qsort( replaySites, cnt, sizeof( replaySite_t ), replaySiteCmp );
+    for ( x = 0; (x < cnt) && (x < REPLAY_TOP); x++ )
+    {
+      const char *name = NULL;
+      int arg;
+
+      for ( arg = 2; (name == NULL) && (arg < replayArgc); arg++ )
+      {
+        if ( replayFileHash( replayArgv[arg] ) == replaySites[x].file )
+        {
+          name = replayArgv[arg];
+        }
+      }
+
+      if ( replaySites[x].file == 0 )
+      {
+        printf( "  %-40s", "stack libraries" );
+      }
+      else if ( name != NULL )
+      {
+        printf( "  %-34s:%-5u", name, replaySites[x].line );
+      }
+      else
+      {
+        printf( "  file 0x%04X%23s:%-5u", replaySites[x].file, "", replaySites[x].line );
+      }
+      printf( " %7lu allocs %9lu B\n",
+              (unsigned long)replaySites[x].allocs, (unsigned long)replaySites[x].bytes );
+    }
+  }
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( int argc, char *argv[] )
+{
+  double start;
+  uint32 ops = 0;
+  long x;
+  int pass;
+
+  if ( argc < 2 )
+  {
+    printf( "usage: heap_replay <trace> [<source file>...]\n" );
+    return ( 1 );
+  }
+  replayArgc = argc;
+  replayArgv = argv;
+
+  replayLoad( argv[1] );
+
+#if OSALMEM_SLABS
+  printf( "heap_replay, size classes:\n" );
+#else
+  printf( "heap_replay, first fit:\n" );
+#endif
+  replayRun( TRUE );
+
+  for ( x = 0; x < replayCnt; x++ )
+  {
+    ops += ( replayRecs[x].size < OSALMEM_TRACE_GAP );
+  }
+
+  start = replayUsec();
+  for ( pass = 0; pass < REPLAY_PASSES; pass++ )
+  {
+    replayRun( FALSE );
+  }
+  printf( "%.1f ns per alloc or free\n",
+          (replayUsec() - start) * 1e3 / ((double)ops * REPLAY_PASSES) );
+
+  // The clock reads alone, so that they are not counted in the alloc times
+  replayLatOverhead = 0xFFFFFFFF;
+  for ( x = 0; x < 1000; x++ )
+  {
+    uint32 ns = replayNsec();
+
+    ns = replayNsec() - ns;
+    if ( replayLatOverhead > ns )
+    {
+      replayLatOverhead = ns;
+    }
+  }
+
+  replayLatency = TRUE;
+  for ( pass = 0; pass < REPLAY_PASSES; pass++ )
+  {
+    replayRun( FALSE );
+  }
+  printf( "alloc time: median %lu ns, 99%% %lu ns, 99.9%% %lu ns, 99.99%% %lu ns\n",
+          (unsigned long)replayLatPct( 0.5 ), (unsigned long)replayLatPct( 0.99 ),
+          (unsigned long)replayLatPct( 0.999 ), (unsigned long)replayLatPct( 0.9999 ) );
+
+  free( replayRecs );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
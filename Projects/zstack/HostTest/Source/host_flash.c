@@ -0,0 +1,230 @@
+/**************************************************************************************************
+  Filename:       host_flash.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    RAM model of the internal flash behind the hal_flash.h API,
+                  or the CC2538 armcm3flashutil.h API. Writes can only clear
+                  bits, as on the part.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// The host hal_types.h must be found before the one next to hal_mcu.h
+#include "hal_types.h"
+#include "hal_flash.h"
+#include "host_flash.h"
+
+#if defined ( HAL_MCU_CC2538 )
+#include <signal.h>
+#include <sys/mman.h>
+
+#include "armcm3flashutil.h"
+#endif
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#if defined ( HAL_MCU_CC2538 )
+// The mapping covers the NV pages, rounded out to host pages
+#define HOST_FLASH_MAP_PAGE  0x1000UL
+#define HOST_FLASH_NV_BEG    ((unsigned long)hostFlash[HAL_NV_PAGE_BEG])
+#define HOST_FLASH_NV_END    ((unsigned long)hostFlash[HAL_NV_PAGE_END + 1])
+#define HOST_FLASH_MAP_BEG   (HOST_FLASH_NV_BEG & ~(HOST_FLASH_MAP_PAGE - 1))
+#define HOST_FLASH_MAP_LEN   \
+  (((HOST_FLASH_NV_END + HOST_FLASH_MAP_PAGE - 1) & ~(HOST_FLASH_MAP_PAGE - 1)) - HOST_FLASH_MAP_BEG)
+#endif
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+#if !defined ( HAL_MCU_CC2538 )
+uint8 hostFlash[HAL_FLASH_PAGE_CNT][HAL_FLASH_PAGE_SIZE];
+#endif
+
+uint32 hostFlashReads;
+uint32 hostFlashWords;
+uint32 hostFlashErases;
+uint32 hostFlashPageErases[HOST_FLASH_PAGE_CNT];
+
+jmp_buf hostFlashPowerFail;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Flash words up to and including the one the power is cut on, 0 if it is
+// not cut
+static uint32 hostFlashFailWords;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Account for one more flash word, cutting the power if it is due.
+ */
+static void hostFlashWord( void )
+{
+  if ( hostFlashFailWords && (--hostFlashFailWords == 0) )
+  {
+    longjmp( hostFlashPowerFail, 1 );
+  }
+  hostFlashWords++;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+#if defined ( HAL_MCU_CC2538 )
+void hostFlashReset( void )
+{
+  static uint8 mapped = FALSE;
+
+  if ( !mapped )
+  {
+    if ( mmap( (void *)HOST_FLASH_MAP_BEG, HOST_FLASH_MAP_LEN, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0 ) !=
+         (void *)HOST_FLASH_MAP_BEG )
+    {
+      printf( "cannot map the NV pages at 0x%lx\n", HOST_FLASH_NV_BEG );
+      exit( 1 );
+    }
+    mapped = TRUE;
+  }
+
+  hostFlashLock( FALSE );
+  memset( hostFlash[HAL_NV_PAGE_BEG], 0xFF, HAL_NV_PAGE_CNT * HAL_FLASH_PAGE_SIZE );
+  memset( hostFlashPageErases, 0, sizeof( hostFlashPageErases ) );
+  hostFlashReads = 0;
+  hostFlashWords = 0;
+  hostFlashErases = 0;
+  hostFlashFailWords = 0;
+}
+
+static void hostFlashFault( int sig )
+{
+  (void)sig;
+  printf( "NV pages accessed while locked\n" );
+  fflush( stdout );
+  _exit( 1 );
+}
+
+void hostFlashLock( uint8 lock )
+{
+  signal( SIGSEGV, hostFlashFault );
+  mprotect( (void *)HOST_FLASH_MAP_BEG, HOST_FLASH_MAP_LEN,
+            lock ? PROT_NONE : (PROT_READ | PROT_WRITE) );
+}
+
+void flashWrite( uint8 *addr, uint16 len, uint8 *buf )
+{
+  uint16 x;
+
+  // addr need not be aligned, each flash word it touches is programmed once
+  for ( x = 0; x < len; x++ )
+  {
+    if ( (x == 0) || ((((unsigned long)addr + x) % HAL_FLASH_WORD_SIZE) == 0) )
+    {
+      hostFlashWord();
+    }
+    addr[x] &= buf[x];
+  }
+}
+
+void flashErasePage( uint8 *addr )
+{
+  hostFlashErases++;
+  hostFlashPageErases[((unsigned long)addr - FLASH_BASE) / HAL_FLASH_PAGE_SIZE]++;
+  memset( addr, 0xFF, HAL_FLASH_PAGE_SIZE );
+}
+#else
+void hostFlashReset( void )
+{
+  memset( hostFlash, 0xFF, sizeof( hostFlash ) );
+  memset( hostFlashPageErases, 0, sizeof( hostFlashPageErases ) );
+  hostFlashReads = 0;
+  hostFlashWords = 0;
+  hostFlashErases = 0;
+  hostFlashFailWords = 0;
+}
+
+void HalFlashRead( uint8 pg, uint16 offset, uint8 *buf, uint16 cnt )
+{
+  hostFlashReads++;
+  memcpy( buf, &hostFlash[pg][offset], cnt );
+}
+
+void HalFlashWrite( uint16 addr, uint8 *buf, uint16 cnt )
+{
+  // addr counts flash words from the start of flash
+  uint32 byteAddr = (uint32)addr * HAL_FLASH_WORD_SIZE;
+  uint8 *dst = &hostFlash[byteAddr / HAL_FLASH_PAGE_SIZE][byteAddr % HAL_FLASH_PAGE_SIZE];
+  uint32 x;
+
+  for ( x = 0; x < ((uint32)cnt * HAL_FLASH_WORD_SIZE); x++ )
+  {
+    if ( (x % HAL_FLASH_WORD_SIZE) == 0 )
+    {
+      hostFlashWord();
+    }
+    dst[x] &= buf[x];
+  }
+}
+
+void HalFlashErase( uint8 pg )
+{
+  hostFlashErases++;
+  hostFlashPageErases[pg]++;
+  memset( hostFlash[pg], 0xFF, HAL_FLASH_PAGE_SIZE );
+}
+#endif
+
+void hostFlashFailAfter( uint32 words )
+{
+  // Counts the word that is cut too
+  hostFlashFailWords = words ? (words + 1) : 0;
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,124 @@
+/**************************************************************************************************
+  Filename:       host_flash.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    RAM model of the internal flash behind the hal_flash.h API.
+                  Writes can only clear bits, as on the part.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_FLASH_H
+#define HOST_FLASH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <setjmp.h>
+
+#include "hal_board.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Pages with an erase count
+#if defined ( HAL_MCU_CC2538 )
+  #define HOST_FLASH_PAGE_CNT  (HAL_NV_PAGE_END + 1)
+#else
+  #define HOST_FLASH_PAGE_CNT  HAL_FLASH_PAGE_CNT
+#endif
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+#if defined ( HAL_MCU_CC2538 )
+// The CC2538 NV driver reads flash through its address, so the NV pages are
+// mapped at their place in the memory map. Only the NV pages can be used.
+#define hostFlash  ((uint8 (*)[HAL_FLASH_PAGE_SIZE])FLASH_BASE)
+#else
+// Flash contents, all pages
+extern uint8 hostFlash[HAL_FLASH_PAGE_CNT][HAL_FLASH_PAGE_SIZE];
+#endif
+
+// HalFlashRead() calls, flash words written and pages erased. The CC2538
+// driver reads flash directly, which is not counted. The counters are
+// cleared by hostFlashReset() only.
+extern uint32 hostFlashReads;
+extern uint32 hostFlashWords;
+extern uint32 hostFlashErases;
+
+// Erases of each page
+extern uint32 hostFlashPageErases[HOST_FLASH_PAGE_CNT];
+
+// Where the test resumes when the power is cut, see hostFlashFailAfter()
+extern jmp_buf hostFlashPowerFail;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Erase every page and clear the counters.
+ */
+extern void hostFlashReset( void );
+
+/*
+ * Cut the power after 'words' more flash words are written, or never if
+ * 'words' is 0. The write in progress stops there, with the words before
+ * it programmed, and the test resumes at hostFlashPowerFail.
+ */
+extern void hostFlashFailAfter( uint32 words );
+
+#if defined ( HAL_MCU_CC2538 )
+/*
+ * Make the NV pages unreadable, or readable again. Any access while they
+ * are locked stops the test.
+ */
+extern void hostFlashLock( uint8 lock );
+#endif
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_FLASH_H */
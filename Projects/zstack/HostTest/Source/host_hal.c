@@ -0,0 +1,196 @@
+/**************************************************************************************************
+  Filename:       host_hal.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the HAL task and the board services the
+                  stack and applications call: keys, LEDs and the OnBoard
+                  functions. Hal_ProcessPoll() polls the UART pipes of
+                  host_uart.c; the clock comes from host_timer.c.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OnBoard.h"
+#include "hal_drivers.h"
+#include "hal_key.h"
+#include "hal_led.h"
+#include "hal_uart.h"
+#include "hal_assert.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define NO_TASK_ID 0xFF
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 Hal_TaskID;
+
+// IEEE address of the device
+uint8 aExtendedAddress[8] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x12, 0x00 };
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 registeredKeysTaskID = NO_TASK_ID;
+
+/*********************************************************************
+ * HAL TASK
+ */
+
+void Hal_Init( uint8 task_id )
+{
+  Hal_TaskID = task_id;
+}
+
+uint16 Hal_ProcessEvent( uint8 task_id, uint16 events )
+{
+  uint8 *msgPtr;
+
+  if ( events & SYS_EVENT_MSG )
+  {
+    while ( (msgPtr = osal_msg_receive( task_id )) )
+    {
+      osal_msg_deallocate( msgPtr );
+    }
+  }
+
+  // The host has no LEDs to blink and no keys to debounce
+  return ( 0 );
+}
+
+void Hal_ProcessPoll( void )
+{
+  HalUARTPoll();
+}
+
+/*********************************************************************
+ * KEYS AND LEDS
+ */
+
+uint8 HalKeyRead( void )
+{
+  return ( 0 );
+}
+
+uint8 HalLedSet( uint8 led, uint8 mode )
+{
+  (void)led;
+  (void)mode;
+  return ( 0 );
+}
+
+void HalLedBlink( uint8 leds, uint8 cnt, uint8 duty, uint16 time )
+{
+  (void)leds;
+  (void)cnt;
+  (void)duty;
+  (void)time;
+}
+
+/*********************************************************************
+ * ONBOARD
+ */
+
+uint8 RegisterForKeys( uint8 task_id )
+{
+  // Allow only the first task
+  if ( registeredKeysTaskID == NO_TASK_ID )
+  {
+    registeredKeysTaskID = task_id;
+    return ( true );
+  }
+  else
+  {
+    return ( false );
+  }
+}
+
+uint8 OnBoard_SendKeys( uint8 keys, uint8 state )
+{
+  keyChange_t *msgPtr;
+
+  if ( registeredKeysTaskID != NO_TASK_ID )
+  {
+    // Send the address to the task
+    msgPtr = (keyChange_t *)osal_msg_allocate( sizeof(keyChange_t) );
+    if ( msgPtr )
+    {
+      msgPtr->hdr.event = KEY_CHANGE;
+      msgPtr->state = state;
+      msgPtr->keys = keys;
+
+      osal_msg_send( registeredKeysTaskID, (uint8 *)msgPtr );
+    }
+    return ( ZSuccess );
+  }
+  else
+  {
+    return ( ZFailure );
+  }
+}
+
+bool OnBoard_CheckVoltage( void )
+{
+  return ( TRUE );
+}
+
+void RegisterVoltageWarningCB( void (*pVoltWarnCB)(uint8) )
+{
+  // The supply never drops on the host
+  (void)pVoltWarnCB;
+}
+
+uint16 Onboard_rand( void )
+{
+  return ( (uint16)rand() );
+}
+
+void halAssertHandler( void )
+{
+  printf( "HAL_ASSERT failed\n" );
+  abort();
+}
@@ -0,0 +1,207 @@
+/**************************************************************************************************
+  Filename:       host_nv.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    RAM stand-in for the OSAL NV item API. Items live in a fixed
+                  table and every osal_nv_write() call is counted.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL_Nv.h"
+#include "host_nv.h"
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16 id;
+  uint16 len;
+  uint8 used;
+  uint8 data[HOST_NV_ITEM_SIZE];
+} hostNvItem_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint32 hostNvWrites;
+uint32 hostNvWriteBytes;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static hostNvItem_t hostNvItems[HOST_NV_ITEMS];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static hostNvItem_t *hostNvFind( uint16 id )
+{
+  uint8 x;
+
+  for ( x = 0; x < HOST_NV_ITEMS; x++ )
+  {
+    if ( hostNvItems[x].used && (hostNvItems[x].id == id) )
+    {
+      return &hostNvItems[x];
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+ * PUBLIC FUNCTIONS
+ */
+
+void hostNvReset( void )
+{
+  memset( hostNvItems, 0, sizeof( hostNvItems ) );
+  hostNvWrites = 0;
+  hostNvWriteBytes = 0;
+}
+
+uint8 *hostNvItem( uint16 id )
+{
+  hostNvItem_t *item = hostNvFind( id );
+
+  return ( item != NULL ) ? item->data : NULL;
+}
+
+uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
+{
+  uint8 x;
+
+  if ( hostNvFind( id ) != NULL )
+  {
+    return SUCCESS;
+  }
+
+  if ( len > HOST_NV_ITEM_SIZE )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  for ( x = 0; x < HOST_NV_ITEMS; x++ )
+  {
+    if ( !hostNvItems[x].used )
+    {
+      hostNvItems[x].used = TRUE;
+      hostNvItems[x].id = id;
+      hostNvItems[x].len = len;
+      if ( buf != NULL )
+      {
+        memcpy( hostNvItems[x].data, buf, len );
+      }
+      else
+      {
+        memset( hostNvItems[x].data, 0xFF, len );
+      }
+      return NV_ITEM_UNINIT;
+    }
+  }
+
+  return NV_OPER_FAILED;
+}
+
+uint8 osal_nv_read( uint16 id, uint16 offset, uint16 len, void *buf )
+{
+  hostNvItem_t *item = hostNvFind( id );
+
+  if ( (item == NULL) || ((offset + len) > item->len) )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  memcpy( buf, item->data + offset, len );
+  return SUCCESS;
+}
+
+uint8 osal_nv_write( uint16 id, uint16 offset, uint16 len, void *buf )
+{
+  hostNvItem_t *item = hostNvFind( id );
+
+  if ( item == NULL )
+  {
+    return NV_ITEM_UNINIT;
+  }
+
+  if ( (offset + len) > item->len )
+  {
+    return NV_OPER_FAILED;
+  }
+
+  hostNvWrites++;
+  hostNvWriteBytes += len;
+  memcpy( item->data + offset, buf, len );
+  return SUCCESS;
+}
+
+uint16 osal_nv_item_len( uint16 id )
+{
+  hostNvItem_t *item = hostNvFind( id );
+
+  return ( item != NULL ) ? item->len : 0;
+}
+
+uint8 osal_nv_delete( uint16 id, uint16 len )
+{
+  hostNvItem_t *item = hostNvFind( id );
+
+  if ( item == NULL )
+  {
+    return NV_ITEM_UNINIT;
+  }
+
+  if ( item->len != len )
+  {
+    return NV_BAD_ITEM_LEN;
+  }
+
+  item->used = FALSE;
+  return SUCCESS;
+}
+
+/*********************************************************************
+*********************************************************************/
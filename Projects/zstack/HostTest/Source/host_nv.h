@@ -0,0 +1,93 @@
+/**************************************************************************************************
+  Filename:       host_nv.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    RAM stand-in for the OSAL NV item API, for host tests of
+                  stack modules that save their state to NV.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_NV_H
+#define HOST_NV_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_types.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Number of items and the size of each item the RAM store can hold
+#if !defined ( HOST_NV_ITEMS )
+  #define HOST_NV_ITEMS    8
+#endif
+#define HOST_NV_ITEM_SIZE  1024
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// osal_nv_write() calls that changed an item, and the bytes they wrote
+extern uint32 hostNvWrites;
+extern uint32 hostNvWriteBytes;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Erase every item and clear the write counters.
+ */
+extern void hostNvReset( void );
+
+/*
+ * Return the stored bytes of an item, or NULL if it was never created.
+ */
+extern uint8 *hostNvItem( uint16 id );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_NV_H */
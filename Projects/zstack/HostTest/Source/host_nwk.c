@@ -0,0 +1,777 @@
+/**************************************************************************************************
+  Filename:       host_nwk.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the NWK, APS and MAC layers below AF. Data
+                  requests are handed to the test; management requests are
+                  accepted and never confirmed, like a network that is not
+                  there, so ZDO and BDB wait for it without sending.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "AF.h"
+#include "nwk.h"
+#include "nwk_util.h"
+#include "APS.h"
+#include "APSMEDE.h"
+#include "AssocList.h"
+#include "AddrMgr.h"
+#include "rtg.h"
+#include "aps_groups.h"
+#include "aps_frag.h"
+#include "BindingTable.h"
+#include "ssp.h"
+#include "ZMAC.h"
+#include "host_nwk.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// ASDU room in a NWK secured frame, before the AF header
+#define HOST_NWK_APS_MTU  80
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint32 hostNwkTxFrames;
+uint32 hostNwkTxBytes;
+void (*hostNwkTxCB)( APSDE_DataReq_t *req );
+
+// NWK
+nwkIB_t _NIB;
+byte NWK_TaskID;
+uint8 saveExtAddr[Z_EXTADDR_LEN];
+uint32 nwkFrameCounter;
+uint16 nwkFrameCounterChanges;
+void (*pNwkNotMyChildListDelete)( uint16 devAddr );
+
+// APS
+uint8 APS_Counter;
+uint8 AIB_apsUseExtendedPANID[Z_EXTADDR_LEN];
+uint8 AIB_apsUseInsecureJoin;
+uint8 *AIB_apsTrustCenterAddress;
+APSF_SendFragmented_t *apsfSendFragmented;
+apsGroupItem_t *apsGroupTable;
+
+/*********************************************************************
+ * DATA
+ */
+
+uint8 APSDE_DataReqMTU( APSDE_DataReqMTU_t* fields )
+{
+  (void)fields;
+  return ( HOST_NWK_APS_MTU );
+}
+
+ZStatus_t APSDE_DataReq( APSDE_DataReq_t* req )
+{
+  hostNwkTxFrames++;
+  hostNwkTxBytes += req->asduLen;
+
+  if ( hostNwkTxCB != NULL )
+  {
+    hostNwkTxCB( req );
+  }
+
+  return ( ZSuccess );
+}
+
+void hostNwkRx( uint16 srcAddr, uint8 srcEP, uint8 dstEP, uint16 clusterID,
+                uint16 profileID, uint8 *asdu, uint8 len )
+{
+  aps_FrameFormat_t aff;
+  zAddrType_t src;
+  NLDE_Signal_t sig;
+
+  memset( &aff, 0, sizeof( aff ) );
+  aff.FrmCtrl = APS_FC_DM_UNICAST;
+  aff.SrcEndPoint = srcEP;
+  aff.DstEndPoint = dstEP;
+  aff.ClusterID = clusterID;
+  aff.ProfileID = profileID;
+  aff.asduLength = len;
+  aff.asdu = asdu;
+  aff.macDestAddr = HOST_NWK_ADDR;
+  aff.macSrcAddr = srcAddr;
+
+  src.addrMode = Addr16Bit;
+  src.addr.shortAddr = srcAddr;
+
+  sig.LinkQuality = 255;
+  sig.correlation = 0;
+  sig.rssi = -40;
+
+  afIncomingData( &aff, &src, _NIB.nwkPanId, &sig, 0, TRUE, 0, 1 );
+}
+
+/*********************************************************************
+ * NWK
+ */
+
+void nwk_init( byte task_id )
+{
+  NWK_TaskID = task_id;
+  _NIB.nwkDevAddress = HOST_NWK_ADDR;
+  _NIB.nwkPanId = 0x1A62;
+}
+
+UINT16 nwk_event_loop( byte task_id, UINT16 events )
+{
+  (void)task_id;
+  (void)events;
+  return ( 0 );
+}
+
+uint16 NLME_GetShortAddr( void )
+{
+  return ( _NIB.nwkDevAddress );
+}
+
+byte *NLME_GetExtAddr( void )
+{
+  return ( saveExtAddr );
+}
+
+uint16 NLME_GetCoordShortAddr( void )
+{
+  return ( _NIB.nwkCoordAddress );
+}
+
+void NLME_GetCoordExtAddr( byte *buf )
+{
+  osal_cpyExtAddr( buf, _NIB.nwkCoordExtAddress );
+}
+
+addr_filter_t NLME_IsAddressBroadcast( uint16 shortAddress )
+{
+  if ( shortAddress == NWK_BROADCAST_SHORTADDR_DEVALL )
+    return ( ADDR_BCAST_NOT_ME );
+
+  if ( shortAddress >= NWK_BROADCAST_SHORTADDR_DEVZCZR )
+    return ( ADDR_BCAST_FOR_ME );
+
+  return ( ADDR_NOT_BCAST );
+}
+
+ZStatus_t NLME_GetRequest( ZNwkAttributes_t NIBAttribute, uint16 Index, void *Value )
+{
+  (void)NIBAttribute;
+  (void)Index;
+  (void)Value;
+  return ( ZNwkUnsupportedAttribute );
+}
+
+ZStatus_t NLME_NetworkDiscoveryRequest( uint32 ScanChannels, uint8 scanDuration )
+{
+  (void)ScanChannels;
+  (void)scanDuration;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_NetworkFormationRequest( uint16 PanId, uint8* ExtendedPANID, uint32 ScanChannels,
+                                        byte ScanDuration, byte BeaconOrder,
+                                        byte SuperframeOrder, byte BatteryLifeExtension, bool DistributedNetwork,
+                                        uint16 DistributedNetworkAddress )
+{
+  (void)PanId;
+  (void)ExtendedPANID;
+  (void)ScanChannels;
+  (void)ScanDuration;
+  (void)BeaconOrder;
+  (void)SuperframeOrder;
+  (void)BatteryLifeExtension;
+  (void)DistributedNetwork;
+  (void)DistributedNetworkAddress;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_JoinRequest( uint8 *extendedPANID, uint16 PanId,
+                            uint8 channel, uint8 CapabilityFlags,
+                            uint16 chosenParent, uint8 parentDepth )
+{
+  (void)extendedPANID;
+  (void)PanId;
+  (void)channel;
+  (void)CapabilityFlags;
+  (void)chosenParent;
+  (void)parentDepth;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_ReJoinRequest( uint8 *ExtendedPANID, uint8 channel )
+{
+  (void)ExtendedPANID;
+  (void)channel;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_ReJoinRequestUnsecure( uint8 *ExtendedPANID, uint8 channel )
+{
+  (void)ExtendedPANID;
+  (void)channel;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_OrphanJoinRequest( uint32 ScanChannels, byte ScanDuration )
+{
+  (void)ScanChannels;
+  (void)ScanDuration;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_StartRouterRequest( byte BeaconOrder, byte SuperframeOrder,
+                                   byte BatteryLifeExtension )
+{
+  (void)BeaconOrder;
+  (void)SuperframeOrder;
+  (void)BatteryLifeExtension;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_PermitJoiningRequest( byte PermitDuration )
+{
+  (void)PermitDuration;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_LeaveReq( NLME_LeaveReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_EDScanRequest( uint32 ScanChannels, uint8 scanDuration )
+{
+  (void)ScanChannels;
+  (void)scanDuration;
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_ResetRequest( void )
+{
+  return ( ZSuccess );
+}
+
+ZStatus_t NLME_CheckNewAddrSet( uint16 shortAddr, uint8 *extAddr )
+{
+  (void)shortAddr;
+  (void)extAddr;
+  return ( ZSuccess );
+}
+
+void NLME_JoinConfirm( uint16 PanId, ZStatus_t Status )
+{
+  (void)PanId;
+  (void)Status;
+}
+
+void NLME_NwkDiscTerm( void )
+{
+}
+
+void NLME_DeviceJoiningInit( void )
+{
+}
+
+void NLME_SetPollRate( uint32 newRate )
+{
+  (void)newRate;
+}
+
+void NLME_SetQueuedPollRate( uint16 newRate )
+{
+  (void)newRate;
+}
+
+void NLME_SetResponseRate( uint16 newRate )
+{
+  (void)newRate;
+}
+
+void NLME_SetBroadcastFilter( byte capabilities )
+{
+  (void)capabilities;
+}
+
+void NLME_SetUpdateID( uint8 updateID )
+{
+  _NIB.nwkUpdateId = updateID;
+}
+
+uint8 NLME_GetEnergyThreshold( void )
+{
+  return ( 0 );
+}
+
+void NLME_SetEnergyThreshold( uint8 value )
+{
+  (void)value;
+}
+
+byte NLME_InitNV( void )
+{
+  return ( TRUE );
+}
+
+void NLME_SetDefaultNV( void )
+{
+}
+
+byte NLME_RestoreFromNV( void )
+{
+  return ( FALSE );
+}
+
+void NLME_UpdateNV( byte enables )
+{
+  (void)enables;
+}
+
+ZStatus_t NLME_ReadNwkKeyInfo( uint16 index, uint16 len, void *keyinfo, uint16 NvId )
+{
+  (void)index;
+  (void)len;
+  (void)keyinfo;
+  (void)NvId;
+  return ( ZFailure );
+}
+
+networkDesc_t *nwk_getNwkDescList( void )
+{
+  return ( NULL );
+}
+
+void nwk_desc_list_release( void )
+{
+}
+
+uint8 nwk_ExtPANIDValid( byte *panID )
+{
+  return ( !osal_isbufset( panID, 0x00, Z_EXTADDR_LEN ) );
+}
+
+void nwk_setStateIdle( uint8 idle )
+{
+  (void)idle;
+}
+
+uint16 nwkTransmissionFailures( uint8 reset )
+{
+  (void)reset;
+  return ( 0 );
+}
+
+uint8 nwkCreateDuplicateNV( uint16 srcId, uint16 dstId )
+{
+  (void)srcId;
+  (void)dstId;
+  return ( FALSE );
+}
+
+void nwkNeighborInitTable( void )
+{
+}
+
+void nwkNeighborRemove( uint16 NeighborAddress, uint16 PanId )
+{
+  (void)NeighborAddress;
+  (void)PanId;
+}
+
+void nwkNeighborRemoveAllStranded( void )
+{
+}
+
+RTG_Status_t RTG_CheckRtStatus( uint16 DstAddress, byte RtStatus, uint8 options )
+{
+  (void)DstAddress;
+  (void)RtStatus;
+  (void)options;
+  return ( RTG_SUCCESS );
+}
+
+RTG_Status_t RTG_RemoveRtgEntry( uint16 DstAddress, uint8 options )
+{
+  (void)DstAddress;
+  (void)options;
+  return ( RTG_SUCCESS );
+}
+
+/*********************************************************************
+ * ASSOCIATED DEVICES AND ADDRESS MANAGER - the device has no children
+ * and knows no other device
+ */
+
+associated_devices_t *AssocGetWithExt( byte *extAddr )
+{
+  (void)extAddr;
+  return ( NULL );
+}
+
+associated_devices_t *AssocGetWithShort( uint16 shortAddr )
+{
+  (void)shortAddr;
+  return ( NULL );
+}
+
+associated_devices_t *AssocFindDevice( uint16 number )
+{
+  (void)number;
+  return ( NULL );
+}
+
+byte AssocIsChild( uint16 shortAddr )
+{
+  (void)shortAddr;
+  return ( FALSE );
+}
+
+byte AssocRemove( byte *extAddr )
+{
+  (void)extAddr;
+  return ( FALSE );
+}
+
+uint16 AssocCount( byte startRelation, byte endRelation )
+{
+  (void)startRelation;
+  (void)endRelation;
+  return ( 0 );
+}
+
+uint16 *AssocMakeList( byte *pCount )
+{
+  *pCount = 0;
+  return ( NULL );
+}
+
+uint8 *AssocMakeListOfRfdChild( uint8 *pCount )
+{
+  *pCount = 0;
+  return ( NULL );
+}
+
+uint8 AddrMgrEntryLookupExt( AddrMgrEntry_t* entry )
+{
+  (void)entry;
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryLookupNwk( AddrMgrEntry_t* entry )
+{
+  (void)entry;
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryGet( AddrMgrEntry_t* entry )
+{
+  (void)entry;
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryUpdate( AddrMgrEntry_t* entry )
+{
+  (void)entry;
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryRelease( AddrMgrEntry_t* entry )
+{
+  (void)entry;
+  return ( FALSE );
+}
+
+uint8 AddrMgrExtAddrLookup( uint16 nwkAddr, uint8* extAddr )
+{
+  (void)nwkAddr;
+  (void)extAddr;
+  return ( FALSE );
+}
+
+uint8 AddrMgrExtAddrValid( uint8* extAddr )
+{
+  return ( !osal_isbufset( extAddr, 0x00, Z_EXTADDR_LEN ) );
+}
+
+void AddrMgrExtAddrSet( uint8* dstExtAddr, uint8* srcExtAddr )
+{
+  if ( srcExtAddr != NULL )
+  {
+    osal_cpyExtAddr( dstExtAddr, srcExtAddr );
+  }
+  else
+  {
+    osal_memset( dstExtAddr, 0x00, Z_EXTADDR_LEN );
+  }
+}
+
+/*********************************************************************
+ * APS
+ */
+
+void APS_Init( byte task_id )
+{
+  (void)task_id;
+
+  // The binding table belongs to APS
+  InitBindingTable();
+}
+
+UINT16 APS_event_loop( byte task_id, UINT16 events )
+{
+  (void)task_id;
+  (void)events;
+  return ( 0 );
+}
+
+void APS_ReflectorInit( void )
+{
+}
+
+void APSF_Init( uint8 task_id )
+{
+  (void)task_id;
+}
+
+UINT16 APSF_ProcessEvent( uint8 task_id, UINT16 events )
+{
+  (void)task_id;
+  (void)events;
+  return ( 0 );
+}
+
+void APSME_HoldDataRequests( uint16 holdTime )
+{
+  (void)holdTime;
+}
+
+ZStatus_t APSME_GetRequest( ZApsAttributes_t AIBAttribute, uint16 Index, byte *AttributeValue )
+{
+  (void)AIBAttribute;
+  (void)Index;
+  (void)AttributeValue;
+  return ( ZApsUnsupportedAttrib );
+}
+
+ZStatus_t APSME_SetRequest( ZApsAttributes_t AIBAttribute, uint16 Index, byte *AttributeValue )
+{
+  (void)AIBAttribute;
+  (void)Index;
+  (void)AttributeValue;
+  return ( ZApsUnsupportedAttrib );
+}
+
+ZStatus_t APSME_BindRequest( byte SrcEndpInt, uint16 ClusterId,
+                             zAddrType_t *DstAddr, byte DstEndpInt )
+{
+  (void)SrcEndpInt;
+  (void)ClusterId;
+  (void)DstAddr;
+  (void)DstEndpInt;
+  return ( ZApsTableFull );
+}
+
+ZStatus_t APSME_UnBindRequest( byte SrcEndpInt, uint16 ClusterId,
+                               zAddrType_t *DstAddr, byte DstEndpInt )
+{
+  (void)SrcEndpInt;
+  (void)ClusterId;
+  (void)DstAddr;
+  (void)DstEndpInt;
+  return ( ZApsInvalidBinding );
+}
+
+uint8 APSME_LookupNwkAddr( uint8* extAddr, uint16* nwkAddr )
+{
+  (void)extAddr;
+  (void)nwkAddr;
+  return ( FALSE );
+}
+
+uint8 APSME_IsDistributedSecurity( void )
+{
+  return ( FALSE );
+}
+
+ZStatus_t APSME_TransportKeyReq( APSME_TransportKeyReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+ZStatus_t APSME_UpdateDeviceReq( APSME_UpdateDeviceReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+ZStatus_t APSME_RemoveDeviceReq( APSME_RemoveDeviceReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+ZStatus_t APSME_RequestKeyReq( APSME_RequestKeyReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+ZStatus_t APSME_VerifyKeyReq( APSME_VerifyKeyReq_t* req )
+{
+  (void)req;
+  return ( ZSuccess );
+}
+
+uint16 APSME_SearchTCLinkKeyEntry( uint8 *pExt, uint8* found, APSME_TCLKDevEntry_t* tcLinkKeyAddrEntry )
+{
+  (void)pExt;
+  (void)tcLinkKeyAddrEntry;
+  *found = FALSE;
+  return ( 0 );
+}
+
+void APSME_EraseICEntry( uint8 *IcIndex )
+{
+  (void)IcIndex;
+}
+
+void APSME_SecurityCM_RD( void )
+{
+}
+
+/*
+ * Groups - the device is in none
+ */
+aps_Group_t *aps_FindGroup( uint8 endpoint, uint16 groupID )
+{
+  (void)endpoint;
+  (void)groupID;
+  return ( NULL );
+}
+
+uint8 aps_FindAllGroupsForEndpoint( uint8 endpoint, uint16 *groupList )
+{
+  (void)endpoint;
+  (void)groupList;
+  return ( 0 );
+}
+
+uint8 aps_CountAllGroups( void )
+{
+  return ( 0 );
+}
+
+ZStatus_t aps_AddGroup( uint8 endpoint, aps_Group_t *group )
+{
+  (void)endpoint;
+  (void)group;
+  return ( ZApsTableFull );
+}
+
+uint8 aps_RemoveGroup( uint8 endpoint, uint16 groupID )
+{
+  (void)endpoint;
+  (void)groupID;
+  return ( FALSE );
+}
+
+void aps_RemoveAllGroup( uint8 endpoint )
+{
+  (void)endpoint;
+}
+
+/*********************************************************************
+ * SECURITY
+ */
+
+void SSP_Init( void )
+{
+}
+
+void SSP_ReadNwkActiveKey( nwkActiveKeyItems *items )
+{
+  osal_memset( items, 0, sizeof( nwkActiveKeyItems ) );
+}
+
+void SSP_UpdateNwkKey( uint8 *key, uint8 keySeqNum )
+{
+  (void)key;
+  (void)keySeqNum;
+}
+
+void SSP_SwitchNwkKey( uint8 seqNum )
+{
+  (void)seqNum;
+}
+
+/*********************************************************************
+ * MAC
+ */
+
+void macTaskInit( uint8 taskId )
+{
+  (void)taskId;
+}
+
+uint16 macEventLoop( uint8 taskId, uint16 events )
+{
+  (void)taskId;
+  (void)events;
+  return ( 0 );
+}
+
+ZMacStatus_t ZMacSetReq( ZMacAttributes_t attr, byte *value )
+{
+  (void)attr;
+  (void)value;
+  return ( ZMacSuccess );
+}
+
+ZMacStatus_t ZMacGetReq( ZMacAttributes_t attr, byte *value )
+{
+  (void)attr;
+  (void)value;
+  return ( ZMacUnsupportedAttribute );
+}
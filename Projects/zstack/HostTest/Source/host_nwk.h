@@ -0,0 +1,91 @@
+/**************************************************************************************************
+  Filename:       host_nwk.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the NWK, APS and MAC layers below AF, which
+                  only ship as target libraries.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+#ifndef HOST_NWK_H
+#define HOST_NWK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "ZComDef.h"
+#include "APSMEDE.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Short address of the device
+#define HOST_NWK_ADDR  0x1234
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Frames handed to APSDE_DataReq(), and the bytes of their ASDUs
+extern uint32 hostNwkTxFrames;
+extern uint32 hostNwkTxBytes;
+
+// Called with each frame handed to APSDE_DataReq(), if set
+extern void (*hostNwkTxCB)( APSDE_DataReq_t *req );
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Deliver a unicast received from another device to AF, as APS does.
+ */
+extern void hostNwkRx( uint16 srcAddr, uint8 srcEP, uint8 dstEP, uint16 clusterID,
+                       uint16 profileID, uint8 *asdu, uint8 len );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_NWK_H */
@@ -0,0 +1,413 @@
+/**************************************************************************************************
+  Filename:       host_osal.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the OSAL services the stack modules call.
+                  The utilities behave as in OSAL.c; the heap is malloc(),
+                  and events, timers and messages are only recorded for the
+                  test to inspect.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OSAL_Tasks.h"
+#include "OSAL_Timers.h"
+#include "hal_assert.h"
+#include "host_osal.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define HOST_OSAL_TASKS   16
+#define HOST_OSAL_TIMERS  16
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint8 taskId;
+  uint16 event;
+  uint32 timeout;
+} hostOsalTimer_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint32 hostOsalClock;
+int32 hostOsalBlocks;
+uint32 hostOsalAllocs;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 hostOsalEvents[HOST_OSAL_TASKS];
+#if !defined ( HOST_OSAL_REAL_TIMERS )
+static hostOsalTimer_t hostOsalTimers[HOST_OSAL_TIMERS];
+#endif
+static osal_msg_q_t hostOsalMsgs[HOST_OSAL_TASKS];
+
+/*********************************************************************
+ * MEMORY AND BUFFER UTILITIES
+ */
+
+int osal_strlen( char *pString )
+{
+  return (int)( strlen( pString ) );
+}
+
+void *osal_memcpy( void *dst, const void GENERIC *src, unsigned int len )
+{
+  memcpy( dst, src, len );
+  return ( (uint8 *)dst + len );
+}
+
+void *osal_revmemcpy( void *dst, const void GENERIC *src, unsigned int len )
+{
+  uint8 *pDst = dst;
+  const uint8 GENERIC *pSrc = (const uint8 GENERIC *)src + (len - 1);
+
+  while ( len-- )
+  {
+    *pDst++ = *pSrc--;
+  }
+
+  return ( pDst );
+}
+
+void *osal_memdup( const void GENERIC *src, unsigned int len )
+{
+  uint8 *pDst = osal_mem_alloc( len );
+
+  if ( pDst )
+  {
+    memcpy( pDst, src, len );
+  }
+
+  return ( pDst );
+}
+
+uint8 osal_memcmp( const void GENERIC *src1, const void GENERIC *src2, unsigned int len )
+{
+  return ( memcmp( src1, src2, len ) == 0 );
+}
+
+void *osal_memset( void *dest, uint8 value, int len )
+{
+  return memset( dest, value, len );
+}
+
+uint16 osal_build_uint16( uint8 *swapped )
+{
+  return ( BUILD_UINT16( swapped[0], swapped[1] ) );
+}
+
+uint32 osal_build_uint32( uint8 *swapped, uint8 len )
+{
+  if ( len == 2 )
+    return ( BUILD_UINT32( swapped[0], swapped[1], 0L, 0L ) );
+  else if ( len == 3 )
+    return ( BUILD_UINT32( swapped[0], swapped[1], swapped[2], 0L ) );
+  else if ( len == 4 )
+    return ( BUILD_UINT32( swapped[0], swapped[1], swapped[2], swapped[3] ) );
+  else
+    return ( (uint32)swapped[0] );
+}
+
+uint8* osal_buffer_uint32( uint8 *buf, uint32 val )
+{
+  *buf++ = BREAK_UINT32( val, 0 );
+  *buf++ = BREAK_UINT32( val, 1 );
+  *buf++ = BREAK_UINT32( val, 2 );
+  *buf++ = BREAK_UINT32( val, 3 );
+
+  return buf;
+}
+
+uint8 osal_isbufset( uint8 *buf, uint8 val, uint8 len )
+{
+  uint8 x;
+
+  if ( buf == NULL )
+  {
+    return ( FALSE );
+  }
+
+  for ( x = 0; x < len; x++ )
+  {
+    if ( buf[x] != val )
+    {
+      return ( FALSE );
+    }
+  }
+  return ( TRUE );
+}
+
+uint16 osal_rand( void )
+{
+  return (uint16)( rand() );
+}
+
+/*********************************************************************
+ * HEAP - tests of the real OSAL_Memory.c define HOST_OSAL_REAL_HEAP
+ */
+
+#if !defined ( HOST_OSAL_REAL_HEAP )
+void *osal_mem_alloc( uint16 size )
+{
+  void *ptr = malloc( size );
+
+  if ( ptr != NULL )
+  {
+    hostOsalBlocks++;
+    hostOsalAllocs++;
+  }
+
+  return ( ptr );
+}
+
+void osal_mem_free( void *ptr )
+{
+  if ( ptr != NULL )
+  {
+    hostOsalBlocks--;
+    free( ptr );
+  }
+}
+#endif
+
+/*********************************************************************
+ * MESSAGES
+ */
+
+uint8 *osal_msg_allocate( uint16 len )
+{
+  osal_msg_hdr_t *hdr;
+
+  if ( len == 0 )
+    return ( NULL );
+
+  hdr = (osal_msg_hdr_t *) osal_mem_alloc( (short)(len + sizeof( osal_msg_hdr_t )) );
+  if ( hdr )
+  {
+    hdr->next = NULL;
+    hdr->len = len;
+    hdr->dest_id = TASK_NO_TASK;
+    return ( (uint8 *) (hdr + 1) );
+  }
+  else
+    return ( NULL );
+}
+
+uint8 osal_msg_deallocate( uint8 *msg_ptr )
+{
+  if ( msg_ptr == NULL )
+    return ( INVALID_MSG_POINTER );
+
+  osal_mem_free( (osal_msg_hdr_t *)msg_ptr - 1 );
+  return ( SUCCESS );
+}
+
+uint8 osal_msg_send( uint8 destination_task, uint8 *msg_ptr )
+{
+  void *tail;
+
+  if ( msg_ptr == NULL )
+    return ( INVALID_MSG_POINTER );
+
+  if ( destination_task >= HOST_OSAL_TASKS )
+  {
+    osal_msg_deallocate( msg_ptr );
+    return ( INVALID_TASK );
+  }
+
+  OSAL_MSG_ID( msg_ptr ) = destination_task;
+  OSAL_MSG_NEXT( msg_ptr ) = NULL;
+
+  if ( hostOsalMsgs[destination_task] == NULL )
+  {
+    hostOsalMsgs[destination_task] = msg_ptr;
+  }
+  else
+  {
+    for ( tail = hostOsalMsgs[destination_task]; OSAL_MSG_NEXT( tail ) != NULL; )
+    {
+      tail = OSAL_MSG_NEXT( tail );
+    }
+    OSAL_MSG_NEXT( tail ) = msg_ptr;
+  }
+
+  hostOsalEvents[destination_task] |= SYS_EVENT_MSG;
+  return ( SUCCESS );
+}
+
+uint8 *hostOsalTakeMsg( uint8 taskId )
+{
+  uint8 *msg_ptr = hostOsalMsgs[taskId];
+
+  if ( msg_ptr != NULL )
+  {
+    hostOsalMsgs[taskId] = OSAL_MSG_NEXT( msg_ptr );
+  }
+
+  return ( msg_ptr );
+}
+
+/*********************************************************************
+ * EVENTS AND TIMERS
+ */
+
+uint8 osal_set_event( uint8 task_id, uint16 event_flag )
+{
+  if ( task_id >= HOST_OSAL_TASKS )
+    return ( INVALID_TASK );
+
+  hostOsalEvents[task_id] |= event_flag;
+  return ( SUCCESS );
+}
+
+uint8 osal_clear_event( uint8 task_id, uint16 event_flag )
+{
+  if ( task_id >= HOST_OSAL_TASKS )
+    return ( INVALID_TASK );
+
+  hostOsalEvents[task_id] &= ~event_flag;
+  return ( SUCCESS );
+}
+
+uint16 hostOsalTakeEvents( uint8 taskId )
+{
+  uint16 events = hostOsalEvents[taskId];
+
+  hostOsalEvents[taskId] = 0;
+  return ( events );
+}
+
+/*
+ * Tests of the real OSAL_Timers.c define HOST_OSAL_REAL_TIMERS
+ */
+#if !defined ( HOST_OSAL_REAL_TIMERS )
+static hostOsalTimer_t *hostOsalFindTimer( uint8 taskId, uint16 event )
+{
+  uint8 x;
+
+  for ( x = 0; x < HOST_OSAL_TIMERS; x++ )
+  {
+    if ( (hostOsalTimers[x].timeout != 0) &&
+         (hostOsalTimers[x].taskId == taskId) && (hostOsalTimers[x].event == event) )
+    {
+      return ( &hostOsalTimers[x] );
+    }
+  }
+
+  return ( NULL );
+}
+
+uint8 osal_start_timerEx( uint8 task_id, uint16 event_id, uint32 timeout_value )
+{
+  hostOsalTimer_t *timer = hostOsalFindTimer( task_id, event_id );
+  uint8 x;
+
+  for ( x = 0; (timer == NULL) && (x < HOST_OSAL_TIMERS); x++ )
+  {
+    if ( hostOsalTimers[x].timeout == 0 )
+    {
+      timer = &hostOsalTimers[x];
+    }
+  }
+
+  if ( timer == NULL )
+    return ( NO_TIMER_AVAIL );
+
+  // A zero timeout expires on the next tick on the target
+  timer->taskId = task_id;
+  timer->event = event_id;
+  timer->timeout = ( timeout_value != 0 ) ? timeout_value : 1;
+  return ( SUCCESS );
+}
+
+uint8 osal_stop_timerEx( uint8 task_id, uint16 event_id )
+{
+  hostOsalTimer_t *timer = hostOsalFindTimer( task_id, event_id );
+
+  if ( timer == NULL )
+    return ( INVALID_EVENT_ID );
+
+  timer->timeout = 0;
+  return ( SUCCESS );
+}
+
+uint32 osal_get_timeoutEx( uint8 task_id, uint16 event_id )
+{
+  return ( hostOsalTimer( task_id, event_id ) );
+}
+
+uint32 hostOsalTimer( uint8 taskId, uint16 event )
+{
+  hostOsalTimer_t *timer = hostOsalFindTimer( taskId, event );
+
+  return ( timer != NULL ) ? timer->timeout : 0;
+}
+
+uint32 osal_GetSystemClock( void )
+{
+  return ( hostOsalClock );
+}
+#endif
+
+/*********************************************************************
+ * HAL
+ */
+
+void halAssertHandler( void )
+{
+  printf( "HAL_ASSERT failed\n" );
+  abort();
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,95 @@
+/**************************************************************************************************
+  Filename:       host_osal.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the OSAL services the stack modules call:
+                  the memory and buffer utilities, the heap, messages,
+                  events, timers and the system clock.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+#ifndef HOST_OSAL_H
+#define HOST_OSAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_types.h"
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Value returned by osal_GetSystemClock(), in ms
+extern uint32 hostOsalClock;
+
+// Heap blocks allocated and not yet freed, unless HOST_OSAL_REAL_HEAP
+extern int32 hostOsalBlocks;
+
+// Heap blocks allocated since the start, unless HOST_OSAL_REAL_HEAP
+extern uint32 hostOsalAllocs;
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Return the events set and not cleared for a task, and clear them.
+ */
+extern uint16 hostOsalTakeEvents( uint8 taskId );
+
+/*
+ * Return the timeout of a running timer, or 0 if it is not running.
+ */
+extern uint32 hostOsalTimer( uint8 taskId, uint16 event );
+
+/*
+ * Return the next message sent to a task, or NULL. Free it with
+ * osal_msg_deallocate().
+ */
+extern uint8 *hostOsalTakeMsg( uint8 taskId );
+
+/*********************************************************************
+*********************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_OSAL_H */
@@ -0,0 +1,116 @@
+/**************************************************************************************************
+  Filename:       host_timer.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the MAC free running timer. OSAL_Clock.c
+                  converts its 320 us ticks into the OSAL clock and timers;
+                  here they are taken from CLOCK_MONOTONIC, plus the time a
+                  test moves it ahead by.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stdint.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "host_timer.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Microseconds per tick of the MAC backoff timer
+#define HOST_TIMER_TICK_US  320
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint32 hostTimerAdvanced;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint64_t hostTimerStart;
+static uint64_t hostTimerStopped;   // Wall clock it was stopped at, or 0
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint64_t hostTimerUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( ((uint64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000) );
+}
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+/*
+ * Free running count of 320 us ticks, read by osalTimeUpdate().
+ */
+uint32 macMcuPrecisionCount( void )
+{
+  uint64_t usec = hostTimerStopped ? hostTimerStopped : hostTimerUsec();
+
+  if ( hostTimerStart == 0 )
+  {
+    hostTimerStart = usec;
+  }
+
+  usec += (uint64_t)hostTimerAdvanced * 1000 - hostTimerStart;
+  return ( (uint32)(usec / HOST_TIMER_TICK_US) );
+}
+
+void hostTimerAdvance( uint32 msec )
+{
+  hostTimerAdvanced += msec;
+}
+
+void hostTimerStop( void )
+{
+  if ( hostTimerStopped == 0 )
+  {
+    hostTimerStopped = hostTimerUsec();
+  }
+}
@@ -0,0 +1,291 @@
+/**************************************************************************************************
+  Filename:       host_uart.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host stand-in for the HAL UART. Each open port is a pair of
+                  non-blocking pipes: HalUARTPoll() moves what the peer wrote
+                  into the Rx buffer and reports the same events as the
+                  CC2538 interrupt driven driver, HalUARTWrite() writes
+                  straight through.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Timers.h"
+#include "hal_uart.h"
+#include "host_uart.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+// Largest Rx buffer a port can be opened with
+#define HOST_UART_RX_MAX  256
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  int rxFd[2];          // Peer writes [1], the port reads [0]
+  int txFd[2];          // The port writes [1], peer reads [0]
+  uint8 rxBuf[HOST_UART_RX_MAX];
+  uint16 rxHead;
+  uint16 rxLen;
+  uint16 rxMax;
+  uint16 flowThreshold;
+  uint8 idleTimeout;
+  uint8 rxIdle;         // No bytes since the last Rx timeout event
+  uint32 rxTime;        // System clock at the last byte received
+  halUARTCBack_t callBackFunc;
+} hostUartPort_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint32 hostUartTxBytes[HAL_UART_PORT_MAX];
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static hostUartPort_t hostUartPorts[HAL_UART_PORT_MAX] =
+{
+  { { -1, -1 }, { -1, -1 } },
+  { { -1, -1 }, { -1, -1 } }
+};
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8 hostUartPipe( int fd[2] )
+{
+  if ( pipe( fd ) != 0 )
+  {
+    return ( FALSE );
+  }
+
+  fcntl( fd[0], F_SETFL, O_NONBLOCK );
+  fcntl( fd[1], F_SETFL, O_NONBLOCK );
+  return ( TRUE );
+}
+
+static void hostUartPollPort( uint8 port, hostUartPort_t *pPort )
+{
+  uint16 tail = (pPort->rxHead + pPort->rxLen) % pPort->rxMax;
+  uint16 space = pPort->rxMax - pPort->rxLen;
+  ssize_t got;
+  uint8 evts = 0;
+
+  // Fill the ring up to its end, then from the start
+  while ( space != 0 )
+  {
+    uint16 run = ( tail + space > pPort->rxMax ) ? (pPort->rxMax - tail) : space;
+
+    got = read( pPort->rxFd[0], &pPort->rxBuf[tail], run );
+    if ( got <= 0 )
+    {
+      break;
+    }
+
+    pPort->rxLen += (uint16)got;
+    pPort->rxIdle = FALSE;
+    pPort->rxTime = osal_GetSystemClock();
+    space -= (uint16)got;
+    tail = (tail + (uint16)got) % pPort->rxMax;
+  }
+
+  if ( (pPort->rxLen + 1) >= pPort->rxMax )
+  {
+    evts = HAL_UART_RX_FULL;
+  }
+
+  if ( !pPort->rxIdle && ((osal_GetSystemClock() - pPort->rxTime) > pPort->idleTimeout) )
+  {
+    pPort->rxIdle = TRUE;
+    evts |= HAL_UART_RX_TIMEOUT;
+  }
+
+  if ( pPort->rxLen >= pPort->rxMax - pPort->flowThreshold )
+  {
+    evts |= HAL_UART_RX_ABOUT_FULL;
+  }
+
+  if ( evts && pPort->callBackFunc )
+  {
+    pPort->callBackFunc( port, evts );
+  }
+}
+
+/*********************************************************************
+ * FUNCTIONS
+ */
+
+void HalUARTInit( void )
+{
+}
+
+uint8 HalUARTOpen( uint8 port, halUARTCfg_t *config )
+{
+  hostUartPort_t *pPort;
+
+  if ( port >= HAL_UART_PORT_MAX )
+  {
+    return ( HAL_UART_NOT_SUPPORTED );
+  }
+
+  pPort = &hostUartPorts[port];
+  HalUARTClose( port );
+
+  if ( !hostUartPipe( pPort->rxFd ) )
+  {
+    return ( HAL_UART_MEM_FAIL );
+  }
+  if ( !hostUartPipe( pPort->txFd ) )
+  {
+    HalUARTClose( port );
+    return ( HAL_UART_MEM_FAIL );
+  }
+
+  pPort->rxHead = 0;
+  pPort->rxLen = 0;
+  pPort->rxMax = ( config->rx.maxBufSize < HOST_UART_RX_MAX ) ? config->rx.maxBufSize : HOST_UART_RX_MAX;
+  pPort->flowThreshold = config->flowControlThreshold;
+  pPort->idleTimeout = config->idleTimeout;
+  pPort->rxIdle = TRUE;
+  pPort->callBackFunc = config->callBackFunc;
+
+  return ( HAL_UART_SUCCESS );
+}
+
+void HalUARTClose( uint8 port )
+{
+  hostUartPort_t *pPort = &hostUartPorts[port];
+  uint8 x;
+
+  for ( x = 0; x < 2; x++ )
+  {
+    if ( pPort->rxFd[x] >= 0 )
+    {
+      close( pPort->rxFd[x] );
+      pPort->rxFd[x] = -1;
+    }
+    if ( pPort->txFd[x] >= 0 )
+    {
+      close( pPort->txFd[x] );
+      pPort->txFd[x] = -1;
+    }
+  }
+  pPort->callBackFunc = NULL;
+}
+
+void HalUARTPoll( void )
+{
+  uint8 port;
+
+  for ( port = 0; port < HAL_UART_PORT_MAX; port++ )
+  {
+    if ( hostUartPorts[port].rxFd[0] >= 0 )
+    {
+      hostUartPollPort( port, &hostUartPorts[port] );
+    }
+  }
+}
+
+uint16 HalUARTRead( uint8 port, uint8 *pBuffer, uint16 length )
+{
+  hostUartPort_t *pPort = &hostUartPorts[port];
+  uint16 cnt = 0;
+
+  while ( (cnt < length) && (pPort->rxLen != 0) )
+  {
+    pBuffer[cnt++] = pPort->rxBuf[pPort->rxHead];
+    pPort->rxHead = (pPort->rxHead + 1) % pPort->rxMax;
+    pPort->rxLen--;
+  }
+
+  return ( cnt );
+}
+
+uint16 HalUARTWrite( uint8 port, uint8 *pBuffer, uint16 length )
+{
+  hostUartPort_t *pPort = &hostUartPorts[port];
+  ssize_t put;
+
+  if ( pPort->txFd[1] < 0 )
+  {
+    return ( 0 );
+  }
+
+  put = write( pPort->txFd[1], pBuffer, length );
+  if ( put <= 0 )
+  {
+    return ( 0 );
+  }
+
+  hostUartTxBytes[port] += (uint32)put;
+  return ( (uint16)put );
+}
+
+uint16 Hal_UART_RxBufLen( uint8 port )
+{
+  return ( hostUartPorts[port].rxLen );
+}
+
+uint16 Hal_UART_TxBufLen( uint8 port )
+{
+  (void)port;
+  return ( 0 );
+}
+
+int hostUartRxFd( uint8 port )
+{
+  return ( hostUartPorts[port].rxFd[1] );
+}
+
+int hostUartTxFd( uint8 port )
+{
+  return ( hostUartPorts[port].txFd[0] );
+}
@@ -0,0 +1 @@
+/* Host stand-in for the IAR intrinsics header, the host build uses none of them. */
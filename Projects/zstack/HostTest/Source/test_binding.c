@@ -0,0 +1,379 @@
+/**************************************************************************************************
+  Filename:       test_binding.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the binding table. Checks the source endpoint
+                  and cluster index against a linear scan of the table, and
+                  checks that BindWriteNV() writes only the changed records.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "nwk_globals.h"
+#include "AddrMgr.h"
+#include "BindingTable.h"
+#include "NLMEDE.h"
+#include "nwk_util.h"
+#include "bdb_interface.h"
+#include "host_nv.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_EPS       3   // Source endpoints 1 to TEST_EPS
+#define TEST_CLUSTERS  6   // Cluster IDs 0 to TEST_CLUSTERS - 1
+#define TEST_DSTS      8   // Destination groups / short addresses
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Normally in nwk_globals.c
+CONFIG_ITEM bindTableIndex_t gNWK_MAX_BINDING_ENTRIES = NWK_MAX_BINDING_ENTRIES;
+CONFIG_ITEM uint8 gMAX_BINDING_CLUSTER_IDS = MAX_BINDING_CLUSTER_IDS;
+CONST uint16 gBIND_REC_SIZE = sizeof( BindingEntry_t );
+BindingEntry_t BindingTable[NWK_MAX_BINDING_ENTRIES];
+
+// Normally in nwk_globals.c and bdb_FindingAndBinding.c
+nwkIB_t _NIB;
+bdbGCB_BindNotification_t pfnBindNotificationCB = NULL;
+
+/*********************************************************************
+ * STUBS - the address manager and NLME are in the NWK library. Short
+ * addresses map straight to address manager indexes.
+ */
+
+byte *NLME_GetExtAddr( void )
+{
+  static uint8 extAddr[Z_EXTADDR_LEN];
+
+  return ( extAddr );
+}
+
+uint16 NLME_GetCoordShortAddr( void )
+{
+  return ( INVALID_NODE_ADDR );
+}
+
+void NLME_GetCoordExtAddr( byte *buf )
+{
+  memset( buf, 0, Z_EXTADDR_LEN );
+}
+
+uint8 nwkCreateDuplicateNV( uint16 srcId, uint16 dstId )
+{
+  return ( NV_OPER_FAILED );
+}
+
+uint8 AddrMgrEntryUpdate( AddrMgrEntry_t *entry )
+{
+  return ( TRUE );
+}
+
+uint8 AddrMgrEntryLookupNwk( AddrMgrEntry_t *entry )
+{
+  entry->index = entry->nwkAddr;
+  return ( TRUE );
+}
+
+uint8 AddrMgrEntryLookupExt( AddrMgrEntry_t *entry )
+{
+  entry->index = INVALID_NODE_ADDR;
+  return ( FALSE );
+}
+
+void AddrMgrExtAddrSet( uint8 *dstExtAddr, uint8 *srcExtAddr )
+{
+  memcpy( dstExtAddr, srcExtAddr, Z_EXTADDR_LEN );
+}
+
+uint8 AddrMgrEntryGet( AddrMgrEntry_t *entry )
+{
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryRelease( AddrMgrEntry_t *entry )
+{
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The entry bindFind() should return, found the way it was before the
+ * index: a scan of the whole table.
+ */
+static BindingEntry_t *refFind( uint8 ep, uint16 clusterID, uint8 skipping )
+{
+  uint16 x;
+
+  for ( x = 0; x < NWK_MAX_BINDING_ENTRIES; x++ )
+  {
+    BindingEntry_t *pBind = &BindingTable[x];
+
+    if ( (pBind->srcEP == ep) && bindIsClusterIDinList( pBind, clusterID ) )
+    {
+      if ( skipping == 0 )
+      {
+        return ( pBind );
+      }
+      skipping--;
+    }
+  }
+
+  return ( NULL );
+}
+
+static void randomDst( zAddrType_t *dst )
+{
+  dst->addrMode = (rand() % 2) ? AddrGroup : Addr16Bit;
+  dst->addr.shortAddr = rand() % TEST_DSTS;
+}
+
+/*
+ * Add or remove a random binding.
+ */
+static void randomOp( void )
+{
+  uint8 ep = 1 + (rand() % TEST_EPS);
+  uint16 clusterID = rand() % TEST_CLUSTERS;
+  uint8 dstEP = 1 + (rand() % 2);
+  zAddrType_t dst;
+
+  randomDst( &dst );
+
+  if ( rand() % 2 )
+  {
+    uint16 list[3];
+    uint8 cnt = 1 + (rand() % 3);
+    uint8 x;
+
+    for ( x = 0; x < cnt; x++ )
+    {
+      list[x] = rand() % TEST_CLUSTERS;
+    }
+    bindAddEntry( ep, &dst, dstEP, cnt, list );
+  }
+  else
+  {
+    BindingEntry_t *pBind = bindFindExisting( ep, &dst, dstEP );
+
+    if ( (pBind != NULL) && !bindRemoveClusterIdFromList( pBind, clusterID ) )
+    {
+      bindRemoveEntry( pBind );
+    }
+  }
+}
+
+/*
+ * Every lookup through the index must match the table scan.
+ */
+static void checkIndex( long step )
+{
+  uint8 ep;
+  uint16 clusterID;
+
+  for ( ep = 1; ep <= TEST_EPS; ep++ )
+  {
+    for ( clusterID = 0; clusterID < TEST_CLUSTERS; clusterID++ )
+    {
+      BindingEntry_t *pBind;
+      bindIter_t iter;
+      uint16 cnt = 0;
+      uint8 skip;
+
+      for ( skip = 0; skip <= NWK_MAX_BINDING_ENTRIES; skip++ )
+      {
+        HOST_CHECK_STEP( bindFind( ep, clusterID, skip ) == refFind( ep, clusterID, skip ), step );
+        if ( refFind( ep, clusterID, skip ) != NULL )
+        {
+          cnt++;
+        }
+      }
+      HOST_CHECK_STEP( bindNumReflections( ep, clusterID ) == cnt, step );
+
+      skip = 0;
+      for ( pBind = bindFindFirst( &iter, ep, clusterID ); pBind != NULL; pBind = bindFindNext( &iter ) )
+      {
+        HOST_CHECK_STEP( pBind == refFind( ep, clusterID, skip ), step );
+        skip++;
+      }
+      HOST_CHECK_STEP( skip == cnt, step );
+    }
+  }
+}
+
+/*
+ * The NV item must hold the table: the header record count and every
+ * record.
+ */
+static void checkNV( long step )
+{
+  uint8 *item = hostNvItem( ZCD_NV_BINDING_TABLE );
+  nvBindingHdr_t hdr;
+  uint16 numRecs = 0;
+  uint16 x;
+
+  HOST_CHECK( item != NULL );
+
+  for ( x = 0; x < NWK_MAX_BINDING_ENTRIES; x++ )
+  {
+    HOST_CHECK_STEP( memcmp( item + sizeof( nvBindingHdr_t ) + (x * gBIND_REC_SIZE),
+                             &BindingTable[x], gBIND_REC_SIZE ) == 0, step );
+    if ( BindingTable[x].srcEP != 0xFF )
+    {
+      numRecs++;
+    }
+  }
+
+  memcpy( &hdr, item, sizeof( hdr ) );
+  HOST_CHECK_STEP( hdr.numRecs == numRecs, step );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testIndex( void )
+{
+  long step;
+
+  InitBindingTable();
+  srand( 3 );
+
+  for ( step = 0; step < 50000; step++ )
+  {
+    randomOp();
+    if ( (rand() % 50) == 0 )
+    {
+      bindRemoveSrcDev( (rand() % 2) ? 0xFF : (1 + (rand() % TEST_EPS)) );
+    }
+    checkIndex( step );
+  }
+
+  printf( "index: %ld steps matched the table scan\n", step );
+}
+
+static void testDirtyWrites( void )
+{
+  BindingEntry_t saved[NWK_MAX_BINDING_ENTRIES];
+  zAddrType_t dst;
+  uint16 clusterID = 1;
+  uint32 writes;
+  long step;
+
+  hostNvReset();
+  InitBindingTable();
+  HOST_CHECK( BindInitNV() == NV_ITEM_UNINIT );
+  BindWriteNV();
+  checkNV( -1 );
+
+  // Nothing changed, nothing to write
+  writes = hostNvWrites;
+  BindWriteNV();
+  HOST_CHECK( hostNvWrites == writes );
+
+  // One new entry: its record and the header record count
+  dst.addrMode = AddrGroup;
+  dst.addr.shortAddr = 3;
+  HOST_CHECK( bindAddEntry( 1, &dst, 1, 1, &clusterID ) != NULL );
+  writes = hostNvWrites;
+  BindWriteNV();
+  HOST_CHECK( hostNvWrites == writes + 2 );
+  checkNV( -1 );
+
+  // A cluster added to it: only its record
+  clusterID = 2;
+  HOST_CHECK( bindAddClusterIdToList( bindFindExisting( 1, &dst, 1 ), clusterID ) );
+  writes = hostNvWrites;
+  BindWriteNV();
+  HOST_CHECK( hostNvWrites == writes + 1 );
+  checkNV( -1 );
+
+  // Random binds and unbinds, saved now and then
+  srand( 5 );
+  writes = hostNvWrites;
+  for ( step = 0; step < 20000; step++ )
+  {
+    randomOp();
+    if ( (rand() % 4) == 0 )
+    {
+      BindWriteNV();
+      checkNV( step );
+    }
+  }
+  BindWriteNV();
+  checkNV( step );
+  HOST_CHECK( (hostNvWrites - writes) < ((step / 4) * (NWK_MAX_BINDING_ENTRIES + 1)) );
+  printf( "dirty: %ld ops took %lu NV writes\n", step, (unsigned long)(hostNvWrites - writes) );
+
+  // Restore after a reset, then a save has nothing to write
+  memcpy( saved, BindingTable, sizeof( saved ) );
+  InitBindingTable();
+  BindRestoreFromNV();
+  for ( step = 0; step < NWK_MAX_BINDING_ENTRIES; step++ )
+  {
+    if ( saved[step].srcEP != 0xFF )
+    {
+      HOST_CHECK( memcmp( &saved[step], &BindingTable[step], sizeof( BindingEntry_t ) ) == 0 );
+    }
+  }
+  checkIndex( -1 );
+  writes = hostNvWrites;
+  BindWriteNV();
+  HOST_CHECK( hostNvWrites == writes );
+}
+
+int main( void )
+{
+  testIndex();
+  testDirtyWrites();
+
+  printf( "test_binding passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,361 @@
+/**************************************************************************************************
+  Filename:       test_gp_duplicate.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks the GPDF duplicate filter: replays GPD traffic against
+                  a model of A.3.6.1.2 and checks the edge cases of the cache.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+// The duplicate cache and its functions are static to gp_common.c
+#include "gp_common.c"
+
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_FRAMES      300000
+#define TEST_HANDLES     256
+
+// GPDs in the replay, and how often each retries a GPDF. With many GPDs
+// the cache sets fill up and GPDFs are evicted before they expire.
+#define TEST_GPDS        8
+#define TEST_GPDS_MAX    64
+#define TEST_RETRIES     3
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// First receipt of a GPDF, as the model remembers it
+typedef struct
+{
+  uint32 counter;
+  uint32 time;
+  uint8  valid;
+} testFirst_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// GPDFs held by the dGP stub, by handle
+static gp_DataInd_t testInd[TEST_HANDLES];
+static uint8 testIndValid[TEST_HANDLES];
+
+// First receipt by GPD and low byte of the counter
+static testFirst_t testFirst[TEST_GPDS_MAX][256];
+
+/*********************************************************************
+ * STUBS
+ */
+
+gp_DataInd_t* gp_DataIndGet( uint8 handle )
+{
+  return ( testIndValid[handle] ? &testInd[handle] : NULL );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Fill in a GPDF from a GPD. Even GPDs use the IEEE address and security,
+ * odd ones a source ID and the MAC sequence number.
+ */
+static gp_DataInd_t *makeInd( uint8 handle, uint8 gpd, uint32 counter )
+{
+  gp_DataInd_t *pInd = &testInd[handle];
+
+  memset( pInd, 0, sizeof( gp_DataInd_t ) );
+  pInd->SecReqHandling.dGPStubHandle = handle;
+
+  if ( gpd & 1 )
+  {
+    pInd->appID = GP_APP_ID_DEFAULT;
+    pInd->SrcId = 0x1000 + gpd;
+    pInd->SeqNumber = (uint8)counter;
+    pInd->GPDSecFrameCounter = rand();
+  }
+  else
+  {
+    pInd->appID = GP_OPT_APP_ID_IEEE;
+    pInd->srcAddr.addrMode = Addr64Bit;
+    memset( pInd->srcAddr.addr.extAddr, 0xA0, Z_EXTADDR_LEN );
+    pInd->srcAddr.addr.extAddr[0] = gpd;
+    pInd->GPDFSecLvl = 2;
+    pInd->GPDSecFrameCounter = counter;
+    pInd->SeqNumber = rand();
+  }
+
+  testIndValid[handle] = TRUE;
+  return ( pInd );
+}
+
+/*
+ * Receive a GPDF as gp_DataInd does: remember it, then check it.
+ */
+static bool rxInd( gp_DataInd_t *pInd )
+{
+  gp_DuplicateCacheAdd( pInd );
+  return ( gp_DataIndFindDuplicate( pInd->SecReqHandling.dGPStubHandle ) );
+}
+
+/*
+ * A GPDF is a duplicate if the same GPDF was passed up as new less than
+ * gpDuplicateTimeout ago.
+ */
+static bool modelInd( uint8 gpd, uint32 counter )
+{
+  testFirst_t *pFirst = &testFirst[gpd][(uint8)counter];
+
+  return ( pFirst->valid && (pFirst->counter == counter) &&
+           ((hostOsalClock - pFirst->time) < gpDuplicateTimeout) );
+}
+
+/*
+ * Remember a GPDF passed up as new. A missed duplicate is one too, and
+ * starts a new window.
+ */
+static void modelNew( uint8 gpd, uint32 counter )
+{
+  testFirst_t *pFirst = &testFirst[gpd][(uint8)counter];
+
+  pFirst->counter = counter;
+  pFirst->time = hostOsalClock;
+  pFirst->valid = TRUE;
+}
+
+/*
+ * Find the next sequence number after seq that a source ID GPD keeps in
+ * the same cache set as seq.
+ */
+static uint8 nextInSet( uint8 gpd, uint8 seq )
+{
+  gpd_ID_t gpd_ID;
+  gpDuplicateEntry_t *pSet;
+  uint8 next = seq;
+
+  gp_DataIndGetGpdId( makeInd( 0, gpd, seq ), &gpd_ID );
+  pSet = gp_DuplicateCacheSet( &gpd_ID, seq );
+
+  do
+  {
+    next++;
+    HOST_CHECK( next != seq );
+  } while ( gp_DuplicateCacheSet( &gpd_ID, next ) != pSet );
+
+  return ( next );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Replay GPDs that each retry their GPDFs a few times in quick
+ * succession. A duplicate is never reported where the model has none.
+ * Returns the share of duplicates missed, in 1/1000.
+ */
+static uint32 testReplay( uint8 gpds )
+{
+  uint32 counter[TEST_GPDS_MAX];
+  uint32 dups = 0;
+  uint32 missed = 0;
+  uint32 n;
+  uint8 retries = 0;
+  uint8 handle = 0;
+  uint8 gpd = 0;
+
+  srand( gpds );
+  memset( counter, 0, sizeof( counter ) );
+  memset( testFirst, 0, sizeof( testFirst ) );
+  memset( gp_DuplicateCache, 0, sizeof( gp_DuplicateCache ) );
+
+  // Run the clock through its wrap
+  hostOsalClock = 0xFFFFFFFF - (TEST_FRAMES / 4) * 100;
+
+  for ( n = 0; n < TEST_FRAMES; n++ )
+  {
+    bool dup;
+    bool model;
+
+    if ( retries == 0 )
+    {
+      hostOsalClock += rand() % (4000 / gpds);
+      gpd = rand() % gpds;
+      counter[gpd]++;
+      retries = 1 + (rand() % TEST_RETRIES);
+    }
+    else
+    {
+      hostOsalClock += rand() % 15;
+    }
+    retries--;
+
+    dup = rxInd( makeInd( handle++, gpd, counter[gpd] ) );
+    model = modelInd( gpd, counter[gpd] );
+
+    HOST_CHECK_STEP( !dup || model, n );
+    if ( model )
+    {
+      dups++;
+      missed += !dup;
+    }
+    if ( !dup )
+    {
+      modelNew( gpd, counter[gpd] );
+    }
+  }
+
+  printf( "duplicate: %u GPDs, %lu frames, %lu duplicates, %lu missed\n",
+          gpds, (unsigned long)n, (unsigned long)dups, (unsigned long)missed );
+
+  return ( (missed * 1000) / dups );
+}
+
+/*
+ * A single GPD, checked at the edges of the filter.
+ */
+static void testEdges( void )
+{
+  gp_DataInd_t *pInd;
+
+  memset( gp_DuplicateCache, 0, sizeof( gp_DuplicateCache ) );
+  memset( testIndValid, 0, sizeof( testIndValid ) );
+  hostOsalClock = 0xFFFFFFFF - 500;
+
+  // The first receipt is not a duplicate, even when checked again
+  pInd = makeInd( 1, 1, 10 );
+  HOST_CHECK( !rxInd( pInd ) );
+  HOST_CHECK( !gp_DataIndFindDuplicate( 1 ) );
+
+  // A retry is, until the timeout, across the clock wrap
+  hostOsalClock += 100;
+  HOST_CHECK( rxInd( makeInd( 2, 1, 10 ) ) );
+  hostOsalClock += gpDuplicateTimeout - 101;
+  HOST_CHECK( rxInd( makeInd( 2, 1, 10 ) ) );
+  hostOsalClock++;
+  HOST_CHECK( !rxInd( makeInd( 3, 1, 10 ) ) );
+
+  // The retry after the timeout starts a new window
+  hostOsalClock += gpDuplicateTimeout - 1;
+  HOST_CHECK( rxInd( makeInd( 4, 1, 10 ) ) );
+
+  // Another sequence number, or another GPD, is not a duplicate
+  HOST_CHECK( !rxInd( makeInd( 5, 1, 11 ) ) );
+  HOST_CHECK( !rxInd( makeInd( 6, 3, 10 ) ) );
+
+  // The same bytes as an IEEE address are another GPD
+  pInd = makeInd( 7, 0, 10 );
+  memset( pInd->srcAddr.addr.extAddr, 0, Z_EXTADDR_LEN );
+  pInd->srcAddr.addr.extAddr[0] = LO_UINT16( 0x1001 );
+  pInd->srcAddr.addr.extAddr[1] = HI_UINT16( 0x1001 );
+  pInd->GPDFSecLvl = 0;
+  pInd->SeqNumber = 10;
+  HOST_CHECK( !rxInd( pInd ) );
+
+  // With security the frame counter is used, not the sequence number
+  pInd = makeInd( 8, 2, 500 );
+  HOST_CHECK( !rxInd( pInd ) );
+  pInd = makeInd( 9, 2, 500 );
+  pInd->SeqNumber = testInd[8].SeqNumber + 1;
+  HOST_CHECK( rxInd( pInd ) );
+  pInd = makeInd( 10, 2, 501 );
+  pInd->SeqNumber = testInd[8].SeqNumber;
+  HOST_CHECK( !rxInd( pInd ) );
+
+  // A GPDF the dGP stub no longer holds is not a duplicate
+  testIndValid[9] = FALSE;
+  HOST_CHECK( !gp_DataIndFindDuplicate( 9 ) );
+}
+
+/*
+ * When a set is full, the GPDF received first is replaced.
+ */
+static void testEviction( void )
+{
+  uint8 seq[GP_DUPLICATE_CACHE_WAYS + 2];
+  uint8 i;
+
+  memset( gp_DuplicateCache, 0, sizeof( gp_DuplicateCache ) );
+  hostOsalClock = 1000;
+
+  seq[0] = 10;
+  for ( i = 1; i < sizeof( seq ); i++ )
+  {
+    seq[i] = nextInSet( 1, seq[i - 1] );
+  }
+
+  // Fill the set, then two more each replace the oldest
+  for ( i = 0; i < sizeof( seq ); i++ )
+  {
+    hostOsalClock += 10;
+    HOST_CHECK( !rxInd( makeInd( 20 + i, 1, seq[i] ) ) );
+  }
+
+  // The last GPDFs are still remembered, the first ones are not. A
+  // retry that is not found is remembered again, so check those last.
+  for ( i = 2; i < sizeof( seq ); i++ )
+  {
+    HOST_CHECK_STEP( rxInd( makeInd( 40 + i, 1, seq[i] ) ), i );
+  }
+  for ( i = 0; i < 2; i++ )
+  {
+    HOST_CHECK_STEP( !rxInd( makeInd( 40 + i, 1, seq[i] ) ), i );
+  }
+}
+
+int main( void )
+{
+  // A few GPDs fit the cache, few retries are missed
+  HOST_CHECK( testReplay( TEST_GPDS ) < 10 );
+  (void)testReplay( TEST_GPDS_MAX );
+  testEdges();
+  testEviction();
+
+  printf( "test_gp_duplicate passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,398 @@
+/**************************************************************************************************
+  Filename:       test_heap_trace.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL heap allocation trace. A router-like
+                  alloc and free sequence runs on the real OSAL_Memory.c and
+                  is drained through MT_DEBUG_HEAP_TRACE at random intervals.
+                  Every record is checked against the sequence, including the
+                  gap markers and that the drain itself is not recorded. The
+                  responses are written to a file for the heap_replay tool.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Memory.h"
+#include "OnBoard.h"  // Before MT_UART.h, which includes the target one as Onboard.h
+#include "MT.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_OPS        200000L  // Allocs and frees after the kick
+#define TEST_LONG_LIVED 24       // Allocations made before the kick
+#define TEST_LIVE_MAX   40       // Blocks held at once
+#define TEST_DRAIN_MAX  10       // Most ops between two drain requests
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// One record expected in the trace
+typedef struct
+{
+  uint16 time;
+  uint16 size;
+  uint16 file;
+  uint16 line;
+  uint8 *ptr;
+} testRec_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static testRec_t testExp[TEST_LONG_LIVED + 1 + TEST_OPS + TEST_LIVE_MAX];
+static long testExpCnt;   // Records expected so far
+static long testExpNext;  // Next record expected from the drain
+
+static void *testLive[TEST_LIVE_MAX];
+static uint16 testFile;   // OSALMEM_TRACE_FILE of this file
+static uint8 *testHeap;   // Block with id 0, from the first record drained
+
+static FILE *testOut;     // Drained responses for heap_replay
+static uint16 testLost;   // Records dropped, from the gap markers
+static long testGaps;
+
+static uint8 testRsp[256];
+static uint8 testRspLen;
+
+/*********************************************************************
+ * STUBS
+ */
+
+/*
+ * The transport allocates the frame and frees it once it is written,
+ * which would be recorded if the trace were not held.
+ */
+void MT_BuildAndSendZToolResponse( uint8 cmdType, uint8 cmdId, uint8 dataLen, uint8 *pData )
+{
+  uint8 *frame = osal_msg_allocate( dataLen + SPI_0DATA_MSG_LEN );
+
+  HOST_CHECK( frame != NULL );
+  HOST_CHECK( cmdType == ((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_DBG) );
+  HOST_CHECK( cmdId == MT_DEBUG_HEAP_TRACE );
+
+  memcpy( frame, pData, dataLen );
+  memcpy( testRsp, frame, dataLen );
+  testRspLen = dataLen;
+
+  osal_msg_deallocate( frame );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+#define MT_DEBUG_FUNC
+#include "MT_DEBUG.c"
+
+/*
+ * The file hash the trace records for a file name, as heap_replay does.
+ */
+static uint16 testFileHash( const char *name )
+{
+  size_t len = strlen( name );
+  uint16 hash = 0;
+  int n;
+
+  for ( n = OSALMEM_TRACE_FILE_CHARS; n > 0; n-- )
+  {
+    char c = name[(len >= (size_t)n) ? (len - n) : 0];
+
+    hash = (uint16)((hash * 31u) + ((c == '\\') ? '/' : c));
+  }
+
+  return ( hash );
+}
+
+/*
+ * Add a record to the sequence expected in the trace.
+ */
+static void testExpect( uint16 size, uint16 file, uint16 line, void *ptr )
+{
+  testRec_t *rec = &testExp[testExpCnt++];
+
+  rec->time = (uint16)hostOsalClock;
+  rec->size = size;
+  rec->file = file;
+  rec->line = line;
+  rec->ptr = ptr;
+}
+
+/*
+ * Alloc a block from this file, or from a stack library which has no
+ * site, and expect its record.
+ */
+static void *testAlloc( uint16 size, uint8 lib )
+{
+  void *ptr;
+  uint16 line;
+
+  if ( lib )
+  {
+    ptr = (osal_mem_alloc)( size ); line = 0;
+  }
+  else
+  {
+    ptr = osal_mem_alloc( size ); line = __LINE__;
+  }
+
+  testExpect( (ptr == NULL) ? (size | OSALMEM_TRACE_FAIL) : size, lib ? 0 : testFile, line, ptr );
+  return ( ptr );
+}
+
+static void testFree( void *ptr, uint8 lib )
+{
+  uint16 line;
+
+  if ( lib )
+  {
+    (osal_mem_free)( ptr ); line = 0;
+  }
+  else
+  {
+    osal_mem_free( ptr ); line = __LINE__;
+  }
+
+  testExpect( OSALMEM_TRACE_FREE, lib ? 0 : testFile, line, ptr );
+}
+
+/*
+ * Request one MT_DEBUG_HEAP_TRACE response, save it and check its
+ * records against the sequence. Return the number of records.
+ */
+static uint8 testDrain( void )
+{
+  uint8 *p = testRsp + 3;
+  uint8 cnt, x;
+
+  testRspLen = 0;
+  MT_DebugHeapTrace();
+
+  HOST_CHECK( testRspLen >= 3 );
+  cnt = testRsp[2];
+  HOST_CHECK( cnt <= MT_DEBUG_HEAP_TRACE_MAX );
+  HOST_CHECK( testRspLen == 3 + (cnt * MT_DEBUG_HEAP_TRACE_LEN) );
+  fwrite( testRsp, 1, testRspLen, testOut );
+
+  for ( x = 0; x < cnt; x++, p += MT_DEBUG_HEAP_TRACE_LEN )
+  {
+    uint16 size = BUILD_UINT16( p[2], p[3] );
+    uint16 id = BUILD_UINT16( p[8], p[9] );
+    testRec_t *exp;
+
+    if ( size == OSALMEM_TRACE_GAP )
+    {
+      // The dropped records are the next ones of the sequence
+      HOST_CHECK( (id != 0) && (BUILD_UINT16( p[4], p[5] ) == 0) );
+      testExpNext += id;
+      testLost += id;
+      testGaps++;
+      continue;
+    }
+
+    HOST_CHECK( testExpNext < testExpCnt );
+    exp = &testExp[testExpNext++];
+    HOST_CHECK( BUILD_UINT16( p[0], p[1] ) == exp->time );
+    HOST_CHECK( size == exp->size );
+    HOST_CHECK( BUILD_UINT16( p[4], p[5] ) == exp->file );
+    HOST_CHECK( BUILD_UINT16( p[6], p[7] ) == exp->line );
+    if ( exp->ptr == NULL )
+    {
+      HOST_CHECK( id == OSALMEM_TRACE_NO_ID );
+    }
+    else
+    {
+      // The id is the offset of the block in the heap
+      if ( testHeap == NULL )
+      {
+        testHeap = exp->ptr - id;
+      }
+      HOST_CHECK( exp->ptr == testHeap + id );
+    }
+  }
+
+  // The count in each response is the total dropped so far
+  HOST_CHECK( BUILD_UINT16( testRsp[0], testRsp[1] ) >= testLost );
+  HOST_CHECK( BUILD_UINT16( testRsp[0], testRsp[1] ) == osal_mem_trace_lost() );
+  return ( cnt );
+}
+
+/*
+ * Long-lived allocations, then the kick marker.
+ */
+static void testBoot( void )
+{
+  uint8 x;
+
+  osal_mem_init();
+
+  for ( x = 0; x < TEST_LONG_LIVED; x++ )
+  {
+    HOST_CHECK( testAlloc( 4 + (rand() % 24), (x % 3) == 0 ) != NULL );
+    if ( (x % 5) == 0 )
+    {
+      testDrain();
+    }
+  }
+
+  osal_mem_kick();
+  testExpect( OSALMEM_TRACE_KICK, 0, 0, NULL );
+}
+
+/*
+ * A size like the ones a router allocates: timers, short messages, ZCL
+ * frames and now and then a large buffer.
+ */
+static uint16 testSize( void )
+{
+  int r = rand() % 100;
+
+  if ( r < 40 )
+    return ( 12 + (rand() % 5) );
+  else if ( r < 80 )
+    return ( 20 + (rand() % 60) );
+  else if ( r < 97 )
+    return ( 80 + (rand() % 100) );
+  else
+    return ( 200 + (rand() % 400) );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * The file hash is a constant, the same as the one computed from the
+ * name.
+ */
+static void testSite( void )
+{
+  static const uint16 constHash = OSALMEM_TRACE_FILE;
+
+  testFile = OSALMEM_TRACE_FILE;
+  HOST_CHECK( testFile == testFileHash( __FILE__ ) );
+  HOST_CHECK( constHash == testFile );
+  HOST_CHECK( testFileHash( "C:\\Components\\zcl\\zcl.c" ) == testFileHash( "../zcl/zcl.c" ) );
+}
+
+/*
+ * Random traffic with random drains. Every record must be drained in
+ * order, or be accounted for by a gap marker.
+ */
+static void testTraffic( const char *path )
+{
+  long op;
+  int drainIn = 1;
+  uint8 x;
+
+  testOut = fopen( path, "wb" );
+  HOST_CHECK( testOut != NULL );
+
+  testBoot();
+
+  for ( op = 0; op < TEST_OPS; op++ )
+  {
+    uint8 slot = rand() % TEST_LIVE_MAX;
+    uint8 lib = (rand() % 4) == 0;
+
+    hostOsalClock += rand() % 3;
+
+    if ( testLive[slot] == NULL )
+    {
+      testLive[slot] = testAlloc( testSize(), lib );
+    }
+    else
+    {
+      testFree( testLive[slot], lib );
+      testLive[slot] = NULL;
+    }
+
+    if ( --drainIn == 0 )
+    {
+      testDrain();
+      drainIn = 1 + (rand() % TEST_DRAIN_MAX);
+    }
+  }
+
+  for ( x = 0; x < TEST_LIVE_MAX; x++ )
+  {
+    if ( testLive[x] != NULL )
+    {
+      testFree( testLive[x], FALSE );
+      testLive[x] = NULL;
+    }
+  }
+
+  while ( testDrain() != 0 )
+  {
+    // The rest of the trace
+  }
+  HOST_CHECK( testExpNext == testExpCnt );
+  HOST_CHECK( testLost == osal_mem_trace_lost() );
+
+  fclose( testOut );
+
+  printf( "%ld records, %u dropped in %ld gaps, written to %s\n",
+          testExpCnt, testLost, testGaps, path );
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( int argc, char *argv[] )
+{
+  srand( 9 );
+
+  testSite();
+  testTraffic( (argc > 1) ? argv[1] : "heap_trace.bin" );
+
+  printf( "test_heap_trace passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
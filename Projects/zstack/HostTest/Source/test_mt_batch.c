@@ -0,0 +1,332 @@
+/**************************************************************************************************
+  Filename:       test_mt_batch.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks MT AREQ batching: every message reaches the host once,
+                  in the order it was sent, and every container is framed
+                  as MT.h describes.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "MT.h"
+#include "MT_RPC.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_ROUNDS   200
+#define TEST_MSGS     300
+#define TEST_TASK_ID  3
+
+// Sequence number in the first two payload bytes of every message
+#define TEST_MSG_MIN  2
+
+// Bytes around each transport buffer, where the SOF and FCS would go
+#define TEST_GUARD    0xA5
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 MT_TaskID;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// What the host has received
+static uint16 rxSeq;
+static uint32 rxFrames;
+static uint32 rxContainers;
+static uint32 rxBatched;
+
+// Transport buffers allocated and not yet sent
+static int16 txOpen;
+
+// Current batch settings
+static uint8 batchMax;
+static uint16 batchDelay;
+
+// Frame length of each message sent, by sequence number
+static uint8 txFrameLen[0x10000];
+
+/*********************************************************************
+ * STUBS
+ */
+
+uint8 *MT_TransportAlloc( uint8 cmd0, uint8 len )
+{
+  uint8 *p = malloc( MT_RPC_FRAME_HDR_SZ + len + 2 );
+
+  HOST_CHECK( p != NULL );
+  txOpen++;
+
+  p[0] = TEST_GUARD;
+  p[MT_RPC_FRAME_HDR_SZ + len + 1] = TEST_GUARD;
+
+  return ( p + 1 );
+}
+
+/*
+ * The host end of the link: check a frame and take the messages in it.
+ */
+static void rxMessage( uint8 *pFrame )
+{
+  uint16 seq = BUILD_UINT16( pFrame[MT_RPC_POS_DAT0], pFrame[MT_RPC_POS_DAT0 + 1] );
+
+  HOST_CHECK_STEP( pFrame[MT_RPC_POS_LEN] >= TEST_MSG_MIN, rxFrames );
+  HOST_CHECK_STEP( pFrame[MT_RPC_POS_CMD1] == (uint8)(seq * 7), rxFrames );
+  HOST_CHECK_STEP( seq == rxSeq, rxFrames );
+
+  rxSeq++;
+  rxFrames++;
+}
+
+void MT_TransportSend( uint8 *pBuf )
+{
+  uint8 len = pBuf[MT_RPC_POS_LEN];
+
+  HOST_CHECK( (pBuf[-1] == TEST_GUARD) && (pBuf[MT_RPC_FRAME_HDR_SZ + len] == TEST_GUARD) );
+  HOST_CHECK( txOpen > 0 );
+  txOpen--;
+
+  if ( (pBuf[MT_RPC_POS_CMD0] == ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_SYS)) &&
+       (pBuf[MT_RPC_POS_CMD1] == MT_SYS_AREQ_BATCH_IND) )
+  {
+    uint8 *pFrame = pBuf + MT_RPC_POS_DAT0;
+    uint8 *pEnd = pFrame + len;
+
+    HOST_CHECK( batchMax != 0 );
+    HOST_CHECK( (len > 0) && (len <= batchMax) );
+
+    // The inner frames fill the container exactly
+    while ( pFrame < pEnd )
+    {
+      HOST_CHECK( (pFrame + MT_RPC_FRAME_HDR_SZ + pFrame[MT_RPC_POS_LEN]) <= pEnd );
+      HOST_CHECK( (pFrame[MT_RPC_POS_CMD0] & MT_RPC_CMD_TYPE_MASK) == MT_RPC_CMD_AREQ );
+      rxMessage( pFrame );
+      rxBatched++;
+      pFrame += MT_RPC_FRAME_HDR_SZ + pFrame[MT_RPC_POS_LEN];
+    }
+
+    rxContainers++;
+
+    // Nothing is left to time out
+    HOST_CHECK( hostOsalTimer( MT_TaskID, MT_AREQ_BATCH_EVT ) == 0 );
+  }
+  else
+  {
+    // Only what cannot be batched is sent on its own
+    HOST_CHECK( (batchMax == 0) ||
+                ((pBuf[MT_RPC_POS_CMD0] & MT_RPC_CMD_TYPE_MASK) != MT_RPC_CMD_AREQ) ||
+                ((MT_RPC_FRAME_HDR_SZ + len) > batchMax) );
+    rxMessage( pBuf );
+  }
+
+  free( pBuf - 1 );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Send one message, either way that MT offers.
+ */
+static void txMessage( uint16 seq, uint8 cmdType, uint8 len )
+{
+  uint8 buf[MT_RPC_DATA_MAX];
+  uint8 *pData = buf;
+  uint8 x;
+
+  if ( rand() % 2 )
+  {
+    pData = MT_ZToolRspAlloc( cmdType, (uint8)(seq * 7), len );
+    HOST_CHECK( pData != NULL );
+  }
+
+  pData[0] = LO_UINT16( seq );
+  pData[1] = HI_UINT16( seq );
+  for ( x = TEST_MSG_MIN; x < len; x++ )
+  {
+    pData[x] = rand();
+  }
+
+  if ( pData == buf )
+  {
+    MT_BuildAndSendZToolResponse( cmdType, (uint8)(seq * 7), len, buf );
+  }
+  else
+  {
+    MT_ZToolRspSend( pData );
+  }
+}
+
+/*
+ * Bytes of inner frames that MT holds: every message not yet received,
+ * since anything sent on its own goes out at once.
+ */
+static uint16 heldBytes( uint16 seq )
+{
+  uint16 bytes = 0;
+  uint16 x;
+
+  for ( x = rxSeq; x != seq; x++ )
+  {
+    bytes += txFrameLen[x];
+  }
+
+  return ( bytes );
+}
+
+/*
+ * Run the MT task for any batch event that is due, as MT_ProcessEvent
+ * does.
+ */
+static void runTask( void )
+{
+  if ( hostOsalTakeEvents( MT_TaskID ) & MT_AREQ_BATCH_EVT )
+  {
+    MT_AreqBatchFlush();
+  }
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testBatches( void )
+{
+  uint16 seq = 0;
+  uint16 round;
+
+  srand( 5 );
+  MT_TaskID = TEST_TASK_ID;
+
+  for ( round = 0; round < TEST_ROUNDS; round++ )
+  {
+    uint8 maxLen = rand() % (MT_RPC_DATA_MAX + 10);
+    uint16 delay = rand() % 3;
+    uint8 status;
+    uint16 n;
+
+    // Longer containers are cut to what a frame can carry
+    status = MT_AreqBatchCfg( maxLen, delay );
+    if ( maxLen > MT_RPC_DATA_MAX )
+    {
+      maxLen = MT_RPC_DATA_MAX;
+    }
+    HOST_CHECK( status == ( ((maxLen == 0) || (maxLen > MT_RPC_FRAME_HDR_SZ)) ?
+                            ZSuccess : ZInvalidParameter ) );
+
+    batchMax = ( status == ZSuccess ) ? maxLen : 0;
+    batchDelay = delay;
+
+    // The old batch was sent when batching was set up again
+    HOST_CHECK( rxSeq == seq );
+
+    for ( n = 0; n < TEST_MSGS; n++ )
+    {
+      uint8 r = rand() % 10;
+      uint8 cmdType = ( (r < 2) ? MT_RPC_CMD_SRSP : MT_RPC_CMD_AREQ ) | MT_RPC_SYS_ZDO;
+      uint8 len = TEST_MSG_MIN + (rand() % ((r == 2) ? (MT_RPC_DATA_MAX - 1) : 40));
+      uint8 wasEmpty = ( rxSeq == seq );
+      uint16 held;
+
+      txFrameLen[seq] = MT_RPC_FRAME_HDR_SZ + len;
+      txMessage( seq++, cmdType, len );
+      held = heldBytes( seq );
+
+      // A batch is sent once not even an empty message fits
+      HOST_CHECK_STEP( (held == 0) || ((held + MT_RPC_FRAME_HDR_SZ) <= batchMax), seq );
+
+      // The first message in a batch starts its timeout
+      if ( wasEmpty && (held != 0) )
+      {
+        if ( batchDelay == 0 )
+        {
+          HOST_CHECK_STEP( osal_get_timeoutEx( MT_TaskID, MT_AREQ_BATCH_EVT ) == 0, seq );
+        }
+        else
+        {
+          HOST_CHECK_STEP( hostOsalTimer( MT_TaskID, MT_AREQ_BATCH_EVT ) == batchDelay, seq );
+        }
+      }
+
+      HOST_CHECK_STEP( txOpen == 0, seq );
+
+      if ( (rand() % 16) == 0 )
+      {
+        // The batch timer runs out
+        if ( osal_get_timeoutEx( MT_TaskID, MT_AREQ_BATCH_EVT ) != 0 )
+        {
+          osal_stop_timerEx( MT_TaskID, MT_AREQ_BATCH_EVT );
+          osal_set_event( MT_TaskID, MT_AREQ_BATCH_EVT );
+        }
+        runTask();
+        HOST_CHECK_STEP( rxSeq == seq, seq );
+      }
+    }
+  }
+
+  MT_AreqBatchCfg( 0, 0 );
+  runTask();
+
+  HOST_CHECK( rxSeq == seq );
+  HOST_CHECK( hostOsalBlocks == 0 );
+
+  printf( "batch: %u messages, %lu in %lu containers\n",
+          seq, (unsigned long)rxBatched, (unsigned long)rxContainers );
+}
+
+int main( void )
+{
+  testBatches();
+
+  printf( "test_mt_batch passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,309 @@
+/**************************************************************************************************
+  Filename:       test_mt_ind.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host benchmark of AF indications to the host through
+                  MT_AfIncomingMsg, serialized into the transport buffer,
+                  against the heap buffer copied by
+                  MT_BuildAndSendZToolResponse that it replaced: the
+                  indications per second, and the allocations and bytes
+                  copied for each.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OnBoard.h"  // Before MT_UART.h, which includes the target one as Onboard.h
+#include "AF.h"
+#include "MT.h"
+#include "MT_AF.h"
+#include "MT_RPC.h"
+#include "MT_UART.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_INDS       200000L // Indications of each size, each way
+#define TEST_TASK_ID    3
+
+// Header bytes of an indication with a short source address, ahead of the
+// data, and the MAC source address and radius after it
+#define TEST_IND_HDR    17
+#define TEST_IND_LEN    20
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 MT_TaskID;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// A ZCL report, a read response and a large read response
+static const uint8 testSizes[] = { 8, 40, 80 };
+
+// The indication, with room for the largest data
+static afIncomingMSGPacket_t testPkt;
+static uint8 testData[80];
+
+// What the host has received
+static uint32 rxFrames;
+static uint8 rxFrame[SPI_0DATA_MSG_LEN + MT_RPC_DATA_MAX];
+static uint8 rxLen;
+
+// Bytes copied by osal_memcpy()
+static uint32 testCopied;
+
+/*********************************************************************
+ * STUBS
+ */
+
+/*
+ * The transport of MT_TASK.c: one OSAL message with room for the SOF and
+ * FCS around the frame.
+ */
+uint8 *MT_TransportAlloc( uint8 cmd0, uint8 len )
+{
+  uint8 *p = osal_msg_allocate( len + SPI_0DATA_MSG_LEN );
+
+  (void)cmd0;
+
+  return ( ( p != NULL ) ? ( p + 1 ) : NULL );
+}
+
+/*
+ * The host end of the link: frame the message as MT_TASK.c does and keep
+ * the last one.
+ */
+void MT_TransportSend( uint8 *pBuf )
+{
+  uint8 *msgPtr = pBuf - 1;
+  uint8 len = pBuf[MT_RPC_POS_LEN];
+  uint8 fcs = 0;
+  uint8 x;
+
+  msgPtr[0] = MT_UART_SOF;
+  for ( x = 0; x < MT_RPC_FRAME_HDR_SZ + len; x++ )
+  {
+    fcs ^= pBuf[x];
+  }
+  msgPtr[SPI_0DATA_MSG_LEN - 1 + len] = fcs;
+
+  rxLen = SPI_0DATA_MSG_LEN + len;
+  memcpy( rxFrame, msgPtr, rxLen );
+  rxFrames++;
+
+  osal_msg_deallocate( msgPtr );
+}
+
+/*
+ * Wrapped at link time to count the bytes the stack copies.
+ */
+extern void *__real_osal_memcpy( void *dst, const void GENERIC *src, unsigned int len );
+
+void *__wrap_osal_memcpy( void *dst, const void GENERIC *src, unsigned int len )
+{
+  testCopied += len;
+  return ( __real_osal_memcpy( dst, src, len ) );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * The MT_AfIncomingMsg() of the baseline for a short source address:
+ * serialized into a heap buffer, which MT_BuildAndSendZToolResponse()
+ * copies into the transport buffer.
+ */
+static void testBaseline( afIncomingMSGPacket_t *pMsg )
+{
+  uint8 dataLen = (uint8)pMsg->cmd.DataLength;
+  uint8 respLen = TEST_IND_LEN + dataLen;
+  uint8 *pRsp, *pTmp;
+
+  if ( ( pRsp = osal_mem_alloc( respLen ) ) == NULL )
+  {
+    return;
+  }
+  pTmp = pRsp;
+
+  *pTmp++ = LO_UINT16( pMsg->groupId );
+  *pTmp++ = HI_UINT16( pMsg->groupId );
+  *pTmp++ = LO_UINT16( pMsg->clusterId );
+  *pTmp++ = HI_UINT16( pMsg->clusterId );
+  *pTmp++ = LO_UINT16( pMsg->srcAddr.addr.shortAddr );
+  *pTmp++ = HI_UINT16( pMsg->srcAddr.addr.shortAddr );
+  *pTmp++ = pMsg->srcAddr.endPoint;
+  *pTmp++ = pMsg->endPoint;
+  *pTmp++ = pMsg->wasBroadcast;
+  *pTmp++ = pMsg->LinkQuality;
+  *pTmp++ = pMsg->SecurityUse;
+  pTmp = osal_buffer_uint32( pTmp, pMsg->timestamp );
+  *pTmp++ = pMsg->cmd.TransSeqNumber;
+  *pTmp++ = dataLen;
+  (void)osal_memcpy( pTmp, pMsg->cmd.Data, dataLen );
+  pTmp += dataLen;
+  *pTmp++ = LO_UINT16( pMsg->macSrcAddr );
+  *pTmp++ = HI_UINT16( pMsg->macSrcAddr );
+  *pTmp = pMsg->radius;
+
+  MT_BuildAndSendZToolResponse( ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_AF),
+                                MT_AF_INCOMING_MSG, respLen, pRsp );
+
+  (void)osal_mem_free( pRsp );
+}
+
+/*
+ * Send the indication TEST_INDS times one way. Return the indications per
+ * second, and the allocations and bytes copied for each.
+ */
+static double testRun( void (*send)( afIncomingMSGPacket_t * ), double *allocs, double *copied )
+{
+  uint32 frames = rxFrames;
+  uint32 a = hostOsalAllocs;
+  uint32 c = testCopied;
+  double usec;
+  long n;
+
+  usec = testUsec();
+  for ( n = 0; n < TEST_INDS; n++ )
+  {
+    testPkt.cmd.TransSeqNumber = (uint8)n;
+    send( &testPkt );
+  }
+  usec = testUsec() - usec;
+
+  HOST_CHECK( rxFrames - frames == TEST_INDS );
+  HOST_CHECK( hostOsalBlocks == 0 );
+
+  *allocs = (double)(hostOsalAllocs - a) / TEST_INDS;
+  *copied = (double)(testCopied - c) / TEST_INDS;
+
+  return ( TEST_INDS * 1e6 / usec );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testIndications( void )
+{
+  uint8 baseFrame[sizeof( rxFrame )];
+  uint8 baseLen;
+  uint8 s;
+
+  srand( 3 );
+  for ( s = 0; s < sizeof( testData ); s++ )
+  {
+    testData[s] = rand();
+  }
+
+  testPkt.groupId = 0;
+  testPkt.clusterId = 0x0402;
+  testPkt.srcAddr.addrMode = afAddr16Bit;
+  testPkt.srcAddr.addr.shortAddr = 0x1234;
+  testPkt.srcAddr.endPoint = 8;
+  testPkt.macSrcAddr = 0x1234;
+  testPkt.endPoint = 1;
+  testPkt.LinkQuality = 200;
+  testPkt.timestamp = 0x12345678;
+  testPkt.radius = 29;
+  testPkt.cmd.Data = testData;
+
+  for ( s = 0; s < sizeof( testSizes ); s++ )
+  {
+    double base, now;
+    double baseAllocs, baseCopied;
+    double allocs, copied;
+
+    testPkt.cmd.DataLength = testSizes[s];
+
+    base = testRun( testBaseline, &baseAllocs, &baseCopied );
+    memcpy( baseFrame, rxFrame, rxLen );
+    baseLen = rxLen;
+
+    now = testRun( MT_AfIncomingMsg, &allocs, &copied );
+
+    // The same frame either way
+    HOST_CHECK( rxLen == SPI_0DATA_MSG_LEN + TEST_IND_LEN + testSizes[s] );
+    HOST_CHECK( ( rxLen == baseLen ) && ( memcmp( rxFrame, baseFrame, rxLen ) == 0 ) );
+    HOST_CHECK( rxFrame[MT_RPC_FRAME_HDR_SZ + TEST_IND_HDR] == testSizes[s] );  // Data length
+
+    // One allocation and only the data copied, where it took two and the
+    // data copied twice
+    HOST_CHECK( ( allocs == 1.0 ) && ( copied == testSizes[s] ) );
+    HOST_CHECK( ( baseAllocs == 2.0 ) && ( baseCopied == TEST_IND_LEN + 2 * testSizes[s] ) );
+
+    printf( "%2u data bytes: %8.0f indications/sec, %.0f allocs, %3.0f bytes copied; "
+            "baseline %8.0f, %.0f allocs, %3.0f bytes copied\n", testSizes[s],
+            now, allocs, copied, base, baseAllocs, baseCopied );
+  }
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  MT_TaskID = TEST_TASK_ID;
+
+  testIndications();
+
+  printf( "test_mt_ind passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
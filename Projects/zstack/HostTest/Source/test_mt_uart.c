@@ -0,0 +1,922 @@
+/**************************************************************************************************
+  Filename:       test_mt_uart.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the MT UART frame parser, MT_UartProcessZToolData.
+                  Damaged frames ahead of good ones check that the parser
+                  resyncs without losing the good frame, a session of the
+                  commands a ZNP host sends is fuzzed with damaged frames
+                  and fed in random chunks, and the bytes per second are
+                  compared with the byte-at-a-time parser it replaced.
+                  Indications from MT.c are looped back through the parser
+                  one frame each and in MT_AREQ_BATCH containers.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OnBoard.h"  // Before MT_UART.h, which includes the target one as Onboard.h
+#include "hal_uart.h"
+#include "MT.h"
+#include "MT_RPC.h"
+#include "MT_UART.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK       1
+#define TEST_MT_TASK    2
+
+#define TEST_FUZZ_FRAMES 40000L // Frames of the fuzz stream
+#define TEST_BENCH_MB    8      // Bytes through each parser per chunk size, in MB
+#define TEST_DAMAGE      5      // Percent of the frames damaged in the fuzz stream
+
+#define TEST_LOOP_INDS   200000L // Indications through the loopback, each way
+#define TEST_LOOP_BURST  16      // Indications generated in one pass of the task
+#define TEST_LOOP_LEN    28      // MT_AF_INCOMING_MSG with 8 data bytes
+
+#define TEST_STREAM_MAX (4L * 1024 * 1024)
+#define TEST_FRAMES_MAX 200000L
+#define TEST_WINDOW     256     // Frames a delivery is looked for in, from the next one
+
+// Ways a frame is damaged
+#define TEST_FLIP       0       // One byte after the SOF changed
+#define TEST_TRUNCATE   1       // The last bytes lost
+#define TEST_FCS        2       // Bad FCS
+#define TEST_JUNK       3       // Stray SOF, length and noise before the frame
+#define TEST_DAMAGES    4
+
+// Checks of the delivered messages
+#define TEST_NONE       0
+#define TEST_COUNT      1       // Count the lost and false ones
+#define TEST_STRICT     2       // Also fail on a lost clean frame
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// A command of the session, with its data length range
+typedef struct
+{
+  uint8 cmd0;
+  uint8 cmd1;
+  uint8 lenMin;
+  uint8 lenMax;
+  uint8 weight;
+} testCmd_t;
+
+// A frame written to the stream, with whether it is expected back
+typedef struct
+{
+  uint32 pos;     // Offset of the LEN byte in the stream
+  uint8 len;      // Data length
+  uint8 clean;
+} testFrame_t;
+
+typedef void (*testParser_t)( uint8 port, uint8 event );
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+uint8 MT_TaskID;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// What a ZNP host sends while it reads every device of a network: the
+// discovery requests, ZCL reads through AF, the odd NV read and ping.
+static const testCmd_t testSession[] =
+{
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_SYS,  MT_SYS_PING,             0,   0,  2 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_SYS,  MT_SYS_OSAL_NV_READ,     3,   3,  1 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_UTIL, MT_UTIL_GET_DEVICE_INFO, 0,   0,  1 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_ZDO,  MT_ZDO_IEEE_ADDR_REQ,    4,   4,  3 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_ZDO,  MT_ZDO_ACTIVE_EP_REQ,    4,   4,  3 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_ZDO,  MT_ZDO_SIMPLE_DESC_REQ,  5,   5,  4 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_ZDO,  MT_ZDO_MGMT_LQI_REQ,     3,   3,  3 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_ZDO,  MT_ZDO_MGMT_RTG_REQ,     3,   3,  2 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_AF,   MT_AF_DATA_REQUEST,     15,  50, 20 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_AF,   MT_AF_DATA_REQUEST_EXT, 25, 120,  4 },
+  { MT_RPC_CMD_SREQ | MT_RPC_SYS_AF,   MT_AF_REGISTER,          9,  40,  1 },
+};
+#define TEST_SESSION_CMDS  (sizeof( testSession ) / sizeof( testSession[0] ))
+
+static uint8 *testStream;
+static uint32 testStreamLen;
+static testFrame_t *testFrames;
+static long testFrameCnt;
+
+// The UART: bytes of the stream received so far, and the Rx buffer
+static uint32 uartRx;
+static uint8 uartBuf[MT_UART_RX_BUFF_MAX];
+static uint16 uartHead;
+static uint16 uartTail;
+
+// Delivery check
+static long testNext;          // Next frame that may be delivered
+static uint32 testDelivered;
+static uint32 testLost;        // Clean frames never delivered
+static uint32 testFalse;       // Deliveries that match no frame
+static uint8 testLostOk;       // A false delivery may have swallowed frames
+static uint8 testMode;         // TEST_COUNT or TEST_STRICT
+
+// The previous parser, kept to compare with
+static uint8 baseState;
+static uint8 baseLen;
+static uint8 baseDataLen;
+static mtOSALSerialData_t *baseMsg;
+
+// The loopback: indications the host took, and the frames and bytes that
+// carried them
+static uint32 loopInds;
+static uint32 loopFrames;
+static uint32 loopBytes;
+
+/*********************************************************************
+ * STUBS
+ */
+
+/*
+ * The Rx buffer is a ring read a byte at a time, as in _hal_uart_isr.c,
+ * so that each read costs what it does on the target.
+ */
+uint16 Hal_UART_RxBufLen( uint8 port )
+{
+  int16 length = uartTail;
+  (void)port;
+
+  length -= uartHead;
+  if ( length < 0 )
+    length += MT_UART_RX_BUFF_MAX;
+
+  return ( (uint16)length );
+}
+
+uint16 HalUARTRead( uint8 port, uint8 *pBuffer, uint16 length )
+{
+  uint16 cnt, idx;
+
+  cnt = Hal_UART_RxBufLen( port );
+  if ( cnt < length )
+  {
+    length = cnt;
+  }
+
+  idx = uartHead;
+  for ( cnt = 0; cnt < length; cnt++ )
+  {
+    pBuffer[cnt] = uartBuf[idx++];
+    if ( idx >= MT_UART_RX_BUFF_MAX )
+    {
+      idx = 0;
+    }
+  }
+  uartHead = idx;
+
+  return ( length );
+}
+
+/*
+ * The transport of MT_TASK.c: one OSAL message with room for the SOF and
+ * FCS around the frame.
+ */
+uint8 *MT_TransportAlloc( uint8 cmd0, uint8 len )
+{
+  uint8 *p = osal_msg_allocate( len + SPI_0DATA_MSG_LEN );
+
+  (void)cmd0;
+
+  return ( ( p != NULL ) ? ( p + 1 ) : NULL );
+}
+
+static void testLoopWrite( const uint8 *pBuf, uint16 len );
+
+/*
+ * Frame the message as MT_TASK.c does, and write it to the loopback.
+ */
+void MT_TransportSend( uint8 *pBuf )
+{
+  uint8 *msgPtr = pBuf - 1;
+  uint8 len = pBuf[MT_RPC_POS_LEN];
+
+  msgPtr[0] = MT_UART_SOF;
+  msgPtr[SPI_0DATA_MSG_LEN - 1 + len] = MT_UartCalcFCS( pBuf, MT_RPC_FRAME_HDR_SZ + len );
+
+  testLoopWrite( msgPtr, SPI_0DATA_MSG_LEN + len );
+  osal_msg_deallocate( msgPtr );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+// Built here, after the host OnBoard.h
+#include "MT_UART.c"
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * The MT_UartProcessZToolData() of the baseline, which reads the frame
+ * header a byte at a time and computes the FCS once the frame is in.
+ */
+static void testBaseline( uint8 port, uint8 event )
+{
+  uint8 ch;
+  uint8 bytesInRxBuffer;
+
+  (void)event;
+
+  while ( Hal_UART_RxBufLen( port ) )
+  {
+    HalUARTRead( port, &ch, 1 );
+
+    switch ( baseState )
+    {
+      case 0:  // SOP
+        if ( ch == MT_UART_SOF )
+          baseState = 1;
+        break;
+
+      case 1:  // LEN
+        baseLen = ch;
+        baseDataLen = 0;
+        baseMsg = (mtOSALSerialData_t *)osal_msg_allocate( sizeof ( mtOSALSerialData_t ) +
+                                                           MT_RPC_FRAME_HDR_SZ + baseLen );
+        if ( baseMsg == NULL )
+        {
+          baseState = 0;
+          return;
+        }
+        baseMsg->hdr.event = CMD_SERIAL_MSG;
+        baseMsg->msg = (uint8 *)(baseMsg + 1);
+        baseMsg->msg[MT_RPC_POS_LEN] = baseLen;
+        baseState = 2;
+        break;
+
+      case 2:  // CMD0
+        baseMsg->msg[MT_RPC_POS_CMD0] = ch;
+        baseState = 3;
+        break;
+
+      case 3:  // CMD1
+        baseMsg->msg[MT_RPC_POS_CMD1] = ch;
+        baseState = ( baseLen ) ? 4 : 5;
+        break;
+
+      case 4:  // DATA
+        baseMsg->msg[MT_RPC_FRAME_HDR_SZ + baseDataLen++] = ch;
+        bytesInRxBuffer = (uint8)Hal_UART_RxBufLen( port );
+        if ( bytesInRxBuffer > (baseLen - baseDataLen) )
+        {
+          bytesInRxBuffer = baseLen - baseDataLen;
+        }
+        HalUARTRead( port, &baseMsg->msg[MT_RPC_FRAME_HDR_SZ + baseDataLen], bytesInRxBuffer );
+        baseDataLen += bytesInRxBuffer;
+        if ( baseDataLen == baseLen )
+          baseState = 5;
+        break;
+
+      case 5:  // FCS
+        if ( MT_UartCalcFCS( baseMsg->msg, MT_RPC_FRAME_HDR_SZ + baseLen ) == ch )
+        {
+          osal_msg_send( TEST_TASK, (uint8 *)baseMsg );
+        }
+        else
+        {
+          osal_msg_deallocate( (uint8 *)baseMsg );
+        }
+        baseState = 0;
+        break;
+    }
+  }
+}
+
+/*
+ * Append a frame to the stream. Return its index.
+ */
+static long testAddFrame( uint8 cmd0, uint8 cmd1, uint8 len, const uint8 *pData )
+{
+  uint8 *p = &testStream[testStreamLen];
+  testFrame_t *frame = &testFrames[testFrameCnt];
+  uint8 fcs;
+  uint8 x;
+
+  HOST_CHECK( (testStreamLen + len + MT_UART_FRAME_OVHD + MT_RPC_FRAME_HDR_SZ) < TEST_STREAM_MAX );
+  HOST_CHECK( testFrameCnt < TEST_FRAMES_MAX );
+
+  frame->pos = testStreamLen + 1;
+  frame->len = len;
+  frame->clean = TRUE;
+
+  *p++ = MT_UART_SOF;
+  *p++ = len;
+  *p++ = cmd0;
+  *p++ = cmd1;
+  fcs = len ^ cmd0 ^ cmd1;
+  for ( x = 0; x < len; x++ )
+  {
+    *p = ( pData != NULL ) ? pData[x] : (uint8)rand();
+    fcs ^= *p++;
+  }
+  *p++ = fcs;
+
+  testStreamLen = (uint32)(p - testStream);
+  return ( testFrameCnt++ );
+}
+
+/*
+ * Append the next command of the session.
+ */
+static long testAddCmd( void )
+{
+  int total = 0, r;
+  uint8 x;
+
+  for ( x = 0; x < TEST_SESSION_CMDS; x++ )
+  {
+    total += testSession[x].weight;
+  }
+
+  r = rand() % total;
+  for ( x = 0; r >= testSession[x].weight; x++ )
+  {
+    r -= testSession[x].weight;
+  }
+
+  return ( testAddFrame( testSession[x].cmd0, testSession[x].cmd1,
+                         testSession[x].lenMin +
+                         (rand() % (testSession[x].lenMax - testSession[x].lenMin + 1)), NULL ) );
+}
+
+/*
+ * Damage the last frame of the stream.
+ */
+static void testDamage( long idx, uint8 how )
+{
+  testFrame_t *frame = &testFrames[idx];
+  uint32 end = frame->pos + MT_RPC_FRAME_HDR_SZ + frame->len + 1;  // After the FCS
+
+  frame->clean = FALSE;
+
+  switch ( how )
+  {
+    case TEST_FLIP:
+      testStream[frame->pos + (rand() % (end - frame->pos))] ^= (uint8)(1 + (rand() % 255));
+      break;
+
+    case TEST_TRUNCATE:
+      testStreamLen -= 1 + (rand() % 4);
+      break;
+
+    case TEST_FCS:
+      testStream[end - 1] ^= (uint8)(1 + (rand() % 255));
+      break;
+
+    case TEST_JUNK:
+      {
+        // Move the frame back and put the noise in front of it
+        uint8 junk = 2 + (rand() % 6);
+        uint8 x;
+
+        memmove( &testStream[frame->pos - 1 + junk], &testStream[frame->pos - 1],
+                 end - frame->pos + 1 );
+        testStream[frame->pos - 1] = MT_UART_SOF;
+        for ( x = 1; x < junk; x++ )
+        {
+          testStream[frame->pos - 1 + x] = (uint8)rand();
+        }
+        testStreamLen += junk;
+        frame->pos += junk;
+        frame->clean = TRUE;  // Only the noise is damaged
+      }
+      break;
+  }
+}
+
+/*
+ * Check one delivered message against the frames of the stream.
+ */
+static void testCheck( mtOSALSerialData_t *msg )
+{
+  long x;
+
+  testDelivered++;
+  HOST_CHECK( msg->hdr.event == CMD_SERIAL_MSG );
+
+  for ( x = testNext; (x < testFrameCnt) && (x < testNext + TEST_WINDOW); x++ )
+  {
+    testFrame_t *frame = &testFrames[x];
+
+    if ( frame->clean && (msg->msg[MT_RPC_POS_LEN] == frame->len) &&
+         (memcmp( msg->msg, &testStream[frame->pos], MT_RPC_FRAME_HDR_SZ + frame->len ) == 0) )
+    {
+      break;
+    }
+  }
+
+  if ( (x == testFrameCnt) || (x == testNext + TEST_WINDOW) )
+  {
+    // Noise or a damaged frame that passed the FCS
+    testFalse++;
+    testLostOk = TRUE;
+    return;
+  }
+
+  // Frames are delivered in order, and a clean one is skipped only
+  // when a false delivery may have swallowed it
+  for ( ; testNext < x; testNext++ )
+  {
+    if ( testFrames[testNext].clean )
+    {
+      HOST_CHECK( testLostOk || (testMode != TEST_STRICT) );
+      testLost++;
+    }
+  }
+  testNext = x + 1;
+  testLostOk = FALSE;
+}
+
+/*
+ * Take the messages the parser delivered, checking them or not.
+ */
+static void testDrain( void )
+{
+  uint8 *msg;
+
+  while ( (msg = hostOsalTakeMsg( TEST_TASK )) != NULL )
+  {
+    if ( testMode != TEST_NONE )
+    {
+      testCheck( (mtOSALSerialData_t *)msg );
+    }
+    osal_msg_deallocate( msg );
+  }
+  hostOsalTakeEvents( TEST_TASK );
+}
+
+/*
+ * Receive the stream in chunks of 1 to chunkMax bytes, calling the
+ * parser after each, as the UART callback would be. A chunk is no
+ * larger than the room in the Rx buffer.
+ */
+static void testFeed( testParser_t parser, uint16 chunkMax, uint8 mode )
+{
+  testMode = mode;
+  uartRx = 0;
+  uartHead = uartTail = 0;
+  testNext = 0;
+  testDelivered = testLost = testFalse = 0;
+  testLostOk = FALSE;
+
+  while ( uartRx < testStreamLen )
+  {
+    uint16 cnt = ( chunkMax > 1 ) ? (1 + (rand() % chunkMax)) : 1;
+
+    if ( cnt > (MT_UART_RX_BUFF_MAX - 1 - Hal_UART_RxBufLen( 0 )) )
+    {
+      cnt = MT_UART_RX_BUFF_MAX - 1 - Hal_UART_RxBufLen( 0 );
+    }
+    if ( cnt > (testStreamLen - uartRx) )
+    {
+      cnt = (uint16)(testStreamLen - uartRx);
+    }
+    while ( cnt-- )
+    {
+      uartBuf[uartTail++] = testStream[uartRx++];
+      if ( uartTail >= MT_UART_RX_BUFF_MAX )
+      {
+        uartTail = 0;
+      }
+    }
+
+    parser( 0, HAL_UART_RX_TIMEOUT );
+    testDrain();
+  }
+}
+
+/*
+ * An indication taken by the host: they arrive in the order they were
+ * sent, batched or not.
+ */
+static void testLoopInd( uint8 *pFrame )
+{
+  uint16 seq = BUILD_UINT16( pFrame[MT_RPC_POS_DAT0], pFrame[MT_RPC_POS_DAT0 + 1] );
+
+  HOST_CHECK_STEP( pFrame[MT_RPC_POS_LEN] == TEST_LOOP_LEN, loopInds );
+  HOST_CHECK_STEP( pFrame[MT_RPC_POS_CMD0] == ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_AF),
+                   loopInds );
+  HOST_CHECK_STEP( pFrame[MT_RPC_POS_CMD1] == MT_AF_INCOMING_MSG, loopInds );
+  HOST_CHECK_STEP( seq == (uint16)loopInds, loopInds );
+
+  loopInds++;
+}
+
+/*
+ * The host reads what the loopback holds, and unpacks the containers.
+ */
+static void testLoopRx( void )
+{
+  mtOSALSerialData_t *msg;
+
+  MT_UartProcessZToolData( 0, HAL_UART_RX_TIMEOUT );
+
+  while ( (msg = (mtOSALSerialData_t *)hostOsalTakeMsg( TEST_TASK )) != NULL )
+  {
+    uint8 *pFrame = msg->msg;
+
+    loopFrames++;
+
+    if ( (pFrame[MT_RPC_POS_CMD0] == ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_SYS)) &&
+         (pFrame[MT_RPC_POS_CMD1] == MT_SYS_AREQ_BATCH_IND) )
+    {
+      uint8 *pInner = pFrame + MT_RPC_POS_DAT0;
+      uint8 *pEnd = pInner + pFrame[MT_RPC_POS_LEN];
+
+      while ( pInner < pEnd )
+      {
+        testLoopInd( pInner );
+        pInner += MT_RPC_FRAME_HDR_SZ + pInner[MT_RPC_POS_LEN];
+      }
+      HOST_CHECK( pInner == pEnd );
+    }
+    else
+    {
+      testLoopInd( pFrame );
+    }
+
+    osal_msg_deallocate( (uint8 *)msg );
+  }
+  hostOsalTakeEvents( TEST_TASK );
+}
+
+/*
+ * The UART from the device to the host, looped back into the Rx ring. The
+ * host reads whenever the ring is full.
+ */
+static void testLoopWrite( const uint8 *pBuf, uint16 len )
+{
+  loopBytes += len;
+
+  while ( len-- )
+  {
+    if ( Hal_UART_RxBufLen( 0 ) == (MT_UART_RX_BUFF_MAX - 1) )
+    {
+      testLoopRx();
+    }
+
+    uartBuf[uartTail++] = *pBuf++;
+    if ( uartTail >= MT_UART_RX_BUFF_MAX )
+    {
+      uartTail = 0;
+    }
+  }
+}
+
+/*
+ * Put both parsers back to waiting for a SOF, freeing a frame either
+ * was receiving.
+ */
+static void testResetParsers( void )
+{
+  if ( (state != SOP_STATE) && (state != LEN_STATE) )
+  {
+    osal_msg_deallocate( (uint8 *)pMsg );
+  }
+  state = SOP_STATE;
+
+  if ( baseState >= 2 )
+  {
+    osal_msg_deallocate( (uint8 *)baseMsg );
+  }
+  baseState = 0;
+}
+
+/*
+ * Start a new stream.
+ */
+static void testReset( void )
+{
+  testResetParsers();
+  testStreamLen = 0;
+  testFrameCnt = 0;
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * A damaged frame followed by good ones: the good ones must all come
+ * through, the first even when the damaged frame swallowed its start.
+ */
+static void testResync( void )
+{
+  static const uint8 dataFE[] = { 0x12, MT_UART_SOF, 0x03, 0x25, 0x01, 0x34, 0x12, 0x00, 0x00 };
+  static const uint16 chunks[] = { 1, 3, 17, 1000 };
+  uint8 how, c;
+
+  for ( how = 0; how < 6; how++ )
+  {
+    for ( c = 0; c < (sizeof( chunks ) / sizeof( chunks[0] )); c++ )
+    {
+      long bad, x;
+      uint32 baseOk;
+
+      testReset();
+
+      switch ( how )
+      {
+        case 0:  // Stray SOF and a long length ahead of a frame
+          testStream[testStreamLen++] = MT_UART_SOF;
+          testStream[testStreamLen++] = 0x40;
+          break;
+
+        case 1:  // Two stray SOFs, the second taken as the length
+          testStream[testStreamLen++] = MT_UART_SOF;
+          testStream[testStreamLen++] = MT_UART_SOF;
+          testStream[testStreamLen++] = 0x05;
+          break;
+
+        case 2:  // Frame cut short
+          testDamage( testAddFrame( 0x24, 0x01, 20, NULL ), TEST_TRUNCATE );
+          break;
+
+        case 3:  // Bad FCS
+          testDamage( testAddFrame( 0x25, 0x31, 3, NULL ), TEST_FCS );
+          break;
+
+        case 4:  // Bad FCS on a frame with a SOF in its data
+          testDamage( testAddFrame( 0x24, 0x01, sizeof( dataFE ), dataFE ), TEST_FCS );
+          break;
+
+        case 5:  // Frame cut short with a SOF in its data
+          testDamage( testAddFrame( 0x24, 0x01, sizeof( dataFE ), dataFE ), TEST_TRUNCATE );
+          break;
+      }
+
+      // The good frames, then pings for any length the noise still waits for
+      bad = testFrameCnt;
+      testAddFrame( 0x25, 0x04, 5, NULL );
+      testAddFrame( 0x24, 0x01, 30, NULL );
+      for ( x = 0; x < 60; x++ )
+      {
+        testAddFrame( 0x21, 0x01, 0, NULL );
+      }
+
+      testFeed( testBaseline, chunks[c], TEST_COUNT );
+      baseOk = testDelivered - testFalse;
+
+      testResetParsers();
+      testFeed( MT_UartProcessZToolData, chunks[c], TEST_STRICT );
+
+      HOST_CHECK( testFalse == 0 );
+      HOST_CHECK( testLost == 0 );
+      HOST_CHECK( testDelivered == (uint32)(testFrameCnt - bad) );
+
+      if ( c == 0 )
+      {
+        printf( "resync case %u: %lu of %ld good frames, the baseline %lu\n", how,
+                (unsigned long)testDelivered, testFrameCnt - bad, (unsigned long)baseOk );
+      }
+    }
+  }
+}
+
+/*
+ * The session with some frames damaged, in random chunks. Every clean
+ * frame comes through in order, unless noise that passed the FCS
+ * swallowed it.
+ */
+static void testFuzz( void )
+{
+  uint32 clean = 0, damaged = 0;
+  long x;
+
+  testReset();
+
+  for ( x = 0; x < TEST_FUZZ_FRAMES; x++ )
+  {
+    long idx = testAddCmd();
+
+    if ( (rand() % 100) < TEST_DAMAGE )
+    {
+      testDamage( idx, rand() % TEST_DAMAGES );
+    }
+  }
+  for ( x = 0; x < testFrameCnt; x++ )
+  {
+    clean += testFrames[x].clean;
+  }
+  damaged = testFrameCnt - clean;
+
+  testFeed( MT_UartProcessZToolData, 64, TEST_STRICT );
+  HOST_CHECK( (testDelivered - testFalse) == (clean - testLost) );
+  printf( "fuzz: %ld frames, %lu damaged: %lu clean delivered, %lu lost, %lu false\n",
+          testFrameCnt, (unsigned long)damaged, (unsigned long)(testDelivered - testFalse),
+          (unsigned long)testLost, (unsigned long)testFalse );
+
+  // Same stream through the baseline
+  testResetParsers();
+  testFeed( testBaseline, 64, TEST_COUNT );
+  printf( "fuzz, baseline: %lu clean delivered, %lu lost, %lu false\n",
+          (unsigned long)(testDelivered - testFalse), (unsigned long)testLost,
+          (unsigned long)testFalse );
+}
+
+/*
+ * Bytes per second through each parser with the session undamaged.
+ */
+static void testBench( void )
+{
+  static const uint16 chunks[] = { 1, 16, MT_UART_RX_BUFF_MAX };
+  uint8 c;
+
+  testReset();
+  while ( testStreamLen < (TEST_STREAM_MAX - 512) )
+  {
+    testAddCmd();
+  }
+
+  for ( c = 0; c < (sizeof( chunks ) / sizeof( chunks[0] )); c++ )
+  {
+    double usec, base, now;
+    int pass;
+    int passes = (int)((TEST_BENCH_MB * 1024.0 * 1024.0) / testStreamLen) + 1;
+
+    srand( c );
+    usec = testUsec();
+    for ( pass = 0; pass < passes; pass++ )
+    {
+      testResetParsers();
+      testFeed( testBaseline, chunks[c], TEST_NONE );
+    }
+    base = (testStreamLen * (double)passes) / (testUsec() - usec);
+
+    srand( c );
+    usec = testUsec();
+    for ( pass = 0; pass < passes; pass++ )
+    {
+      testResetParsers();
+      testFeed( MT_UartProcessZToolData, chunks[c], TEST_NONE );
+    }
+    now = (testStreamLen * (double)passes) / (testUsec() - usec);
+
+    printf( "reads of 1-%-3u bytes: baseline %6.1f MB/s, bulk parser %6.1f MB/s\n",
+            chunks[c], base, now );
+  }
+}
+
+/*
+ * Indications per second from MT through the loopback to the host, and
+ * the bytes and frames on the wire for each, sent a frame each and
+ * batched in containers as large as a frame carries.
+ */
+static void testLoopback( void )
+{
+  uint8 ind[TEST_LOOP_LEN];
+  double perFrame = 0;
+  uint8 batch;
+  uint8 x;
+
+  for ( x = 0; x < TEST_LOOP_LEN; x++ )
+  {
+    ind[x] = (uint8)rand();
+  }
+
+  MT_TaskID = TEST_MT_TASK;
+
+  for ( batch = 0; batch < 2; batch++ )
+  {
+    double usec, bytes, frames;
+    long n;
+
+    HOST_CHECK( MT_AreqBatchCfg( ( batch ) ? MT_RPC_DATA_MAX : 0, 0 ) == ZSuccess );
+
+    testResetParsers();
+    uartHead = uartTail = 0;
+    loopInds = loopFrames = loopBytes = 0;
+
+    usec = testUsec();
+    for ( n = 0; n < TEST_LOOP_INDS; n++ )
+    {
+      ind[0] = LO_UINT16( n );
+      ind[1] = HI_UINT16( n );
+      MT_BuildAndSendZToolResponse( ((uint8)MT_RPC_CMD_AREQ | (uint8)MT_RPC_SYS_AF),
+                                    MT_AF_INCOMING_MSG, TEST_LOOP_LEN, ind );
+
+      // The end of a pass of the task, and the host reads what came
+      if ( ((n + 1) % TEST_LOOP_BURST) == 0 )
+      {
+        if ( hostOsalTakeEvents( MT_TaskID ) & MT_AREQ_BATCH_EVT )
+        {
+          MT_AreqBatchFlush();
+        }
+        testLoopRx();
+      }
+    }
+    usec = testUsec() - usec;
+
+    HOST_CHECK( MT_AreqBatchCfg( 0, 0 ) == ZSuccess );
+    testLoopRx();
+    HOST_CHECK( loopInds == TEST_LOOP_INDS );
+
+    bytes = (double)loopBytes / TEST_LOOP_INDS;
+    frames = (double)loopFrames / TEST_LOOP_INDS;
+    if ( batch )
+    {
+      // Fewer frames, and one SOF and FCS for all the indications in one
+      HOST_CHECK( frames < 1.0 );
+      HOST_CHECK( bytes < perFrame );
+    }
+    else
+    {
+      HOST_CHECK( loopFrames == TEST_LOOP_INDS );
+      HOST_CHECK( loopBytes == TEST_LOOP_INDS * (SPI_0DATA_MSG_LEN + TEST_LOOP_LEN) );
+      perFrame = bytes;
+    }
+
+    printf( "loopback %s: %8.0f indications/sec, %.2f bytes and %.3f frames on the wire each\n",
+            ( batch ) ? "batched  " : "per frame", TEST_LOOP_INDS * 1e6 / usec, bytes, frames );
+  }
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  testStream = malloc( TEST_STREAM_MAX );
+  testFrames = malloc( TEST_FRAMES_MAX * sizeof( testFrame_t ) );
+  HOST_CHECK( (testStream != NULL) && (testFrames != NULL) );
+
+  srand( 7 );
+  MT_UartRegisterTaskID( TEST_TASK );
+
+  testResync();
+  testFuzz();
+  testBench();
+  testLoopback();
+
+  // Nothing the parser allocated is left, replay buffers included
+  testResetParsers();
+  HOST_CHECK( hostOsalBlocks == 0 );
+
+  free( testFrames );
+  free( testStream );
+
+  printf( "test_mt_uart passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
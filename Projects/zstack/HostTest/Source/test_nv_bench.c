@@ -0,0 +1,548 @@
+/**************************************************************************************************
+  Filename:       test_nv_bench.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Replays ZDiags, frame counter and binding table NV traffic
+                  through an OSAL NV driver and the RAM flash in host_flash.c.
+                  Reports operations per second, bytes erased per byte
+                  written and page compactions, and cuts the power at random
+                  flash words to check that every item survives a reboot.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Nv.h"
+#include "nwk_globals.h"
+#include "AddrMgr.h"
+#include "BindingTable.h"
+#include "NLMEDE.h"
+#include "APSMEDE.h"
+#include "ssp.h"
+#include "ZDiags.h"
+#include "bdb_interface.h"
+#include "host_flash.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_OPS        20000L  // Operations per timed workload
+#define TEST_CUTS       1500L   // Power cuts per workload
+#define TEST_APS_KEYS   8       // APS link keys with frame counters
+#define TEST_MAC_CNTS   6       // MAC diagnostics counters
+#define TEST_EPS        3       // Binding source endpoints
+#define TEST_CLUSTERS   6       // Binding cluster IDs
+#define TEST_DSTS       8       // Binding destinations
+
+// The NWK frame counter is stored every MAX_NWK_FRAMECOUNTER_CHANGES frames
+#define TEST_NWK_FC_STEP  1000
+
+#if defined ( HAL_MCU_CC2538 )
+  #define TEST_DRIVER   "cc2538"
+#else
+  #define TEST_DRIVER   "cc2530"
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16 id;
+  uint16 len;
+} testItem_t;
+
+typedef struct
+{
+  const char *name;
+  void (*boot)( void );
+  void (*op)( void );
+} testWorkload_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// Normally in nwk_globals.c
+CONFIG_ITEM bindTableIndex_t gNWK_MAX_BINDING_ENTRIES = NWK_MAX_BINDING_ENTRIES;
+CONFIG_ITEM uint8 gMAX_BINDING_CLUSTER_IDS = MAX_BINDING_CLUSTER_IDS;
+CONST uint16 gBIND_REC_SIZE = sizeof( BindingEntry_t );
+BindingEntry_t BindingTable[NWK_MAX_BINDING_ENTRIES];
+
+// Normally in nwk_globals.c and bdb_FindingAndBinding.c
+nwkIB_t _NIB;
+bdbGCB_BindNotification_t pfnBindNotificationCB = NULL;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Items of a router image that the workloads do not touch, and must
+// survive every compaction and power cut unchanged
+static const testItem_t testStatic[] = {
+  { ZCD_NV_EXTADDR, Z_EXTADDR_LEN },
+  { ZCD_NV_STARTUP_OPTION, 1 },
+  { ZCD_NV_NIB, sizeof( nwkIB_t ) },
+  { ZCD_NV_ADDRMGR, 240 },
+  { ZCD_NV_POLL_RATE, 4 },
+  { ZCD_NV_EXTENDED_PAN_ID, Z_EXTADDR_LEN },
+  { ZCD_NV_NWK_ALTERN_KEY_INFO, sizeof( nwkActiveKeyItems ) },
+  { ZCD_NV_GROUP_TABLE, 170 },
+  { ZCD_NV_NWKKEY, 42 },
+  { ZCD_NV_PANID, 2 },
+  { ZCD_NV_CHANLIST, 4 },
+  { ZCD_NV_PRECFGKEY, SEC_KEY_LEN },
+  { ZCD_NV_USERDESC, 17 },
+  { ZCD_NV_TCLK_TABLE_START, 19 },
+  { ZCD_NV_BDBNODEISONANETWORK, 1 },
+};
+
+#define TEST_STATIC  (sizeof( testStatic ) / sizeof( testStatic[0] ))
+
+static uint8 testStaticData[TEST_STATIC][256];
+
+// Frame counters: what NV holds, and what the write in progress stores
+static uint32 fcNwk;
+static uint32 fcNwkNew;
+static uint32 fcAps[TEST_APS_KEYS];
+static uint32 fcApsNew[TEST_APS_KEYS];
+static int8 fcWriting = -1;  // Key being written, TEST_APS_KEYS for the NWK key
+static uint8 fcCreated;      // Items created, they must never be lost after that
+
+// MAC diagnostics PIB
+static uint32 macCnt[TEST_MAC_CNTS];
+
+/*********************************************************************
+ * STUBS - the MAC, address manager and NLME are in the closed libraries
+ */
+
+ZMacStatus_t ZMacGetReq( ZMacAttributes_t attr, byte *value )
+{
+  memcpy( value, &macCnt[(attr - ZMacDiagsRxCrcPass) % TEST_MAC_CNTS], sizeof( uint32 ) );
+  return ( ZMacSuccess );
+}
+
+byte *NLME_GetExtAddr( void )
+{
+  static uint8 extAddr[Z_EXTADDR_LEN];
+
+  return ( extAddr );
+}
+
+uint16 NLME_GetCoordShortAddr( void )
+{
+  return ( INVALID_NODE_ADDR );
+}
+
+void NLME_GetCoordExtAddr( byte *buf )
+{
+  memset( buf, 0, Z_EXTADDR_LEN );
+}
+
+uint8 nwkCreateDuplicateNV( uint16 srcId, uint16 dstId )
+{
+  return ( NV_OPER_FAILED );
+}
+
+uint8 AddrMgrEntryUpdate( AddrMgrEntry_t *entry )
+{
+  return ( TRUE );
+}
+
+uint8 AddrMgrEntryLookupNwk( AddrMgrEntry_t *entry )
+{
+  entry->index = entry->nwkAddr;
+  return ( TRUE );
+}
+
+uint8 AddrMgrEntryLookupExt( AddrMgrEntry_t *entry )
+{
+  entry->index = INVALID_NODE_ADDR;
+  return ( FALSE );
+}
+
+void AddrMgrExtAddrSet( uint8 *dstExtAddr, uint8 *srcExtAddr )
+{
+  memcpy( dstExtAddr, srcExtAddr, Z_EXTADDR_LEN );
+}
+
+uint8 AddrMgrEntryGet( AddrMgrEntry_t *entry )
+{
+  return ( FALSE );
+}
+
+uint8 AddrMgrEntryRelease( AddrMgrEntry_t *entry )
+{
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * Microseconds since an arbitrary start.
+ */
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * Fresh flash holding the static items.
+ */
+static void testReset( void )
+{
+  uint16 x, y;
+
+  hostFlashReset();
+  osal_nv_init( NULL );
+  fcCreated = FALSE;
+
+  for ( x = 0; x < TEST_STATIC; x++ )
+  {
+    for ( y = 0; y < testStatic[x].len; y++ )
+    {
+      testStaticData[x][y] = rand();
+    }
+    HOST_CHECK( osal_nv_item_init( testStatic[x].id, testStatic[x].len,
+                                   testStaticData[x] ) == NV_ITEM_UNINIT );
+  }
+
+  osal_nv_metrics_reset();
+}
+
+/*
+ * The static items must read back as written.
+ */
+static void checkStatic( long step )
+{
+  uint8 buf[256];
+  uint16 x;
+
+  for ( x = 0; x < TEST_STATIC; x++ )
+  {
+    HOST_CHECK_STEP( osal_nv_item_len( testStatic[x].id ) == testStatic[x].len, step );
+    HOST_CHECK_STEP( osal_nv_read( testStatic[x].id, 0, testStatic[x].len, buf ) == SUCCESS, step );
+    HOST_CHECK_STEP( memcmp( buf, testStaticData[x], testStatic[x].len ) == 0, step );
+  }
+}
+
+/*
+ * Take the page erase counts of the driver and of the flash model.
+ */
+static void takeErases( uint16 *nvErases, uint32 *flashErases )
+{
+  uint8 pg;
+
+  for ( pg = 0; pg < HAL_NV_PAGE_CNT; pg++ )
+  {
+    nvErases[pg] = osal_nv_page_erases( pg );
+    flashErases[pg] = hostFlashPageErases[HAL_NV_PAGE_BEG + pg];
+  }
+}
+
+/*********************************************************************
+ * WORKLOADS
+ */
+
+/*
+ * ZDiags: counters move and the table is saved now and then.
+ */
+static void zdiagsBoot( void )
+{
+  uint16 bootCnt = 0;
+
+  osal_nv_item_init( ZCD_NV_BOOTCOUNTER, sizeof( bootCnt ), &bootCnt );
+  memset( macCnt, 0, sizeof( macCnt ) );
+  HOST_CHECK( ZDiagsInitStats() == ZSuccess );
+}
+
+static void zdiagsOp( void )
+{
+  static const uint16 attrs[] = {
+    ZDIAGS_APS_TX_UCAST_SUCCESS, ZDIAGS_APS_RX_UCAST, ZDIAGS_RELAYED_UCAST,
+    ZDIAGS_NEIGHBOR_ADDED, ZDIAGS_ROUTE_DISC_INITIATED, ZDIAGS_APS_TX_UCAST_RETRY
+  };
+  uint8 x;
+
+  for ( x = 0; x < 8; x++ )
+  {
+    ZDiagsUpdateStats( attrs[rand() % (sizeof( attrs ) / sizeof( attrs[0] ))] );
+  }
+  macCnt[rand() % TEST_MAC_CNTS] += rand() % 5;
+
+  hostOsalClock++;
+  ZDiagsSaveStatsToNV();
+}
+
+/*
+ * Frame counters: the NWK outgoing counter and the APS link key counters
+ * are stored as they move.
+ */
+static void fcBoot( void )
+{
+  nwkActiveKeyItems keyItems;
+  APSME_LinkKeyData_t keyData;
+  uint8 x;
+
+  memset( &keyItems, 0, sizeof( keyItems ) );
+  keyItems.frameCounter = fcNwk;
+  if ( osal_nv_item_init( ZCD_NV_NWK_ACTIVE_KEY_INFO, sizeof( keyItems ), &keyItems ) != SUCCESS )
+  {
+    HOST_CHECK( !fcCreated );
+  }
+  else
+  {
+    // Whichever write was cut, what NV holds now is what it holds
+    HOST_CHECK( osal_nv_read( ZCD_NV_NWK_ACTIVE_KEY_INFO, 0, sizeof( keyItems ), &keyItems ) == SUCCESS );
+    HOST_CHECK( (fcWriting != TEST_APS_KEYS) ? (keyItems.frameCounter == fcNwk) :
+                ((keyItems.frameCounter == fcNwk) || (keyItems.frameCounter == fcNwkNew)) );
+    fcNwk = keyItems.frameCounter;
+  }
+
+  for ( x = 0; x < TEST_APS_KEYS; x++ )
+  {
+    memset( &keyData, 0, sizeof( keyData ) );
+    keyData.txFrmCntr = fcAps[x];
+    if ( osal_nv_item_init( ZCD_NV_APS_LINK_KEY_DATA_START + x, sizeof( keyData ), &keyData ) != SUCCESS )
+    {
+      HOST_CHECK( !fcCreated );
+    }
+    else
+    {
+      HOST_CHECK( osal_nv_read( ZCD_NV_APS_LINK_KEY_DATA_START + x, 0,
+                                sizeof( keyData ), &keyData ) == SUCCESS );
+      HOST_CHECK( (fcWriting != x) ? (keyData.txFrmCntr == fcAps[x]) :
+                  ((keyData.txFrmCntr == fcAps[x]) || (keyData.txFrmCntr == fcApsNew[x])) );
+      fcAps[x] = keyData.txFrmCntr;
+    }
+  }
+
+  fcWriting = -1;
+  fcCreated = TRUE;
+}
+
+static void fcOp( void )
+{
+  uint8 x = rand() % (TEST_APS_KEYS + 2);
+
+  if ( x >= TEST_APS_KEYS )
+  {
+    nwkActiveKeyItems keyItems;
+
+    memset( &keyItems, 0, sizeof( keyItems ) );
+    keyItems.frameCounter = fcNwkNew = fcNwk + TEST_NWK_FC_STEP;
+    fcWriting = TEST_APS_KEYS;
+    HOST_CHECK( osal_nv_write( ZCD_NV_NWK_ACTIVE_KEY_INFO, 0, sizeof( keyItems ), &keyItems ) == SUCCESS );
+    fcNwk = fcNwkNew;
+  }
+  else
+  {
+    fcApsNew[x] = fcAps[x] + 1 + (rand() % 64);
+    fcWriting = x;
+    HOST_CHECK( osal_nv_write( ZCD_NV_APS_LINK_KEY_DATA_START + x,
+                               offsetof( APSME_LinkKeyData_t, txFrmCntr ),
+                               sizeof( uint32 ), &fcApsNew[x] ) == SUCCESS );
+    fcAps[x] = fcApsNew[x];
+  }
+  fcWriting = -1;
+}
+
+/*
+ * Bindings: entries are added and removed, and the table is saved.
+ */
+static void bindBoot( void )
+{
+  InitBindingTable();
+  if ( BindInitNV() != NV_ITEM_UNINIT )
+  {
+    BindRestoreFromNV();
+  }
+}
+
+static void bindOp( void )
+{
+  uint8 ep = 1 + (rand() % TEST_EPS);
+  uint16 clusterID = rand() % TEST_CLUSTERS;
+  zAddrType_t dst;
+
+  dst.addrMode = (rand() % 2) ? AddrGroup : Addr16Bit;
+  dst.addr.shortAddr = rand() % TEST_DSTS;
+
+  if ( rand() % 2 )
+  {
+    bindAddEntry( ep, &dst, 1, 1, &clusterID );
+  }
+  else
+  {
+    BindingEntry_t *pBind = bindFindExisting( ep, &dst, 1 );
+
+    if ( (pBind != NULL) && !bindRemoveClusterIdFromList( pBind, clusterID ) )
+    {
+      bindRemoveEntry( pBind );
+    }
+  }
+
+  BindWriteNV();
+}
+
+static const testWorkload_t testWorkloads[] = {
+  { "zdiags", zdiagsBoot, zdiagsOp },
+  { "frame counters", fcBoot, fcOp },
+  { "bindings", bindBoot, bindOp },
+};
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Run a workload and report its rate and flash cost.
+ */
+static void testBench( const testWorkload_t *work )
+{
+  osalNvMetrics_t m;
+  uint16 nvErases[HAL_NV_PAGE_CNT];
+  uint32 flashErases[HAL_NV_PAGE_CNT];
+  uint32 minErases = 0xFFFFFFFF;
+  uint32 maxErases = 0;
+  uint32 totalErases = 0;
+  double usec;
+  long step;
+  uint8 pg;
+
+  srand( 1 );
+  testReset();
+  work->boot();
+  osal_nv_metrics_reset();
+  takeErases( nvErases, flashErases );
+
+  usec = testUsec();
+  for ( step = 0; step < TEST_OPS; step++ )
+  {
+    work->op();
+  }
+  usec = testUsec() - usec;
+
+  checkStatic( step );
+  osal_nv_metrics( &m );
+
+  // The driver's counters must match what the flash saw
+  for ( pg = 0; pg < HAL_NV_PAGE_CNT; pg++ )
+  {
+    uint32 erases = hostFlashPageErases[HAL_NV_PAGE_BEG + pg] - flashErases[pg];
+
+    HOST_CHECK( (uint16)(osal_nv_page_erases( pg ) - nvErases[pg]) == erases );
+    totalErases += erases;
+
+    minErases = MIN( minErases, erases );
+    maxErases = MAX( maxErases, erases );
+  }
+  HOST_CHECK( m.pageErases == totalErases );
+
+  printf( "%s %-14s %8.0f ops/s, %7lu B requested, %7lu B programmed, "
+          "%5.2f B erased/B, %4u compactions, page erases %lu-%lu\n",
+          TEST_DRIVER, work->name, (step * 1e6) / usec,
+          (unsigned long)m.bytesRequested, (unsigned long)m.bytesProgrammed,
+          m.bytesRequested ? ((double)m.bytesErased / m.bytesRequested) : 0.0,
+          m.compactions, (unsigned long)minErases, (unsigned long)maxErases );
+}
+
+/*
+ * Run a workload with the power cut after a random number of flash words,
+ * rebooting into osal_nv_init() each time.
+ */
+static void testPowerFail( const testWorkload_t *work )
+{
+  volatile long cuts = 0;
+  volatile long step = 0;
+
+  srand( 2 );
+  testReset();
+  work->boot();
+
+  while ( cuts < TEST_CUTS )
+  {
+    if ( setjmp( hostFlashPowerFail ) == 0 )
+    {
+      hostFlashFailAfter( 1 + (rand() % 200) );
+      for ( ; ; step++ )
+      {
+        work->op();
+      }
+    }
+
+    // Reboot
+    cuts++;
+    osal_nv_init( NULL );
+    checkStatic( step );
+    work->boot();
+  }
+
+  hostFlashFailAfter( 0 );
+  printf( "%s %-14s %ld power cuts in %ld ops recovered\n", TEST_DRIVER, work->name, (long)cuts, (long)step );
+}
+
+int main( void )
+{
+  uint8 x;
+
+  for ( x = 0; x < (sizeof( testWorkloads ) / sizeof( testWorkloads[0] )); x++ )
+  {
+    testBench( &testWorkloads[x] );
+    testPowerFail( &testWorkloads[x] );
+  }
+
+  printf( "test_nv_bench passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,308 @@
+/**************************************************************************************************
+  Filename:       test_nv_dir.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the CC2530 or CC2538 OSAL NV driver and its RAM
+                  directory, run over the RAM flash in host_flash.c. Checks
+                  the items against a model through random use and resets,
+                  and checks that a lookup of an Id never written does not
+                  scan flash. Reports the cost of a lookup miss and of the
+                  page scan at init.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "OSAL_Nv.h"
+#include "host_flash.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_IDS       150   // Item Ids 1 to TEST_IDS - 1 in the model check
+#define TEST_ITEM_MAX  32    // Largest item in the model check
+#define TEST_STEPS     100000L
+
+// More live items than the directory entries, 32 on the CC2530 and 128 on
+// the CC2538, with Ids 1 to TEST_LIVE_IDS
+#if defined ( HAL_MCU_CC2538 )
+  #define TEST_LIVE_IDS  144
+#else
+  #define TEST_LIVE_IDS  48
+#endif
+
+// Ids that were never written, hashing away from the live ones
+#define TEST_MISS_ID1  0x00F0
+#define TEST_MISS_ID2  0x0FE0
+
+// Id written and deleted, so a miss on it still scans the pages
+#define TEST_GONE_ID   0x0100
+
+#define TEST_TIMED     2000  // Lookups per timed figure
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// The model: what each item should hold
+static uint8 refData[TEST_IDS][TEST_ITEM_MAX];
+static uint16 refLen[TEST_IDS];
+static uint8 refLive[TEST_IDS];
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testModel( void )
+{
+  uint8 buf[TEST_ITEM_MAX];
+  long step;
+  uint16 x;
+
+  hostFlashReset();
+  osal_nv_init( NULL );
+  srand( 1 );
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    uint16 id = 1 + (rand() % (TEST_IDS - 1));
+    uint8 op = rand() % 10;
+
+    // The hot items are always created by the stack and are looked up
+    // without the directory
+    if ( (id == ZCD_NV_NWKKEY) || (id == ZCD_NV_NWK_ACTIVE_KEY_INFO) ||
+         (id == ZCD_NV_NWK_ALTERN_KEY_INFO) )
+    {
+      continue;
+    }
+
+    if ( op == 0 )
+    {
+      uint16 len = 1 + (rand() % TEST_ITEM_MAX);
+      uint8 ret;
+
+      for ( x = 0; x < len; x++ )
+      {
+        buf[x] = rand();
+      }
+
+      ret = osal_nv_item_init( id, len, buf );
+      if ( refLive[id] )
+      {
+        HOST_CHECK_STEP( ret == SUCCESS, step );
+      }
+      else
+      {
+        HOST_CHECK_STEP( ret == NV_ITEM_UNINIT, step );
+        refLive[id] = TRUE;
+        refLen[id] = len;
+        memcpy( refData[id], buf, len );
+      }
+    }
+    else if ( op < 5 )
+    {
+      uint16 ndx, len;
+
+      if ( !refLive[id] )
+      {
+        HOST_CHECK_STEP( osal_nv_write( id, 0, 1, buf ) == NV_ITEM_UNINIT, step );
+        continue;
+      }
+
+      ndx = rand() % refLen[id];
+      len = 1 + (rand() % (refLen[id] - ndx));
+      for ( x = 0; x < len; x++ )
+      {
+        buf[x] = rand();
+      }
+
+      HOST_CHECK_STEP( osal_nv_write( id, ndx, len, buf ) == SUCCESS, step );
+      memcpy( refData[id] + ndx, buf, len );
+    }
+    else if ( op < 9 )
+    {
+      if ( refLive[id] )
+      {
+        HOST_CHECK_STEP( osal_nv_item_len( id ) == refLen[id], step );
+        HOST_CHECK_STEP( osal_nv_read( id, 0, refLen[id], buf ) == SUCCESS, step );
+        HOST_CHECK_STEP( memcmp( buf, refData[id], refLen[id] ) == 0, step );
+      }
+      else
+      {
+        HOST_CHECK_STEP( osal_nv_item_len( id ) == 0, step );
+        HOST_CHECK_STEP( osal_nv_read( id, 0, 1, buf ) == NV_OPER_FAILED, step );
+      }
+    }
+    else if ( (rand() % 4) == 0 )
+    {
+      // Reset: the directory is rebuilt from the pages
+      osal_nv_init( NULL );
+    }
+    else if ( refLive[id] && ((rand() % 3) == 0) )
+    {
+      HOST_CHECK_STEP( osal_nv_delete( id, refLen[id] ) == SUCCESS, step );
+      refLive[id] = FALSE;
+    }
+  }
+
+  printf( "model: %ld steps, %lu page erases\n", step, (unsigned long)hostFlashErases );
+}
+
+/*
+ * Microseconds since an arbitrary start.
+ */
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * A miss must not touch flash. The CC2530 reads are counted, the CC2538
+ * ones are caught by locking the pages.
+ */
+static void checkMissNoScan( void )
+{
+  uint8 buf[1];
+  uint32 reads = hostFlashReads;
+
+#if defined ( HAL_MCU_CC2538 )
+  hostFlashLock( TRUE );
+#endif
+  HOST_CHECK( osal_nv_item_len( TEST_MISS_ID1 ) == 0 );
+  HOST_CHECK( osal_nv_read( TEST_MISS_ID2, 0, 1, buf ) == NV_OPER_FAILED );
+#if defined ( HAL_MCU_CC2538 )
+  hostFlashLock( FALSE );
+#endif
+  HOST_CHECK( hostFlashReads == reads );
+}
+
+static void testMissAfterEviction( void )
+{
+  uint8 buf[4];
+  uint32 reads;
+  double usec, missUsec, scanUsec;
+  uint16 id;
+  uint16 x;
+  uint8 pass;
+
+  hostFlashReset();
+  osal_nv_init( NULL );
+
+  for ( id = 1; id <= TEST_LIVE_IDS; id++ )
+  {
+    buf[0] = (uint8)id;
+    HOST_CHECK( osal_nv_item_init( id, 1, buf ) == NV_ITEM_UNINIT );
+  }
+  HOST_CHECK( osal_nv_item_init( TEST_GONE_ID, 1, buf ) == NV_ITEM_UNINIT );
+  HOST_CHECK( osal_nv_delete( TEST_GONE_ID, 1 ) == SUCCESS );
+
+  // First pass as created, second pass after a reset rescans the pages
+  for ( pass = 0; pass < 2; pass++ )
+  {
+    // Touch every item so the directory evicts entries
+    for ( id = 1; id <= TEST_LIVE_IDS; id++ )
+    {
+      HOST_CHECK( osal_nv_read( id, 0, 1, buf ) == SUCCESS );
+      HOST_CHECK( buf[0] == (uint8)id );
+    }
+
+    checkMissNoScan();
+
+    reads = hostFlashReads;
+    usec = testUsec();
+    osal_nv_init( NULL );
+    usec = testUsec() - usec;
+    if ( pass == 0 )
+    {
+      printf( "init: %lu items scanned in %.1f us", (unsigned long)TEST_LIVE_IDS, usec );
+#if !defined ( HAL_MCU_CC2538 )
+      printf( ", %lu flash reads", (unsigned long)(hostFlashReads - reads) );
+#endif
+      printf( "\n" );
+    }
+  }
+
+  // Items evicted from the directory are still found by the page scan
+  for ( id = 1; id <= TEST_LIVE_IDS; id++ )
+  {
+    HOST_CHECK( osal_nv_item_len( id ) == 1 );
+  }
+
+  // A miss on an Id never seen against one that scans the pages, which is
+  // what every miss cost once an entry had been evicted
+  reads = hostFlashReads;
+  missUsec = testUsec();
+  for ( x = 0; x < TEST_TIMED; x++ )
+  {
+    HOST_CHECK( osal_nv_item_len( TEST_MISS_ID1 ) == 0 );
+  }
+  missUsec = (testUsec() - missUsec) / TEST_TIMED;
+  HOST_CHECK( hostFlashReads == reads );
+
+  scanUsec = testUsec();
+  for ( x = 0; x < TEST_TIMED; x++ )
+  {
+    HOST_CHECK( osal_nv_item_len( TEST_GONE_ID ) == 0 );
+  }
+  scanUsec = (testUsec() - scanUsec) / TEST_TIMED;
+
+  printf( "miss: %.3f us for an Id never seen, %.3f us with a page scan",
+          missUsec, scanUsec );
+#if !defined ( HAL_MCU_CC2538 )
+  printf( ", %lu flash reads per scan", (unsigned long)((hostFlashReads - reads) / TEST_TIMED) );
+#endif
+  printf( "\n" );
+}
+
+int main( void )
+{
+  testModel();
+  testMissAfterEviction();
+
+  printf( "test_nv_dir passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
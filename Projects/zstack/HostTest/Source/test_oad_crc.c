@@ -0,0 +1,198 @@
+/**************************************************************************************************
+  Filename:       test_oad_crc.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OAD image CRC16 in the CC2530 hal_oad.c.
+                  Random images are written to the download area and the
+                  CRC check is compared with a bit-serial reference.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "comdef.h"
+#include "hal_oad.h"
+#include "host_flash.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_IMAGES     300
+#define TEST_IMAGE_MAX  (8 * HAL_FLASH_PAGE_SIZE)
+
+// First byte after the preamble
+#define TEST_IMAGE_MIN  (PREAMBLE_OFFSET + sizeof( preamble_t ))
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 image[TEST_IMAGE_MAX];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The CRC16 step as hal_oad.c ran it before the nibble table, one bit at
+ * a time.
+ */
+static uint16 refPoly( uint16 crc, uint8 val )
+{
+  const uint16 poly = 0x1021;
+  uint8 cnt;
+
+  for ( cnt = 0; cnt < 8; cnt++, val <<= 1 )
+  {
+    uint8 msb = (crc & 0x8000) ? 1 : 0;
+
+    crc <<= 1;
+    if ( val & 0x80 )  crc |= 0x0001;
+    if ( msb )         crc ^= poly;
+  }
+
+  return crc;
+}
+
+/*
+ * CRC of an image, skipping the four CRC bytes, with the two zero bytes
+ * run for the CRC itself.
+ */
+static uint16 refCrc( uint32 len )
+{
+  uint16 crc = 0;
+  uint32 oset;
+
+  for ( oset = 0; oset < len; oset++ )
+  {
+    if ( (oset < HAL_OAD_CRC_OSET) || (oset >= (HAL_OAD_CRC_OSET + 4)) )
+    {
+      crc = refPoly( crc, image[oset] );
+    }
+  }
+
+  crc = refPoly( crc, 0 );
+  crc = refPoly( crc, 0 );
+
+  return crc;
+}
+
+/*
+ * Write the image to the download area, a page at a time so that each
+ * page is erased first.
+ */
+static void writeImage( uint32 len )
+{
+  uint32 oset;
+
+  for ( oset = 0; oset < len; oset += HAL_FLASH_PAGE_SIZE )
+  {
+    uint32 cnt = len - oset;
+
+    if ( cnt > HAL_FLASH_PAGE_SIZE )
+    {
+      cnt = HAL_FLASH_PAGE_SIZE;
+    }
+
+    // Whole flash words, the tail of the buffer fills the last one
+    HalOADWrite( oset, image + oset, (uint16)((cnt + 3) & ~3), HAL_OAD_DL );
+  }
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testImages( void )
+{
+  uint16 n;
+
+  hostFlashReset();
+  srand( 7 );
+
+  for ( n = 0; n < TEST_IMAGES; n++ )
+  {
+    uint32 len = TEST_IMAGE_MIN + (rand() % (TEST_IMAGE_MAX - TEST_IMAGE_MIN - 3));
+    preamble_t preamble;
+    uint16 crc;
+    uint32 x;
+
+    for ( x = 0; x < TEST_IMAGE_MAX; x++ )
+    {
+      image[x] = rand();
+    }
+
+    memset( &preamble, 0, sizeof( preamble ) );
+    preamble.len = len;
+    memcpy( image + PREAMBLE_OFFSET, &preamble, sizeof( preamble ) );
+
+    crc = refCrc( len );
+    memcpy( image + HAL_OAD_CRC_OSET, &crc, sizeof( crc ) );
+    writeImage( len );
+    HOST_CHECK_STEP( HalOADChkDL( PREAMBLE_OFFSET ) == SUCCESS, n );
+
+    // The shadow CRC bytes are not part of the CRC
+    image[HAL_OAD_CRC_OSET + 2 + (rand() % 2)] ^= 0xFF;
+    writeImage( len );
+    HOST_CHECK_STEP( HalOADChkDL( PREAMBLE_OFFSET ) == SUCCESS, n );
+
+    // Every other byte is, up to the image length
+    do
+    {
+      x = rand() % len;
+    } while ( ((x >= HAL_OAD_CRC_OSET) && (x < (HAL_OAD_CRC_OSET + 4))) ||
+              ((x >= PREAMBLE_OFFSET) && (x < TEST_IMAGE_MIN)) );
+    image[x] ^= 1 << (rand() % 8);
+    writeImage( len );
+    HOST_CHECK_STEP( HalOADChkDL( PREAMBLE_OFFSET ) == FAILURE, n );
+  }
+
+  printf( "crc: %u images, %lu flash reads\n", n, (unsigned long)hostFlashReads );
+}
+
+int main( void )
+{
+  testImages();
+
+  printf( "test_oad_crc passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
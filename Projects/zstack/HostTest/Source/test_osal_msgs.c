@@ -0,0 +1,402 @@
+/**************************************************************************************************
+  Filename:       test_osal_msgs.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the per-task message queues of the real OSAL.c.
+                  Random sends at normal and high priority and to the front
+                  are checked against a model of each queue, including
+                  osal_msg_find() and osal_msg_count(), then send and
+                  receive are timed with a thousand messages queued.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "hal_types.h"  // Before hal_mcu.h, which includes the target one
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASKS      8
+#define TEST_EVENTS     4       // Event ids carried by the messages
+#define TEST_EVENT_BASE 0xC0
+
+#define TEST_STEPS      200000L // Model check
+#define TEST_MODEL_MAX  64      // Messages queued at most in the model check
+
+#define TEST_QUEUED     1000    // Messages queued during the benchmark
+#define TEST_BENCH_OPS  1000000L
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  osal_event_hdr_t hdr;
+  uint32 seq;
+} testMsg_t;
+
+// Model of one task queue: the sequence numbers in the order they will
+// be received, the first 'hiCnt' of them sent at high priority or to
+// the front.
+typedef struct
+{
+  uint32 seq[TEST_MODEL_MAX];
+  uint8 cnt;
+  uint8 hiCnt;
+} testQ_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+// The task table of an application, without tasks
+const uint8 tasksCnt = TEST_TASKS;
+uint16 *tasksEvents;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint16 testEvents[TEST_TASKS];
+static testQ_t testModel[TEST_TASKS];
+static uint32 testSeq;
+
+/*********************************************************************
+ * STUBS
+ */
+
+void osalInitTasks( void )
+{
+  tasksEvents = testEvents;
+  memset( testEvents, 0, sizeof( testEvents ) );
+}
+
+void halAssertHandler( void )
+{
+  printf( "HAL_ASSERT failed\n" );
+  abort();
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+static uint8 testEvent( uint32 seq )
+{
+  return ( TEST_EVENT_BASE + (uint8)(seq % TEST_EVENTS) );
+}
+
+/*
+ * Allocate and send the next message at a priority.
+ */
+static uint32 testSend( uint8 task, uint8 pri )
+{
+  testMsg_t *msg = (testMsg_t *)osal_msg_allocate( sizeof( testMsg_t ) );
+  uint8 status;
+
+  HOST_CHECK( msg != NULL );
+  msg->seq = testSeq++;
+  msg->hdr.event = testEvent( msg->seq );
+  msg->hdr.status = pri;
+
+  if ( pri == OSAL_MSG_PRI_FRONT )
+  {
+    status = osal_msg_push_front( task, (uint8 *)msg );
+  }
+  else
+  {
+    status = osal_msg_send_pri( task, (uint8 *)msg, pri );
+  }
+  HOST_CHECK( status == SUCCESS );
+
+  return ( msg->seq );
+}
+
+/*
+ * Add a message to the model: at the front, behind the other high
+ * priority ones, or at the back.
+ */
+static void testModelAdd( testQ_t *q, uint32 seq, uint8 pri )
+{
+  uint8 pos;
+
+  HOST_CHECK( q->cnt < TEST_MODEL_MAX );
+
+  if ( pri == OSAL_MSG_PRI_FRONT )
+  {
+    pos = 0;
+  }
+  else if ( pri == OSAL_MSG_PRI_HIGH )
+  {
+    pos = q->hiCnt;
+  }
+  else
+  {
+    pos = q->cnt;
+  }
+
+  memmove( &q->seq[pos + 1], &q->seq[pos], (q->cnt - pos) * sizeof( uint32 ) );
+  q->seq[pos] = seq;
+  q->cnt++;
+  if ( pri != OSAL_MSG_PRI_NORMAL )
+  {
+    q->hiCnt++;
+  }
+}
+
+/*
+ * Receive a message and check it is the next one of the model.
+ */
+static void testReceive( uint8 task, long step )
+{
+  testQ_t *q = &testModel[task];
+  testMsg_t *msg = (testMsg_t *)osal_msg_receive( task );
+
+  if ( q->cnt == 0 )
+  {
+    HOST_CHECK_STEP( msg == NULL, step );
+    return;
+  }
+
+  HOST_CHECK_STEP( msg != NULL, step );
+  HOST_CHECK_STEP( msg->seq == q->seq[0], step );
+  HOST_CHECK_STEP( msg->hdr.event == testEvent( msg->seq ), step );
+  HOST_CHECK_STEP( osal_msg_deallocate( (uint8 *)msg ) == SUCCESS, step );
+
+  memmove( &q->seq[0], &q->seq[1], (q->cnt - 1) * sizeof( uint32 ) );
+  q->cnt--;
+  if ( q->hiCnt != 0 )
+  {
+    q->hiCnt--;
+  }
+}
+
+/*
+ * The message event, count and find of a task match the model.
+ */
+static void testCompare( uint8 task, long step )
+{
+  testQ_t *q = &testModel[task];
+  uint8 event;
+
+  HOST_CHECK_STEP( ((testEvents[task] & SYS_EVENT_MSG) != 0) == (q->cnt != 0), step );
+  HOST_CHECK_STEP( osal_msg_count( task, 0xFF ) == q->cnt, step );
+
+  for ( event = TEST_EVENT_BASE; event < (TEST_EVENT_BASE + TEST_EVENTS); event++ )
+  {
+    osal_event_hdr_t *found = osal_msg_find( task, event );
+    uint8 cnt = 0, x;
+    int first = -1;
+
+    for ( x = 0; x < q->cnt; x++ )
+    {
+      if ( testEvent( q->seq[x] ) == event )
+      {
+        cnt++;
+        if ( first < 0 )
+        {
+          first = x;
+        }
+      }
+    }
+
+    HOST_CHECK_STEP( osal_msg_count( task, event ) == cnt, step );
+    if ( first < 0 )
+    {
+      HOST_CHECK_STEP( found == NULL, step );
+    }
+    else
+    {
+      HOST_CHECK_STEP( (found != NULL) && (((testMsg_t *)found)->seq == q->seq[first]), step );
+    }
+  }
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Random sends at each priority and receives, checked against the model.
+ */
+static void testOrder( void )
+{
+  long step;
+  uint8 task;
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    int r = rand() % 100;
+
+    task = rand() % TEST_TASKS;
+
+    if ( (r < 55) && (testModel[task].cnt < TEST_MODEL_MAX) )
+    {
+      uint8 pri = ( r < 5 ) ? OSAL_MSG_PRI_FRONT :
+                  ( r < 20 ) ? OSAL_MSG_PRI_HIGH : OSAL_MSG_PRI_NORMAL;
+
+      testModelAdd( &testModel[task], testSend( task, pri ), pri );
+    }
+    else
+    {
+      testReceive( task, step );
+    }
+
+    testCompare( task, step );
+  }
+
+  for ( task = 0; task < TEST_TASKS; task++ )
+  {
+    while ( testModel[task].cnt != 0 )
+    {
+      testReceive( task, step );
+    }
+    testCompare( task, step );
+  }
+}
+
+/*
+ * Bad sends are refused and do not leak the message.
+ */
+static void testInvalid( void )
+{
+  uint8 *msg = osal_msg_allocate( sizeof( testMsg_t ) );
+
+  HOST_CHECK( osal_msg_send_pri( TEST_TASKS, msg, OSAL_MSG_PRI_HIGH ) == INVALID_TASK );
+  HOST_CHECK( osal_msg_send( 0, NULL ) == INVALID_MSG_POINTER );
+  HOST_CHECK( osal_msg_receive( TEST_TASKS ) == NULL );
+  HOST_CHECK( osal_msg_count( TEST_TASKS, 0xFF ) == 0 );
+}
+
+/*
+ * Nanoseconds per send and receive with TEST_QUEUED messages waiting,
+ * spread over the tasks, one in ten at high priority.
+ */
+static void testBench( void )
+{
+  double usec, send = 0, receive = 0, count = 0;
+  testMsg_t *msgs[TEST_TASKS];
+  long op, x;
+
+  for ( x = 0; x < TEST_QUEUED; x++ )
+  {
+    testSend( rand() % TEST_TASKS, ((rand() % 10) == 0) ? OSAL_MSG_PRI_HIGH : OSAL_MSG_PRI_NORMAL );
+  }
+
+  for ( op = 0; op < TEST_BENCH_OPS; op += TEST_TASKS )
+  {
+    uint8 task;
+
+    usec = testUsec();
+    for ( task = 0; task < TEST_TASKS; task++ )
+    {
+      msgs[task] = (testMsg_t *)osal_msg_receive( task );
+    }
+    receive += testUsec() - usec;
+
+    // Messages go back to random tasks, the queues stay about the same length
+    usec = testUsec();
+    for ( task = 0; task < TEST_TASKS; task++ )
+    {
+      if ( msgs[task] != NULL )
+      {
+        uint8 dest = (uint8)((op + (task * 5)) % TEST_TASKS);
+
+        osal_msg_send_pri( dest, (uint8 *)msgs[task],
+                           ((op % 10) == 0) ? OSAL_MSG_PRI_HIGH : OSAL_MSG_PRI_NORMAL );
+      }
+    }
+    send += testUsec() - usec;
+
+    if ( (op % 1000) == 0 )
+    {
+      usec = testUsec();
+      osal_msg_count( op % TEST_TASKS, 0xFF );
+      count += testUsec() - usec;
+    }
+  }
+
+  x = 0;
+  for ( op = 0; op < TEST_TASKS; op++ )
+  {
+    x += osal_msg_count( (uint8)op, 0xFF );
+  }
+  HOST_CHECK( x == TEST_QUEUED );
+
+  printf( "%d messages queued on %d tasks: send %.1f ns, receive %.1f ns, "
+          "count %.0f ns per message\n", TEST_QUEUED, TEST_TASKS,
+          send * 1e3 / TEST_BENCH_OPS, receive * 1e3 / TEST_BENCH_OPS,
+          count * 1e3 / (TEST_BENCH_OPS / 1000) / (TEST_QUEUED / TEST_TASKS) );
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  srand( 10 );
+
+  HOST_CHECK( osal_init_system() == SUCCESS );
+
+  testOrder();
+  testInvalid();
+  testBench();
+
+  printf( "test_osal_msgs passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
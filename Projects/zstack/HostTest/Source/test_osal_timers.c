@@ -0,0 +1,456 @@
+/**************************************************************************************************
+  Filename:       test_osal_timers.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the OSAL timer wheel in OSAL_Timers.c. Random
+                  starts, restarts, stops and clock updates are checked
+                  against a model, past the timer pool and across a clock
+                  wrap, then start, stop, tick and next timeout are timed
+                  with 10, 100 and 1000 timers running.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Timers.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASKS      4       // Tasks of the model check
+#define TEST_EVENTS     16      // One timer per event bit
+#define TEST_TIMERS     (TEST_TASKS * TEST_EVENTS)
+#define TEST_STEPS      400000L
+
+#define TEST_POOL       24      // OSAL_TIMERS_MAX
+
+#define TEST_BENCH_OPS  200000L
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Model of one timer, on a clock that does not wrap
+typedef struct
+{
+  uint8 active;
+  uint64 expire;
+  uint32 reload;
+} testTimer_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static testTimer_t testModel[TEST_TIMERS];
+static uint64 testClock;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * Timers running in the model.
+ */
+static uint16 testActive( void )
+{
+  uint16 cnt = 0;
+  uint8 x;
+
+  for ( x = 0; x < TEST_TIMERS; x++ )
+  {
+    cnt += testModel[x].active;
+  }
+
+  return ( cnt );
+}
+
+/*
+ * Milliseconds left on a model timer, 0 once it has expired.
+ */
+static uint32 testLeft( testTimer_t *t )
+{
+  return ( (t->active && (t->expire > testClock)) ? (uint32)(t->expire - testClock) : 0 );
+}
+
+/*
+ * Start a timer in both, as osal_start_timerEx or osal_start_reload_timer.
+ */
+static void testStart( uint8 x, uint32 timeout, uint8 reload, long step )
+{
+  testTimer_t *t = &testModel[x];
+  uint8 task = x / TEST_EVENTS;
+  uint16 event = BV( x % TEST_EVENTS );
+  uint8 status;
+
+  if ( reload )
+  {
+    status = osal_start_reload_timer( task, event, timeout );
+    t->reload = timeout;
+  }
+  else
+  {
+    status = osal_start_timerEx( task, event, timeout );
+
+    // A restart keeps the reload timeout, a new timer has none
+    if ( !t->active )
+    {
+      t->reload = 0;
+    }
+  }
+  HOST_CHECK_STEP( status == SUCCESS, step );
+
+  t->active = TRUE;
+  t->expire = testClock + timeout;
+}
+
+/*
+ * Let time go by in both. The events set must be the ones of the model
+ * timers that expired, and those with a reload timeout start again from
+ * the new time.
+ */
+static void testUpdate( uint32 ms, long step )
+{
+  uint16 events[TEST_TASKS];
+  uint8 x;
+
+  memset( events, 0, sizeof( events ) );
+  osalTimerUpdate( ms );
+  testClock += ms;
+
+  for ( x = 0; x < TEST_TIMERS; x++ )
+  {
+    testTimer_t *t = &testModel[x];
+
+    if ( t->active && (t->expire <= testClock) )
+    {
+      events[x / TEST_EVENTS] |= BV( x % TEST_EVENTS );
+      if ( t->reload )
+      {
+        t->expire = testClock + t->reload;
+      }
+      else
+      {
+        t->active = FALSE;
+      }
+    }
+  }
+
+  for ( x = 0; x < TEST_TASKS; x++ )
+  {
+    HOST_CHECK_STEP( hostOsalTakeEvents( x ) == events[x], step );
+  }
+}
+
+/*
+ * Everything the timer API reports matches the model.
+ */
+static void testCompare( long step )
+{
+  uint32 next = OSAL_TIMERS_MAX_TIMEOUT;
+  uint16 active = testActive();
+  uint8 x;
+
+  HOST_CHECK_STEP( osal_GetSystemClock() == (uint32)testClock, step );
+  HOST_CHECK_STEP( osal_timer_num_active() == active, step );
+
+  // Records beyond the pool come from the heap
+  HOST_CHECK_STEP( hostOsalBlocks <= active, step );
+  HOST_CHECK_STEP( (active - hostOsalBlocks) <= TEST_POOL, step );
+
+  for ( x = 0; x < TEST_TIMERS; x++ )
+  {
+    uint32 left = testLeft( &testModel[x] );
+
+    HOST_CHECK_STEP( osal_get_timeoutEx( x / TEST_EVENTS, BV( x % TEST_EVENTS ) ) == left, step );
+    if ( testModel[x].active && (left < next) )
+    {
+      next = left;
+    }
+  }
+
+  // The earliest timeout, or 0 when no timer is running
+  HOST_CHECK_STEP( osal_next_timeout() == (active ? next : 0), step );
+}
+
+/*
+ * A timeout like the ones the stack uses: polls, retries, the odd long one.
+ */
+static uint32 testTimeout( void )
+{
+  int r = rand() % 100;
+
+  if ( r < 10 )
+    return ( 0 );
+  else if ( r < 60 )
+    return ( 1 + (rand() % 50) );
+  else if ( r < 95 )
+    return ( 50 + (rand() % 5000) );
+  else
+    return ( 5000 + (rand() % 200000) );
+}
+
+/*
+ * Time going by, mostly in ticks and now and then after a sleep.
+ */
+static uint32 testElapsed( void )
+{
+  int r = rand() % 100;
+
+  if ( r < 50 )
+    return ( 1 );
+  else if ( r < 60 )
+    return ( 0 );
+  else if ( r < 97 )
+    return ( rand() % 50 );
+  else
+    return ( 1000 + (rand() % 70000) );
+}
+
+/*
+ * Stop every timer and check that the heap records went back.
+ */
+static void testStopAll( long step )
+{
+  uint8 x;
+
+  for ( x = 0; x < TEST_TIMERS; x++ )
+  {
+    uint8 status = osal_stop_timerEx( x / TEST_EVENTS, BV( x % TEST_EVENTS ) );
+
+    HOST_CHECK_STEP( status == (testModel[x].active ? SUCCESS : INVALID_EVENT_ID), step );
+    testModel[x].active = FALSE;
+  }
+
+  HOST_CHECK_STEP( osal_timer_num_active() == 0, step );
+  HOST_CHECK_STEP( hostOsalBlocks == 0, step );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Random starts, restarts, stops and time going by, against the model.
+ * Half way the clock is moved to just before it wraps.
+ */
+static void testModelCheck( void )
+{
+  long step;
+
+  osalTimerInit();
+  testClock = 0;
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    uint8 x = rand() % TEST_TIMERS;
+    int r = rand() % 100;
+
+    if ( step == (TEST_STEPS / 2) )
+    {
+      testStopAll( step );
+      testUpdate( 0xFFFFF000 - (uint32)testClock, step );
+    }
+
+    if ( r < 35 )
+    {
+      testStart( x, testTimeout(), FALSE, step );
+    }
+    else if ( r < 45 )
+    {
+      testStart( x, 1 + (testTimeout() % 500), TRUE, step );
+    }
+    else if ( r < 60 )
+    {
+      uint8 status = osal_stop_timerEx( x / TEST_EVENTS, BV( x % TEST_EVENTS ) );
+
+      HOST_CHECK_STEP( status == (testModel[x].active ? SUCCESS : INVALID_EVENT_ID), step );
+      testModel[x].active = FALSE;
+    }
+    else
+    {
+      testUpdate( testElapsed(), step );
+    }
+
+    if ( (step % 7) == 0 )
+    {
+      testCompare( step );
+    }
+  }
+
+  testCompare( step );
+  HOST_CHECK( (uint32)(testClock >> 32) == 1 );
+  testStopAll( step );
+}
+
+/*
+ * A timeout past the longest one is clamped so that it still compares
+ * after the clock wraps.
+ */
+static void testLongest( void )
+{
+  osalTimerInit();
+
+  HOST_CHECK( osal_start_timerEx( 0, 0x0001, 0xFFFFFFFF ) == SUCCESS );
+  HOST_CHECK( osal_get_timeoutEx( 0, 0x0001 ) == 0x7FFFFFFF );
+  osalTimerUpdate( 0x7FFFFFFE );
+  HOST_CHECK( hostOsalTakeEvents( 0 ) == 0 );
+  osalTimerUpdate( 1 );
+  HOST_CHECK( hostOsalTakeEvents( 0 ) == 0x0001 );
+  HOST_CHECK( osal_timer_num_active() == 0 );
+}
+
+/*
+ * Nanoseconds per operation with n timers running, each with its own
+ * task and event value. Restarts keep the reload timeout.
+ */
+static void testBench( uint16 n )
+{
+  double usec;
+  double start, restart, stop, tick, next;
+  long op;
+  uint16 x;
+
+  osalTimerInit();
+
+  // New timers, started in rounds so that the cost is not a cold cache
+  start = 0;
+  for ( op = 0; op < TEST_BENCH_OPS; op += n )
+  {
+    if ( op != 0 )
+    {
+      for ( x = 0; x < n; x++ )
+      {
+        osal_stop_timerEx( x % 16, (x / 16) + 1 );
+      }
+    }
+
+    usec = testUsec();
+    for ( x = 0; x < n; x++ )
+    {
+      osal_start_reload_timer( x % 16, (x / 16) + 1, 100 + (x * 7) % 5000 );
+    }
+    start += testUsec() - usec;
+  }
+  start = start * 1e3 / TEST_BENCH_OPS;
+
+  usec = testUsec();
+  for ( op = 0; op < TEST_BENCH_OPS; op++ )
+  {
+    x = (uint16)(op % n);
+    osal_start_timerEx( x % 16, (x / 16) + 1, 100 + (op % 5000) );
+  }
+  restart = (testUsec() - usec) * 1e3 / TEST_BENCH_OPS;
+
+  usec = testUsec();
+  for ( op = 0; op < TEST_BENCH_OPS; op++ )
+  {
+    x = (uint16)(op % n);
+    osal_stop_timerEx( x % 16, (x / 16) + 1 );
+    osal_start_reload_timer( x % 16, (x / 16) + 1, 100 + (op % 5000) );
+  }
+  stop = (testUsec() - usec) * 1e3 / TEST_BENCH_OPS;
+
+  // The timers reload, so every tick leaves n running
+  usec = testUsec();
+  for ( op = 0; op < TEST_BENCH_OPS; op++ )
+  {
+    osalTimerUpdate( 1 );
+    for ( x = 0; x < 16; x++ )
+    {
+      hostOsalTakeEvents( x );
+    }
+  }
+  tick = (testUsec() - usec) * 1e3 / TEST_BENCH_OPS;
+  HOST_CHECK( osal_timer_num_active() == ((n > 0xFF) ? 0xFF : n) );
+
+  usec = testUsec();
+  for ( op = 0; op < TEST_BENCH_OPS; op++ )
+  {
+    x = (uint16)(op % n);
+    osal_stop_timerEx( x % 16, (x / 16) + 1 );
+    osal_next_timeout();
+    osal_start_reload_timer( x % 16, (x / 16) + 1, 100 + (op % 5000) );
+  }
+  next = ((testUsec() - usec) * 1e3 / TEST_BENCH_OPS) - stop;
+
+  for ( x = 0; x < n; x++ )
+  {
+    osal_stop_timerEx( x % 16, (x / 16) + 1 );
+  }
+  HOST_CHECK( hostOsalBlocks == 0 );
+
+  printf( "%4u timers: start %6.1f  restart %6.1f  stop+start %6.1f  tick %7.1f  "
+          "next_timeout %7.1f ns\n", n, start, restart, stop, tick, next );
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  srand( 1 );
+
+  testModelCheck();
+  testLongest();
+
+  testBench( 10 );
+  testBench( 100 );
+  testBench( 1000 );
+
+  printf( "test_osal_timers passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,232 @@
+/**************************************************************************************************
+  Filename:       hal_types.h
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks the block read CRC16 of the CC2530 OTA image check against
+                  the bit at a time CRC it replaced.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "comdef.h"
+#include "hal_ota.h"
+#include "ota_common.h"
+#include "host_flash.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_IMAGES     300
+#define TEST_IMAGE_MAX  (8 * HAL_FLASH_PAGE_SIZE)
+
+// Program size field, after the CRC and its shadow
+#define TEST_SIZE_OSET  (HAL_OTA_CRC_OSET + 4)
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 image[TEST_IMAGE_MAX];
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+/*
+ * The CRC16 step as hal_ota.c ran it before the nibble table, one bit at
+ * a time.
+ */
+static uint16 refPoly( uint16 crc, uint8 val )
+{
+  const uint16 poly = 0x1021;
+  uint8 cnt;
+
+  for ( cnt = 0; cnt < 8; cnt++, val <<= 1 )
+  {
+    uint8 msb = (crc & 0x8000) ? 1 : 0;
+
+    crc <<= 1;
+    if ( val & 0x80 )  crc |= 0x0001;
+    if ( msb )         crc ^= poly;
+  }
+
+  return crc;
+}
+
+/*
+ * CRC of a program, skipping the CRC and its shadow.
+ */
+static uint16 refCrc( uint8 *pProgram, uint32 len )
+{
+  uint16 crc = 0;
+  uint32 oset;
+
+  for ( oset = 0; oset < len; oset++ )
+  {
+    if ( (oset < HAL_OTA_CRC_OSET) || (oset >= (HAL_OTA_CRC_OSET + 4)) )
+    {
+      crc = refPoly( crc, pProgram[oset] );
+    }
+  }
+
+  return crc;
+}
+
+/*
+ * Write the OTA file to the download area, a page at a time so that
+ * each page is erased first.
+ */
+static void writeImage( uint32 len )
+{
+  uint32 oset;
+
+  for ( oset = 0; oset < len; oset += HAL_FLASH_PAGE_SIZE )
+  {
+    uint32 cnt = len - oset;
+
+    if ( cnt > HAL_FLASH_PAGE_SIZE )
+    {
+      cnt = HAL_FLASH_PAGE_SIZE;
+    }
+
+    // Whole flash words, the tail of the buffer fills the last one
+    HalOTAWrite( oset, image + oset, (uint16)((cnt + 3) & ~3), HAL_OTA_DL );
+  }
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testImages( void )
+{
+  uint16 n;
+
+  hostFlashReset();
+  srand( 9 );
+
+  for ( n = 0; n < TEST_IMAGES; n++ )
+  {
+    OTA_ImageHeader_t header;
+    uint16 hdrLen = sizeof( header ) + (rand() % 16);
+    uint32 start = hdrLen + OTA_SUB_ELEMENT_HDR_LEN;
+    uint32 size = (TEST_SIZE_OSET + 4) +
+                  (rand() % (TEST_IMAGE_MAX - start - TEST_SIZE_OSET - 8));
+    uint8 *pProgram = image + start;
+    uint16 crc;
+    uint32 x;
+
+    for ( x = 0; x < TEST_IMAGE_MAX; x++ )
+    {
+      image[x] = rand();
+    }
+
+    memcpy( &header, image, sizeof( header ) );
+    header.headerLength = hdrLen;
+    memcpy( image, &header, sizeof( header ) );
+
+    pProgram[TEST_SIZE_OSET]     = BREAK_UINT32( size, 0 );
+    pProgram[TEST_SIZE_OSET + 1] = BREAK_UINT32( size, 1 );
+    pProgram[TEST_SIZE_OSET + 2] = BREAK_UINT32( size, 2 );
+    pProgram[TEST_SIZE_OSET + 3] = BREAK_UINT32( size, 3 );
+
+    crc = refCrc( pProgram, size );
+    pProgram[HAL_OTA_CRC_OSET]     = LO_UINT16( crc );
+    pProgram[HAL_OTA_CRC_OSET + 1] = HI_UINT16( crc );
+    writeImage( start + size );
+    HOST_CHECK_STEP( HalOTAChkDL( 0 ) == SUCCESS, n );
+
+    // The shadow CRC is not part of the CRC
+    pProgram[HAL_OTA_CRC_OSET + 2 + (rand() % 2)] ^= 0xFF;
+    writeImage( start + size );
+    HOST_CHECK_STEP( HalOTAChkDL( 0 ) == SUCCESS, n );
+
+    // Neither are the bytes after the program
+    image[start + size + (rand() % 4)] ^= 0xFF;
+    writeImage( start + size + 4 );
+    HOST_CHECK_STEP( HalOTAChkDL( 0 ) == SUCCESS, n );
+
+    // Every other program byte is
+    do
+    {
+      x = rand() % size;
+    } while ( (x >= HAL_OTA_CRC_OSET) && (x < (TEST_SIZE_OSET + 4)) );
+    pProgram[x] ^= 1 << (rand() % 8);
+    writeImage( start + size );
+    HOST_CHECK_STEP( HalOTAChkDL( 0 ) == FAILURE, n );
+  }
+
+  printf( "crc: %u images, %lu flash reads\n", n, (unsigned long)hostFlashReads );
+}
+
+static void testBadSize( void )
+{
+  OTA_ImageHeader_t header;
+  uint32 start = sizeof( header ) + OTA_SUB_ELEMENT_HDR_LEN;
+  uint32 size;
+
+  hostFlashReset();
+  memset( image, 0, sizeof( image ) );
+  header.headerLength = sizeof( header );
+  memcpy( image, &header, sizeof( header ) );
+
+  // An empty program, or one larger than the download area, is rejected
+  size = 0;
+  memcpy( image + start + TEST_SIZE_OSET, &size, sizeof( size ) );
+  writeImage( TEST_IMAGE_MAX );
+  HOST_CHECK( HalOTAChkDL( 0 ) == FAILURE );
+
+  size = HAL_OTA_DL_MAX + 1;
+  memcpy( image + start + TEST_SIZE_OSET, &size, sizeof( size ) );
+  writeImage( TEST_IMAGE_MAX );
+  HOST_CHECK( HalOTAChkDL( 0 ) == FAILURE );
+}
+
+int main( void )
+{
+  testImages();
+  testBadSize();
+
+  printf( "test_ota_crc passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -0,0 +1,403 @@
+/**************************************************************************************************
+  Filename:       test_ota_image.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Checks the OTA client image parser: random images split into
+                  random blocks are parsed the same as byte by byte, the hash
+                  and signature fields are taken from the right spans, and
+                  broken images are rejected.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+// The parser and its state are static to zcl_ota.c
+#include "zcl_ota.c"
+
+#include "ota_signature.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_IMAGES      3000
+#define TEST_IMAGE_MAX   4096
+#define TEST_BLOCK_MAX   64
+
+#define TEST_HDR_LEN     56
+#define TEST_UNKNOWN_TAG 0x1234
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 image[TEST_IMAGE_MAX];
+static uint32 imageLen;
+
+// Where the signature bytes (after the signer address) and the
+// certificate are in image[]
+static uint32 sigOset;
+static uint32 certOset;
+
+// What the parser passed to the HAL and the hash
+static uint8 written[TEST_IMAGE_MAX];
+#if defined OTA_MMO_SIGN
+static uint8 hashed[TEST_IMAGE_MAX];
+static uint32 hashedLen;
+#endif
+static uint16 chkDLCalls;
+static uint8 chkDLStatus;
+static uint16 upgradeElems;
+
+/*********************************************************************
+ * STUBS
+ */
+
+void HalOTAWrite( uint32 oset, uint8 *pBuf, uint16 len, image_t type )
+{
+  HOST_CHECK( (type == HAL_OTA_DL) && ((oset + len) <= TEST_IMAGE_MAX) );
+  memcpy( written + oset, pBuf, len );
+}
+
+uint8 HalOTAChkDL( uint8 dlImagePreambleOffset )
+{
+  chkDLCalls++;
+  return ( chkDLStatus );
+}
+
+#if defined OTA_MMO_SIGN
+void OTA_CalculateMmoR3( OTA_MmoCtrl_t *pCtrl, uint8 *pData, uint8 len, uint8 lastBlock )
+{
+  // Only the last call may take part of a hash block
+  HOST_CHECK( lastBlock || (len == OTA_MMO_HASH_SIZE) );
+  HOST_CHECK( (hashedLen + len) <= TEST_IMAGE_MAX );
+  memcpy( hashed + hashedLen, pData, len );
+  hashedLen += len;
+}
+
+uint8 OTA_ValidateSignature( uint8 *pHash, uint8 *pCert, uint8 *pSig, uint8 *pIEEE )
+{
+  return ( ZSuccess );
+}
+#endif
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint32 addElement( uint32 oset, uint16 tag, uint32 len )
+{
+  uint32 x;
+
+  image[oset++] = LO_UINT16( tag );
+  image[oset++] = HI_UINT16( tag );
+  image[oset++] = BREAK_UINT32( len, 0 );
+  image[oset++] = BREAK_UINT32( len, 1 );
+  image[oset++] = BREAK_UINT32( len, 2 );
+  image[oset++] = BREAK_UINT32( len, 3 );
+
+  if ( tag == OTA_ECDSA_SIGNATURE_TAG_ID )
+  {
+    sigOset = oset + Z_EXTADDR_LEN;
+  }
+  else if ( tag == OTA_ECDSA_CERT_TAG_ID )
+  {
+    certOset = oset;
+  }
+  else if ( tag == OTA_UPGRADE_IMAGE_TAG_ID )
+  {
+    upgradeElems++;
+  }
+
+  for ( x = 0; x < len; x++ )
+  {
+    image[oset++] = rand();
+  }
+
+  return ( oset );
+}
+
+/*
+ * Build a random image: a header of random length, then the upgrade
+ * image and certificate elements with an unknown element, in random
+ * order. One in four images has a second upgrade element. The signature
+ * is last, as the OTA spec requires; the parser hashes nothing after it
+ * within a block.
+ */
+static void makeImage( void )
+{
+  uint16 tags[4] = { OTA_UPGRADE_IMAGE_TAG_ID, OTA_ECDSA_CERT_TAG_ID,
+                     TEST_UNKNOWN_TAG, OTA_UPGRADE_IMAGE_TAG_ID };
+  uint8 cnt = ( (rand() % 4) == 0 ) ? 4 : 3;
+  uint16 hdrLen = TEST_HDR_LEN + (rand() % 8);
+  uint32 oset;
+  uint8 x;
+
+  for ( x = 0; x < hdrLen; x++ )
+  {
+    image[x] = rand();
+  }
+  memcpy( image, zclOTA_HdrMagic, sizeof( zclOTA_HdrMagic ) );
+  image[ZCL_OTA_HDR_LEN_OFFSET] = LO_UINT16( hdrLen );
+  image[ZCL_OTA_HDR_LEN_OFFSET + 1] = HI_UINT16( hdrLen );
+  image[ZCL_OTA_STK_VER_OFFSET] = LO_UINT16( OTA_HDR_STACK_VERSION );
+  image[ZCL_OTA_STK_VER_OFFSET + 1] = HI_UINT16( OTA_HDR_STACK_VERSION );
+
+  for ( x = 0; x < cnt; x++ )
+  {
+    uint8 y = rand() % cnt;
+    uint16 t = tags[x];
+
+    tags[x] = tags[y];
+    tags[y] = t;
+  }
+
+  upgradeElems = 0;
+  oset = hdrLen;
+  for ( x = 0; x < cnt; x++ )
+  {
+    switch ( tags[x] )
+    {
+      case OTA_UPGRADE_IMAGE_TAG_ID:
+        oset = addElement( oset, tags[x], 1 + (rand() % 1500) );
+        break;
+
+      case OTA_ECDSA_CERT_TAG_ID:
+        oset = addElement( oset, tags[x], OTA_CERTIFICATE_LEN );
+        break;
+
+      default:
+        // Empty elements are allowed
+        oset = addElement( oset, tags[x], rand() % 3 ? rand() % 100 : 0 );
+        break;
+    }
+  }
+  oset = addElement( oset, OTA_ECDSA_SIGNATURE_TAG_ID, Z_EXTADDR_LEN + OTA_SIGNATURE_LEN );
+
+  imageLen = oset;
+}
+
+/*
+ * Start a download of the image, as zclOTA_ProcessImageBlockRsp does for
+ * the first block.
+ */
+static void startImage( void )
+{
+  zclOTA_ImageUpgradeStatus = OTA_STATUS_IN_PROGRESS;
+  zclOTA_ClientPdState = ZCL_OTA_PD_MAGIC_0_STATE;
+  zclOTA_FileOffset = 0;
+  zclOTA_DownloadedImageSize = imageLen;
+
+  memset( written, 0xFF, sizeof( written ) );
+#if defined OTA_MMO_SIGN
+  hashedLen = 0;
+#endif
+  chkDLCalls = 0;
+  chkDLStatus = SUCCESS;
+}
+
+/*
+ * Feed the image in blocks of 1 to maxBlock bytes until the parser fails
+ * or the image is done. Returns the status of the last block.
+ */
+static uint8 feedImage( uint8 maxBlock )
+{
+  uint8 status = ZSuccess;
+
+  while ( (status == ZSuccess) && (zclOTA_FileOffset < imageLen) )
+  {
+    uint32 left = imageLen - zclOTA_FileOffset;
+    uint8 len = 1 + (rand() % maxBlock);
+
+    if ( len > left )
+    {
+      len = (uint8)left;
+    }
+
+    status = zclOTA_ProcessImageData( image + zclOTA_FileOffset, len );
+  }
+
+  return ( status );
+}
+
+/*
+ * Check what the parser took from a complete image.
+ */
+static void checkImage( long step )
+{
+  HOST_CHECK_STEP( zclOTA_ImageUpgradeStatus == OTA_STATUS_COMPLETE, step );
+  HOST_CHECK_STEP( zclOTA_FileOffset == imageLen, step );
+  HOST_CHECK_STEP( memcmp( written, image, imageLen ) == 0, step );
+  HOST_CHECK_STEP( chkDLCalls == upgradeElems, step );
+
+#if defined OTA_MMO_SIGN
+  // The hash covers the whole image except the signature itself
+  HOST_CHECK_STEP( hashedLen == (imageLen - OTA_SIGNATURE_LEN), step );
+  HOST_CHECK_STEP( memcmp( hashed, image, sigOset ) == 0, step );
+  HOST_CHECK_STEP( memcmp( hashed + sigOset, image + sigOset + OTA_SIGNATURE_LEN,
+                           imageLen - sigOset - OTA_SIGNATURE_LEN ) == 0, step );
+
+  HOST_CHECK_STEP( memcmp( zclOTA_SignerIEEE, image + sigOset - Z_EXTADDR_LEN,
+                           Z_EXTADDR_LEN ) == 0, step );
+  HOST_CHECK_STEP( memcmp( zclOTA_SignatureData, image + sigOset,
+                           OTA_SIGNATURE_LEN ) == 0, step );
+  HOST_CHECK_STEP( memcmp( zclOTA_Certificate, image + certOset,
+                           OTA_CERTIFICATE_LEN ) == 0, step );
+#endif
+}
+
+/*
+ * Find the offset of the length field of the first element with a tag.
+ */
+static uint32 findElement( uint16 tag )
+{
+  uint32 oset = BUILD_UINT16( image[ZCL_OTA_HDR_LEN_OFFSET],
+                              image[ZCL_OTA_HDR_LEN_OFFSET + 1] );
+
+  while ( BUILD_UINT16( image[oset], image[oset + 1] ) != tag )
+  {
+    oset += 6 + BUILD_UINT32( image[oset + 2], image[oset + 3],
+                              image[oset + 4], image[oset + 5] );
+    HOST_CHECK( oset < imageLen );
+  }
+
+  return ( oset + 2 );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Random images in random blocks, each parsed again a byte at a time.
+ */
+static void testImages( void )
+{
+  long n;
+
+  srand( 11 );
+
+  for ( n = 0; n < TEST_IMAGES; n++ )
+  {
+    makeImage();
+
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZSuccess, n );
+    checkImage( n );
+
+    // Nothing is taken after the image is complete
+    HOST_CHECK_STEP( zclOTA_ProcessImageData( image, 1 ) == ZCL_STATUS_ABORT, n );
+
+    if ( (n % 8) == 0 )
+    {
+      startImage();
+      HOST_CHECK_STEP( feedImage( 1 ) == ZSuccess, n );
+      checkImage( n );
+    }
+  }
+
+  printf( "image: %ld images parsed\n", n );
+}
+
+/*
+ * Broken images stop the download.
+ */
+static void testInvalid( void )
+{
+  uint32 oset;
+  long n;
+
+  srand( 12 );
+
+  for ( n = 0; n < 500; n++ )
+  {
+    // Bad magic number
+    makeImage();
+    image[rand() % sizeof( zclOTA_HdrMagic )] ^= 1 << (rand() % 8);
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+
+    // Unsupported stack version
+    makeImage();
+    image[ZCL_OTA_STK_VER_OFFSET] = OTA_HDR_STACK_VERSION + 1;
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+
+    // Element longer than the rest of the image
+    makeImage();
+    oset = findElement( TEST_UNKNOWN_TAG );
+    image[oset + 2] = 0xFF;
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+
+    // Upgrade image with a bad CRC
+    makeImage();
+    startImage();
+    chkDLStatus = FAILURE;
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+    HOST_CHECK_STEP( chkDLCalls == 1, n );
+
+#if defined OTA_MMO_SIGN
+    // Signature element of the wrong length
+    makeImage();
+    oset = findElement( OTA_ECDSA_SIGNATURE_TAG_ID );
+    image[oset]--;
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+
+    // Certificate element of the wrong length
+    makeImage();
+    oset = findElement( OTA_ECDSA_CERT_TAG_ID );
+    image[oset]--;
+    startImage();
+    HOST_CHECK_STEP( feedImage( TEST_BLOCK_MAX ) == ZCL_STATUS_INVALID_IMAGE, n );
+#endif
+  }
+}
+
+int main( void )
+{
+  testImages();
+  testInvalid();
+
+  printf( "test_ota_image passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
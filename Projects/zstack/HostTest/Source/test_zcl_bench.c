@@ -0,0 +1,759 @@
+/**************************************************************************************************
+  Filename:       test_zcl_bench.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Runs the MultiSensor application on the real OSAL, AF and ZCL
+                  with the NWK, APS and MAC layers of host_nwk.c below it.
+                  Sends it Read Attributes, Write Attributes and Configure
+                  Reporting commands and sensor frames on its UART, and
+                  reports messages per second and the heap high-water mark.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "OSAL_Tasks.h"
+#include "OnBoard.h"
+#include "AF.h"
+#include "zcl.h"
+#include "zcl_general.h"
+#include "zcl_ms.h"
+#include "zcl_ha.h"
+#include "bdb.h"
+#include "zcl_MultiSensor.h"
+#ifdef BDB_REPORTING
+  #include "BindingTable.h"
+#endif
+#include "host_nwk.h"
+#include "host_timer.h"
+#include "host_uart.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_READS      100000L // Read Attributes commands
+#define TEST_WRITES     100000L // Write Attributes commands
+#define TEST_FRAMES     20000L  // Sensor frames on the UART
+#define TEST_PERIODS    1000L   // Reporting intervals
+#define TEST_COSTS      10000L  // Reports sent to count their cost
+
+#define TEST_SENSORS    3       // Sensor levels in a frame
+
+// An hour of sensor frames, every TEST_HOUR_FRAME seconds
+#define TEST_HOUR       3600
+#define TEST_HOUR_FRAME 5
+
+// An endpoint with a large attribute table, of TEST_LARGE_CLUSTERS
+// clusters of TEST_LARGE_ATTRS attributes each
+#define TEST_LARGE_EP         9
+#define TEST_LARGE_CLUSTERS   8
+#define TEST_LARGE_ATTRS      15
+#define TEST_LARGE_NUM        ( TEST_LARGE_CLUSTERS * TEST_LARGE_ATTRS )
+#define TEST_LARGE_READ       10      // Attributes per Read Attributes command
+
+// The coordinator the commands come from, and the reports go to
+#define TEST_PEER_ADDR  0x0000
+#define TEST_PEER_EP    1
+
+// Past the idle timeout the application opens its UART with
+#define TEST_UART_IDLE  10
+
+#ifdef BDB_REPORTING
+  #define TEST_REPORTING  "bdb"
+  #define TEST_GROUP    0x0001
+#else
+  #define TEST_REPORTING  "app"
+#endif
+
+/*********************************************************************
+ * EXTERNAL FUNCTIONS
+ */
+
+// In zcl.c
+extern zclAttrRecsList *zclFindAttrRecsList( uint8 endpoint );
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// Profile wide commands sent, by command ID
+static uint32 testCmds[256];
+
+// ZCL payload of the last command sent
+static uint8 testRsp[128];
+static uint8 testRspLen;
+
+static uint8 testSeq;
+
+// The light, TVOC and CO2 levels the sensor board sends in one frame
+static const uint16 testSensorClusters[TEST_SENSORS] =
+{
+  ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT,
+  ZCL_CLUSTER_ID_MS_TVOC_MEASUREMENT,
+  ZCL_CLUSTER_ID_MS_CO2_MEASUREMENT
+};
+static const uint16 testSensorAttrs[TEST_SENSORS] =
+{
+  ATTRID_MS_ILLUMINANCE_LEVEL_STATUS,
+  ATTRID_MS_TVOC_MEASURED_VALUE,
+  ATTRID_MS_CO2_MEASURED_VALUE
+};
+
+// Reports sent of each sensor level
+static uint32 testSensorReports[TEST_SENSORS];
+
+// Times the application ran its report check
+static uint32 testReportChecks;
+
+// Heap allocations and bytes copied by the stack
+static uint32 testAllocs;
+static uint32 testCopied;
+
+// The large endpoint
+static cId_t testLargeClusters[TEST_LARGE_CLUSTERS];
+static zclAttrRec_t testLargeAttrs[TEST_LARGE_NUM];
+static uint16 testLargeValues[TEST_LARGE_NUM];
+static SimpleDescriptionFormat_t testLargeDesc;
+
+/*********************************************************************
+ * GLOBAL FUNCTIONS
+ */
+
+/*
+ * The application task, wrapped at link time to count the report checks
+ * it runs.
+ */
+extern uint16 __real_zclMultiSensor_event_loop( uint8 task_id, uint16 events );
+
+uint16 __wrap_zclMultiSensor_event_loop( uint8 task_id, uint16 events )
+{
+  // Messages are taken first, the report check on a later call
+  if ( ( events & MULTISENSOR_CHECK_REPORT__EVT ) && !( events & SYS_EVENT_MSG ) )
+  {
+    testReportChecks++;
+  }
+
+  return ( __real_zclMultiSensor_event_loop( task_id, events ) );
+}
+
+/*
+ * The heap and copy routines, wrapped at link time to count what the
+ * send path costs.
+ */
+extern void *__real_osal_mem_alloc( uint16 size );
+extern void *__real_osal_memcpy( void *dst, const void *src, unsigned int len );
+
+void *__wrap_osal_mem_alloc( uint16 size )
+{
+  testAllocs++;
+  return ( __real_osal_mem_alloc( size ) );
+}
+
+void *__wrap_osal_memcpy( void *dst, const void *src, unsigned int len )
+{
+  testCopied += len;
+  return ( __real_osal_memcpy( dst, src, len ) );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * Every frame the device sends, whatever the cluster.
+ */
+static void testTx( APSDE_DataReq_t *req )
+{
+  uint8 hdrLen = 3;
+
+  if ( req->asduLen < hdrLen )
+  {
+    return;
+  }
+  if ( req->asdu[0] & ZCL_FRAME_CONTROL_MANU_SPECIFIC )
+  {
+    hdrLen += 2;
+  }
+  if ( ( req->asdu[0] & ZCL_FRAME_CONTROL_TYPE ) == ZCL_FRAME_TYPE_PROFILE_CMD )
+  {
+    testCmds[req->asdu[hdrLen - 1]]++;
+
+    if ( req->asdu[hdrLen - 1] == ZCL_CMD_REPORT )
+    {
+      uint8 i;
+
+      for ( i = 0; i < TEST_SENSORS; i++ )
+      {
+        if ( req->clusterID == testSensorClusters[i] )
+        {
+          testSensorReports[i]++;
+        }
+      }
+    }
+  }
+
+  testRspLen = req->asduLen - hdrLen;
+  if ( testRspLen > sizeof( testRsp ) )
+  {
+    testRspLen = sizeof( testRsp );
+  }
+  memcpy( testRsp, req->asdu + hdrLen, testRspLen );
+}
+
+/*
+ * Run the tasks until none has an event left. Timers that are not due
+ * yet stay pending.
+ */
+static void testRun( void )
+{
+  uint8 idx;
+
+  do
+  {
+    osal_run_system();
+
+    for ( idx = 0; idx < tasksCnt; idx++ )
+    {
+      if ( tasksEvents[idx] )
+      {
+        break;
+      }
+    }
+  } while ( idx < tasksCnt );
+}
+
+/*
+ * Let msec go by a millisecond at a time, running the tasks at each, so
+ * that timers fire when they are due.
+ */
+static void testRunFor( uint32 msec )
+{
+  while ( msec-- )
+  {
+    hostTimerAdvance( 1 );
+    testRun();
+  }
+}
+
+/*
+ * A profile wide command from the coordinator to an endpoint, run to
+ * completion.
+ */
+static void testSend( uint8 endpoint, uint16 clusterID, uint8 cmd, uint8 *payload, uint8 len )
+{
+  uint8 frame[80];
+
+  frame[0] = ZCL_FRAME_TYPE_PROFILE_CMD | ZCL_FRAME_CONTROL_DISABLE_DEFAULT_RSP;
+  frame[1] = testSeq++;
+  frame[2] = cmd;
+  memcpy( frame + 3, payload, len );
+
+  hostNwkRx( TEST_PEER_ADDR, TEST_PEER_EP, endpoint, clusterID,
+             ZCL_HA_PROFILE_ID, frame, len + 3 );
+  testRun();
+}
+
+/*
+ * Read the identity of the device, as a console polling it does.
+ */
+static void testRead( void )
+{
+  static uint8 attrs[] =
+  {
+    LO_UINT16( ATTRID_BASIC_ZCL_VERSION ), HI_UINT16( ATTRID_BASIC_ZCL_VERSION ),
+    LO_UINT16( ATTRID_BASIC_MANUFACTURER_NAME ), HI_UINT16( ATTRID_BASIC_MANUFACTURER_NAME ),
+    LO_UINT16( ATTRID_BASIC_MODEL_ID ), HI_UINT16( ATTRID_BASIC_MODEL_ID ),
+    LO_UINT16( ATTRID_BASIC_POWER_SOURCE ), HI_UINT16( ATTRID_BASIC_POWER_SOURCE ),
+    LO_UINT16( ATTRID_BASIC_LOCATION_DESC ), HI_UINT16( ATTRID_BASIC_LOCATION_DESC ),
+  };
+  uint32 rsps = testCmds[ZCL_CMD_READ_RSP];
+  double start;
+  double usec;
+  long step;
+
+  start = testUsec();
+  for ( step = 0; step < TEST_READS; step++ )
+  {
+    testSend( MULTISENSOR_ENDPOINT, ZCL_CLUSTER_ID_GEN_BASIC, ZCL_CMD_READ, attrs, sizeof( attrs ) );
+    HOST_CHECK_STEP( testCmds[ZCL_CMD_READ_RSP] == rsps + step + 1, step );
+  }
+  usec = testUsec() - start;
+
+  // ZCL version, then its status and type
+  HOST_CHECK( testRsp[0] == LO_UINT16( ATTRID_BASIC_ZCL_VERSION ) );
+  HOST_CHECK( testRsp[2] == ZCL_STATUS_SUCCESS );
+  HOST_CHECK( testRsp[3] == ZCL_DATATYPE_UINT8 );
+
+  printf( "read:   %ld commands of 5 attributes, %8.0f msgs/sec\n",
+          TEST_READS, TEST_READS * 1e6 / usec );
+}
+
+/*
+ * Register TEST_LARGE_EP, with its attributes in cluster order as
+ * application tables have them.
+ */
+static void testLargeRegister( void )
+{
+  uint16 i;
+
+  for ( i = 0; i < TEST_LARGE_NUM; i++ )
+  {
+    testLargeValues[i] = i;
+    testLargeAttrs[i].clusterID = ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT + ( i / TEST_LARGE_ATTRS );
+    testLargeAttrs[i].attr.attrId = i % TEST_LARGE_ATTRS;
+    testLargeAttrs[i].attr.dataType = ZCL_DATATYPE_UINT16;
+    testLargeAttrs[i].attr.accessControl = ACCESS_CONTROL_READ;
+    testLargeAttrs[i].attr.dataPtr = &testLargeValues[i];
+  }
+  for ( i = 0; i < TEST_LARGE_CLUSTERS; i++ )
+  {
+    testLargeClusters[i] = ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT + i;
+  }
+
+  testLargeDesc.EndPoint = TEST_LARGE_EP;
+  testLargeDesc.AppProfId = ZCL_HA_PROFILE_ID;
+  testLargeDesc.AppDeviceId = ZCL_HA_DEVICEID_SIMPLE_SENSOR;
+  testLargeDesc.AppNumInClusters = TEST_LARGE_CLUSTERS;
+  testLargeDesc.pAppInClusterList = testLargeClusters;
+
+  bdb_RegisterSimpleDescriptor( &testLargeDesc );
+  HOST_CHECK( zcl_registerAttrList( TEST_LARGE_EP, TEST_LARGE_NUM, testLargeAttrs ) == ZSuccess );
+}
+
+/*
+ * Read the last TEST_LARGE_READ attributes of the last cluster of
+ * TEST_LARGE_EP, which a linear scan finds last.
+ */
+static double testLargeRead( void )
+{
+  uint16 clusterID = testLargeClusters[TEST_LARGE_CLUSTERS - 1];
+  uint32 rsps = testCmds[ZCL_CMD_READ_RSP];
+  uint8 attrs[TEST_LARGE_READ * 2];
+  double start;
+  long step;
+  uint8 i;
+
+  for ( i = 0; i < TEST_LARGE_READ; i++ )
+  {
+    attrs[i * 2] = TEST_LARGE_ATTRS - TEST_LARGE_READ + i;
+    attrs[i * 2 + 1] = 0;
+  }
+
+  start = testUsec();
+  for ( step = 0; step < TEST_READS; step++ )
+  {
+    testSend( TEST_LARGE_EP, clusterID, ZCL_CMD_READ, attrs, sizeof( attrs ) );
+    HOST_CHECK_STEP( testCmds[ZCL_CMD_READ_RSP] == rsps + step + 1, step );
+  }
+
+  // Every attribute read back: ID, status, type and value
+  HOST_CHECK( testRspLen == TEST_LARGE_READ * 6 );
+  for ( i = 0; i < TEST_LARGE_READ; i++ )
+  {
+    uint16 value = TEST_LARGE_NUM - TEST_LARGE_READ + i;
+
+    HOST_CHECK_STEP( testRsp[i * 6] == attrs[i * 2], i );
+    HOST_CHECK_STEP( testRsp[i * 6 + 2] == ZCL_STATUS_SUCCESS, i );
+    HOST_CHECK_STEP( testRsp[i * 6 + 3] == ZCL_DATATYPE_UINT16, i );
+    HOST_CHECK_STEP( BUILD_UINT16( testRsp[i * 6 + 4], testRsp[i * 6 + 5] ) == value, i );
+  }
+
+  return ( testUsec() - start );
+}
+
+/*
+ * The same reads with the sorted attribute index, and with the linear
+ * scan zclFindAttrRecPtr() falls back to without it.
+ */
+static void testReadLarge( void )
+{
+  zclAttrRecsList *pList = zclFindAttrRecsList( TEST_LARGE_EP );
+  uint8 *pIndex;
+  double indexed;
+  double scanned;
+
+  HOST_CHECK( ( pList != NULL ) && ( pList->attrIndex != NULL ) );
+
+  indexed = testLargeRead();
+
+  pIndex = pList->attrIndex;
+  pList->attrIndex = NULL;
+  scanned = testLargeRead();
+  pList->attrIndex = pIndex;
+
+  printf( "read:   %ld commands of %u of %u attributes, %8.0f msgs/sec indexed, %8.0f scanned\n",
+          TEST_READS, TEST_LARGE_READ, TEST_LARGE_NUM, TEST_READS * 1e6 / indexed,
+          TEST_READS * 1e6 / scanned );
+}
+
+/*
+ * Rename the location of the device and change its environment.
+ */
+static void testWrite( void )
+{
+  uint32 rsps = testCmds[ZCL_CMD_WRITE_RSP];
+  uint8 payload[32];
+  uint8 len;
+  double start;
+  double usec;
+  long step;
+
+  start = testUsec();
+  for ( step = 0; step < TEST_WRITES; step++ )
+  {
+    len = 0;
+    payload[len++] = LO_UINT16( ATTRID_BASIC_LOCATION_DESC );
+    payload[len++] = HI_UINT16( ATTRID_BASIC_LOCATION_DESC );
+    payload[len++] = ZCL_DATATYPE_CHAR_STR;
+    payload[len++] = 7;
+    memcpy( payload + len, "Room ", 5 );
+    len += 5;
+    payload[len++] = '0' + ( step / 10 ) % 10;
+    payload[len++] = '0' + step % 10;
+    payload[len++] = LO_UINT16( ATTRID_BASIC_PHYSICAL_ENV );
+    payload[len++] = HI_UINT16( ATTRID_BASIC_PHYSICAL_ENV );
+    payload[len++] = ZCL_DATATYPE_ENUM8;
+    payload[len++] = step & 1;
+
+    testSend( MULTISENSOR_ENDPOINT, ZCL_CLUSTER_ID_GEN_BASIC, ZCL_CMD_WRITE, payload, len );
+    HOST_CHECK_STEP( testCmds[ZCL_CMD_WRITE_RSP] == rsps + step + 1, step );
+
+    // Every attribute was written
+    HOST_CHECK_STEP( ( testRspLen == 1 ) && ( testRsp[0] == ZCL_STATUS_SUCCESS ), step );
+  }
+  usec = testUsec() - start;
+
+  printf( "write:  %ld commands of 2 attributes, %8.0f msgs/sec\n",
+          TEST_WRITES, TEST_WRITES * 1e6 / usec );
+}
+
+/*
+ * Have a sensor level reported on a change of 1, no sooner than minInt
+ * seconds after the last report, and at least every maxInt seconds.
+ */
+static void testConfigReport( uint8 sensor, uint16 minInt, uint16 maxInt )
+{
+  uint32 rsps = testCmds[ZCL_CMD_CONFIG_REPORT_RSP];
+  uint8 payload[10];
+
+  payload[0] = ZCL_SEND_ATTR_REPORTS;
+  payload[1] = LO_UINT16( testSensorAttrs[sensor] );
+  payload[2] = HI_UINT16( testSensorAttrs[sensor] );
+  payload[3] = ZCL_DATATYPE_UINT16;
+  payload[4] = LO_UINT16( minInt );
+  payload[5] = HI_UINT16( minInt );
+  payload[6] = LO_UINT16( maxInt );
+  payload[7] = HI_UINT16( maxInt );
+  payload[8] = 1;                       // reportable change
+  payload[9] = 0;
+
+  testSend( MULTISENSOR_ENDPOINT, testSensorClusters[sensor], ZCL_CMD_CONFIG_REPORT,
+            payload, sizeof( payload ) );
+  HOST_CHECK( testCmds[ZCL_CMD_CONFIG_REPORT_RSP] == rsps + 1 );
+  HOST_CHECK( testRsp[0] == ZCL_STATUS_SUCCESS );
+}
+
+#ifndef BDB_REPORTING
+/*
+ * The sensor board sends the light, TVOC and CO2 levels, each different
+ * from the last, and every change is reported.
+ */
+static void testReport( void )
+{
+  uint32 reports;
+  char frame[32];
+  int len;
+  double start;
+  double usec;
+  long step;
+
+  for ( step = 0; step < TEST_SENSORS; step++ )
+  {
+    testConfigReport( step, 0, 3600 );
+  }
+
+  // Each record is reported as soon as it is configured
+  testRun();
+  reports = testCmds[ZCL_CMD_REPORT];
+  HOST_CHECK( reports == 3 );
+
+  start = testUsec();
+  for ( step = 0; step < TEST_FRAMES; step++ )
+  {
+    len = sprintf( frame, "P%ld,%ld,%ld\n", 100 + step % 1000, 200 + step % 1000,
+                   400 + step % 1000 );
+    HOST_CHECK_STEP( write( hostUartRxFd( HAL_UART_PORT_0 ), frame, len ) == len, step );
+
+    // Take the frame in, then let the port go idle
+    testRun();
+    testRunFor( TEST_UART_IDLE );
+
+    HOST_CHECK_STEP( testCmds[ZCL_CMD_REPORT] == reports + 3 * ( step + 1 ), step );
+  }
+  usec = testUsec() - start;
+
+  printf( "report: %ld sensor frames, %lu reports, %8.0f frames/sec\n",
+          TEST_FRAMES, (unsigned long)( testCmds[ZCL_CMD_REPORT] - reports ),
+          TEST_FRAMES * 1e6 / usec );
+}
+
+/*
+ * An hour of a sensor board that sends a frame every TEST_HOUR_FRAME
+ * seconds, in which the light level always changes and the TVOC and CO2
+ * levels hold. Light is reported at most every 10 seconds, TVOC every 5
+ * minutes and CO2 every 15. The report check only runs when a report is
+ * due, where it used to run every second.
+ */
+static void testReportHour( void )
+{
+  uint32 checks;
+  uint32 sent[TEST_SENSORS];
+  char frame[32];
+  int len;
+  uint16 sec;
+  uint8 i;
+
+  // Simulated time only
+  hostTimerStop();
+
+  testConfigReport( 0, 10, 60 );
+  testConfigReport( 1, 10, 300 );
+  testConfigReport( 2, 10, 900 );
+  testRun();
+
+  checks = testReportChecks;
+  memcpy( sent, testSensorReports, sizeof( sent ) );
+
+  for ( sec = 1; sec <= TEST_HOUR; sec++ )
+  {
+    if ( ( sec % TEST_HOUR_FRAME ) == 0 )
+    {
+      len = sprintf( frame, "P%u,%u,%u\n", 100 + sec / TEST_HOUR_FRAME,
+                     zclMultiSensor_TVOC_MeasuredValue, zclMultiSensor_CO2_MeasuredValue );
+      HOST_CHECK_STEP( write( hostUartRxFd( HAL_UART_PORT_0 ), frame, len ) == len, sec );
+      testRun();
+    }
+
+    testRunFor( 1000 );
+  }
+
+  checks = testReportChecks - checks;
+  for ( i = 0; i < TEST_SENSORS; i++ )
+  {
+    sent[i] = testSensorReports[i] - sent[i];
+  }
+
+  // Held to the minimum interval, and on time for the maximum
+  HOST_CHECK( ( sent[0] >= TEST_HOUR / 10 - 1 ) && ( sent[0] <= TEST_HOUR / 10 ) );
+  HOST_CHECK( ( sent[1] >= TEST_HOUR / 300 - 1 ) && ( sent[1] <= TEST_HOUR / 300 ) );
+  HOST_CHECK( ( sent[2] >= TEST_HOUR / 900 - 1 ) && ( sent[2] <= TEST_HOUR / 900 ) );
+  HOST_CHECK( checks <= sent[0] + sent[1] + sent[2] );
+
+  printf( "hour:   %u sensor frames, %lu light, %lu TVOC and %lu CO2 reports, "
+          "%lu report checks (%u polling every second)\n",
+          TEST_HOUR / TEST_HOUR_FRAME, (unsigned long)sent[0], (unsigned long)sent[1],
+          (unsigned long)sent[2], (unsigned long)checks, TEST_HOUR );
+}
+#else
+/*
+ * Reporting by BDB: the light, TVOC and CO2 levels are reported every
+ * second to a group.
+ */
+static void testReport( void )
+{
+  zAddrType_t dstAddr;
+  uint32 reports;
+  double start;
+  double usec;
+  long step;
+  uint8 i;
+
+  for ( i = 0; i < TEST_SENSORS; i++ )
+  {
+    testConfigReport( i, 0, 1 );
+  }
+
+  // Reports only go out to a binding
+  dstAddr.addrMode = AddrGroup;
+  dstAddr.addr.shortAddr = TEST_GROUP;
+  HOST_CHECK( bindAddEntry( MULTISENSOR_ENDPOINT, &dstAddr, 0, TEST_SENSORS,
+                            (uint16 *)testSensorClusters ) != NULL );
+  testRun();
+  reports = testCmds[ZCL_CMD_REPORT];
+
+  start = testUsec();
+  for ( step = 0; step < TEST_PERIODS; step++ )
+  {
+    testRunFor( 1000 );
+  }
+  usec = testUsec() - start;
+
+  // BDB sends one cluster per tick and then restarts the interval, so
+  // the interval runs a few milliseconds long
+  reports = testCmds[ZCL_CMD_REPORT] - reports;
+  HOST_CHECK( reports >= 3 * ( TEST_PERIODS - ( TEST_PERIODS / 100 ) ) );
+  HOST_CHECK( reports <= 3 * TEST_PERIODS );
+
+  printf( "report: %ld intervals, %lu reports, %8.0f reports/sec\n",
+          TEST_PERIODS, (unsigned long)reports, reports * 1e6 / usec );
+}
+#endif
+
+/*
+ * Allocations and bytes copied for one report of the light level, sent
+ * by zcl_SendReportCmd(), which serializes it in place, and the way it was
+ * sent before: serialized by the caller into a buffer of its own and
+ * copied behind the header by zcl_SendCommand().
+ */
+static void testReportCost( void )
+{
+  afAddrType_t dstAddr;
+  zclReportCmd_t *pReport;
+  uint8 buf[5];
+  uint8 *pBuf;
+  uint32 frames;
+  uint32 allocs[2];
+  uint32 copied[2];
+  uint32 n;
+
+  dstAddr.addrMode = afAddr16Bit;
+  dstAddr.addr.shortAddr = TEST_PEER_ADDR;
+  dstAddr.endPoint = TEST_PEER_EP;
+  dstAddr.panId = 0;
+
+  pReport = osal_mem_alloc( sizeof( zclReportCmd_t ) + sizeof( zclReport_t ) );
+  HOST_CHECK( pReport != NULL );
+  pReport->numAttr = 1;
+  pReport->attrList[0].attrID = ATTRID_MS_ILLUMINANCE_MEASURED_VALUE;
+  pReport->attrList[0].dataType = ZCL_DATATYPE_UINT16;
+  pReport->attrList[0].attrData = (uint8 *)&zclMultiSensor_Light_MeasuredValue;
+
+  frames = hostNwkTxFrames;
+  allocs[0] = testAllocs;
+  copied[0] = testCopied;
+  for ( n = 0; n < TEST_COSTS; n++ )
+  {
+    HOST_CHECK_STEP( zcl_SendReportCmd( MULTISENSOR_ENDPOINT, &dstAddr,
+                                        ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT, pReport,
+                                        ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, testSeq++ ) == ZSuccess, n );
+  }
+  allocs[0] = testAllocs - allocs[0];
+  copied[0] = testCopied - copied[0];
+
+  allocs[1] = testAllocs;
+  copied[1] = testCopied;
+  for ( n = 0; n < TEST_COSTS; n++ )
+  {
+    pBuf = osal_mem_alloc( sizeof( buf ) );
+    HOST_CHECK_STEP( pBuf != NULL, n );
+    pBuf[0] = LO_UINT16( ATTRID_MS_ILLUMINANCE_MEASURED_VALUE );
+    pBuf[1] = HI_UINT16( ATTRID_MS_ILLUMINANCE_MEASURED_VALUE );
+    pBuf[2] = ZCL_DATATYPE_UINT16;
+    zclSerializeData( ZCL_DATATYPE_UINT16, &zclMultiSensor_Light_MeasuredValue, pBuf + 3 );
+    HOST_CHECK_STEP( zcl_SendCommand( MULTISENSOR_ENDPOINT, &dstAddr,
+                                      ZCL_CLUSTER_ID_MS_ILLUMINANCE_MEASUREMENT, ZCL_CMD_REPORT,
+                                      FALSE, ZCL_FRAME_SERVER_CLIENT_DIR, TRUE, 0, testSeq++,
+                                      sizeof( buf ), pBuf ) == ZSuccess, n );
+    osal_mem_free( pBuf );
+  }
+  allocs[1] = testAllocs - allocs[1];
+  copied[1] = testCopied - copied[1];
+
+  osal_mem_free( pReport );
+
+  // Sent as they were asked for, with no task run in between
+  HOST_CHECK( hostNwkTxFrames - frames == 2 * TEST_COSTS );
+
+  // One allocation in place, and one more and a copy of the report the
+  // old way. Both read the Device Enabled attribute for every frame.
+  HOST_CHECK( allocs[0] == TEST_COSTS );
+  HOST_CHECK( allocs[1] == 2 * TEST_COSTS );
+  HOST_CHECK( copied[0] <= TEST_COSTS );
+  HOST_CHECK( copied[1] == copied[0] + sizeof( buf ) * TEST_COSTS );
+
+  printf( "cost:   %ld reports, %.2f allocs and %.2f bytes copied each in place, "
+          "%.2f and %.2f through zcl_SendCommand\n", TEST_COSTS,
+          (double)allocs[0] / TEST_COSTS, (double)copied[0] / TEST_COSTS,
+          (double)allocs[1] / TEST_COSTS, (double)copied[1] / TEST_COSTS );
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  hostNwkTxCB = testTx;
+
+  osal_init_system();
+  testLargeRegister();
+  testRun();
+
+  // Nothing is sent until the device is asked
+  HOST_CHECK( hostNwkTxFrames == 0 );
+
+  testRead();
+  testReadLarge();
+  testWrite();
+  testReport();
+#ifndef BDB_REPORTING
+  testReportHour();
+#endif
+  testReportCost();
+
+  printf( "heap:   %u of %u bytes high-water, %lu frames of %lu bytes sent\n",
+          osal_heap_high_water(), MAXMEMHEAP, (unsigned long)hostNwkTxFrames,
+          (unsigned long)hostNwkTxBytes );
+
+  printf( "zcl bench %s: ok\n", TEST_REPORTING );
+  return ( 0 );
+}
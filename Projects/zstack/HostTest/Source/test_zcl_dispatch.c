@@ -0,0 +1,564 @@
+/**************************************************************************************************
+  Filename:       test_zcl_dispatch.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test and benchmark of the ZCL dispatch table: the plugin,
+                  command callbacks and cluster option found for every
+                  cluster of every endpoint, as plugins, callbacks and
+                  option lists are registered in random order, checked
+                  against a walk of what was registered, and the frames
+                  per second zcl_ProcessMessageMSG() passes to zcl_general.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "hal_types.h"  // Before hal_mcu.h, which includes the target one
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "AF.h"
+#include "zcl.h"
+#include "zcl_general.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_EP_A         8     // zcl_general callbacks testCBsA
+#define TEST_EP_B         9     // zcl_general callbacks testCBsB
+#define TEST_EP_AF        10    // Registered with AF only
+#define TEST_EP_NONE      11    // Not registered at all
+#define TEST_PROFILE      0x0104
+
+#define TEST_NUM_EPS      12    // Endpoints 1..12 are swept
+#define TEST_NUM_HDLRS    3
+#define TEST_NUM_PLUGINS  12
+#define TEST_NUM_CBS      24
+#define TEST_NUM_OPTIONS  6     // Option lists
+#define TEST_MAX_OPTIONS  4     // Records in an option list
+
+// Clusters the random plugins, callbacks and options are registered in
+#define TEST_FIRST_CLUSTER  0x0100
+#define TEST_LAST_CLUSTER   0x0FFF
+#define TEST_PLUGIN_SPAN    0x0100
+
+// Frame control: cluster specific command to the server, without
+// Default Response
+#define TEST_FC_SPECIFIC  0x11
+
+#define TEST_BENCH_FRAMES 2000000L
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint16 startClusterID;
+  uint16 endClusterID;
+  uint8 hdlr;
+} testPlugin_t;
+
+typedef struct
+{
+  uint8 endpoint;
+  uint8 hdlr;
+} testCBs_t;
+
+typedef struct
+{
+  uint8 endpoint;
+  uint8 numOptions;
+  zclOptionRec_t options[TEST_MAX_OPTIONS];
+} testOptions_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static SimpleDescriptionFormat_t testSimpleDesc = { 0, TEST_PROFILE };
+static endPointDesc_t testEpDesc[TEST_NUM_EPS + 1];
+static uint32 testFindEpCnt;
+static uint32 testSentCnt;
+
+static uint8 testOnOffA;
+static uint8 testOnOffB;
+static uint8 testResetA;
+
+static void testOnOffCBA( uint8 cmd );
+static void testOnOffCBB( uint8 cmd );
+static void testBasicResetCBA( void );
+
+static zclGeneral_AppCallbacks_t testCBsA;
+static zclGeneral_AppCallbacks_t testCBsB;
+
+static zclOptionRec_t testGenOptions[] =
+{
+  { ZCL_CLUSTER_ID_GEN_ON_OFF, AF_EN_SECURITY },
+  { ZCL_CLUSTER_ID_GEN_POLL_CONTROL, AF_ACK_REQUEST },
+};
+
+// Registered so far, in order
+static testPlugin_t testPlugins[TEST_NUM_PLUGINS];
+static uint8 testNumPlugins;
+static testCBs_t testCBs[TEST_NUM_CBS];
+static uint8 testNumCBs;
+static testOptions_t testOptions[TEST_NUM_OPTIONS];
+static uint8 testNumOptions;
+
+// Last call of a test plugin handler
+static uint8 testHdlrCalled;
+static void *testHdlrCBs;
+
+static uint8 testSeq;
+
+/*********************************************************************
+ * STUBS
+ */
+
+uint8 APS_Counter;
+nwkIB_t _NIB;
+
+endPointDesc_t *afFindEndPointDesc( uint8 EndPoint )
+{
+  testFindEpCnt++;
+  if ( ( EndPoint == 0 ) || ( EndPoint > TEST_NUM_EPS ) || ( EndPoint == TEST_EP_NONE ) )
+  {
+    return ( NULL );
+  }
+  return ( &testEpDesc[EndPoint] );
+}
+
+afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
+                           uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                           uint8 options, uint8 radius )
+{
+  testSentCnt++;
+  return ( afStatus_SUCCESS );
+}
+
+uint32 bdb_getZCLFrameCounter( void )
+{
+  return ( 0 );
+}
+
+void bdb_ZclIdentifyCmdInd( uint16 identifyTime, uint8 endpoint )
+{
+}
+
+void bdb_ZclIdentifyQueryCmdInd( zclIdentifyQueryRsp_t *pCmd )
+{
+}
+
+uint8 *osal_msg_receive( uint8 task_id )
+{
+  return ( hostOsalTakeMsg( task_id ) );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void testOnOffCBA( uint8 cmd )
+{
+  testOnOffA = cmd;
+}
+
+static void testOnOffCBB( uint8 cmd )
+{
+  testOnOffB = cmd;
+}
+
+static void testBasicResetCBA( void )
+{
+  testResetA++;
+}
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+/*
+ * Plugin handlers, which note the callbacks ZCL finds for the message.
+ */
+static ZStatus_t testHdlr( uint8 hdlr, zclIncoming_t *pInMsg )
+{
+  testHdlrCalled = hdlr;
+  testHdlrCBs = zcl_FindCallbacks( pInMsg->msg->endPoint, pInMsg->msg->clusterId );
+  return ( ZSuccess );
+}
+
+static ZStatus_t testHdlr1( zclIncoming_t *pInMsg )
+{
+  return ( testHdlr( 1, pInMsg ) );
+}
+
+static ZStatus_t testHdlr2( zclIncoming_t *pInMsg )
+{
+  return ( testHdlr( 2, pInMsg ) );
+}
+
+static ZStatus_t testHdlr3( zclIncoming_t *pInMsg )
+{
+  return ( testHdlr( 3, pInMsg ) );
+}
+
+static const zclInHdlr_t testHdlrs[TEST_NUM_HDLRS] = { testHdlr1, testHdlr2, testHdlr3 };
+
+/*
+ * Pass a command with an empty payload to zcl_ProcessMessageMSG().
+ */
+static zclProcMsgStatus_t testProcess( uint8 endpoint, uint16 clusterID, uint8 fc,
+                                       uint8 cmdID, uint8 secure )
+{
+  afIncomingMSGPacket_t pkt;
+  uint8 frame[3];
+
+  frame[0] = fc;
+  frame[1] = testSeq++;
+  frame[2] = cmdID;
+
+  memset( &pkt, 0, sizeof( pkt ) );
+  pkt.clusterId = clusterID;
+  pkt.srcAddr.addrMode = afAddr16Bit;
+  pkt.srcAddr.addr.shortAddr = 0x1234;
+  pkt.srcAddr.endPoint = 1;
+  pkt.endPoint = endpoint;
+  pkt.SecurityUse = secure;
+  pkt.cmd.DataLength = sizeof( frame );
+  pkt.cmd.Data = frame;
+
+  return ( zcl_ProcessMessageMSG( &pkt ) );
+}
+
+/*
+ * Registered test plugin of a cluster, NULL if none.
+ */
+static testPlugin_t *testRefPlugin( uint16 clusterID )
+{
+  uint8 i;
+
+  for ( i = 0; i < testNumPlugins; i++ )
+  {
+    if ( ( clusterID >= testPlugins[i].startClusterID ) &&
+         ( clusterID <= testPlugins[i].endClusterID ) )
+    {
+      return ( &testPlugins[i] );
+    }
+  }
+  return ( NULL );
+}
+
+/*
+ * First callbacks registered for the plugin of an endpoint's cluster,
+ * NULL if none.
+ */
+static testCBs_t *testRefCBs( uint8 endpoint, uint16 clusterID )
+{
+  testPlugin_t *pPlugin = testRefPlugin( clusterID );
+  uint8 i;
+
+  for ( i = 0; ( pPlugin != NULL ) && ( i < testNumCBs ); i++ )
+  {
+    if ( ( testCBs[i].endpoint == endpoint ) && ( testCBs[i].hdlr == pPlugin->hdlr ) )
+    {
+      return ( &testCBs[i] );
+    }
+  }
+  return ( NULL );
+}
+
+/*
+ * First option record registered for an endpoint's cluster, NULL if none.
+ */
+static zclOptionRec_t *testRefOption( uint8 endpoint, uint16 clusterID )
+{
+  uint8 i, j;
+
+  for ( i = 0; i < testNumOptions; i++ )
+  {
+    for ( j = 0; ( testOptions[i].endpoint == endpoint ) && ( j < testOptions[i].numOptions ); j++ )
+    {
+      if ( testOptions[i].options[j].clusterID == clusterID )
+      {
+        return ( &testOptions[i].options[j] );
+      }
+    }
+  }
+  return ( NULL );
+}
+
+/*
+ * Every cluster of every endpoint: the callbacks found, whether an
+ * unsecured frame is refused, the handler it is passed to, and whether
+ * AF was asked for the endpoint, against a walk of what was registered.
+ */
+static void testSweep( long step )
+{
+  uint8 endpoint;
+  uint16 clusterID;
+
+  for ( endpoint = 1; endpoint <= TEST_NUM_EPS; endpoint++ )
+  {
+    for ( clusterID = TEST_FIRST_CLUSTER - 0x10; clusterID <= TEST_LAST_CLUSTER; clusterID++ )
+    {
+      testPlugin_t *pPlugin = testRefPlugin( clusterID );
+      testCBs_t *pCBs = testRefCBs( endpoint, clusterID );
+      zclOptionRec_t *pOption = testRefOption( endpoint, clusterID );
+      uint8 secure = ( pOption != NULL ) && ( pOption->option & AF_EN_SECURITY );
+      zclProcMsgStatus_t status;
+
+      HOST_CHECK_STEP( zcl_FindCallbacks( endpoint, clusterID ) == (void *)pCBs, step );
+
+      testHdlrCalled = 0;
+      testHdlrCBs = NULL;
+      testFindEpCnt = 0;
+      testSentCnt = 0;
+      status = testProcess( endpoint, clusterID, TEST_FC_SPECIFIC, 0, FALSE );
+
+      // The endpoint is only looked up if nothing was registered for it,
+      // and again for each Default Response sent
+      HOST_CHECK_STEP( testFindEpCnt - testSentCnt ==
+                       ( ( pCBs == NULL ) && ( pOption == NULL ) ), step );
+
+      if ( ( endpoint == TEST_EP_NONE ) && ( pCBs == NULL ) && ( pOption == NULL ) )
+      {
+        HOST_CHECK_STEP( status == ZCL_PROC_EP_NOT_FOUND, step );
+        HOST_CHECK_STEP( testHdlrCalled == 0, step );
+      }
+      else if ( ( pPlugin != NULL ) && secure )
+      {
+        HOST_CHECK_STEP( status == ZCL_PROC_NOT_SECURE, step );
+        HOST_CHECK_STEP( testHdlrCalled == 0, step );
+      }
+      else if ( pPlugin != NULL )
+      {
+        HOST_CHECK_STEP( status == ZCL_PROC_SUCCESS, step );
+        HOST_CHECK_STEP( testHdlrCalled == pPlugin->hdlr + 1, step );
+        HOST_CHECK_STEP( testHdlrCBs == (void *)pCBs, step );
+      }
+      else
+      {
+        HOST_CHECK_STEP( testHdlrCalled == 0, step );
+      }
+    }
+  }
+}
+
+/*
+ * zcl_general callbacks on two endpoints, a cluster option splitting
+ * its range on one of them, and endpoints only AF or nobody knows.
+ */
+static void testGeneral( void )
+{
+  testCBsA.pfnBasicReset = testBasicResetCBA;
+  testCBsA.pfnOnOff = testOnOffCBA;
+  testCBsB.pfnOnOff = testOnOffCBB;
+
+  HOST_CHECK( zclGeneral_RegisterCmdCallbacks( TEST_EP_A, &testCBsA ) == ZSuccess );
+  HOST_CHECK( zclGeneral_RegisterCmdCallbacks( TEST_EP_B, &testCBsB ) == ZSuccess );
+  HOST_CHECK( zcl_registerClusterOptionList( TEST_EP_A,
+                                             sizeof( testGenOptions ) / sizeof( testGenOptions[0] ),
+                                             testGenOptions ) == ZSuccess );
+
+  // Each endpoint's own callbacks, on both sides of the option record
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_A, ZCL_CLUSTER_ID_GEN_BASIC ) == &testCBsA );
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_A, ZCL_CLUSTER_ID_GEN_ON_OFF ) == &testCBsA );
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_A, ZCL_CLUSTER_ID_GEN_MULTISTATE_VALUE_BASIC ) == &testCBsA );
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_B, ZCL_CLUSTER_ID_GEN_ON_OFF ) == &testCBsB );
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_AF, ZCL_CLUSTER_ID_GEN_ON_OFF ) == NULL );
+  HOST_CHECK( zcl_FindCallbacks( TEST_EP_A, ZCL_CLUSTER_ID_GEN_POLL_CONTROL ) == NULL );
+
+  testFindEpCnt = 0;
+  HOST_CHECK( testProcess( TEST_EP_A, ZCL_CLUSTER_ID_GEN_ON_OFF, TEST_FC_SPECIFIC,
+                           COMMAND_TOGGLE, TRUE ) == ZCL_PROC_SUCCESS );
+  HOST_CHECK( testOnOffA == COMMAND_TOGGLE && testOnOffB == 0 );
+  HOST_CHECK( testProcess( TEST_EP_A, ZCL_CLUSTER_ID_GEN_BASIC, TEST_FC_SPECIFIC,
+                           COMMAND_BASIC_RESET_FACT_DEFAULT, FALSE ) == ZCL_PROC_SUCCESS );
+  HOST_CHECK( testResetA == 1 );
+  HOST_CHECK( testProcess( TEST_EP_B, ZCL_CLUSTER_ID_GEN_ON_OFF, TEST_FC_SPECIFIC,
+                           COMMAND_ON, FALSE ) == ZCL_PROC_SUCCESS );
+  HOST_CHECK( testOnOffB == COMMAND_ON );
+  HOST_CHECK( testFindEpCnt == 0 );
+
+  // On/Off has to be secured on TEST_EP_A only
+  testOnOffA = 0;
+  HOST_CHECK( testProcess( TEST_EP_A, ZCL_CLUSTER_ID_GEN_ON_OFF, TEST_FC_SPECIFIC,
+                           COMMAND_OFF, FALSE ) == ZCL_PROC_NOT_SECURE );
+  HOST_CHECK( testOnOffA == 0 );
+
+  // Endpoints ZCL knows nothing about are still checked with AF
+  testOnOffA = testOnOffB = 0;
+  testFindEpCnt = 0;
+  HOST_CHECK( testProcess( TEST_EP_AF, ZCL_CLUSTER_ID_GEN_ON_OFF, TEST_FC_SPECIFIC,
+                           COMMAND_TOGGLE, FALSE ) != ZCL_PROC_EP_NOT_FOUND );
+  HOST_CHECK( testFindEpCnt == 1 );
+  HOST_CHECK( testProcess( TEST_EP_NONE, ZCL_CLUSTER_ID_GEN_ON_OFF, TEST_FC_SPECIFIC,
+                           COMMAND_TOGGLE, FALSE ) == ZCL_PROC_EP_NOT_FOUND );
+  HOST_CHECK( testOnOffA == 0 && testOnOffB == 0 );
+}
+
+/*
+ * Plugins, callbacks and option lists registered in random order, some
+ * callbacks before their plugin and some twice for an endpoint, with the
+ * whole table swept after each registration.
+ */
+static void testRandom( void )
+{
+  long step = 0;
+
+  while ( ( testNumPlugins < TEST_NUM_PLUGINS ) || ( testNumCBs < TEST_NUM_CBS ) ||
+          ( testNumOptions < TEST_NUM_OPTIONS ) )
+  {
+    uint8 what = rand() % 3;
+
+    if ( ( what == 0 ) && ( testNumPlugins < TEST_NUM_PLUGINS ) )
+    {
+      // One plugin in each span, several sharing a handler
+      testPlugin_t *pPlugin = &testPlugins[testNumPlugins];
+      uint16 span = TEST_FIRST_CLUSTER + testNumPlugins * TEST_PLUGIN_SPAN;
+
+      pPlugin->startClusterID = span + rand() % 0x40;
+      pPlugin->endClusterID = pPlugin->startClusterID + rand() % 0x40;
+      pPlugin->hdlr = rand() % TEST_NUM_HDLRS;
+      HOST_CHECK( zcl_registerPlugin( pPlugin->startClusterID, pPlugin->endClusterID,
+                                      testHdlrs[pPlugin->hdlr] ) == ZSuccess );
+      testNumPlugins++;
+    }
+    else if ( ( what == 1 ) && ( testNumCBs < TEST_NUM_CBS ) )
+    {
+      testCBs_t *pCBs = &testCBs[testNumCBs];
+
+      pCBs->endpoint = 1 + rand() % TEST_NUM_EPS;
+      pCBs->hdlr = rand() % TEST_NUM_HDLRS;
+      HOST_CHECK( zcl_registerCmdCallbacks( pCBs->endpoint, testHdlrs[pCBs->hdlr],
+                                            pCBs ) == ZSuccess );
+      testNumCBs++;
+    }
+    else if ( ( what == 2 ) && ( testNumOptions < TEST_NUM_OPTIONS ) )
+    {
+      testOptions_t *pOptions = &testOptions[testNumOptions];
+      uint8 i;
+
+      pOptions->endpoint = 1 + rand() % TEST_NUM_EPS;
+      pOptions->numOptions = 1 + rand() % TEST_MAX_OPTIONS;
+      for ( i = 0; i < pOptions->numOptions; i++ )
+      {
+        // Often at the edges of a span, where plugins start
+        uint16 span = TEST_FIRST_CLUSTER + ( rand() % TEST_NUM_PLUGINS ) * TEST_PLUGIN_SPAN;
+
+        pOptions->options[i].clusterID = span + ( ( rand() & 1 ) ? rand() % 0x80 : rand() % 2 );
+        pOptions->options[i].option = ( rand() & 1 ) ? AF_EN_SECURITY : AF_ACK_REQUEST;
+      }
+      HOST_CHECK( zcl_registerClusterOptionList( pOptions->endpoint, pOptions->numOptions,
+                                                 pOptions->options ) == ZSuccess );
+      testNumOptions++;
+    }
+    else
+    {
+      continue;
+    }
+
+    testSweep( step++ );
+  }
+}
+
+/*
+ * Frames per second through zcl_ProcessMessageMSG() to zcl_general.
+ */
+static void testBench( void )
+{
+  static const struct
+  {
+    uint8 endpoint;
+    const char *name;
+  } cases[] =
+  {
+    { TEST_EP_A,  "registered endpoint" },
+    { TEST_EP_AF, "AF only endpoint" },
+  };
+  uint8 i;
+
+  for ( i = 0; i < sizeof( cases ) / sizeof( cases[0] ); i++ )
+  {
+    double start = testUsec();
+    double usec;
+    long n;
+
+    for ( n = 0; n < TEST_BENCH_FRAMES; n++ )
+    {
+      (void)testProcess( cases[i].endpoint, ZCL_CLUSTER_ID_GEN_ON_OFF,
+                         TEST_FC_SPECIFIC, COMMAND_TOGGLE, TRUE );
+    }
+
+    usec = testUsec() - start;
+    printf( "%s: %.0f frames/sec\n", cases[i].name, TEST_BENCH_FRAMES * 1e6 / usec );
+  }
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  uint8 i;
+
+  srand( 1 );
+
+  for ( i = 1; i <= TEST_NUM_EPS; i++ )
+  {
+    testEpDesc[i].endPoint = i;
+    testEpDesc[i].simpleDesc = &testSimpleDesc;
+  }
+
+  testGeneral();
+  testRandom();
+  testBench();
+
+  printf( "zcl dispatch: ok\n" );
+  return ( 0 );
+}
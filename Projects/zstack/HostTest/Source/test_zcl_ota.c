@@ -0,0 +1,671 @@
+/**************************************************************************************************
+  Filename:       test_zcl_ota.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test and benchmark of the OTA server's image block cache:
+                  Image Block Requests from several clients at the same
+                  and at adjacent offsets, OTA console replies that arrive
+                  after the server gave up on them, and a short read at
+                  the end of the image, with MT_OtaFileReadReq() faked.
+                  Reports the blocks per second served to 150 clients.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+#include <time.h>
+
+#include "hal_types.h"  // Before hal_mcu.h, which includes the target one
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "AF.h"
+#include "zcl.h"
+#include "zcl_ota.h"
+#include "MT_OTA.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_TASK         6
+#define TEST_MANUFACTURER 0x1234
+#define TEST_IMAGE_TYPE   0x5678
+#define TEST_VERSION      0x00000002
+
+#define TEST_IMAGE_SIZE   1000L   // Not a whole number of windows
+
+#define TEST_CLIENT_ADDR  0x1000  // Short address of client 0
+#define TEST_MAX_CLIENTS  150
+#define TEST_MAX_READS    256
+
+// Bytes the server reads per window, see ZCL_OTA_BLOCK_CACHE_LEN
+#define TEST_WINDOW       ( OTA_MAX_MTU * 2 )
+
+// Past ZCL_OTA_BLOCK_CACHE_TIMEOUT
+#define TEST_TIMEOUT      2001
+
+// Frame control: cluster specific command to the server, without
+// Default Response
+#define TEST_FC_SPECIFIC  0x11
+
+#define TEST_BENCH_CLIENTS    150
+#define TEST_BENCH_IMAGE_SIZE 16384L
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+// Last Image Block Response a client got
+typedef struct
+{
+  uint32 offset;
+  uint16 numRsps;
+  uint8 status;
+  uint8 len;
+} testClient_t;
+
+// File read sent to the OTA console
+typedef struct
+{
+  afAddrType_t addr;
+  uint32 offset;
+  uint8 len;
+  uint8 answered;
+} testRead_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static zclOTA_FileID_t testFileId = { TEST_MANUFACTURER, TEST_IMAGE_TYPE, TEST_VERSION };
+static uint32 testImageSize = TEST_IMAGE_SIZE;
+
+static testClient_t testClients[TEST_MAX_CLIENTS];
+static testRead_t testReads[TEST_MAX_READS];
+static uint16 testNumReads;
+
+static endPointDesc_t *testEpDesc;
+static uint8 testSeq;
+
+/*********************************************************************
+ * STUBS
+ */
+
+uint8 APS_Counter;
+nwkIB_t _NIB;
+
+afStatus_t afRegister( endPointDesc_t *epDesc )
+{
+  testEpDesc = epDesc;
+  return ( afStatus_SUCCESS );
+}
+
+endPointDesc_t *afFindEndPointDesc( uint8 EndPoint )
+{
+  if ( ( testEpDesc != NULL ) && ( EndPoint == testEpDesc->endPoint ) )
+  {
+    return ( testEpDesc );
+  }
+  return ( NULL );
+}
+
+/*
+ * Image Block Responses are checked against the image and noted for
+ * the client they are sent to.
+ */
+afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
+                           uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                           uint8 options, uint8 radius )
+{
+  testClient_t *pClient;
+  uint8 *pData = buf + 3;
+  uint8 i;
+
+  HOST_CHECK( cID == ZCL_CLUSTER_ID_OTA && len >= 4 );
+  if ( buf[2] != COMMAND_IMAGE_BLOCK_RSP )
+  {
+    return ( afStatus_SUCCESS );
+  }
+
+  HOST_CHECK( dstAddr->addr.shortAddr >= TEST_CLIENT_ADDR &&
+              dstAddr->addr.shortAddr < TEST_CLIENT_ADDR + TEST_MAX_CLIENTS );
+  pClient = &testClients[dstAddr->addr.shortAddr - TEST_CLIENT_ADDR];
+  pClient->status = *pData++;
+  pClient->numRsps++;
+
+  if ( pClient->status == ZSuccess )
+  {
+    HOST_CHECK( BUILD_UINT16( pData[0], pData[1] ) == TEST_MANUFACTURER );
+    HOST_CHECK( BUILD_UINT16( pData[2], pData[3] ) == TEST_IMAGE_TYPE );
+    HOST_CHECK( osal_build_uint32( &pData[4], 4 ) == TEST_VERSION );
+    pClient->offset = osal_build_uint32( &pData[8], 4 );
+    pClient->len = pData[12];
+    pData += 13;
+
+    HOST_CHECK( pClient->len <= OTA_MAX_MTU );
+    HOST_CHECK( len == 3 + 14 + pClient->len );
+    HOST_CHECK( pClient->offset + pClient->len <= testImageSize );
+    for ( i = 0; i < pClient->len; i++ )
+    {
+      HOST_CHECK( pData[i] == (uint8)( ( pClient->offset + i ) * 31 + ( ( pClient->offset + i ) >> 8 ) ) );
+    }
+  }
+
+  return ( afStatus_SUCCESS );
+}
+
+uint8 MT_OtaFileReadReq( afAddrType_t *pAddr, zclOTA_FileID_t *pFileId,
+                         uint8 len, uint32 offset )
+{
+  HOST_CHECK( testNumReads < TEST_MAX_READS );
+  HOST_CHECK( osal_memcmp( pFileId, &testFileId, sizeof( zclOTA_FileID_t ) ) );
+
+  testReads[testNumReads].addr = *pAddr;
+  testReads[testNumReads].offset = offset;
+  testReads[testNumReads].len = len;
+  testReads[testNumReads].answered = FALSE;
+  testNumReads++;
+
+  return ( ZSuccess );
+}
+
+uint8 MT_OtaGetImage( afAddrType_t *pAddr, zclOTA_FileID_t *pFileId,
+                      uint16 hwVer, uint8 *ieee, uint8 options )
+{
+  return ( ZFailure );
+}
+
+uint8 MT_OtaSendStatus( uint16 shortAddr, uint8 type, uint8 status, uint8 optional )
+{
+  return ( ZSuccess );
+}
+
+void MT_OtaRegister( uint8 taskId )
+{
+}
+
+uint8 osal_nv_item_init( uint16 id, uint16 len, void *buf )
+{
+  return ( NV_ITEM_UNINIT );
+}
+
+uint8 osal_nv_read( uint16 id, uint16 ndx, uint16 len, void *buf )
+{
+  return ( NV_OPER_FAILED );
+}
+
+uint8 ZDO_RegisterForZDOMsg( uint8 taskID, uint16 clusterID )
+{
+  return ( ZSuccess );
+}
+
+uint32 bdb_getZCLFrameCounter( void )
+{
+  return ( 0 );
+}
+
+void bdb_ZclIdentifyCmdInd( uint16 identifyTime, uint8 endpoint )
+{
+}
+
+uint8 *osal_msg_receive( uint8 task_id )
+{
+  return ( hostOsalTakeMsg( task_id ) );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static double testUsec( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ( (ts.tv_sec * 1e6) + (ts.tv_nsec / 1e3) );
+}
+
+static uint8 testImage( uint32 offset )
+{
+  return ( (uint8)( offset * 31 + ( offset >> 8 ) ) );
+}
+
+/*
+ * Image Block Request of a block from a client.
+ */
+static void testBlockReq( uint8 client, uint32 offset )
+{
+  afIncomingMSGPacket_t pkt;
+  uint8 frame[3 + 14];
+  uint8 *pBuf = frame;
+
+  *pBuf++ = TEST_FC_SPECIFIC;
+  *pBuf++ = testSeq++;
+  *pBuf++ = COMMAND_IMAGE_BLOCK_REQ;
+  *pBuf++ = 0;   // Field control
+  *pBuf++ = LO_UINT16( TEST_MANUFACTURER );
+  *pBuf++ = HI_UINT16( TEST_MANUFACTURER );
+  *pBuf++ = LO_UINT16( TEST_IMAGE_TYPE );
+  *pBuf++ = HI_UINT16( TEST_IMAGE_TYPE );
+  pBuf = osal_buffer_uint32( pBuf, TEST_VERSION );
+  pBuf = osal_buffer_uint32( pBuf, offset );
+  *pBuf++ = OTA_MAX_MTU;
+
+  memset( &pkt, 0, sizeof( pkt ) );
+  pkt.clusterId = ZCL_CLUSTER_ID_OTA;
+  pkt.srcAddr.addrMode = afAddr16Bit;
+  pkt.srcAddr.addr.shortAddr = TEST_CLIENT_ADDR + client;
+  pkt.srcAddr.endPoint = ZCL_OTA_ENDPOINT;
+  pkt.endPoint = ZCL_OTA_ENDPOINT;
+  pkt.SecurityUse = TRUE;
+  pkt.cmd.DataLength = pBuf - frame;
+  pkt.cmd.Data = frame;
+
+  (void)zcl_ProcessMessageMSG( &pkt );
+}
+
+/*
+ * Pass a reply of the OTA console to the OTA task: 'cnt' bytes of the
+ * image from the read's offset, or a failure if 'status' is not ZSuccess.
+ */
+static void testConsoleRsp( uint8 cmd, afAddrType_t *pAddr, uint8 status,
+                            uint32 offset, uint8 cnt )
+{
+  OTA_MtMsg_t *pMsg;
+  uint8 *pBuf;
+  uint8 i;
+
+  pMsg = (OTA_MtMsg_t *)osal_msg_allocate( sizeof( OTA_MtMsg_t ) + 32 + cnt );
+  HOST_CHECK( pMsg != NULL );
+  pMsg->hdr.event = MT_SYS_OTA_MSG;
+  pMsg->cmd = cmd;
+
+  pBuf = OTA_FileIdToStream( &testFileId, pMsg->data );
+  pBuf = OTA_AfAddrToStream( pAddr, pBuf );
+  *pBuf++ = status;
+  if ( cmd == MT_OTA_NEXT_IMG_RSP )
+  {
+    *pBuf++ = 0;   // Options
+    pBuf = osal_buffer_uint32( pBuf, testImageSize );
+  }
+  else
+  {
+    pBuf = osal_buffer_uint32( pBuf, offset );
+    *pBuf++ = cnt;
+    for ( i = 0; i < cnt; i++ )
+    {
+      *pBuf++ = testImage( offset + i );
+    }
+  }
+
+  HOST_CHECK( osal_msg_send( TEST_TASK, (uint8 *)pMsg ) == SUCCESS );
+  (void)zclOTA_event_loop( TEST_TASK, SYS_EVENT_MSG );
+}
+
+/*
+ * Answer a read sent to the OTA console with what is left of the image,
+ * at most 'max' bytes.
+ */
+static void testAnswer( uint16 read, uint8 max )
+{
+  testRead_t *pRead = &testReads[read];
+  uint32 left = ( pRead->offset < testImageSize ) ? testImageSize - pRead->offset : 0;
+
+  HOST_CHECK( !pRead->answered );
+  pRead->answered = TRUE;
+  testConsoleRsp( MT_OTA_FILE_READ_RSP, &pRead->addr, ZSuccess, pRead->offset,
+                  (uint8)( ( left < max ) ? left : max ) );
+}
+
+/*
+ * Answer every read not answered yet, in the order they were sent.
+ */
+static void testAnswerAll( void )
+{
+  uint16 i;
+
+  for ( i = 0; i < testNumReads; i++ )
+  {
+    if ( !testReads[i].answered )
+    {
+      testAnswer( i, testReads[i].len );
+    }
+  }
+}
+
+static void testResetClients( void )
+{
+  memset( testClients, 0, sizeof( testClients ) );
+}
+
+/*
+ * Move time on so that every window is the least recently used once,
+ * with any read left over answered.
+ */
+static void testFlush( void )
+{
+  testAnswerAll();
+  hostOsalClock += TEST_TIMEOUT;
+  testResetClients();
+}
+
+/*
+ * Clients asking for the same block, and the blocks next to it, before
+ * and after the console answers are served by one read.
+ */
+static void testSameOffset( void )
+{
+  uint16 reads = testNumReads;
+  uint8 i;
+
+  testFlush();
+  for ( i = 0; i < 3; i++ )
+  {
+    testBlockReq( i, 0 );
+  }
+  HOST_CHECK( testNumReads == reads + 1 );
+  HOST_CHECK( testReads[reads].offset == 0 && testReads[reads].len == TEST_WINDOW );
+
+  // Nobody hears anything until the console answers
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_CHECK( testClients[i].numRsps == 0 );
+  }
+
+  testAnswer( reads, TEST_WINDOW );
+  for ( i = 0; i < 3; i++ )
+  {
+    HOST_CHECK_STEP( testClients[i].numRsps == 1 && testClients[i].status == ZSuccess, i );
+    HOST_CHECK_STEP( testClients[i].offset == 0 && testClients[i].len == OTA_MAX_MTU, i );
+  }
+
+  // The next block, and one straddling it, come from the window
+  testBlockReq( 3, OTA_MAX_MTU );
+  testBlockReq( 4, 5 );
+  HOST_CHECK( testNumReads == reads + 1 );
+  HOST_CHECK( testClients[3].status == ZSuccess && testClients[3].offset == OTA_MAX_MTU );
+  HOST_CHECK( testClients[3].len == OTA_MAX_MTU );
+  HOST_CHECK( testClients[4].status == ZSuccess && testClients[4].offset == 5 );
+  HOST_CHECK( testClients[4].len == OTA_MAX_MTU );
+}
+
+/*
+ * A client asking for a block in a window being read waits on it, one
+ * asking past it starts another read, and with every window being read
+ * the client is told to wait.
+ */
+static void testAdjacent( void )
+{
+  uint16 reads;
+
+  testFlush();
+  reads = testNumReads;
+
+  testBlockReq( 0, 128 );
+  testBlockReq( 1, 128 + OTA_MAX_MTU );
+  HOST_CHECK( testNumReads == reads + 1 );
+
+  // Only the start of the block is in the window being read
+  testBlockReq( 2, 128 + OTA_MAX_MTU + 1 );
+  HOST_CHECK( testNumReads == reads + 2 );
+  HOST_CHECK( testReads[reads + 1].offset == 128 + OTA_MAX_MTU + 1 );
+
+  testBlockReq( 3, 512 );
+  HOST_CHECK( testNumReads == reads + 2 );
+  HOST_CHECK( testClients[3].numRsps == 1 && testClients[3].status == ZOtaWaitForData );
+
+  testAnswerAll();
+  HOST_CHECK( testClients[0].status == ZSuccess && testClients[0].offset == 128 );
+  HOST_CHECK( testClients[1].status == ZSuccess && testClients[1].offset == 128 + OTA_MAX_MTU );
+  HOST_CHECK( testClients[2].status == ZSuccess && testClients[2].offset == 128 + OTA_MAX_MTU + 1 );
+
+  // The waiting client gets its block once a window is free
+  testBlockReq( 3, 512 );
+  HOST_CHECK( testNumReads == reads + 3 );
+  testAnswerAll();
+  HOST_CHECK( testClients[3].numRsps == 2 && testClients[3].status == ZSuccess );
+}
+
+/*
+ * Console replies arriving after the server gave up on them go to the
+ * client they were read for, one block long, and do not disturb the
+ * window read again since.
+ */
+static void testLateReply( void )
+{
+  uint16 reads;
+
+  testFlush();
+  reads = testNumReads;
+
+  // Both windows are read, and not answered in time
+  testBlockReq( 0, 256 );
+  testBlockReq( 1, 448 );
+  HOST_CHECK( testNumReads == reads + 2 );
+  hostOsalClock += TEST_TIMEOUT;
+
+  // One is read again for another client
+  testBlockReq( 2, 640 );
+  HOST_CHECK( testNumReads == reads + 3 );
+  HOST_CHECK( testClients[2].numRsps == 0 );
+
+  testAnswer( reads, TEST_WINDOW );
+  HOST_CHECK( testClients[0].numRsps == 1 && testClients[0].status == ZSuccess );
+  HOST_CHECK( testClients[0].offset == 256 && testClients[0].len == OTA_MAX_MTU );
+  HOST_CHECK( testClients[2].numRsps == 0 );
+
+  // A late failure is passed on too
+  testReads[reads + 1].answered = TRUE;
+  testConsoleRsp( MT_OTA_FILE_READ_RSP, &testReads[reads + 1].addr, ZFailure, 448, 0 );
+  HOST_CHECK( testClients[1].numRsps == 1 && testClients[1].status == ZOtaAbort );
+
+  // The window read since is still answered in full
+  testAnswer( reads + 2, TEST_WINDOW );
+  HOST_CHECK( testClients[2].numRsps == 1 && testClients[2].status == ZSuccess );
+  HOST_CHECK( testClients[2].offset == 640 );
+  testBlockReq( 3, 640 + OTA_MAX_MTU );
+  HOST_CHECK( testNumReads == reads + 3 );
+  HOST_CHECK( testClients[3].status == ZSuccess && testClients[3].offset == 640 + OTA_MAX_MTU );
+
+  // The same client moved on to another block, its late reply is not
+  // taken for the window read for that
+  testBlockReq( 6, 256 );
+  hostOsalClock += TEST_TIMEOUT;
+  testBlockReq( 6, 896 );
+  HOST_CHECK( testNumReads == reads + 5 );
+  testAnswer( reads + 3, TEST_WINDOW );
+  HOST_CHECK( testClients[6].numRsps == 1 && testClients[6].offset == 256 );
+  testAnswer( reads + 4, TEST_WINDOW );
+  HOST_CHECK( testClients[6].numRsps == 2 && testClients[6].offset == 896 );
+  testBlockReq( 7, 896 + OTA_MAX_MTU );
+  HOST_CHECK( testNumReads == reads + 5 );
+  HOST_CHECK( testClients[7].status == ZSuccess && testClients[7].offset == 896 + OTA_MAX_MTU );
+
+  // A reply within the timeout, with no request since, is still used
+  testBlockReq( 4, 768 );
+  hostOsalClock += TEST_TIMEOUT;
+  testAnswer( reads + 5, TEST_WINDOW );
+  HOST_CHECK( testClients[4].numRsps == 1 && testClients[4].status == ZSuccess );
+  testBlockReq( 5, 768 + OTA_MAX_MTU );
+  HOST_CHECK( testNumReads == reads + 6 );
+  HOST_CHECK( testClients[5].status == ZSuccess );
+}
+
+/*
+ * The console answers short at the end of the image: the rest of the
+ * image is served from the window, and a request past it reads again.
+ */
+static void testShortRead( void )
+{
+  uint16 reads;
+  uint32 offset = TEST_IMAGE_SIZE - TEST_WINDOW + 24;
+
+  testFlush();
+  reads = testNumReads;
+
+  testBlockReq( 0, offset );
+  testAnswer( reads, TEST_WINDOW );
+  HOST_CHECK( testClients[0].status == ZSuccess && testClients[0].len == OTA_MAX_MTU );
+
+  // The last block is shorter, and comes from the window
+  testBlockReq( 1, TEST_IMAGE_SIZE - 8 );
+  HOST_CHECK( testNumReads == reads + 1 );
+  HOST_CHECK( testClients[1].status == ZSuccess && testClients[1].len == 8 );
+  HOST_CHECK( testClients[1].offset == TEST_IMAGE_SIZE - 8 );
+
+  // Past the end of the image
+  testBlockReq( 2, TEST_IMAGE_SIZE );
+  HOST_CHECK( testNumReads == reads + 2 );
+  testAnswer( reads + 1, TEST_WINDOW );
+  HOST_CHECK( testClients[2].numRsps == 1 && testClients[2].status == ZOtaAbort );
+}
+
+/*
+ * 150 clients upgrading at once, a few at a time starting at the same
+ * block. Each round every client that is not waiting asks for its next
+ * block and the console then answers every read, so a round stands for
+ * one UART round trip to the console.
+ */
+static void testBench( void )
+{
+  uint32 offsets[TEST_BENCH_CLIENTS];
+  uint32 blocks = 0;
+  uint32 waits = 0;
+  uint32 rounds = 0;
+  uint16 done = 0;
+  uint16 reads = 0;
+  uint32 totalReads = 0;
+  double start;
+  double usec;
+  uint8 i;
+
+  testFlush();
+  testImageSize = TEST_BENCH_IMAGE_SIZE;
+  memset( offsets, 0, sizeof( offsets ) );
+
+  start = testUsec();
+  while ( done < TEST_BENCH_CLIENTS )
+  {
+    testNumReads = 0;
+    for ( i = 0; ( i < TEST_BENCH_CLIENTS ) && ( i < ( rounds + 1 ) * 4 ); i++ )
+    {
+      if ( offsets[i] < TEST_BENCH_IMAGE_SIZE )
+      {
+        testClients[i].status = 0xFF;
+        testClients[i].numRsps = 0;
+        testBlockReq( i, offsets[i] );
+      }
+    }
+
+    reads = testNumReads;
+    totalReads += reads;
+    testAnswerAll();
+    hostOsalClock += 10;
+
+    for ( i = 0; ( i < TEST_BENCH_CLIENTS ) && ( i < ( rounds + 1 ) * 4 ); i++ )
+    {
+      if ( offsets[i] >= TEST_BENCH_IMAGE_SIZE )
+      {
+        continue;
+      }
+
+      HOST_CHECK_STEP( testClients[i].numRsps == 1, rounds );
+      if ( testClients[i].status == ZSuccess )
+      {
+        HOST_CHECK_STEP( testClients[i].offset == offsets[i], rounds );
+        offsets[i] += testClients[i].len;
+        blocks++;
+        if ( offsets[i] >= TEST_BENCH_IMAGE_SIZE )
+        {
+          done++;
+        }
+      }
+      else
+      {
+        HOST_CHECK_STEP( testClients[i].status == ZOtaWaitForData, rounds );
+        waits++;
+      }
+    }
+
+    rounds++;
+  }
+  usec = testUsec() - start;
+
+  printf( "%u clients, %lu byte image: %lu blocks, %lu console reads, %lu waits, %lu round trips\n",
+          TEST_BENCH_CLIENTS, TEST_BENCH_IMAGE_SIZE, (unsigned long)blocks,
+          (unsigned long)totalReads, (unsigned long)waits, (unsigned long)rounds );
+  printf( "%.0f blocks/sec\n", blocks * 1e6 / usec );
+
+  testImageSize = TEST_IMAGE_SIZE;
+  testNumReads = 0;
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  afAddrType_t addr;
+
+  srand( 1 );
+
+  zclOTA_Init( TEST_TASK );
+  zclOTA_PermitOta( TRUE );
+
+  // The console offers the image, which the server then serves blocks of
+  memset( &addr, 0, sizeof( addr ) );
+  addr.addrMode = afAddr16Bit;
+  addr.addr.shortAddr = TEST_CLIENT_ADDR;
+  addr.endPoint = ZCL_OTA_ENDPOINT;
+  testConsoleRsp( MT_OTA_NEXT_IMG_RSP, &addr, ZSuccess, 0, 0 );
+  hostOsalBlocks = 0;
+
+  testSameOffset();
+  testAdjacent();
+  testLateReply();
+  testShortRead();
+  testBench();
+
+  HOST_CHECK( hostOsalBlocks == 0 );
+
+  printf( "zcl ota: ok\n" );
+  return ( 0 );
+}
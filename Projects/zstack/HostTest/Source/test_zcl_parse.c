@@ -0,0 +1,620 @@
+/**************************************************************************************************
+  Filename:       test_zcl_parse.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the in-place walkers over received ZCL foundation
+                  commands: the bounds checks of zclParseNextAttrID(),
+                  zclParseNextAttrRec() and the reporting configuration
+                  walkers on truncated and odd-length payloads, and the
+                  Write, Write Undivided and Report commands processed
+                  through zcl_ProcessMessageMSG() without parsing them into
+                  allocated structures.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "hal_types.h"  // Before hal_mcu.h, which includes the target one
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "AF.h"
+#include "zcl.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_EP           8     // Foundation commands processed by ZCL
+#define TEST_EP_EXT       9     // Foundation commands sent to TEST_TASK
+#define TEST_TASK         5
+#define TEST_CLUSTER      ZCL_CLUSTER_ID_GEN_ON_OFF
+#define TEST_PROFILE      0x0104
+
+#define TEST_ATTR_U8      0x0000
+#define TEST_ATTR_U16     0x0001
+#define TEST_ATTR_STR     0x0002
+#define TEST_ATTR_RO      0x0003
+#define TEST_ATTR_NONE    0x0009
+
+#define TEST_STR_MAX      16
+
+// Frame control: foundation command, without Default Response
+#define TEST_FC_CLIENT    0x10
+#define TEST_FC_SERVER    0x18
+
+#define TEST_INVALID      0xEE  // Value rejected by the validate callback
+
+#define TEST_FUZZ_FRAMES  200000L
+#define TEST_FUZZ_MAX     48
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static uint8 testU8;
+static uint16 testU16;
+static uint8 testStr[TEST_STR_MAX];
+static uint8 testRO;
+
+static CONST zclAttrRec_t testAttrs[] =
+{
+  { TEST_CLUSTER, { TEST_ATTR_U8,  ZCL_DATATYPE_UINT8,    ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE, (void *)&testU8 } },
+  { TEST_CLUSTER, { TEST_ATTR_U16, ZCL_DATATYPE_UINT16,   ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE, (void *)&testU16 } },
+  { TEST_CLUSTER, { TEST_ATTR_STR, ZCL_DATATYPE_CHAR_STR, ACCESS_CONTROL_READ | ACCESS_CONTROL_WRITE, (void *)testStr } },
+  { TEST_CLUSTER, { TEST_ATTR_RO,  ZCL_DATATYPE_UINT8,    ACCESS_CONTROL_READ,                        (void *)&testRO } },
+};
+
+static SimpleDescriptionFormat_t testSimpleDesc = { TEST_EP, TEST_PROFILE };
+static endPointDesc_t testEpDesc = { TEST_EP, 0, NULL, &testSimpleDesc };
+static endPointDesc_t testEpDescExt = { TEST_EP_EXT, 0, NULL, &testSimpleDesc };
+
+// Last frame sent through AF_DataRequest()
+static uint8 testSent[128];
+static uint16 testSentLen;
+static uint16 testSentCnt;
+
+static uint8 testSeq;
+
+/*********************************************************************
+ * STUBS
+ */
+
+uint8 APS_Counter;
+nwkIB_t _NIB;
+
+endPointDesc_t *afFindEndPointDesc( uint8 EndPoint )
+{
+  if ( EndPoint == TEST_EP )
+  {
+    return ( &testEpDesc );
+  }
+  if ( EndPoint == TEST_EP_EXT )
+  {
+    return ( &testEpDescExt );
+  }
+  return ( NULL );
+}
+
+afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
+                           uint16 cID, uint16 len, uint8 *buf, uint8 *transID,
+                           uint8 options, uint8 radius )
+{
+  HOST_CHECK( len <= sizeof( testSent ) );
+  memcpy( testSent, buf, len );
+  testSentLen = len;
+  testSentCnt++;
+  return ( afStatus_SUCCESS );
+}
+
+uint32 bdb_getZCLFrameCounter( void )
+{
+  return ( 0 );
+}
+
+void bdb_ZclIdentifyCmdInd( uint16 identifyTime, uint8 endpoint )
+{
+}
+
+uint8 *osal_msg_receive( uint8 task_id )
+{
+  return ( hostOsalTakeMsg( task_id ) );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static uint8 testValidate( zclAttrRec_t *pAttr, zclWriteRec_t *pAttrInfo )
+{
+  return ( pAttrInfo->attrData[0] != TEST_INVALID );
+}
+
+/*
+ * Pass a foundation command with the payload 'pData' to
+ * zcl_ProcessMessageMSG(), and return the heap blocks it allocated.
+ */
+static uint32 testProcess( uint8 endpoint, uint8 fc, uint8 cmdID,
+                           const uint8 *pData, uint16 len )
+{
+  afIncomingMSGPacket_t pkt;
+  uint8 frame[3 + 256];
+  uint32 allocs = hostOsalAllocs;
+
+  frame[0] = fc;
+  frame[1] = testSeq++;
+  frame[2] = cmdID;
+  memcpy( &frame[3], pData, len );
+
+  memset( &pkt, 0, sizeof( pkt ) );
+  pkt.clusterId = TEST_CLUSTER;
+  pkt.srcAddr.addrMode = afAddr16Bit;
+  pkt.srcAddr.addr.shortAddr = 0x1234;
+  pkt.srcAddr.endPoint = 1;
+  pkt.endPoint = endpoint;
+  pkt.SecurityUse = TRUE;
+  pkt.cmd.DataLength = 3 + len;
+  pkt.cmd.Data = frame;
+
+  testSentCnt = 0;
+  (void)zcl_ProcessMessageMSG( &pkt );
+  HOST_CHECK( hostOsalBlocks == 0 || endpoint == TEST_EP_EXT );
+
+  return ( hostOsalAllocs - allocs );
+}
+
+/*
+ * Walk the records of a payload, and return how many were found and
+ * the bytes left after them.
+ */
+static uint8 testWalkRecs( uint8 *pData, uint16 len, uint16 *pLeft )
+{
+  zclParseCmd_t cmd;
+  uint16 attrID;
+  uint8 dataType;
+  uint8 *pAttrData;
+  uint8 cnt = 0;
+
+  cmd.endpoint = TEST_EP;
+  cmd.pData = pData;
+  cmd.dataLen = len;
+  while ( zclParseNextAttrRec( &cmd, &attrID, &dataType, &pAttrData ) )
+  {
+    // The record and its data are in the payload, and consumed
+    HOST_CHECK( pAttrData == cmd.pData - zclGetAttrDataLength( dataType, pAttrData ) );
+    HOST_CHECK( cmd.pData <= pData + len );
+    HOST_CHECK( cmd.dataLen == (uint16)( pData + len - cmd.pData ) );
+    cnt++;
+  }
+
+  HOST_CHECK( cmd.pData == pData + len - cmd.dataLen );
+  *pLeft = cmd.dataLen;
+  return ( cnt );
+}
+
+/*
+ * zclParseNextAttrID on empty, odd and even lengths.
+ */
+static void testAttrID( void )
+{
+  uint8 buf[6] = { 0x01, 0x00, 0x02, 0x00, 0x03, 0x00 };
+  uint16 lens[] = { 0, 1, 2, 3, 5, 6 };
+  uint8 i;
+
+  for ( i = 0; i < sizeof( lens ) / sizeof( lens[0] ); i++ )
+  {
+    zclParseCmd_t cmd;
+    uint16 attrID;
+    uint16 cnt = 0;
+
+    cmd.pData = buf;
+    cmd.dataLen = lens[i];
+    while ( zclParseNextAttrID( &cmd, &attrID ) )
+    {
+      cnt++;
+      HOST_CHECK_STEP( attrID == cnt, i );
+    }
+
+    // An odd byte at the end is left over, never read as half an ID
+    HOST_CHECK_STEP( cnt == lens[i] / 2, i );
+    HOST_CHECK_STEP( cmd.dataLen == lens[i] % 2, i );
+  }
+}
+
+/*
+ * zclParseNextAttrRec on records cut at every length, and on
+ * string lengths that run past the end of the payload.
+ */
+static void testAttrRec( void )
+{
+  static const struct
+  {
+    uint8 len;
+    uint8 data[12];
+    uint8 recs;         // whole records
+    uint8 left;         // bytes left after them
+  } cases[] =
+  {
+    { 0,  { 0 },                                                 0, 0 },
+    { 1,  { 0x00 },                                              0, 1 },
+    { 2,  { 0x00, 0x00 },                                        0, 2 },
+    { 3,  { 0x00, 0x00, ZCL_DATATYPE_UINT8 },                    0, 3 },
+    { 4,  { 0x00, 0x00, ZCL_DATATYPE_UINT8, 0x11 },              1, 0 },
+    { 4,  { 0x01, 0x00, ZCL_DATATYPE_UINT16, 0x11 },             0, 4 },
+    { 5,  { 0x01, 0x00, ZCL_DATATYPE_UINT16, 0x11, 0x22 },       1, 0 },
+    { 6,  { 0x01, 0x00, ZCL_DATATYPE_UINT32, 0x11, 0x22, 0x33 }, 0, 6 },
+    // string without its length, or shorter than its length
+    { 3,  { 0x02, 0x00, ZCL_DATATYPE_CHAR_STR },                 0, 3 },
+    { 6,  { 0x02, 0x00, ZCL_DATATYPE_CHAR_STR, 3, 'a', 'b' },    0, 6 },
+    { 7,  { 0x02, 0x00, ZCL_DATATYPE_OCTET_STR, 3, 1, 2, 3 },    1, 0 },
+    { 4,  { 0x02, 0x00, ZCL_DATATYPE_CHAR_STR, 0 },              1, 0 },
+    { 4,  { 0x02, 0x00, ZCL_DATATYPE_CHAR_STR, 0xFF },           0, 4 },
+    { 4,  { 0x02, 0x00, ZCL_DATATYPE_LONG_CHAR_STR, 0x00 },      0, 4 },
+    { 6,  { 0x02, 0x00, ZCL_DATATYPE_LONG_OCTET_STR, 2, 0, 1 },  0, 6 },
+    { 7,  { 0x02, 0x00, ZCL_DATATYPE_LONG_OCTET_STR, 2, 0, 1, 2 }, 1, 0 },
+    { 7,  { 0x02, 0x00, ZCL_DATATYPE_LONG_CHAR_STR, 0, 1, 'a', 'b' }, 0, 7 },
+    // a whole record, then a cut one
+    { 9,  { 0x00, 0x00, ZCL_DATATYPE_UINT8, 0x11,
+            0x02, 0x00, ZCL_DATATYPE_CHAR_STR, 2, 'a' },         1, 5 },
+    { 10, { 0x00, 0x00, ZCL_DATATYPE_UINT8, 0x11,
+            0x01, 0x00, ZCL_DATATYPE_UINT16, 0x22, 0x33, 0x00 }, 2, 1 },
+  };
+  uint8 i;
+
+  for ( i = 0; i < sizeof( cases ) / sizeof( cases[0] ); i++ )
+  {
+    uint8 buf[12];
+    uint16 left;
+
+    memcpy( buf, cases[i].data, cases[i].len );
+    HOST_CHECK_STEP( testWalkRecs( buf, cases[i].len, &left ) == cases[i].recs, i );
+    HOST_CHECK_STEP( left == cases[i].left, i );
+  }
+}
+
+/*
+ * The reporting configuration walkers, on whole and cut records of
+ * both directions.
+ */
+static void testCfgReportRec( void )
+{
+  // reported analog uint16: direction, ID, type, min, max, change
+  uint8 analog[] = { ZCL_SEND_ATTR_REPORTS, 0x01, 0x00, ZCL_DATATYPE_UINT16,
+                     0x01, 0x00, 0x10, 0x00, 0x05, 0x00 };
+  // reported discrete boolean, without a Reportable Change
+  uint8 discrete[] = { ZCL_SEND_ATTR_REPORTS, 0x00, 0x00, ZCL_DATATYPE_BOOLEAN,
+                       0x02, 0x00, 0x20, 0x00 };
+  // received reports: direction, ID, timeout
+  uint8 receive[] = { ZCL_EXPECT_ATTR_REPORTS, 0x02, 0x00, 0x30, 0x00 };
+  uint8 buf[sizeof( analog ) + sizeof( discrete ) + sizeof( receive )];
+  zclCfgReportRec_t rec;
+  zclReadReportCfgRec_t readRec;
+  zclParseCmd_t cmd;
+  uint16 len;
+
+  memcpy( buf, analog, sizeof( analog ) );
+  memcpy( &buf[sizeof( analog )], discrete, sizeof( discrete ) );
+  memcpy( &buf[sizeof( analog ) + sizeof( discrete )], receive, sizeof( receive ) );
+
+  cmd.pData = buf;
+  cmd.dataLen = sizeof( buf );
+  HOST_CHECK( zclParseNextCfgReportRec( &cmd, &rec ) );
+  HOST_CHECK( rec.attrID == 1 && rec.dataType == ZCL_DATATYPE_UINT16 );
+  HOST_CHECK( rec.minReportInt == 1 && rec.maxReportInt == 0x10 );
+  HOST_CHECK( rec.reportableChange == &buf[8] );
+  HOST_CHECK( zclParseNextCfgReportRec( &cmd, &rec ) );
+  HOST_CHECK( rec.attrID == 0 && rec.maxReportInt == 0x20 );
+  HOST_CHECK( rec.reportableChange == NULL );
+  HOST_CHECK( zclParseNextCfgReportRec( &cmd, &rec ) );
+  HOST_CHECK( rec.direction == ZCL_EXPECT_ATTR_REPORTS );
+  HOST_CHECK( rec.attrID == 2 && rec.timeoutPeriod == 0x30 );
+  HOST_CHECK( !zclParseNextCfgReportRec( &cmd, &rec ) && cmd.dataLen == 0 );
+
+  // Every cut of each record is left unread
+  for ( len = 0; len < sizeof( analog ); len++ )
+  {
+    cmd.pData = analog;
+    cmd.dataLen = len;
+    HOST_CHECK_STEP( !zclParseNextCfgReportRec( &cmd, &rec ) && cmd.dataLen == len, len );
+  }
+  for ( len = 0; len < sizeof( discrete ); len++ )
+  {
+    cmd.pData = discrete;
+    cmd.dataLen = len;
+    HOST_CHECK_STEP( !zclParseNextCfgReportRec( &cmd, &rec ) && cmd.dataLen == len, len );
+  }
+  for ( len = 0; len < sizeof( receive ); len++ )
+  {
+    cmd.pData = receive;
+    cmd.dataLen = len;
+    HOST_CHECK_STEP( !zclParseNextCfgReportRec( &cmd, &rec ) && cmd.dataLen == len, len );
+  }
+
+  // Read Reporting Configuration records are 3 bytes
+  for ( len = 0; len <= sizeof( receive ); len++ )
+  {
+    uint8 cnt = 0;
+
+    cmd.pData = receive;
+    cmd.dataLen = len;
+    while ( zclParseNextReadReportCfgRec( &cmd, &readRec ) )
+    {
+      HOST_CHECK_STEP( readRec.direction == ZCL_EXPECT_ATTR_REPORTS, len );
+      HOST_CHECK_STEP( readRec.attrID == 2, len );
+      cnt++;
+    }
+    HOST_CHECK_STEP( cnt == len / 3 && cmd.dataLen == len % 3, len );
+  }
+}
+
+/*
+ * Random payloads: the walkers stay in the payload, and the allocating
+ * parsers kept for the external handlers find the same records.
+ */
+static void testFuzz( void )
+{
+  static const uint8 types[] =
+  {
+    ZCL_DATATYPE_UINT8, ZCL_DATATYPE_UINT16, ZCL_DATATYPE_UINT32,
+    ZCL_DATATYPE_CHAR_STR, ZCL_DATATYPE_OCTET_STR,
+    ZCL_DATATYPE_LONG_CHAR_STR, ZCL_DATATYPE_LONG_OCTET_STR,
+    ZCL_DATATYPE_BOOLEAN, ZCL_DATATYPE_INT24, ZCL_DATATYPE_IEEE_ADDR
+  };
+  long frame;
+
+  for ( frame = 0; frame < TEST_FUZZ_FRAMES; frame++ )
+  {
+    uint8 buf[TEST_FUZZ_MAX];
+    zclParseCmd_t cmd;
+    zclCfgReportRec_t rec;
+    zclWriteCmd_t *writeCmd;
+    zclReportCmd_t *reportCmd;
+    zclCfgReportCmd_t *cfgReportCmd;
+    uint16 len = rand() % ( TEST_FUZZ_MAX + 1 );
+    uint16 left;
+    uint8 recs;
+    uint8 cfgRecs = 0;
+    uint16 i;
+
+    for ( i = 0; i < len; i++ )
+    {
+      buf[i] = rand();
+    }
+    // Mostly known data types, short strings and both directions
+    for ( i = 0; i + 3 < len; i += 3 + ( rand() % 4 ) )
+    {
+      buf[i] = rand() % 2;
+      buf[i + 2] = types[rand() % sizeof( types )];
+      buf[i + 3] = ( buf[i + 3] % 8 );
+    }
+
+    recs = testWalkRecs( buf, len, &left );
+
+    cmd.endpoint = TEST_EP;
+    cmd.pData = buf;
+    cmd.dataLen = len;
+    while ( zclParseNextCfgReportRec( &cmd, &rec ) )
+    {
+      HOST_CHECK_STEP( cmd.pData <= buf + len, frame );
+      HOST_CHECK_STEP( ( rec.reportableChange == NULL ) ||
+                       ( rec.reportableChange + zclGetDataTypeLength( rec.dataType ) == cmd.pData ), frame );
+      cfgRecs++;
+    }
+    HOST_CHECK_STEP( cmd.pData + cmd.dataLen == buf + len, frame );
+
+    cmd.pData = buf;
+    cmd.dataLen = len;
+    writeCmd = (zclWriteCmd_t *)zclParseInWriteCmd( &cmd );
+    reportCmd = (zclReportCmd_t *)zclParseInReportCmd( &cmd );
+    cfgReportCmd = (zclCfgReportCmd_t *)zclParseInConfigReportCmd( &cmd );
+    HOST_CHECK_STEP( writeCmd != NULL && writeCmd->numAttr == recs, frame );
+    HOST_CHECK_STEP( reportCmd != NULL && reportCmd->numAttr == recs, frame );
+    HOST_CHECK_STEP( cfgReportCmd != NULL && cfgReportCmd->numAttr == cfgRecs, frame );
+    for ( i = 0; i < recs; i++ )
+    {
+      HOST_CHECK_STEP( writeCmd->attrList[i].attrID == reportCmd->attrList[i].attrID, frame );
+    }
+    osal_mem_free( writeCmd );
+    osal_mem_free( reportCmd );
+    osal_mem_free( cfgReportCmd );
+  }
+
+  HOST_CHECK( hostOsalBlocks == 0 );
+}
+
+/*
+ * Write and Write No Response, processed in place.
+ */
+static void testWrite( void )
+{
+  uint8 cmd[] =
+  {
+    TEST_ATTR_U8,   0x00, ZCL_DATATYPE_UINT8,    0x11,
+    TEST_ATTR_U16,  0x00, ZCL_DATATYPE_UINT16,   0x33, 0x22,
+    TEST_ATTR_RO,   0x00, ZCL_DATATYPE_UINT8,    0x44,
+    TEST_ATTR_STR,  0x00, ZCL_DATATYPE_CHAR_STR, 3, 'a', 'b', 'c',
+    TEST_ATTR_NONE, 0x00, ZCL_DATATYPE_UINT8,    0x01,
+    TEST_ATTR_U16,  0x00, ZCL_DATATYPE_UINT8,    0x01,
+    TEST_ATTR_U8,   0x00, ZCL_DATATYPE_UINT8     // cut, not written
+  };
+  uint8 rsp[] =
+  {
+    ZCL_STATUS_READ_ONLY,           TEST_ATTR_RO,   0x00,
+    ZCL_STATUS_UNSUPPORTED_ATTRIBUTE, TEST_ATTR_NONE, 0x00,
+    ZCL_STATUS_INVALID_DATA_TYPE,   TEST_ATTR_U16,  0x00
+  };
+  uint8 noRsp[] = { TEST_ATTR_U8, 0x00, ZCL_DATATYPE_UINT8, 0x55 };
+  uint32 allocs;
+
+  allocs = testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE, cmd, sizeof( cmd ) );
+  HOST_CHECK( testU8 == 0x11 && testU16 == 0x2233 && testRO == 0 );
+  HOST_CHECK( testStr[0] == 3 && memcmp( &testStr[1], "abc", 3 ) == 0 );
+  HOST_CHECK( testSentCnt == 1 && testSent[2] == ZCL_CMD_WRITE_RSP );
+  HOST_CHECK( testSentLen == 3 + sizeof( rsp ) && memcmp( &testSent[3], rsp, sizeof( rsp ) ) == 0 );
+  printf( "write: %u allocations\n", (unsigned)allocs );
+
+  // Without a response, nothing is allocated
+  allocs = testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE_NO_RSP, noRsp, sizeof( noRsp ) );
+  HOST_CHECK( testU8 == 0x55 && testSentCnt == 0 && allocs == 0 );
+
+  // An empty Write is answered with SUCCESS
+  (void)testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE, cmd, 0 );
+  HOST_CHECK( testSentCnt == 1 && testSentLen == 4 && testSent[3] == ZCL_STATUS_SUCCESS );
+}
+
+/*
+ * Write Undivided: all or none of the records are written.
+ */
+static void testWriteUndivided( void )
+{
+  uint8 ok[] =
+  {
+    TEST_ATTR_U8,  0x00, ZCL_DATATYPE_UINT8,  0x66,
+    TEST_ATTR_U16, 0x00, ZCL_DATATYPE_UINT16, 0x88, 0x77,
+    TEST_ATTR_U8,  0x00                                   // cut, ignored
+  };
+  uint8 readOnly[] =
+  {
+    TEST_ATTR_U8, 0x00, ZCL_DATATYPE_UINT8, 0x99,
+    TEST_ATTR_RO, 0x00, ZCL_DATATYPE_UINT8, 0x01
+  };
+  // The second write fails validation, so the first one is reverted
+  uint8 invalid[] =
+  {
+    TEST_ATTR_U8,  0x00, ZCL_DATATYPE_UINT8,  0x12,
+    TEST_ATTR_STR, 0x00, ZCL_DATATYPE_CHAR_STR, 1, 'z',
+    TEST_ATTR_U16, 0x00, ZCL_DATATYPE_UINT16, TEST_INVALID, 0x00
+  };
+
+  (void)testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE_UNDIVIDED, ok, sizeof( ok ) );
+  HOST_CHECK( testU8 == 0x66 && testU16 == 0x7788 );
+  HOST_CHECK( testSentCnt == 1 && testSentLen == 4 && testSent[3] == ZCL_STATUS_SUCCESS );
+
+  (void)testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE_UNDIVIDED, readOnly, sizeof( readOnly ) );
+  HOST_CHECK( testU8 == 0x66 );
+  HOST_CHECK( testSentCnt == 1 && testSentLen == 6 );
+  HOST_CHECK( testSent[3] == ZCL_STATUS_READ_ONLY && testSent[4] == TEST_ATTR_RO );
+
+  (void)testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_WRITE_UNDIVIDED, invalid, sizeof( invalid ) );
+  HOST_CHECK( testU8 == 0x66 && testU16 == 0x7788 );
+  HOST_CHECK( testStr[0] == 3 && memcmp( &testStr[1], "abc", 3 ) == 0 );
+  HOST_CHECK( testSentCnt == 1 && testSentLen == 6 );
+  HOST_CHECK( testSent[3] == ZCL_STATUS_INVALID_VALUE && testSent[4] == TEST_ATTR_U16 );
+}
+
+/*
+ * Reports: nothing is allocated without a task to send them to, and
+ * the task registered gets them parsed.
+ */
+static void testReport( void )
+{
+  uint8 report[] =
+  {
+    TEST_ATTR_U8,  0x00, ZCL_DATATYPE_UINT8,    0x42,
+    TEST_ATTR_STR, 0x00, ZCL_DATATYPE_CHAR_STR, 2, 'h', 'i',
+    TEST_ATTR_U16, 0x00, ZCL_DATATYPE_UINT16,   0x01        // cut
+  };
+  uint8 cfgReport[] =
+  {
+    ZCL_SEND_ATTR_REPORTS, TEST_ATTR_U16, 0x00, ZCL_DATATYPE_UINT16,
+    0x01, 0x00, 0x10, 0x00, 0x05, 0x00
+  };
+  zclIncomingMsg_t *pMsg;
+  zclReportCmd_t *reportCmd;
+  zclCfgReportCmd_t *cfgReportCmd;
+  uint32 allocs;
+
+  allocs = testProcess( TEST_EP, TEST_FC_SERVER, ZCL_CMD_REPORT, report, sizeof( report ) );
+  HOST_CHECK( allocs == 0 && testSentCnt == 0 );
+  allocs = testProcess( TEST_EP, TEST_FC_CLIENT, ZCL_CMD_CONFIG_REPORT, cfgReport, sizeof( cfgReport ) );
+  HOST_CHECK( allocs == 0 );
+
+  allocs = testProcess( TEST_EP_EXT, TEST_FC_SERVER, ZCL_CMD_REPORT, report, sizeof( report ) );
+  printf( "report to a task: %u allocations\n", (unsigned)allocs );
+  pMsg = (zclIncomingMsg_t *)hostOsalTakeMsg( TEST_TASK );
+  HOST_CHECK( pMsg != NULL && pMsg->hdr.event == ZCL_INCOMING_MSG );
+  HOST_CHECK( pMsg->zclHdr.commandID == ZCL_CMD_REPORT && pMsg->endPoint == TEST_EP_EXT );
+  reportCmd = (zclReportCmd_t *)pMsg->attrCmd;
+  HOST_CHECK( reportCmd->numAttr == 2 );
+  HOST_CHECK( reportCmd->attrList[0].attrID == TEST_ATTR_U8 );
+  HOST_CHECK( reportCmd->attrList[0].attrData[0] == 0x42 );
+  HOST_CHECK( reportCmd->attrList[1].dataType == ZCL_DATATYPE_CHAR_STR );
+  HOST_CHECK( memcmp( reportCmd->attrList[1].attrData, "\x02hi", 3 ) == 0 );
+  osal_mem_free( pMsg->attrCmd );
+  osal_msg_deallocate( (uint8 *)pMsg );
+
+  (void)testProcess( TEST_EP_EXT, TEST_FC_CLIENT, ZCL_CMD_CONFIG_REPORT, cfgReport, sizeof( cfgReport ) );
+  pMsg = (zclIncomingMsg_t *)hostOsalTakeMsg( TEST_TASK );
+  HOST_CHECK( pMsg != NULL && pMsg->zclHdr.commandID == ZCL_CMD_CONFIG_REPORT );
+  cfgReportCmd = (zclCfgReportCmd_t *)pMsg->attrCmd;
+  HOST_CHECK( cfgReportCmd->numAttr == 1 );
+  HOST_CHECK( cfgReportCmd->attrList[0].maxReportInt == 0x10 );
+  HOST_CHECK( *(uint16 *)cfgReportCmd->attrList[0].reportableChange == 5 );
+  osal_mem_free( pMsg->attrCmd );
+  osal_msg_deallocate( (uint8 *)pMsg );
+
+  HOST_CHECK( hostOsalTakeMsg( TEST_TASK ) == NULL );
+  HOST_CHECK( hostOsalBlocks == 0 );
+}
+
+/*********************************************************************
+ * MAIN
+ */
+
+int main( void )
+{
+  srand( 1 );
+
+  HOST_CHECK( zcl_registerAttrList( TEST_EP, sizeof( testAttrs ) / sizeof( testAttrs[0] ),
+                                    testAttrs ) == ZSuccess );
+  HOST_CHECK( zcl_registerValidateAttrData( testValidate ) == ZSuccess );
+  HOST_CHECK( zcl_registerForMsgExt( TEST_TASK, TEST_EP_EXT ) == TRUE );
+  hostOsalBlocks = 0;
+
+  testAttrID();
+  testAttrRec();
+  testCfgReportRec();
+  testFuzz();
+  testWrite();
+  testWriteUndivided();
+  testReport();
+
+  printf( "zcl parse: ok\n" );
+  return ( 0 );
+}
@@ -0,0 +1,263 @@
+/**************************************************************************************************
+  Filename:       test_zdiags.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Host test of the ZDiags statistics journal. Counters are moved,
+                  saved, cleared and restored after resets, with and without
+                  a restart of the system clock, and checked against a model.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+#include "ZComDef.h"
+#include "OSAL_Nv.h"
+#include "ZMAC.h"
+#include "ZDiags.h"
+#include "host_nv.h"
+#include "host_osal.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_STEPS      200000L
+
+// First attribute of the stack counters, after SysClock, resets,
+// PersistentMemoryWrites and the eight MAC counters
+#define TEST_FIRST_CNT  11
+
+// Most updates go to a few counters, the way a running network does
+#define TEST_HOT_CNTS   5
+
+#define TEST_MAC_CNTS   (ZDIAGS_MAC_TX_UCAST_FAIL - ZDIAGS_MAC_RX_CRC_PASS + 1)
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+static const uint16 testAttrs[] =
+{
+  ZDIAGS_SYSTEM_CLOCK, ZDIAGS_NUMBER_OF_RESETS, ZDIAGS_PERSISTENT_MEMORY_WRITES,
+  ZDIAGS_MAC_RX_CRC_PASS, ZDIAGS_MAC_RX_CRC_FAIL, ZDIAGS_MAC_RX_BCAST, ZDIAGS_MAC_TX_BCAST,
+  ZDIAGS_MAC_RX_UCAST, ZDIAGS_MAC_TX_UCAST, ZDIAGS_MAC_TX_UCAST_RETRY, ZDIAGS_MAC_TX_UCAST_FAIL,
+  ZDIAGS_NWK_DECRYPT_FAILURES, ZDIAGS_PACKET_VALIDATE_DROP_COUNT, ZDIAGS_APS_TX_BCAST,
+  ZDIAGS_APS_TX_UCAST_SUCCESS, ZDIAGS_APS_TX_UCAST_RETRY,
+  ZDIAGS_ROUTE_DISC_INITIATED, ZDIAGS_NEIGHBOR_ADDED, ZDIAGS_NEIGHBOR_REMOVED,
+  ZDIAGS_NEIGHBOR_STALE, ZDIAGS_JOIN_INDICATION, ZDIAGS_CHILD_MOVED, ZDIAGS_NWK_FC_FAILURE,
+  ZDIAGS_PACKET_BUFFER_ALLOCATE_FAILURES, ZDIAGS_RELAYED_UCAST,
+  ZDIAGS_PHY_TO_MAC_QUEUE_LIMIT_REACHED, ZDIAGS_APS_RX_BCAST, ZDIAGS_APS_RX_UCAST,
+  ZDIAGS_APS_TX_UCAST_FAIL, ZDIAGS_APS_FC_FAILURE, ZDIAGS_APS_UNAUTHORIZED_KEY,
+  ZDIAGS_APS_DECRYPT_FAILURES, ZDIAGS_APS_INVALID_PACKETS,
+  ZDIAGS_MAC_RETRIES_PER_APS_TX_SUCCESS
+};
+
+#define TEST_ATTRS  (sizeof( testAttrs ) / sizeof( testAttrs[0] ))
+
+// The model: what each stack counter should read
+static uint16 refCnt[TEST_ATTRS];
+
+// MAC diagnostics PIB
+static uint32 macCnt[TEST_MAC_CNTS];
+
+/*********************************************************************
+ * STUBS
+ */
+
+ZMacStatus_t ZMacGetReq( ZMacAttributes_t attr, byte *value )
+{
+  memcpy( value, &macCnt[attr - ZMacDiagsRxCrcPass], sizeof( uint32 ) );
+  return ( ZMacSuccess );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void testReset( void )
+{
+  uint16 bootCnt = 0;
+
+  hostNvReset();
+  HOST_CHECK( osal_nv_item_init( ZCD_NV_BOOTCOUNTER, sizeof( bootCnt ), &bootCnt ) == NV_ITEM_UNINIT );
+  memset( refCnt, 0, sizeof( refCnt ) );
+  memset( macCnt, 0, sizeof( macCnt ) );
+  hostOsalClock = 1000;
+  HOST_CHECK( ZDiagsInitStats() == ZSuccess );
+}
+
+/*
+ * Every stack counter must read as in the model.
+ */
+static void checkCounters( long step )
+{
+  uint8 x;
+
+  for ( x = TEST_FIRST_CNT; x < TEST_ATTRS; x++ )
+  {
+    HOST_CHECK_STEP( (uint16)ZDiagsGetStatsAttr( testAttrs[x] ) == refCnt[x], step );
+  }
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+static void testReplay( uint8 restartClock )
+{
+  uint32 saves = 0;
+  long step;
+
+  testReset();
+  srand( 1 + restartClock );
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    uint8 op = rand() % 100;
+
+    if ( op < 90 )
+    {
+      uint8 x = TEST_FIRST_CNT + (rand() % (TEST_ATTRS - TEST_FIRST_CNT));
+
+      if ( rand() % 4 )
+      {
+        x = TEST_FIRST_CNT + (rand() % TEST_HOT_CNTS);
+      }
+      ZDiagsUpdateStats( testAttrs[x] );
+      refCnt[x]++;
+    }
+    else if ( op < 93 )
+    {
+      macCnt[rand() % TEST_MAC_CNTS] += rand() % 5;
+    }
+    else if ( op < 98 )
+    {
+      // Saves within one clock tick happen too
+      if ( rand() % 3 )
+      {
+        hostOsalClock++;
+      }
+      ZDiagsSaveStatsToNV();
+      saves++;
+    }
+    else if ( (op < 99) && ((rand() % 20) == 0) )
+    {
+      ZDiagsClearStats( rand() % 2 );
+      memset( refCnt, 0, sizeof( refCnt ) );
+    }
+    else if ( op == 99 )
+    {
+      // Reset: save, restart the MAC and maybe the clock, and restore
+      hostOsalClock++;
+      ZDiagsSaveStatsToNV();
+      saves++;
+
+      memset( macCnt, 0, sizeof( macCnt ) );
+      if ( restartClock )
+      {
+        hostOsalClock = 1000 + (rand() % 8);
+      }
+      HOST_CHECK_STEP( ZDiagsInitStats() == ZSuccess, step );
+      checkCounters( step );
+    }
+  }
+
+  printf( "replay%s: %lu saves took %lu NV writes\n",
+          restartClock ? " with clock restarts" : "",
+          (unsigned long)saves, (unsigned long)hostNvWrites );
+}
+
+static void testSaveWrites( void )
+{
+  uint32 writes;
+  uint8 x;
+
+  testReset();
+
+  // Nothing moved, nothing written
+  hostOsalClock++;
+  writes = hostNvWrites;
+  ZDiagsSaveStatsToNV();
+  HOST_CHECK( hostNvWrites == writes );
+
+  // Moving MAC counters alone are saved with the table, not journalled
+  macCnt[0] += 10;
+  hostOsalClock++;
+  ZDiagsSaveStatsToNV();
+  HOST_CHECK( hostNvWrites == writes );
+
+  // One counter moved: one journal write
+  ZDiagsUpdateStats( testAttrs[TEST_FIRST_CNT] );
+  hostOsalClock++;
+  ZDiagsSaveStatsToNV();
+  HOST_CHECK( hostNvWrites == writes + 1 );
+
+  // The same counter again reuses its record, saves keep going to the journal
+  for ( x = 0; x < 20; x++ )
+  {
+    ZDiagsUpdateStats( testAttrs[TEST_FIRST_CNT] );
+    hostOsalClock++;
+    ZDiagsSaveStatsToNV();
+  }
+  HOST_CHECK( hostNvWrites == writes + 21 );
+
+  // The journal fills up with different counters and is folded
+  for ( x = TEST_FIRST_CNT; x < TEST_ATTRS; x++ )
+  {
+    ZDiagsUpdateStats( testAttrs[x] );
+  }
+  writes = hostNvWrites;
+  hostOsalClock++;
+  ZDiagsSaveStatsToNV();
+  HOST_CHECK( hostNvWrites == writes + 1 );
+  HOST_CHECK( memcmp( hostNvItem( ZCD_NV_DIAGNOSTIC_STATS ), ZDiagsGetStatsTable(),
+                      sizeof( DiagStatistics_t ) ) == 0 );
+}
+
+int main( void )
+{
+  testReplay( FALSE );
+  testReplay( TRUE );
+  testSaveWrites();
+
+  printf( "test_zdiags passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
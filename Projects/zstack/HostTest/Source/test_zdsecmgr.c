@@ -0,0 +1,426 @@
+/**************************************************************************************************
+  Filename:       test_zdsecmgr.c
+  Revised:        $Date$
+  Revision:       $Revision$
+
+  Description:    Join storm against the Security Manager entry table. Checks
+                  the address index chains against a scan of the table after
+                  every join and leave, and checks the link key state kept in
+                  RAM against the keys in NV.
+
+
+  Copyright 2026 Texas Instruments Incorporated. All rights reserved.
+
+  IMPORTANT: Your use of this Software is limited to those specific rights
+  granted under the terms of a software license agreement between the user
+  who downloaded the software, his/her employer (which must be your employer)
+  and Texas Instruments Incorporated (the "License").  You may not use this
+  Software unless you agree to abide by the terms of the License. The License
+  limits your use, and you acknowledge, that the Software may not be modified,
+  copied or distributed unless embedded on a Texas Instruments microcontroller
+  or used solely and exclusively in conjunction with a Texas Instruments radio
+  frequency transceiver, which is integrated into your product.  Other than for
+  the foregoing purpose, you may not use, reproduce, copy, prepare derivative
+  works of, modify, distribute, perform, display or sell this Software and/or
+  its documentation for any purpose.
+
+  YOU FURTHER ACKNOWLEDGE AND AGREE THAT THE SOFTWARE AND DOCUMENTATION ARE
+  PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+  INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF MERCHANTABILITY, TITLE,
+  NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT SHALL
+  TEXAS INSTRUMENTS OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER CONTRACT,
+  NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR OTHER
+  LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+  INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE
+  OR CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT
+  OF SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+  (INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+
+  Should you have any questions regarding your right to use this Software,
+  contact Texas Instruments Incorporated at www.TI.com.
+**************************************************************************************************/
+
+
+/*********************************************************************
+ * INCLUDES
+ */
+#include <string.h>
+
+// Built with the Security Manager so its entry chains can be checked
+#include "ZDSecMgr.c"
+
+#include "host_nv.h"
+#include "host_test.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+#define TEST_DEVICES   (ZDSECMGR_ENTRY_MAX * 2)  // Devices taking part in the storm
+#define TEST_AMI_MAX   (TEST_DEVICES + 16)       // Address manager entries
+#define TEST_STEPS     40000
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint8 used;
+  uint16 nwkAddr;
+  uint8 extAddr[Z_EXTADDR_LEN];
+} testAddr_t;
+
+/*********************************************************************
+ * LOCAL VARIABLES
+ */
+
+// The address manager: indexes are handed out at random, and reused
+static testAddr_t testAddr[TEST_AMI_MAX];
+
+/*********************************************************************
+ * STUBS
+ */
+
+void AddrMgrExtAddrSet( uint8* dstExtAddr, uint8* srcExtAddr )
+{
+  memcpy( dstExtAddr, srcExtAddr, Z_EXTADDR_LEN );
+}
+
+static uint16 testAddrFind( uint8* extAddr )
+{
+  uint16 x;
+
+  for ( x = 0; x < TEST_AMI_MAX; x++ )
+  {
+    if ( testAddr[x].used && (memcmp( testAddr[x].extAddr, extAddr, Z_EXTADDR_LEN ) == 0) )
+    {
+      return x;
+    }
+  }
+
+  return INVALID_NODE_ADDR;
+}
+
+uint8 AddrMgrEntryUpdate( AddrMgrEntry_t* entry )
+{
+  uint16 x = testAddrFind( entry->extAddr );
+
+  if ( x == INVALID_NODE_ADDR )
+  {
+    x = rand() % TEST_AMI_MAX;
+    while ( testAddr[x].used )
+    {
+      x = (x + 1) % TEST_AMI_MAX;
+    }
+    testAddr[x].used = TRUE;
+    memcpy( testAddr[x].extAddr, entry->extAddr, Z_EXTADDR_LEN );
+  }
+  testAddr[x].nwkAddr = entry->nwkAddr;
+  entry->index = x;
+
+  return ( TRUE );
+}
+
+uint8 AddrMgrEntryLookupExt( AddrMgrEntry_t* entry )
+{
+  entry->index = testAddrFind( entry->extAddr );
+
+  return ( entry->index != INVALID_NODE_ADDR );
+}
+
+uint8 AddrMgrEntryRelease( AddrMgrEntry_t* entry )
+{
+  if ( (entry->index >= TEST_AMI_MAX) || !testAddr[entry->index].used )
+  {
+    return ( FALSE );
+  }
+
+  testAddr[entry->index].used = FALSE;
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ */
+
+static void testExtAddr( uint16 dev, uint8* extAddr )
+{
+  memset( extAddr, 0, Z_EXTADDR_LEN );
+  extAddr[0] = LO_UINT16( dev );
+  extAddr[1] = HI_UINT16( dev );
+  extAddr[7] = 0x12;
+}
+
+static void testReset( void )
+{
+  APSME_LinkKeyData_t key;
+  uint16 x;
+
+  hostNvReset();
+  memset( &key, 0, sizeof( key ) );
+  for ( x = 0; x < ZDSECMGR_ENTRY_MAX; x++ )
+  {
+    HOST_CHECK( osal_nv_item_init( ZCD_NV_APS_LINK_KEY_DATA_START + x,
+                                   sizeof( key ), &key ) == NV_ITEM_UNINIT );
+  }
+  memset( testAddr, 0, sizeof( testAddr ) );
+
+  osal_mem_free( ZDSecMgrEntries );
+  ZDSecMgrEntries = NULL;
+  ZDSecMgrEntryInit( ZDO_INITDEV_NEW_NETWORK_STATE );
+  HOST_CHECK( ZDSecMgrEntries != NULL );
+}
+
+/*
+ * Entry of an address index, found by a scan of the whole table.
+ */
+static uint16 refEntry( uint16 ami )
+{
+  uint16 x;
+
+  for ( x = 0; x < ZDSECMGR_ENTRY_MAX; x++ )
+  {
+    if ( ZDSecMgrEntries[x].ami == ami )
+    {
+      return x;
+    }
+  }
+
+  return ZDSECMGR_ENTRY_NONE;
+}
+
+/*
+ * Whether the device's key is set, from the key in NV.
+ */
+static uint8 refKeyValid( uint8* extAddr )
+{
+  uint16 ami = testAddrFind( extAddr );
+  uint16 x;
+  uint8* item;
+
+  if ( (ami == INVALID_NODE_ADDR) || ((x = refEntry( ami )) == ZDSECMGR_ENTRY_NONE) ||
+       (ZDSecMgrEntries[x].keyNvId == SEC_NO_KEY_NV_ID) )
+  {
+    return ( FALSE );
+  }
+
+  item = hostNvItem( ZDSecMgrEntries[x].keyNvId );
+
+  return ( (item != NULL) && !osal_isbufset( item, 0x00, SEC_KEY_LEN ) );
+}
+
+/*
+ * Every entry must sit once on the chain of its address index, free
+ * entries on the free chain, and every lookup must match a table scan.
+ */
+static void checkChains( long step )
+{
+  uint8 seen[ZDSECMGR_ENTRY_MAX];
+  uint16 lookups;
+  uint16 index;
+  uint16 x;
+
+  memset( seen, 0, sizeof( seen ) );
+
+  for ( x = 0; x <= ZDSECMGR_AMI_HASH_SIZE; x++ )
+  {
+    index = ( x < ZDSECMGR_AMI_HASH_SIZE ) ? ZDSecMgrAmiHash[x] : ZDSecMgrFreeHead;
+    lookups = 0;
+
+    while ( index != ZDSECMGR_ENTRY_NONE )
+    {
+      HOST_CHECK_STEP( index < ZDSECMGR_ENTRY_MAX, step );
+      HOST_CHECK_STEP( !seen[index], step );
+      HOST_CHECK_STEP( ZDSecMgrEntryChain( ZDSecMgrEntries[index].ami ) ==
+                       (( x < ZDSECMGR_AMI_HASH_SIZE ) ? &ZDSecMgrAmiHash[x] : &ZDSecMgrFreeHead),
+                       step );
+      HOST_CHECK_STEP( ++lookups <= ZDSECMGR_ENTRY_MAX, step );
+      seen[index] = TRUE;
+      index = ZDSecMgrEntryNext[index];
+    }
+  }
+
+  for ( x = 0; x < ZDSECMGR_ENTRY_MAX; x++ )
+  {
+    HOST_CHECK_STEP( seen[x], step );
+  }
+
+  for ( x = 0; x < TEST_AMI_MAX; x++ )
+  {
+    uint16 ref = refEntry( x );
+
+    if ( ZDSecMgrEntryLookupAMIGetIndex( x, &index ) == ZSuccess )
+    {
+      HOST_CHECK_STEP( index == ref, step );
+    }
+    else
+    {
+      HOST_CHECK_STEP( ref == ZDSECMGR_ENTRY_NONE, step );
+    }
+  }
+
+  HOST_CHECK_STEP( ZDSecMgrEntryLookupAMIGetIndex( INVALID_NODE_ADDR, &index ) != ZSuccess, step );
+}
+
+/*********************************************************************
+ * TESTS
+ */
+
+/*
+ * Devices join, leave and rejoin at random while keys are written through
+ * the Security Manager and, as MT does, straight to NV.
+ */
+static void testJoinStorm( void )
+{
+  uint32 joins = 0;
+  uint32 full = 0;
+  uint32 leaves = 0;
+  uint32 keyChecks = 0;
+  long step;
+
+  testReset();
+  srand( 1 );
+
+  for ( step = 0; step < TEST_STEPS; step++ )
+  {
+    uint8 extAddr[Z_EXTADDR_LEN];
+    uint8 key[SEC_KEY_LEN];
+    uint8 op = rand() % 100;
+    uint16 dev = rand() % TEST_DEVICES;
+    uint16 ami = INVALID_NODE_ADDR;
+    uint16 keyNvId;
+    ZStatus_t status;
+    uint8 had;
+
+    testExtAddr( dev, extAddr );
+    osal_memset( key, (op & 1) ? 0x00 : (uint8)(1 + dev), SEC_KEY_LEN );
+
+    if ( op < 45 )
+    {
+      // A joiner gets an entry unless the table is full
+      ami = testAddrFind( extAddr );
+      had = ( ami != INVALID_NODE_ADDR ) && ( refEntry( ami ) != ZDSECMGR_ENTRY_NONE );
+      status = ZDSecMgrAddLinkKey( (uint16)(0x1000 + dev), extAddr, key );
+      ami = testAddrFind( extAddr );
+      if ( had || (refEntry( INVALID_NODE_ADDR ) != ZDSECMGR_ENTRY_NONE) ||
+           (refEntry( ami ) != ZDSECMGR_ENTRY_NONE) )
+      {
+        HOST_CHECK_STEP( status == ZSuccess, step );
+        HOST_CHECK_STEP( refEntry( ami ) != ZDSECMGR_ENTRY_NONE, step );
+        joins++;
+      }
+      else
+      {
+        HOST_CHECK_STEP( status == ZBufferFull, step );
+        full++;
+      }
+    }
+    else if ( op < 75 )
+    {
+      // A device leaves, and its address index may go to another device
+      had = ( ZDSecMgrDeviceRemoveByExtAddr( extAddr ) == ZSuccess );
+      if ( had )
+      {
+        leaves++;
+      }
+      if ( rand() % 2 )
+      {
+        ZDSecMgrAddrClear( extAddr );
+      }
+    }
+    else if ( op < 85 )
+    {
+      // MT writes or deletes the key item behind the Security Manager
+      if ( ( APSME_LinkKeyNVIdGet( extAddr, &keyNvId ) == ZSuccess ) &&
+           ( keyNvId != SEC_NO_KEY_NV_ID ) )
+      {
+        if ( rand() % 4 )
+        {
+          APSME_LinkKeyData_t data;
+
+          memset( &data, 0, sizeof( data ) );
+          memcpy( data.key, key, SEC_KEY_LEN );
+          if ( hostNvItem( keyNvId ) == NULL )
+          {
+            osal_nv_item_init( keyNvId, sizeof( data ), &data );
+          }
+          else
+          {
+            HOST_CHECK_STEP( osal_nv_write( keyNvId, 0, sizeof( data ), &data ) == SUCCESS, step );
+          }
+        }
+        else
+        {
+          osal_nv_delete( keyNvId, sizeof( APSME_LinkKeyData_t ) );
+        }
+        ZDSecMgrLinkKeyStateClear( keyNvId );
+      }
+    }
+    else
+    {
+      // The key state kept in RAM must agree with the key in NV
+      HOST_CHECK_STEP( APSME_IsLinkKeyValid( extAddr ) == refKeyValid( extAddr ), step );
+      keyChecks++;
+    }
+
+    checkChains( step );
+  }
+
+  HOST_CHECK( joins && full && leaves && keyChecks );
+
+  printf( "join storm: %lu joins, %lu refused, %lu leaves, %lu key checks\n",
+          (unsigned long)joins, (unsigned long)full,
+          (unsigned long)leaves, (unsigned long)keyChecks );
+}
+
+/*
+ * A key read back from NV once is not read again until it changes.
+ */
+static void testKeyState( void )
+{
+  uint8 extAddr[Z_EXTADDR_LEN];
+  uint8 key[SEC_KEY_LEN];
+  uint16 keyNvId;
+  void *item;
+
+  testReset();
+  testExtAddr( 1, extAddr );
+  osal_memset( key, 0x5A, SEC_KEY_LEN );
+  HOST_CHECK( ZDSecMgrAddLinkKey( 0x1001, extAddr, key ) == ZSuccess );
+  HOST_CHECK( APSME_LinkKeyNVIdGet( extAddr, &keyNvId ) == ZSuccess );
+  HOST_CHECK( APSME_IsLinkKeyValid( extAddr ) == TRUE );
+
+  // Changing NV without telling the Security Manager goes unseen
+  item = hostNvItem( keyNvId );
+  memset( item, 0x00, SEC_KEY_LEN );
+  HOST_CHECK( APSME_IsLinkKeyValid( extAddr ) == TRUE );
+
+  // Until the state is cleared
+  ZDSecMgrLinkKeyStateClear( keyNvId );
+  HOST_CHECK( APSME_IsLinkKeyValid( extAddr ) == FALSE );
+
+  // A deleted key item reads as no key
+  memset( item, 0x5A, SEC_KEY_LEN );
+  ZDSecMgrLinkKeyStateClear( keyNvId );
+  HOST_CHECK( APSME_IsLinkKeyValid( extAddr ) == TRUE );
+  HOST_CHECK( osal_nv_delete( keyNvId, sizeof( APSME_LinkKeyData_t ) ) == SUCCESS );
+  ZDSecMgrLinkKeyStateClear( keyNvId );
+  HOST_CHECK( APSME_IsLinkKeyValid( extAddr ) == FALSE );
+
+  // NV IDs outside the key table are ignored
+  ZDSecMgrLinkKeyStateClear( ZCD_NV_APS_LINK_KEY_DATA_START + ZDSECMGR_ENTRY_MAX );
+  ZDSecMgrLinkKeyStateClear( ZCD_NV_APS_LINK_KEY_DATA_START - 1 );
+}
+
+int main( void )
+{
+  testJoinStorm();
+  testKeyState();
+
+  printf( "test_zdsecmgr passed\n" );
+  return ( 0 );
+}
+
+/*********************************************************************
+*********************************************************************/
@@ -288,6 +288,13 @@ uint16 znpEventLoop(uint8 taskId, uint16 events)
     MT_AfExec();
     events ^= MT_AF_EXEC_EVT;
   }
+#if defined MT_AREQ_BATCH
+  else if (events & MT_AREQ_BATCH_EVT)
+  {
+    MT_AreqBatchFlush();
+    events ^= MT_AREQ_BATCH_EVT;
+  }
+#endif
   else
   {
     events = 0;  /* Discard unknown events. */